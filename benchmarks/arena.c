@@ -94,6 +94,9 @@ int main(int argc, char **argv)
     size_t used;
     uint64_t start;
     uint64_t elapsed;
+    int counted;
+    struct cfl_allocator counting;
+    struct cfl_allocator_counters counters;
 #if !defined(CFL_SYSTEM_WINDOWS)
     struct rusage usage;
 #endif
@@ -109,6 +112,13 @@ int main(int argc, char **argv)
     reserved = 0;
     used = 0;
 
+    /* counting adds a size prefix and atomic updates to every allocation */
+    counted = getenv("CFL_COUNT_ALLOCATIONS") != NULL;
+    if (counted) {
+        cfl_allocator_counting_init(&counting, &counters);
+        cfl_set_allocator(&counting);
+    }
+
     start = monotonic_nanoseconds();
     for (iteration = 0; iteration < iterations; iteration++) {
         if (strcmp(mode, "arena") == 0 ||
@@ -152,6 +162,14 @@ int main(int argc, char **argv)
         printf(" arena_reserved=%zu arena_used=%zu arena_slack=%zu",
                reserved, used, reserved - used);
     }
+    if (counted) {
+        printf(" allocations=%llu reallocations=%llu frees=%llu "
+               "bytes_peak=%llu",
+               (unsigned long long) counters.allocations,
+               (unsigned long long) counters.reallocations,
+               (unsigned long long) counters.frees,
+               (unsigned long long) counters.bytes_peak);
+    }
     putchar('\n');
     return EXIT_SUCCESS;
 }
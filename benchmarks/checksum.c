@@ -0,0 +1,109 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+/* the byte-at-a-time loop cfl_checksum_crc32c() used to run */
+static uint32_t bytewise_table[256];
+
+static void bytewise_init(void)
+{
+    int bit;
+    uint32_t index;
+    uint32_t crc;
+
+    for (index = 0; index < 256; index++) {
+        crc = index;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+        bytewise_table[index] = crc;
+    }
+}
+
+static uint32_t bytewise_crc32c(unsigned char *buffer, size_t length)
+{
+    size_t index;
+    uint32_t crc;
+
+    crc = 0xFFFFFFFF;
+    for (index = 0; index < length; index++) {
+        crc = bytewise_table[(crc ^ buffer[index]) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xFFFFFFFF;
+}
+
+static double run(uint32_t (*function)(unsigned char *, size_t),
+                  unsigned char *buffer, size_t size, size_t total,
+                  uint32_t *sink)
+{
+    size_t rounds;
+    size_t index;
+    uint64_t start;
+    uint64_t elapsed;
+
+    rounds = total / size;
+    if (rounds == 0) {
+        rounds = 1;
+    }
+
+    start = cfl_time_now();
+    for (index = 0; index < rounds; index++) {
+        *sink ^= function(buffer, size);
+    }
+    elapsed = cfl_time_now() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    /* MB/s */
+    return (double) size * rounds * 1000.0 / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    size_t index;
+    size_t total;
+    size_t largest;
+    uint32_t sink;
+    unsigned char *buffer;
+    static const size_t sizes[] = {16, 64, 256, 1024, 4096, 16384, 65536,
+                                   1048576, 16777216};
+
+    total = argc > 1 ? strtoull(argv[1], NULL, 10) : 268435456;
+    if (total == 0) {
+        fprintf(stderr, "usage: %s [bytes-per-size]\n", argv[0]);
+        return 1;
+    }
+
+    cfl_init();
+    bytewise_init();
+
+    largest = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    buffer = malloc(largest);
+    if (buffer == NULL) {
+        return 1;
+    }
+    for (index = 0; index < largest; index++) {
+        buffer[index] = (unsigned char) (index * 2654435761u >> 13);
+    }
+
+    sink = 0;
+    printf("implementation=%s\n", cfl_checksum_crc32c_implementation());
+    printf("%10s %14s %14s\n", "size", "bytewise_MBps", "dispatch_MBps");
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index++) {
+        printf("%10zu %14.1f %14.1f\n", sizes[index],
+               run(bytewise_crc32c, buffer, sizes[index], total / 8, &sink),
+               run(cfl_checksum_crc32c, buffer, sizes[index], total, &sink));
+    }
+    printf("sink=%08x\n", sink);
+
+    free(buffer);
+
+    return 0;
+}
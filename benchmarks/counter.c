@@ -0,0 +1,123 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_counter.h>
+
+#define MODE_COMPARE_EXCHANGE 0
+#define MODE_FETCH_ADD        1
+#define MODE_COUNTER          2
+
+struct worker {
+    int                 mode;
+    size_t              count;
+    uint64_t           *shared;
+    struct cfl_counter *counter;
+    pthread_t           thread;
+};
+
+static void *increment(void *data)
+{
+    size_t         index;
+    uint64_t       old;
+    struct worker *worker;
+
+    worker = data;
+
+    for (index = 0; index < worker->count; index++) {
+        if (worker->mode == MODE_COMPARE_EXCHANGE) {
+            do {
+                old = cfl_atomic_load(worker->shared);
+            } while (!cfl_atomic_compare_exchange(worker->shared,
+                                                  old, old + 1));
+        }
+        else if (worker->mode == MODE_FETCH_ADD) {
+            cfl_atomic_fetch_add_explicit(worker->shared, 1,
+                                          CFL_ATOMIC_RELAXED);
+        }
+        else {
+            cfl_counter_inc(worker->counter);
+        }
+    }
+
+    return NULL;
+}
+
+/* returns million increments per second across all threads */
+static double run(int mode, int threads, size_t per_thread)
+{
+    int                 index;
+    uint64_t            start;
+    uint64_t            elapsed;
+    uint64_t            shared;
+    uint64_t            total;
+    struct cfl_counter *counter;
+    struct worker      *workers;
+
+    workers = calloc(threads, sizeof(struct worker));
+    counter = cfl_counter_create(0);
+    if (workers == NULL || counter == NULL) {
+        return 0;
+    }
+
+    shared = 0;
+    start = cfl_time_now();
+    for (index = 0; index < threads; index++) {
+        workers[index].mode = mode;
+        workers[index].count = per_thread;
+        workers[index].shared = &shared;
+        workers[index].counter = counter;
+        pthread_create(&workers[index].thread, NULL, increment,
+                       &workers[index]);
+    }
+    for (index = 0; index < threads; index++) {
+        pthread_join(workers[index].thread, NULL);
+    }
+    elapsed = cfl_time_now() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    total = mode == MODE_COUNTER ? cfl_counter_get(counter) : shared;
+    if (total != per_thread * threads) {
+        fprintf(stderr, "lost increments: %llu\n", (unsigned long long) total);
+    }
+
+    cfl_counter_destroy(counter);
+    free(workers);
+
+    return (double) per_thread * threads * 1000.0 / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    size_t           index;
+    size_t           per_thread;
+    static const int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    per_thread = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    if (per_thread == 0) {
+        fprintf(stderr, "usage: %s [increments-per-thread]\n", argv[0]);
+        return 1;
+    }
+
+    cfl_init();
+
+    printf("atomics=%s\n", cfl_atomic_implementation());
+    printf("%8s %14s %14s %14s\n", "threads", "cas_Mops", "fetch_add_Mops",
+           "counter_Mops");
+    for (index = 0; index < sizeof(thread_counts) / sizeof(thread_counts[0]);
+         index++) {
+        printf("%8d %14.2f %14.2f %14.2f\n", thread_counts[index],
+               run(MODE_COMPARE_EXCHANGE, thread_counts[index], per_thread),
+               run(MODE_FETCH_ADD, thread_counts[index], per_thread),
+               run(MODE_COUNTER, thread_counts[index], per_thread));
+    }
+
+    return 0;
+}
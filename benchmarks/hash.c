@@ -0,0 +1,106 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+static uint64_t sink;
+
+static void hash_64(const void *buffer, size_t size)
+{
+    sink += cfl_hash_64bits(buffer, size);
+}
+
+static void hash_128(const void *buffer, size_t size)
+{
+    cfl_hash_128bits_t hash;
+
+    hash = cfl_hash_128bits(buffer, size);
+    sink += hash.low64 ^ hash.high64;
+}
+
+static void hash_128_stream(const void *buffer, size_t size)
+{
+    size_t offset;
+    size_t chunk;
+    cfl_hash_state_t state;
+    cfl_hash_128bits_t hash;
+
+    /* 4 KiB updates, like hashing a chunk as it is appended */
+    cfl_hash_128bits_reset(&state);
+    for (offset = 0; offset < size; offset += chunk) {
+        chunk = size - offset < 4096 ? size - offset : 4096;
+        cfl_hash_128bits_update(&state, (const char *) buffer + offset, chunk);
+    }
+    hash = cfl_hash_128bits_digest(&state);
+    sink += hash.low64 ^ hash.high64;
+}
+
+static double run(void (*function)(const void *, size_t),
+                  const void *buffer, size_t size, size_t total)
+{
+    size_t rounds;
+    size_t index;
+    uint64_t start;
+    uint64_t elapsed;
+
+    rounds = total / size;
+    if (rounds == 0) {
+        rounds = 1;
+    }
+
+    start = cfl_time_now();
+    for (index = 0; index < rounds; index++) {
+        function(buffer, size);
+    }
+    elapsed = cfl_time_now() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    /* MB/s */
+    return (double) size * rounds * 1000.0 / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    size_t index;
+    size_t total;
+    size_t largest;
+    unsigned char *buffer;
+    static const size_t sizes[] = {16, 64, 256, 1024, 4096, 65536, 1048576,
+                                   16777216};
+
+    total = argc > 1 ? strtoull(argv[1], NULL, 10) : 1073741824;
+    if (total == 0) {
+        fprintf(stderr, "usage: %s [bytes-per-size]\n", argv[0]);
+        return 1;
+    }
+
+    largest = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    buffer = malloc(largest);
+    if (buffer == NULL) {
+        return 1;
+    }
+    for (index = 0; index < largest; index++) {
+        buffer[index] = (unsigned char) (index * 2654435761u >> 13);
+    }
+
+    printf("implementation=%s\n", cfl_hash_implementation());
+    printf("%10s %12s %12s %14s\n",
+           "size", "xxh3_64_MBps", "xxh3_128_MBps", "stream_128_MBps");
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index++) {
+        printf("%10zu %12.1f %12.1f %14.1f\n", sizes[index],
+               run(hash_64, buffer, sizes[index], total),
+               run(hash_128, buffer, sizes[index], total),
+               run(hash_128_stream, buffer, sizes[index], total));
+    }
+    printf("sink=%016llx\n", (unsigned long long) sink);
+
+    free(buffer);
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+static size_t sink;
+static struct cfl_arena *arena;
+
+static const char *logfmt_line =
+    "time=2026-03-14T09:26:53.589Z level=info service=checkout "
+    "msg=\"order placed for customer \\\"acme\\\" after retry\" "
+    "order_id=8d1c6f3e-43a2-4b7a-9f0e-2c6a1b5d9e71 items=3 total=129.95 "
+    "currency=EUR latency_ms=41.7 path=/api/v1/orders method=POST "
+    "status=201 trace_id=4bf92f3577b34da6a3ce929d0e0e4736 "
+    "user_agent=\"curl/8.5.0\" region=eu-west-1";
+
+/* split the pairs, then split each pair and copy key and value */
+static void parse_split(const char *line, size_t length)
+{
+    char *equal;
+    struct cfl_list *head;
+    struct cfl_list *pairs;
+    struct cfl_kvlist *list;
+    struct cfl_split_entry *entry;
+
+    (void) length;
+
+    list = cfl_kvlist_create();
+    pairs = cfl_utils_split_quoted(line, ' ', -1);
+    cfl_list_foreach(head, pairs) {
+        entry = cfl_list_entry(head, struct cfl_split_entry, _head);
+        equal = memchr(entry->value, '=', entry->len);
+        if (equal == NULL) {
+            continue;
+        }
+        cfl_kvlist_insert_string_s(list, entry->value, equal - entry->value,
+                                   equal + 1,
+                                   entry->len - (equal + 1 - entry->value),
+                                   CFL_FALSE);
+    }
+    cfl_utils_split_free(pairs);
+
+    sink += cfl_kvlist_count(list);
+    cfl_kvlist_destroy(list);
+}
+
+static void parse_logfmt(const char *line, size_t length)
+{
+    struct cfl_kvlist *list;
+
+    list = cfl_logfmt_parse(NULL, line, length, 0);
+    sink += cfl_kvlist_count(list);
+    cfl_kvlist_destroy(list);
+}
+
+static void parse_logfmt_typed(const char *line, size_t length)
+{
+    struct cfl_kvlist *list;
+
+    list = cfl_logfmt_parse(NULL, line, length, CFL_LOGFMT_INFER_TYPES);
+    sink += cfl_kvlist_count(list);
+    cfl_kvlist_destroy(list);
+}
+
+static void parse_logfmt_arena(const char *line, size_t length)
+{
+    struct cfl_kvlist *list;
+
+    list = cfl_logfmt_parse(arena, line, length, CFL_LOGFMT_INFER_TYPES);
+    sink += cfl_kvlist_count(list);
+    cfl_arena_reset(arena);
+}
+
+static void run(const char *name, void (*function)(const char *, size_t),
+                size_t lines)
+{
+    size_t index;
+    size_t length;
+    uint64_t start;
+    uint64_t elapsed;
+
+    length = strlen(logfmt_line);
+
+    start = cfl_time_monotonic();
+    for (index = 0; index < lines; index++) {
+        function(logfmt_line, length);
+    }
+    elapsed = cfl_time_monotonic() - start;
+
+    printf("%-16s %10.1f\n", name, (double) elapsed / lines);
+}
+
+int main(int argc, char **argv)
+{
+    size_t lines;
+
+    lines = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (lines == 0) {
+        fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+        return 1;
+    }
+
+    arena = cfl_arena_create(8192);
+    if (arena == NULL) {
+        return 1;
+    }
+
+    printf("%-16s %10s\n", "parser", "ns_per_line");
+    run("split_insert", parse_split, lines);
+    run("logfmt", parse_logfmt, lines);
+    run("logfmt_typed", parse_logfmt_typed, lines);
+    run("logfmt_arena", parse_logfmt_arena, lines);
+    printf("sink=%zu\n", sink);
+
+    cfl_arena_destroy(arena);
+
+    return 0;
+}
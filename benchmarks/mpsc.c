@@ -0,0 +1,190 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_mpsc.h>
+
+struct record {
+    uint64_t             payload;
+    struct cfl_mpsc_node _node;
+    struct cfl_list      _head;
+};
+
+struct queue {
+    int                   locked;
+    pthread_mutex_t       lock;
+    struct cfl_list       list;
+    struct cfl_mpsc_queue mpsc;
+};
+
+struct producer {
+    struct queue  *queue;
+    struct record *records;
+    size_t         count;
+    pthread_t      thread;
+};
+
+static void *produce(void *data)
+{
+    size_t           index;
+    struct producer *producer;
+    struct queue    *queue;
+
+    producer = data;
+    queue = producer->queue;
+
+    for (index = 0; index < producer->count; index++) {
+        if (queue->locked) {
+            pthread_mutex_lock(&queue->lock);
+            cfl_list_add(&producer->records[index]._head, &queue->list);
+            pthread_mutex_unlock(&queue->lock);
+        }
+        else {
+            cfl_mpsc_queue_push(&queue->mpsc, &producer->records[index]._node);
+        }
+    }
+
+    return NULL;
+}
+
+/* the consumer drains up to 'batch' records per lock or pop_batch call */
+static size_t consume(struct queue *queue, size_t batch, uint64_t *sink)
+{
+    size_t                 index;
+    size_t                 count;
+    struct cfl_list       *head;
+    struct cfl_list       *tmp;
+    struct record         *record;
+    struct cfl_mpsc_node  *nodes[256];
+
+    count = 0;
+
+    if (queue->locked) {
+        pthread_mutex_lock(&queue->lock);
+        cfl_list_foreach_safe(head, tmp, &queue->list) {
+            if (count == batch) {
+                break;
+            }
+            record = cfl_list_entry(head, struct record, _head);
+            cfl_list_del(&record->_head);
+            *sink += record->payload;
+            count++;
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        return count;
+    }
+
+    count = cfl_mpsc_queue_pop_batch(&queue->mpsc, nodes, batch);
+    for (index = 0; index < count; index++) {
+        record = cfl_mpsc_entry(nodes[index], struct record, _node);
+        *sink += record->payload;
+    }
+
+    return count;
+}
+
+static double run(int locked, int producers, size_t per_producer,
+                  size_t batch, struct record *records, uint64_t *sink)
+{
+    int              index;
+    size_t           received;
+    size_t           total;
+    uint64_t         start;
+    uint64_t         elapsed;
+    struct queue     queue;
+    struct producer *workers;
+
+    workers = calloc(producers, sizeof(struct producer));
+    if (workers == NULL) {
+        return 0;
+    }
+
+    queue.locked = locked;
+    pthread_mutex_init(&queue.lock, NULL);
+    cfl_list_init(&queue.list);
+    cfl_mpsc_queue_init(&queue.mpsc);
+
+    total = per_producer * producers;
+
+    start = cfl_time_now();
+    for (index = 0; index < producers; index++) {
+        workers[index].queue = &queue;
+        workers[index].records = &records[index * per_producer];
+        workers[index].count = per_producer;
+        pthread_create(&workers[index].thread, NULL, produce, &workers[index]);
+    }
+
+    received = 0;
+    while (received < total) {
+        received += consume(&queue, batch, sink);
+    }
+
+    for (index = 0; index < producers; index++) {
+        pthread_join(workers[index].thread, NULL);
+    }
+    elapsed = cfl_time_now() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    pthread_mutex_destroy(&queue.lock);
+    free(workers);
+
+    /* million records per second */
+    return (double) total * 1000.0 / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    int            index;
+    int            producers;
+    size_t         count;
+    size_t         batch;
+    size_t         per_producer;
+    uint64_t       sink;
+    struct record *records;
+    static const int thread_counts[] = {1, 2, 4, 8, 16};
+
+    per_producer = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    batch = argc > 2 ? strtoull(argv[2], NULL, 10) : 64;
+    if (per_producer == 0 || batch == 0 || batch > 256) {
+        fprintf(stderr, "usage: %s [records-per-producer] [batch<=256]\n",
+                argv[0]);
+        return 1;
+    }
+
+    cfl_init();
+
+    producers = thread_counts[sizeof(thread_counts) /
+                              sizeof(thread_counts[0]) - 1];
+    count = per_producer * producers;
+    records = calloc(count, sizeof(struct record));
+    if (records == NULL) {
+        return 1;
+    }
+    for (count = 0; count < per_producer * producers; count++) {
+        records[count].payload = count;
+    }
+
+    sink = 0;
+    printf("atomics=%s batch=%zu\n", cfl_atomic_implementation(), batch);
+    printf("%10s %14s %14s\n", "producers", "mutex_Mops", "mpsc_Mops");
+    for (index = 0; index < (int) (sizeof(thread_counts) /
+                                   sizeof(thread_counts[0])); index++) {
+        producers = thread_counts[index];
+        printf("%10d %14.2f %14.2f\n", producers,
+               run(CFL_TRUE, producers, per_producer, batch, records, &sink),
+               run(CFL_FALSE, producers, per_producer, batch, records, &sink));
+    }
+    printf("sink=%llu\n", (unsigned long long) sink);
+
+    free(records);
+
+    return 0;
+}
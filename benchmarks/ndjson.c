@@ -0,0 +1,180 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <cfl/cfl.h>
+
+static size_t sink;
+static size_t file_size;
+static char path[] = "/tmp/cfl-benchmark-ndjson-XXXXXX";
+
+static int write_file(size_t lines)
+{
+    int fd;
+    size_t index;
+    FILE *fp;
+
+    fd = mkstemp(path);
+    if (fd == -1) {
+        return -1;
+    }
+
+    fp = fdopen(fd, "w");
+    if (fp == NULL) {
+        close(fd);
+        return -1;
+    }
+
+    for (index = 0; index < lines; index++) {
+        fprintf(fp,
+                "{\"time\":\"2026-03-14T09:26:53.%03zuZ\",\"level\":\"info\","
+                "\"service\":\"checkout\",\"msg\":\"order placed for "
+                "customer \\\"acme\\\" after retry\",\"order_id\":%zu,"
+                "\"items\":3,\"total\":129.95,\"currency\":\"EUR\","
+                "\"http\":{\"method\":\"POST\",\"path\":\"/api/v1/orders\","
+                "\"status\":201},\"tags\":[\"eu-west-1\",\"canary\"],"
+                "\"trace_id\":\"4bf92f3577b34da6a3ce929d0e0e4736\"}\n",
+                index % 1000, index);
+    }
+    file_size = ftell(fp);
+    fclose(fp);
+
+    return 0;
+}
+
+/* what replay does today: fgets() into a buffer, then parse */
+static size_t read_fgets(int decode)
+{
+    char buffer[4096];
+    size_t lines = 0;
+    size_t length;
+    FILE *fp;
+    struct cfl_arena *arena;
+    struct cfl_kvlist *list;
+
+    arena = cfl_arena_create(64 * 1024);
+    fp = fopen(path, "r");
+    while (fgets(buffer, sizeof(buffer), fp) != NULL) {
+        length = strlen(buffer);
+        if (decode) {
+            list = cfl_ndjson_decode(arena, buffer, length, 0);
+            sink += cfl_kvlist_count(list);
+            cfl_arena_reset(arena);
+        }
+        lines++;
+    }
+    fclose(fp);
+    cfl_arena_destroy(arena);
+
+    return lines;
+}
+
+static size_t read_mmap(int decode)
+{
+    size_t lines = 0;
+    size_t length;
+    const char *line;
+    struct cfl_arena *arena;
+    struct cfl_kvlist *list;
+    struct cfl_ndjson_reader *reader;
+
+    arena = cfl_arena_create(64 * 1024);
+    reader = cfl_ndjson_reader_open(path);
+    while (cfl_ndjson_reader_next(reader, &line, &length) == 0) {
+        if (decode) {
+            list = cfl_ndjson_decode(arena, line, length, 0);
+            sink += cfl_kvlist_count(list);
+            cfl_arena_reset(arena);
+        }
+        lines++;
+    }
+    cfl_ndjson_reader_destroy(reader);
+    cfl_arena_destroy(arena);
+
+    return lines;
+}
+
+static size_t counts[64];
+
+static int count_record(struct cfl_kvlist *record,
+                        const char *line, size_t length,
+                        int worker, void *data)
+{
+    (void) line;
+    (void) length;
+    (void) data;
+
+    counts[worker] += cfl_kvlist_count(record) > 0;
+
+    return 0;
+}
+
+static size_t read_workers(int workers)
+{
+    int index;
+    size_t lines = 0;
+    struct cfl_ndjson_reader *reader;
+
+    memset(counts, 0, sizeof(counts));
+    reader = cfl_ndjson_reader_open(path);
+    cfl_ndjson_reader_for_each(reader, workers, CFL_NDJSON_DECODE,
+                               count_record, NULL);
+    cfl_ndjson_reader_destroy(reader);
+
+    for (index = 0; index < workers; index++) {
+        lines += counts[index];
+    }
+
+    return lines;
+}
+
+static void run(const char *name, size_t (*function)(int), int argument)
+{
+    size_t lines;
+    uint64_t start;
+    uint64_t elapsed;
+
+    start = cfl_time_monotonic();
+    lines = function(argument);
+    elapsed = cfl_time_monotonic() - start;
+
+    printf("%-16s %12.1f %10.1f\n", name, (double) elapsed / lines,
+           (double) file_size / 1048576 / ((double) elapsed / 1e9));
+}
+
+int main(int argc, char **argv)
+{
+    size_t lines;
+
+    lines = argc > 1 ? strtoull(argv[1], NULL, 10) : 500000;
+    if (lines == 0) {
+        fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+        return 1;
+    }
+
+    if (write_file(lines) != 0) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+
+    /* warm the page cache */
+    read_mmap(CFL_FALSE);
+
+    printf("%-16s %12s %10s\n", "reader", "ns_per_line", "MiB_per_s");
+    run("fgets", read_fgets, CFL_FALSE);
+    run("mmap_lines", read_mmap, CFL_FALSE);
+    run("fgets_decode", read_fgets, CFL_TRUE);
+    run("mmap_decode", read_mmap, CFL_TRUE);
+    run("workers_1", read_workers, 1);
+    run("workers_2", read_workers, 2);
+    run("workers_4", read_workers, 4);
+    printf("sink=%zu\n", sink);
+
+    unlink(path);
+
+    return 0;
+}
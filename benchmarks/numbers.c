@@ -0,0 +1,148 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+#define SAMPLE_COUNT 4096
+#define SAMPLE_SIZE  32
+
+static char samples[SAMPLE_COUNT][SAMPLE_SIZE];
+static size_t lengths[SAMPLE_COUNT];
+static double sink;
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+static void fill_integers(void)
+{
+    int index;
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+    for (index = 0; index < SAMPLE_COUNT; index++) {
+        lengths[index] = snprintf(samples[index], SAMPLE_SIZE, "%lld",
+                                  (long long) (next_random(&state) >>
+                                               (next_random(&state) % 63)));
+    }
+}
+
+static void fill_doubles(void)
+{
+    int index;
+    double value;
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+    for (index = 0; index < SAMPLE_COUNT; index++) {
+        /* metrics-like values with a varying number of digits */
+        value = (double) (next_random(&state) % 100000000) /
+                (double) (1 + next_random(&state) % 100000);
+        lengths[index] = snprintf(samples[index], SAMPLE_SIZE, "%.*g",
+                                  1 + (int) (next_random(&state) % 17),
+                                  value);
+    }
+}
+
+/* the slice is copied to add the terminator strtoll()/strtod() need */
+static double parse_strtoll(const char *text, size_t length)
+{
+    char buffer[SAMPLE_SIZE];
+
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+
+    return (double) strtoll(buffer, NULL, 10);
+}
+
+static double parse_int64(const char *text, size_t length)
+{
+    int64_t value;
+
+    cfl_utils_parse_int64(text, length, &value);
+
+    return (double) value;
+}
+
+static double parse_strtod(const char *text, size_t length)
+{
+    char buffer[SAMPLE_SIZE];
+
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+
+    return strtod(buffer, NULL);
+}
+
+static double parse_double(const char *text, size_t length)
+{
+    double value;
+
+    cfl_utils_parse_double(text, length, &value);
+
+    return value;
+}
+
+static double parse_variant(const char *text, size_t length)
+{
+    double value;
+    struct cfl_variant *variant;
+
+    variant = cfl_variant_create_from_numeric_text_in(NULL, text, length);
+    value = (double) variant->type;
+    cfl_variant_destroy(variant);
+
+    return value;
+}
+
+static double run(double (*function)(const char *, size_t), size_t rounds)
+{
+    size_t round;
+    size_t index;
+    uint64_t start;
+    uint64_t elapsed;
+
+    start = cfl_time_monotonic();
+    for (round = 0; round < rounds; round++) {
+        for (index = 0; index < SAMPLE_COUNT; index++) {
+            sink += function(samples[index], lengths[index]);
+        }
+    }
+    elapsed = cfl_time_monotonic() - start;
+
+    return (double) elapsed / (rounds * SAMPLE_COUNT);
+}
+
+int main(int argc, char **argv)
+{
+    size_t rounds;
+
+    rounds = argc > 1 ? strtoull(argv[1], NULL, 10) : 500;
+    if (rounds == 0) {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-10s %12s %12s %12s\n", "input", "libc_ns", "cfl_ns", "variant_ns");
+
+    fill_integers();
+    printf("%-10s %12.1f %12.1f %12.1f\n", "int64",
+           run(parse_strtoll, rounds), run(parse_int64, rounds),
+           run(parse_variant, rounds));
+
+    fill_doubles();
+    printf("%-10s %12.1f %12.1f %12.1f\n", "double",
+           run(parse_strtod, rounds), run(parse_double, rounds),
+           run(parse_variant, rounds));
+
+    printf("sink=%g\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_sds_builder.h>
+
+#define RECORDS_PER_PAYLOAD 1000
+
+/* IOV_MAX on Linux and the BSDs */
+#define WRITEV_BATCH        1024
+
+static size_t sink;
+
+static const char *message =
+    "order placed for customer acme after retry, items were reserved in "
+    "warehouse eu-west-1 and the payment provider confirmed the charge";
+
+static char body[512];
+
+static struct cfl_sds_builder *builder;
+
+#ifndef _WIN32
+static int null_fd = -1;
+#endif
+
+/* a record body produced by an earlier encoding step */
+static cfl_sds_t record_body(size_t index)
+{
+    return cfl_sds_create_len(body, 256 + (int) (index % 256));
+}
+
+static size_t record_id(char *buffer, size_t index)
+{
+    return (size_t) snprintf(buffer, 32, "%zu", index);
+}
+
+static cfl_sds_t cat_payload(size_t first, size_t records)
+{
+    size_t index;
+    size_t length;
+    char id[32];
+    cfl_sds_t s;
+    cfl_sds_t value;
+
+    s = cfl_sds_create_size(64);
+    for (index = first; index < first + records; index++) {
+        length = record_id(id, index);
+        value = record_body(index);
+        s = cfl_sds_cat(s, "{\"id\":", 6);
+        s = cfl_sds_cat(s, id, (int) length);
+        s = cfl_sds_cat(s, ",\"msg\":\"", 8);
+        s = cfl_sds_cat(s, message, (int) strlen(message));
+        s = cfl_sds_cat(s, "\",\"body\":\"", 10);
+        s = cfl_sds_cat(s, value, (int) cfl_sds_len(value));
+        s = cfl_sds_cat(s, "\"}\n", 3);
+        cfl_sds_destroy(value);
+    }
+
+    return s;
+}
+
+static void build_cat(size_t first, size_t records)
+{
+    cfl_sds_t s;
+
+    s = cat_payload(first, records);
+    sink += cfl_sds_len(s);
+    cfl_sds_destroy(s);
+}
+
+static void build_segments(size_t first, size_t records)
+{
+    size_t index;
+    size_t length;
+    char id[32];
+
+    cfl_sds_builder_reset(builder);
+    for (index = first; index < first + records; index++) {
+        length = record_id(id, index);
+        cfl_sds_builder_append(builder, "{\"id\":", 6);
+        cfl_sds_builder_append(builder, id, length);
+        cfl_sds_builder_append(builder, ",\"msg\":\"", 8);
+        cfl_sds_builder_append_ref(builder, message, strlen(message));
+        cfl_sds_builder_append(builder, "\",\"body\":\"", 10);
+        cfl_sds_builder_append_sds(builder, record_body(index));
+        cfl_sds_builder_append(builder, "\"}\n", 3);
+    }
+}
+
+static void build_flatten(size_t first, size_t records)
+{
+    cfl_sds_t s;
+
+    build_segments(first, records);
+    s = cfl_sds_builder_flatten(builder);
+
+    sink += cfl_sds_len(s);
+    cfl_sds_destroy(s);
+}
+
+static void build_iov(size_t first, size_t records)
+{
+    size_t index;
+    size_t count;
+    struct cfl_iovec *iov;
+
+    build_segments(first, records);
+
+    /* what writev() walks */
+    iov = cfl_sds_builder_iov(builder, &count);
+    for (index = 0; index < count; index++) {
+        sink += iov[index].iov_len;
+    }
+}
+
+#ifndef _WIN32
+static void write_cat(size_t first, size_t records)
+{
+    cfl_sds_t s;
+
+    s = cat_payload(first, records);
+    sink += (size_t) write(null_fd, s, cfl_sds_len(s));
+    cfl_sds_destroy(s);
+}
+
+static void write_iov(size_t first, size_t records)
+{
+    size_t index;
+    size_t count;
+    size_t batch;
+    struct cfl_iovec *iov;
+
+    build_segments(first, records);
+
+    iov = cfl_sds_builder_iov(builder, &count);
+    for (index = 0; index < count; index += batch) {
+        batch = count - index < WRITEV_BATCH ?
+                count - index : WRITEV_BATCH;
+        sink += (size_t) writev(null_fd, (struct iovec *) &iov[index],
+                                (int) batch);
+    }
+}
+#endif
+
+static void run(const char *name, void (*function)(size_t, size_t),
+                size_t records)
+{
+    size_t first;
+    size_t batch;
+    uint64_t start;
+    uint64_t elapsed;
+
+    start = cfl_time_monotonic();
+    for (first = 0; first < records; first += batch) {
+        batch = records - first < RECORDS_PER_PAYLOAD ?
+                records - first : RECORDS_PER_PAYLOAD;
+        function(first, batch);
+    }
+    elapsed = cfl_time_monotonic() - start;
+
+    printf("%-20s %12.1f\n", name, (double) elapsed / records);
+}
+
+int main(int argc, char **argv)
+{
+    size_t records;
+
+    records = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (records == 0) {
+        fprintf(stderr, "usage: %s [records]\n", argv[0]);
+        return 1;
+    }
+
+    memset(body, 'x', sizeof(body));
+    builder = cfl_sds_builder_create();
+
+    printf("%-20s %12s\n", "case", "ns_per_record");
+    run("sds_cat", build_cat, records);
+    run("builder_flatten", build_flatten, records);
+    run("builder_iov", build_iov, records);
+#ifndef _WIN32
+    null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        run("sds_cat_write", write_cat, records);
+        run("builder_writev", write_iov, records);
+        close(null_fd);
+    }
+#endif
+    printf("sink=%zu\n", sink);
+
+    cfl_sds_builder_destroy(builder);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <cfl/cfl.h>
+
+static size_t sink;
+
+static const char *message =
+    "order placed for customer acme after retry, items were reserved in "
+    "warehouse eu-west-1 and the payment provider confirmed the charge";
+
+/*
+ * The same lines with a field width of 1, which changes nothing in the
+ * output but is not handled natively, measure the vsnprintf() path.
+ */
+static void format_native(cfl_sds_t *s, uint64_t index)
+{
+    cfl_sds_printf(s, "ts=%" PRIu64 " seq=%zu level=%s status=%d "
+                   "latency=%f trace=%x msg=\"%.*s\"\n",
+                   UINT64_C(1773480413589000000) + index, (size_t) index,
+                   "info", 201, 41.7, (unsigned int) index * 2654435761u,
+                   (int) strlen(message), message);
+}
+
+static void format_libc(cfl_sds_t *s, uint64_t index)
+{
+    cfl_sds_printf(s, "ts=%1" PRIu64 " seq=%1zu level=%1s status=%1d "
+                   "latency=%1f trace=%1x msg=\"%1.*s\"\n",
+                   UINT64_C(1773480413589000000) + index, (size_t) index,
+                   "info", 201, 41.7, (unsigned int) index * 2654435761u,
+                   (int) strlen(message), message);
+}
+
+static void format_integers(cfl_sds_t *s, uint64_t index)
+{
+    cfl_sds_printf(s, "%" PRIu64 ",%" PRId64 ",%zu,%d\n",
+                   index, -(int64_t) index, (size_t) index * 7, (int) index);
+}
+
+static void format_integers_libc(cfl_sds_t *s, uint64_t index)
+{
+    cfl_sds_printf(s, "%1" PRIu64 ",%1" PRId64 ",%1zu,%1d\n",
+                   index, -(int64_t) index, (size_t) index * 7, (int) index);
+}
+
+static void run(const char *name, void (*function)(cfl_sds_t *, uint64_t),
+                size_t lines, int fresh)
+{
+    size_t index;
+    uint64_t start;
+    uint64_t elapsed;
+    cfl_sds_t s;
+
+    s = cfl_sds_create_size(64);
+
+    start = cfl_time_monotonic();
+    for (index = 0; index < lines; index++) {
+        if (fresh) {
+            /* a new short string per line that has to grow */
+            cfl_sds_destroy(s);
+            s = cfl_sds_create_size(16);
+        }
+        else {
+            cfl_sds_set_len(s, 0);
+        }
+        function(&s, index);
+        sink += cfl_sds_len(s);
+    }
+    elapsed = cfl_time_monotonic() - start;
+    cfl_sds_destroy(s);
+
+    printf("%-20s %10.1f\n", name, (double) elapsed / lines);
+}
+
+int main(int argc, char **argv)
+{
+    size_t lines;
+
+    lines = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (lines == 0) {
+        fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-20s %10s\n", "case", "ns_per_line");
+    run("line_native", format_native, lines, CFL_FALSE);
+    run("line_vsnprintf", format_libc, lines, CFL_FALSE);
+    run("line_native_new", format_native, lines, CFL_TRUE);
+    run("line_vsnprintf_new", format_libc, lines, CFL_TRUE);
+    run("ints_native", format_integers, lines, CFL_FALSE);
+    run("ints_vsnprintf", format_integers_libc, lines, CFL_FALSE);
+    printf("sink=%zu\n", sink);
+
+    return 0;
+}
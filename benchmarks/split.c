@@ -0,0 +1,148 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+#define MAX_VIEWS 64
+
+static size_t sink;
+
+static const char *syslog_line =
+    "<165>1 2026-03-14T09:26:53.589Z web-07.example.net nginx 2817 ID47 "
+    "[exampleSDID@32473 iut=\"3\" eventSource=\"Application\" "
+    "eventID=\"1011\"] \"GET /api/v1/orders?limit=50 HTTP/1.1\" 200 5213 "
+    "\"-\" \"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+    "(KHTML, like Gecko) Chrome/122.0 Safari/537.36\" rt=0.042";
+
+static const char *logfmt_line =
+    "time=2026-03-14T09:26:53.589Z level=info service=checkout "
+    "msg=\"order placed for customer \\\"acme\\\" after retry\" "
+    "order_id=8d1c6f3e-43a2-4b7a-9f0e-2c6a1b5d9e71 items=3 total=129.95 "
+    "currency=EUR latency_ms=41.7 path=/api/v1/orders method=POST "
+    "status=201 trace_id=4bf92f3577b34da6a3ce929d0e0e4736 "
+    "user_agent=\"curl/8.5.0\" region=eu-west-1";
+
+/* error line with a long quoted message */
+static const char *logfmt_error_line =
+    "time=2026-03-14T09:26:54.102Z level=error service=checkout "
+    "msg=\"payment authorization failed: upstream returned 503 "
+    "Service Unavailable after 3 attempts; last error: dial tcp "
+    "10.42.7.19:8443: i/o timeout while waiting for TLS handshake to "
+    "complete, circuit breaker for provider \\\"card-eu\\\" is now open "
+    "and requests will be rejected for the next 30s\" "
+    "stack=\"at PaymentClient.authorize (client.ts:214) at "
+    "CheckoutService.placeOrder (service.ts:88) at Router.handle "
+    "(router.ts:41) at Server.dispatch (server.ts:130)\" "
+    "order_id=8d1c6f3e-43a2-4b7a-9f0e-2c6a1b5d9e71 attempt=3";
+
+static void split_list(const char *line, size_t length, int quoted)
+{
+    struct cfl_list *list;
+
+    (void) length;
+
+    if (quoted) {
+        list = cfl_utils_split_quoted(line, ' ', -1);
+    }
+    else {
+        list = cfl_utils_split(line, ' ', -1);
+    }
+    sink += cfl_list_size(list);
+    cfl_utils_split_free(list);
+}
+
+static void split_view(const char *line, size_t length, int quoted)
+{
+    int count;
+    char scratch[512];
+    struct cfl_split_view views[MAX_VIEWS];
+
+    if (quoted) {
+        count = cfl_utils_split_quoted_view(line, length, ' ', -1,
+                                            views, MAX_VIEWS,
+                                            scratch, sizeof(scratch));
+    }
+    else {
+        count = cfl_utils_split_view(line, length, ' ', -1,
+                                     views, MAX_VIEWS);
+    }
+    sink += count;
+}
+
+static struct cfl_arena *arena;
+
+static void split_view_in(const char *line, size_t length, int quoted)
+{
+    struct cfl_split_view *views;
+
+    sink += cfl_utils_split_view_in(arena, line, length, ' ', -1, quoted,
+                                    &views);
+    cfl_arena_reset(arena);
+}
+
+static double run(void (*function)(const char *, size_t, int),
+                  const char *line, int quoted, size_t lines)
+{
+    size_t index;
+    size_t length;
+    uint64_t start;
+    uint64_t elapsed;
+
+    length = strlen(line);
+
+    start = cfl_time_monotonic();
+    for (index = 0; index < lines; index++) {
+        function(line, length, quoted);
+    }
+    elapsed = cfl_time_monotonic() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    /* ns per line */
+    return (double) elapsed / lines;
+}
+
+static void report(const char *name, const char *line, size_t lines)
+{
+    int quoted;
+
+    for (quoted = 0; quoted <= 1; quoted++) {
+        printf("%-8s %-8s %12.1f %12.1f %12.1f\n",
+               name, quoted ? "quoted" : "plain",
+               run(split_list, line, quoted, lines),
+               run(split_view, line, quoted, lines),
+               run(split_view_in, line, quoted, lines));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t lines;
+
+    lines = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (lines == 0) {
+        fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+        return 1;
+    }
+
+    arena = cfl_arena_create(4096);
+    if (arena == NULL) {
+        return 1;
+    }
+
+    printf("%-8s %-8s %12s %12s %12s\n",
+           "input", "mode", "list_ns", "view_ns", "view_in_ns");
+    report("syslog", syslog_line, lines);
+    report("logfmt", logfmt_line, lines);
+    report("error", logfmt_error_line, lines);
+    printf("sink=%zu\n", sink);
+
+    cfl_arena_destroy(arena);
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_spsc.h>
+
+struct stage {
+    struct cfl_spsc_ring  *ring;
+    struct cfl_spsc_ring  *reply;
+    struct cfl_variant   **values;
+    size_t                 count;
+    size_t                 batch;
+};
+
+static void *produce(void *data)
+{
+    size_t        sent;
+    size_t        count;
+    struct stage *stage;
+
+    stage = data;
+
+    sent = 0;
+    while (sent < stage->count) {
+        count = stage->count - sent;
+        if (count > stage->batch) {
+            count = stage->batch;
+        }
+
+        count = cfl_spsc_ring_push_batch(stage->ring,
+                                         (void **) &stage->values[sent],
+                                         count);
+        if (count == 0) {
+            cfl_spsc_ring_wait_writable(stage->ring, -1);
+        }
+        sent += count;
+    }
+
+    return NULL;
+}
+
+/* returns million variants per second */
+static double throughput(int flags, size_t batch,
+                         struct cfl_variant **values, size_t count,
+                         int64_t *sink)
+{
+    size_t              index;
+    size_t              received;
+    size_t              popped;
+    uint64_t            start;
+    uint64_t            elapsed;
+    pthread_t           thread;
+    struct stage        stage;
+    struct cfl_variant *items[256];
+
+    stage.ring = cfl_spsc_ring_create(1024, flags);
+    stage.values = values;
+    stage.count = count;
+    stage.batch = batch;
+    if (stage.ring == NULL) {
+        return 0;
+    }
+
+    start = cfl_time_now();
+    pthread_create(&thread, NULL, produce, &stage);
+
+    received = 0;
+    while (received < count) {
+        popped = cfl_spsc_ring_pop_batch(stage.ring, (void **) items, batch);
+        if (popped == 0) {
+            cfl_spsc_ring_wait_readable(stage.ring, -1);
+            continue;
+        }
+        for (index = 0; index < popped; index++) {
+            *sink += items[index]->data.as_int64;
+        }
+        received += popped;
+    }
+
+    pthread_join(thread, NULL);
+    elapsed = cfl_time_now() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    cfl_spsc_ring_destroy(stage.ring);
+
+    return (double) count * 1000.0 / elapsed;
+}
+
+static void *echo(void *data)
+{
+    size_t        index;
+    void         *item;
+    struct stage *stage;
+
+    stage = data;
+
+    for (index = 0; index < stage->count; index++) {
+        while ((item = cfl_spsc_ring_pop(stage->ring)) == NULL) {
+            cfl_spsc_ring_wait_readable(stage->ring, -1);
+        }
+        while (cfl_spsc_ring_push(stage->reply, item) != 0) {
+            cfl_spsc_ring_wait_writable(stage->reply, -1);
+        }
+    }
+
+    return NULL;
+}
+
+/* returns nanoseconds per one-way handoff measured over round trips */
+static double latency(int flags, struct cfl_variant *value, size_t rounds)
+{
+    size_t       index;
+    uint64_t     start;
+    uint64_t     elapsed;
+    pthread_t    thread;
+    struct stage stage;
+
+    stage.ring = cfl_spsc_ring_create(2, flags);
+    stage.reply = cfl_spsc_ring_create(2, flags);
+    stage.count = rounds;
+    if (stage.ring == NULL || stage.reply == NULL) {
+        return 0;
+    }
+
+    pthread_create(&thread, NULL, echo, &stage);
+
+    start = cfl_time_now();
+    for (index = 0; index < rounds; index++) {
+        cfl_spsc_ring_push(stage.ring, value);
+        while (cfl_spsc_ring_pop(stage.reply) == NULL) {
+            cfl_spsc_ring_wait_readable(stage.reply, -1);
+        }
+    }
+    elapsed = cfl_time_now() - start;
+
+    pthread_join(thread, NULL);
+
+    cfl_spsc_ring_destroy(stage.ring);
+    cfl_spsc_ring_destroy(stage.reply);
+
+    return (double) elapsed / rounds / 2;
+}
+
+int main(int argc, char **argv)
+{
+    size_t               index;
+    size_t               count;
+    size_t               rounds;
+    int64_t              sink;
+    struct cfl_variant **values;
+    static const size_t  batches[] = {1, 16, 64, 256};
+
+    count = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    rounds = argc > 2 ? strtoull(argv[2], NULL, 10) : 100000;
+    if (count == 0 || rounds == 0) {
+        fprintf(stderr, "usage: %s [variants] [round-trips]\n", argv[0]);
+        return 1;
+    }
+
+    cfl_init();
+
+    values = malloc(count * sizeof(struct cfl_variant *));
+    if (values == NULL) {
+        return 1;
+    }
+    for (index = 0; index < count; index++) {
+        values[index] = cfl_variant_create_from_int64((int64_t) index);
+        if (values[index] == NULL) {
+            return 1;
+        }
+    }
+
+    sink = 0;
+    printf("%8s %14s %14s\n", "batch", "spin_Mops", "wait_Mops");
+    for (index = 0; index < sizeof(batches) / sizeof(batches[0]); index++) {
+        printf("%8zu %14.2f %14.2f\n", batches[index],
+               throughput(0, batches[index], values, count, &sink),
+               throughput(CFL_SPSC_RING_WAIT, batches[index], values, count,
+                          &sink));
+    }
+
+    printf("handoff_ns spin=%.1f wait=%.1f\n",
+           latency(0, values[0], rounds),
+           latency(CFL_SPSC_RING_WAIT, values[0], rounds));
+    printf("sink=%lld\n", (long long) sink);
+
+    for (index = 0; index < count; index++) {
+        cfl_variant_destroy(values[index]);
+    }
+    free(values);
+
+    return 0;
+}
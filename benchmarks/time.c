@@ -0,0 +1,69 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <cfl/cfl.h>
+
+static double run(uint64_t (*clock)(), size_t count, uint64_t *sink)
+{
+    size_t   index;
+    uint64_t start;
+    uint64_t elapsed;
+
+    start = cfl_time_monotonic();
+    for (index = 0; index < count; index++) {
+        *sink += clock();
+    }
+    elapsed = cfl_time_monotonic() - start;
+
+    /* nanoseconds per call */
+    return (double) elapsed / count;
+}
+
+int main(int argc, char **argv)
+{
+    size_t   index;
+    size_t   count;
+    uint64_t sink;
+    static const struct {
+        const char *name;
+        uint64_t  (*clock)();
+    } clocks[] = {
+        {"now",              cfl_time_now},
+        {"now_coarse",       cfl_time_now_coarse},
+        {"monotonic",        cfl_time_monotonic},
+        {"monotonic_coarse", cfl_time_monotonic_coarse},
+        {"tsc",              cfl_time_tsc},
+        {"cached_now",       cfl_time_cached_now},
+        {"cached_monotonic", cfl_time_cached_monotonic},
+    };
+
+    count = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    if (count == 0) {
+        fprintf(stderr, "usage: %s [calls]\n", argv[0]);
+        return 1;
+    }
+
+    cfl_init();
+
+    printf("tsc_available=%d\n", cfl_time_tsc_available());
+    if (cfl_time_cache_start(0) != 0) {
+        fprintf(stderr, "cannot start the time cache\n");
+        return 1;
+    }
+
+    sink = 0;
+    printf("%18s %10s\n", "clock", "ns_call");
+    for (index = 0; index < sizeof(clocks) / sizeof(clocks[0]); index++) {
+        printf("%18s %10.2f\n", clocks[index].name,
+               run(clocks[index].clock, count, &sink));
+    }
+    printf("sink=%llu\n", (unsigned long long) sink);
+
+    cfl_time_cache_stop();
+
+    return 0;
+}
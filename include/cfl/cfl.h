@@ -29,6 +29,7 @@
 #include <cfl/cfl_compat.h>
 #include <cfl/cfl_atomic.h>
 #include <cfl/cfl_log.h>
+#include <cfl/cfl_allocator.h>
 #include <cfl/cfl_sds.h>
 #include <cfl/cfl_list.h>
 #include <cfl/cfl_hash.h>
@@ -41,6 +42,20 @@
 #include <cfl/cfl_arena.h>
 #include <cfl/cfl_object.h>
 #include <cfl/cfl_utils.h>
+#include <cfl/cfl_otlp.h>
+#include <cfl/cfl_iovec.h>
+#include <cfl/cfl_encoder.h>
+#include <cfl/cfl_size_cache.h>
+#include <cfl/cfl_image.h>
+#include <cfl/cfl_codec.h>
+#include <cfl/cfl_mpsc.h>
+#include <cfl/cfl_spsc.h>
+#include <cfl/cfl_counter.h>
+#include <cfl/cfl_epoch.h>
+#include <cfl/cfl_logfmt.h>
+#include <cfl/cfl_ndjson.h>
+#include <cfl/cfl_sds_builder.h>
+#include <cfl/cfl_object_cache.h>
 
 int cfl_init();
 char *cfl_version();
@@ -0,0 +1,82 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_ALLOCATOR_H
+#define CFL_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Every heap allocation made by CFL goes through the global allocator,
+ * which defaults to malloc(), calloc(), realloc() and free(). Arenas
+ * created without their own malloc_fn/free_fn also draw their chunks from
+ * it.
+ *
+ * Replace it before any CFL object exists and before other threads use
+ * CFL: memory must be released by the allocator that provided it. The
+ * calling thread's object cache is flushed, the caches of other threads
+ * are not.
+ *
+ * malloc_fn, realloc_fn and free_fn are required. Without calloc_fn,
+ * calloc requests use malloc_fn and clear the block. free_sized_fn is
+ * optional and receives the size of the block as it was last requested
+ * from malloc_fn, calloc_fn (count * size) or realloc_fn; CFL calls it
+ * where that size is known and free_fn everywhere else.
+ */
+struct cfl_allocator {
+    void *(*malloc_fn)(void *context, size_t size);
+    void *(*calloc_fn)(void *context, size_t count, size_t size);
+    void *(*realloc_fn)(void *context, void *pointer, size_t size);
+    void (*free_fn)(void *context, void *pointer);
+    void (*free_sized_fn)(void *context, void *pointer, size_t size);
+    void *context;
+};
+
+/* NULL restores the libc allocator, returns -1 if a required hook is missing */
+int cfl_set_allocator(const struct cfl_allocator *allocator);
+void cfl_get_allocator(struct cfl_allocator *allocator);
+
+void *cfl_malloc(size_t size);
+void *cfl_calloc(size_t count, size_t size);
+void *cfl_realloc(void *pointer, size_t size);
+void cfl_free(void *pointer);
+void cfl_free_sized(void *pointer, size_t size);
+
+/*
+ * Allocator statistics kept by the counting allocator. Counters are
+ * updated atomically and may be read while other threads allocate.
+ */
+struct cfl_allocator_counters {
+    uint64_t allocations;    /* malloc, calloc and realloc of NULL */
+    uint64_t reallocations;
+    uint64_t frees;
+    uint64_t bytes_in_use;
+    uint64_t bytes_peak;
+};
+
+/*
+ * Set up 'allocator' to forward to libc while counting into 'counters',
+ * which must outlive every block it allocates. Each block carries a
+ * 16-byte size prefix.
+ */
+void cfl_allocator_counting_init(struct cfl_allocator *allocator,
+                                 struct cfl_allocator_counters *counters);
+
+#endif
@@ -95,5 +95,6 @@ int cfl_array_remove_by_index(struct cfl_array *array, size_t position);
 int cfl_array_remove_by_reference(struct cfl_array *array, struct cfl_variant *value);
 
 int cfl_array_print(FILE *fp, struct cfl_array *array);
+int cfl_array_print_ex(FILE *fp, struct cfl_array *array, int bytes_format);
 
 #endif
@@ -22,10 +22,71 @@
 
 #include <stdint.h>
 
+/*
+ * Memory orders for the explicit operations, numbered like C11
+ * memory_order. Loads treat RELEASE and ACQ_REL as SEQ_CST, stores treat
+ * CONSUME, ACQUIRE and ACQ_REL as SEQ_CST. A failed compare exchange
+ * uses the strongest failure order the success order allows.
+ *
+ * As in C11, every call taking an order ends in _explicit (the fence only
+ * exists in that form); the calls without one are sequentially consistent.
+ * Storage must be naturally aligned.
+ */
+#define CFL_ATOMIC_RELAXED 0
+#define CFL_ATOMIC_CONSUME 1
+#define CFL_ATOMIC_ACQUIRE 2
+#define CFL_ATOMIC_RELEASE 3
+#define CFL_ATOMIC_ACQ_REL 4
+#define CFL_ATOMIC_SEQ_CST 5
+
+/* padding unit that keeps atomics written by different threads apart */
+#define CFL_CACHE_LINE_SIZE 64
+
 int cfl_atomic_initialize();
 int cfl_atomic_compare_exchange(uint64_t *storage, uint64_t old_value,
                                 uint64_t new_value);
 void cfl_atomic_store(uint64_t *storage, uint64_t new_value);
 uint64_t cfl_atomic_load(uint64_t *storage);
 
+/* 64 bit */
+uint64_t cfl_atomic_load_explicit(uint64_t *storage, int order);
+void cfl_atomic_store_explicit(uint64_t *storage, uint64_t value, int order);
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order);
+
+/* on failure the current value is stored in 'expected' */
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order);
+
+/* fetch operations return the value held before the update */
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order);
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order);
+
+/* 32 bit */
+uint32_t cfl_atomic32_load_explicit(uint32_t *storage, int order);
+void cfl_atomic32_store_explicit(uint32_t *storage, uint32_t value, int order);
+uint32_t cfl_atomic32_exchange_explicit(uint32_t *storage, uint32_t value,
+                                        int order);
+int cfl_atomic32_compare_exchange_explicit(uint32_t *storage,
+                                           uint32_t *expected,
+                                           uint32_t desired, int order);
+uint32_t cfl_atomic32_fetch_add_explicit(uint32_t *storage, uint32_t value,
+                                         int order);
+uint32_t cfl_atomic32_fetch_sub_explicit(uint32_t *storage, uint32_t value,
+                                         int order);
+
+/* pointer sized */
+void *cfl_atomic_ptr_load_explicit(void **storage, int order);
+void cfl_atomic_ptr_store_explicit(void **storage, void *value, int order);
+void *cfl_atomic_ptr_exchange_explicit(void **storage, void *value, int order);
+int cfl_atomic_ptr_compare_exchange_explicit(void **storage, void **expected,
+                                             void *desired, int order);
+
+void cfl_atomic_thread_fence(int order);
+
+/* name of the backend selected at build time, e.g. "c11" */
+const char *cfl_atomic_implementation();
+
 #endif
@@ -23,6 +23,32 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * CRC32C (Castagnoli). The implementation is picked from the CPU features
+ * on first use: SSE4.2 with a PCLMULQDQ-combined three-way interleave on
+ * x86-64, the ARMv8 CRC32 instructions on AArch64, or slicing-by-8.
+ */
 uint32_t cfl_checksum_crc32c(unsigned char *buffer, size_t length);
 
+/* name of the selected implementation, for logs and benchmarks */
+const char *cfl_checksum_crc32c_implementation(void);
+
+/*
+ * Incremental CRC32C: start from cfl_checksum_crc32c_init(), feed any
+ * number of buffers through cfl_checksum_crc32c_update() and finish with
+ * cfl_checksum_crc32c_final(). Updating with a NULL buffer leaves the
+ * state unchanged.
+ */
+uint32_t cfl_checksum_crc32c_init(void);
+uint32_t cfl_checksum_crc32c_update(uint32_t crc, const void *buffer,
+                                    size_t length);
+uint32_t cfl_checksum_crc32c_final(uint32_t crc);
+
+/*
+ * Checksum of A followed by B from the final checksums of A and B and the
+ * length of B, in O(log length_b). Lets parts be checksummed in parallel.
+ */
+uint32_t cfl_checksum_crc32c_combine(uint32_t crc_a, uint32_t crc_b,
+                                     size_t length_b);
+
 #endif
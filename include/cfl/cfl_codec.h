@@ -0,0 +1,53 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_CODEC_H
+#define CFL_CODEC_H
+
+#include <stddef.h>
+
+/*
+ * Lowercase hexadecimal and RFC 4648 base64 (standard alphabet, '=' padded)
+ * codecs. Encoders write exactly the *_encoded_size() number of bytes and
+ * return it; no NUL terminator is added. Decoders return 0 and store the
+ * number of bytes written in 'decoded_size', or return -1 for malformed
+ * input. Hex decoding accepts both letter cases; base64 decoding accepts
+ * input with or without padding but no whitespace.
+ *
+ * Vector kernels are used on x86-64 (SSE2, SSSE3) and AArch64 (NEON).
+ */
+
+size_t cfl_hex_encoded_size(size_t length);
+size_t cfl_hex_encode(const void *input, size_t length, char *output);
+
+/* 'output' must hold length / 2 bytes */
+int cfl_hex_decode(const char *input, size_t length,
+                   void *output, size_t *decoded_size);
+
+size_t cfl_base64_encoded_size(size_t length);
+size_t cfl_base64_encode(const void *input, size_t length, char *output);
+
+/* exact decoded length of well-formed input, honoring trailing padding */
+size_t cfl_base64_decoded_size(const char *input, size_t length);
+
+/* 'output' must hold cfl_base64_decoded_size() bytes */
+int cfl_base64_decode(const char *input, size_t length,
+                      void *output, size_t *decoded_size);
+
+#endif
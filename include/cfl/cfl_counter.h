@@ -0,0 +1,62 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_COUNTER_H
+#define CFL_COUNTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cfl/cfl_atomic.h>
+
+/*
+ * Sharded event counter. Increments go to a cache-line sized slot picked
+ * by the CPU the thread runs on (rseq or sched_getcpu() on Linux,
+ * GetCurrentProcessorNumber() on Windows) or, where that is unknown, by a
+ * per-thread index. Concurrent writers on different CPUs never share a
+ * line; reads add up every slot.
+ *
+ * Values wrap modulo 2^64.
+ */
+
+struct cfl_counter_slot {
+    uint64_t value;
+    char     padding[CFL_CACHE_LINE_SIZE - sizeof(uint64_t)];
+};
+
+struct cfl_counter {
+    uint32_t                 mask;
+    struct cfl_counter_slot *slots;
+    void                    *allocation;
+};
+
+/* 'slot_count' is rounded up to a power of two, 0 uses the CPU count */
+struct cfl_counter *cfl_counter_create(size_t slot_count);
+void cfl_counter_destroy(struct cfl_counter *counter);
+
+void cfl_counter_add(struct cfl_counter *counter, uint64_t value);
+void cfl_counter_inc(struct cfl_counter *counter);
+
+/* sum of all slots, not a snapshot while writers are active */
+uint64_t cfl_counter_get(struct cfl_counter *counter);
+
+/* returns the sum and zeroes the slots without losing concurrent adds */
+uint64_t cfl_counter_reset(struct cfl_counter *counter);
+
+#endif
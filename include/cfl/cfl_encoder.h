@@ -0,0 +1,73 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_ENCODER_H
+#define CFL_ENCODER_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_iovec.h>
+#include <cfl/cfl_variant.h>
+
+#define CFL_ENCODER_MAX_DEPTH    512
+
+/* cfl_encoder_write() and cfl_encoder_write_iov() results */
+#define CFL_ENCODER_DONE          0
+#define CFL_ENCODER_NEED_SPACE    1
+#define CFL_ENCODER_ERROR        -1
+
+struct cfl_encoder;
+
+/*
+ * A streaming encoder serializes one variant graph incrementally. The
+ * position inside the graph is kept in the encoder, so output can be produced
+ * in pieces of any size and resumed after the caller has drained its buffer.
+ *
+ * The JSON format produces the same text as cfl_variant_print(). The OTLP
+ * format produces the same bytes as cfl_otlp_any_value_encode().
+ *
+ * The graph must not be modified or destroyed until the encoder reports
+ * CFL_ENCODER_DONE or is restarted with cfl_encoder_begin().
+ */
+struct cfl_encoder *cfl_encoder_create(int format);
+void cfl_encoder_destroy(struct cfl_encoder *encoder);
+int cfl_encoder_begin(struct cfl_encoder *encoder, struct cfl_variant *value);
+
+/*
+ * Copy the next part of the output into 'buffer'. 'written' receives the
+ * number of bytes stored. CFL_ENCODER_NEED_SPACE means the buffer was filled
+ * and more output remains.
+ */
+int cfl_encoder_write(struct cfl_encoder *encoder,
+                      char *buffer, size_t buffer_size, size_t *written);
+
+/*
+ * Describe the next part of the output as an iovec array for writev().
+ * String payloads that need no escaping are referenced in place; delimiters,
+ * numbers and escape sequences are stored in 'scratch'. Referenced memory
+ * belongs to the graph and 'scratch' must be kept until the segments have
+ * been written. CFL_ENCODER_NEED_SPACE means the iovec array or the scratch
+ * buffer is exhausted and more output remains.
+ */
+int cfl_encoder_write_iov(struct cfl_encoder *encoder,
+                          struct cfl_iovec *iov, size_t iov_count,
+                          size_t *iov_used,
+                          char *scratch, size_t scratch_size);
+
+#endif
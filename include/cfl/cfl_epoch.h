@@ -0,0 +1,88 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_EPOCH_H
+#define CFL_EPOCH_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_variant.h>
+#include <cfl/cfl_arena.h>
+
+/*
+ * Epoch-based reclamation for read-mostly data shared between threads,
+ * such as a cfl_kvlist routing table swapped in by a control thread.
+ *
+ * Each reading thread creates a reader and brackets its accesses with
+ * cfl_epoch_enter() / cfl_epoch_exit(). A writer publishes a new version
+ * with cfl_epoch_publish() and hands the old one to cfl_epoch_defer_*();
+ * it is destroyed once every reader that could still see it has left.
+ *
+ * Where the system provides an asymmetric barrier (Linux membarrier,
+ * Windows FlushProcessWriteBuffers) readers enter and exit with plain
+ * loads and stores and the writer pays for the barrier while reclaiming.
+ * Otherwise entering costs one full fence.
+ */
+
+struct cfl_epoch;
+struct cfl_epoch_reader;
+
+typedef void (*cfl_epoch_destroy_cb)(void *data);
+
+struct cfl_epoch *cfl_epoch_create();
+
+/* runs every pending callback, no reader may be active or registered */
+void cfl_epoch_destroy(struct cfl_epoch *domain);
+
+/* a reader belongs to one thread at a time */
+struct cfl_epoch_reader *cfl_epoch_reader_create(struct cfl_epoch *domain);
+void cfl_epoch_reader_destroy(struct cfl_epoch_reader *reader);
+
+/* read-side sections nest */
+void cfl_epoch_enter(struct cfl_epoch_reader *reader);
+void cfl_epoch_exit(struct cfl_epoch_reader *reader);
+
+/* swap a shared pointer, returns the previous version */
+void *cfl_epoch_publish(void **slot, void *value);
+void *cfl_epoch_dereference(void **slot);
+
+/*
+ * Destroy 'data' once all current readers have left. Returns 0, or -1
+ * when the callback cannot be queued; the object is then left alone.
+ */
+int cfl_epoch_defer(struct cfl_epoch *domain,
+                    cfl_epoch_destroy_cb callback, void *data);
+int cfl_epoch_defer_variant_destroy(struct cfl_epoch *domain,
+                                    struct cfl_variant *variant);
+int cfl_epoch_defer_arena_destroy(struct cfl_epoch *domain,
+                                  struct cfl_arena *arena);
+
+/* run callbacks that are safe now, returns how many ran */
+size_t cfl_epoch_reclaim(struct cfl_epoch *domain);
+
+/*
+ * Wait until everything deferred so far has been destroyed. Must not be
+ * called from inside a read-side section.
+ */
+void cfl_epoch_synchronize(struct cfl_epoch *domain);
+
+/* "membarrier", "flush-process-write-buffers" or "fence" */
+const char *cfl_epoch_barrier_implementation(struct cfl_epoch *domain);
+
+#endif
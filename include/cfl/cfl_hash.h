@@ -20,19 +20,44 @@
 #ifndef CFL_HASH_H
 #define CFL_HASH_H
 
-/* NOTE: this is just a wrapper for naming convention */
+/*
+ * XXH3 hashing. On x86-64 builds with CFL_XXHASH_DISPATCH (the default)
+ * the long-input kernels pick SSE2, AVX2 or AVX512 at runtime instead of
+ * the instruction set the library was compiled for. Results are identical
+ * to the plain XXH3 functions.
+ */
 
+#include <stddef.h>
 #include <stdint.h>
 #include "xxh3.h"
 
 #define cfl_hash_64bits_t      XXH64_hash_t
 #define cfl_hash_state_t       XXH3_state_t
-#define cfl_hash_64bits_reset  XXH3_64bits_reset
-#define cfl_hash_64bits_update XXH3_64bits_update
-#define cfl_hash_64bits_digest XXH3_64bits_digest
-#define cfl_hash_64bits        XXH3_64bits
-
 #define cfl_hash_128bits_t     XXH128_hash_t
-#define cfl_hash_128bits       XXH3_128bits
+
+cfl_hash_64bits_t cfl_hash_64bits(const void *input, size_t length);
+cfl_hash_64bits_t cfl_hash_64bits_with_seed(const void *input, size_t length,
+                                            uint64_t seed);
+
+XXH_errorcode cfl_hash_64bits_reset(cfl_hash_state_t *state);
+XXH_errorcode cfl_hash_64bits_reset_with_seed(cfl_hash_state_t *state,
+                                              uint64_t seed);
+XXH_errorcode cfl_hash_64bits_update(cfl_hash_state_t *state,
+                                     const void *input, size_t length);
+cfl_hash_64bits_t cfl_hash_64bits_digest(const cfl_hash_state_t *state);
+
+cfl_hash_128bits_t cfl_hash_128bits(const void *input, size_t length);
+cfl_hash_128bits_t cfl_hash_128bits_with_seed(const void *input,
+                                              size_t length, uint64_t seed);
+
+XXH_errorcode cfl_hash_128bits_reset(cfl_hash_state_t *state);
+XXH_errorcode cfl_hash_128bits_reset_with_seed(cfl_hash_state_t *state,
+                                               uint64_t seed);
+XXH_errorcode cfl_hash_128bits_update(cfl_hash_state_t *state,
+                                      const void *input, size_t length);
+cfl_hash_128bits_t cfl_hash_128bits_digest(const cfl_hash_state_t *state);
+
+/* XXH3 kernel in use: "scalar", "sse2", "avx2", "avx512" or "neon" */
+const char *cfl_hash_implementation(void);
 
 #endif
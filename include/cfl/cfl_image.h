@@ -0,0 +1,107 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_IMAGE_H
+#define CFL_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cfl/cfl_variant.h>
+
+/*
+ * Graph images are a read-only binary layout of a variant graph that can be
+ * queried in place, for example straight from an mmap'd file:
+ *
+ *   header   "CFLI", uint32 version, uint64 image size
+ *   root     16-byte value slot: type byte, 7 reserved bytes, 8-byte payload
+ *   blocks   strings, bytes, arrays and kvlists referenced by slot payloads
+ *
+ * All integers are little endian and every block starts at an offset that is
+ * a multiple of 8. A string or bytes block is a uint64 length followed by the
+ * data and a NUL byte. An array block is a uint64 count followed by its value
+ * slots, so entries are found by index without scanning. A kvlist block is a
+ * uint64 count, 24-byte entries in insertion order (uint64 key block offset
+ * plus the value slot) and a directory of uint32 entry indexes sorted by
+ * case-folded key, which is binary searched by the fetch functions.
+ *
+ * Nulls and references are stored as CFL_VARIANT_NULL. Pairs without a key or
+ * value are skipped, as in cfl_variant_print().
+ *
+ * Readers never trust the buffer: every offset is bounds checked on access
+ * and accessors return NULL or -1 for malformed images.
+ */
+
+#define CFL_IMAGE_VERSION      1
+#define CFL_IMAGE_MAX_DEPTH    512
+
+struct cfl_image {
+    const unsigned char *buffer;
+    size_t size;
+};
+
+/* opaque handle to a value slot inside an image buffer */
+struct cfl_image_slot;
+
+int cfl_image_size(struct cfl_variant *value, size_t *size);
+int cfl_image_encode(struct cfl_variant *value,
+                     char *buffer, size_t buffer_size, size_t *encoded_size);
+
+/* checks the header; the buffer must stay mapped while the image is used */
+int cfl_image_open(struct cfl_image *image, const void *buffer, size_t size);
+const struct cfl_image_slot *cfl_image_root(struct cfl_image *image);
+
+int cfl_image_type(struct cfl_image *image,
+                   const struct cfl_image_slot *slot);
+int cfl_image_get_bool(struct cfl_image *image,
+                       const struct cfl_image_slot *slot, int *value);
+int cfl_image_get_int64(struct cfl_image *image,
+                        const struct cfl_image_slot *slot, int64_t *value);
+int cfl_image_get_uint64(struct cfl_image *image,
+                         const struct cfl_image_slot *slot, uint64_t *value);
+int cfl_image_get_double(struct cfl_image *image,
+                         const struct cfl_image_slot *slot, double *value);
+
+/* string and bytes payloads, always followed by a NUL byte in the image */
+int cfl_image_get_string(struct cfl_image *image,
+                         const struct cfl_image_slot *slot,
+                         const char **data, size_t *length);
+
+size_t cfl_image_array_count(struct cfl_image *image,
+                             const struct cfl_image_slot *slot);
+const struct cfl_image_slot *cfl_image_array_fetch_by_index(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    size_t index);
+
+size_t cfl_image_kvlist_count(struct cfl_image *image,
+                              const struct cfl_image_slot *slot);
+int cfl_image_kvlist_entry(struct cfl_image *image,
+                           const struct cfl_image_slot *slot, size_t index,
+                           const char **key, size_t *key_length,
+                           const struct cfl_image_slot **value);
+
+/* case-insensitive lookup, like cfl_kvlist_fetch_s() */
+const struct cfl_image_slot *cfl_image_kvlist_fetch_s(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    const char *key, size_t key_size);
+const struct cfl_image_slot *cfl_image_kvlist_fetch_case_s(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    const char *key, size_t key_size);
+
+#endif
@@ -0,0 +1,43 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2022 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_INFO_H
+#define CFL_INFO_H
+
+#define CFL_SOURCE_DIR "/root/repo"
+
+/* General flags set by /CMakeLists.txt */
+#ifndef CFL_HAVE_GMTIME_R
+#define CFL_HAVE_GMTIME_R
+#endif
+#ifndef CFL_HAVE_SCHED_GETCPU
+#define CFL_HAVE_SCHED_GETCPU
+#endif
+#ifndef CFL_HAVE_RSEQ
+#define CFL_HAVE_RSEQ
+#endif
+#ifndef CFL_HAVE_XXHASH_DISPATCH
+#define CFL_HAVE_XXHASH_DISPATCH
+#endif
+#ifndef CFL_HAVE_OBJECT_CACHE
+#define CFL_HAVE_OBJECT_CACHE
+#endif
+
+
+#endif
@@ -101,6 +101,7 @@ int cfl_kvlist_insert(struct cfl_kvlist *list,
 int cfl_kvlist_count(struct cfl_kvlist *list);
 struct cfl_variant *cfl_kvlist_fetch(struct cfl_kvlist *list, char *key);
 int cfl_kvlist_print(FILE *fp, struct cfl_kvlist *list);
+int cfl_kvlist_print_ex(FILE *fp, struct cfl_kvlist *list, int bytes_format);
 
 int cfl_kvlist_insert_string_s(struct cfl_kvlist *list,
                                char *key, size_t key_size,
@@ -0,0 +1,61 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_LOGFMT_H
+#define CFL_LOGFMT_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_kvlist.h>
+#include <cfl/cfl_arena.h>
+
+/*
+ * Single-pass parser for logfmt lines:
+ *
+ *   time=2026-03-14T09:26:53Z level=info msg="order \"42\" placed" items=3
+ *
+ * Pairs are separated by spaces or tabs. Values are unquoted runs or double
+ * quoted strings where \", \\, \n, \r and \t are unescaped; a key without
+ * '=' gets a null value and 'key=' an empty string. Keys are always copied.
+ *
+ * Values that need no unescaping reference the line, which must then outlive
+ * the kvlist; CFL_LOGFMT_COPY copies them instead. Escaped values are
+ * unescaped once into the kvlist's arena or the heap.
+ *
+ * With CFL_LOGFMT_INFER_TYPES unquoted integers become INT (UINT above
+ * INT64_MAX), decimal numbers with a fraction or exponent become DOUBLE and
+ * true/false become BOOL. Quoted values are always strings.
+ */
+
+#define CFL_LOGFMT_COPY         (1 << 0)
+#define CFL_LOGFMT_INFER_TYPES  (1 << 1)
+
+/*
+ * Append the pairs of 'line' to 'list'. Returns 0, or -1 on malformed input
+ * or allocation failure, in which case the pairs parsed so far remain.
+ */
+int cfl_logfmt_decode(struct cfl_kvlist *list,
+                      const char *line, size_t length, int flags);
+
+/* new kvlist, allocated in 'arena' when it is not NULL */
+struct cfl_kvlist *cfl_logfmt_parse(struct cfl_arena *arena,
+                                    const char *line, size_t length,
+                                    int flags);
+
+#endif
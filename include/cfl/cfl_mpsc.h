@@ -0,0 +1,64 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_MPSC_H
+#define CFL_MPSC_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_list.h>
+#include <cfl/cfl_atomic.h>
+
+/*
+ * Intrusive lock-free multi-producer single-consumer queue (Vyukov). Embed
+ * a 'struct cfl_mpsc_node' in the queued structure, the same way as a
+ * 'struct cfl_list _head', and recover it with cfl_mpsc_entry().
+ *
+ * Any thread may push; push is wait-free. Only one thread at a time may
+ * pop. A pop can return NULL while a producer is between its two steps,
+ * even though the queue is not empty; the item shows up on a later pop.
+ * A node must not be pushed again before it has been popped.
+ */
+
+#define cfl_mpsc_entry(node, type, member) cfl_container_of(node, type, member)
+
+struct cfl_mpsc_node {
+    struct cfl_mpsc_node *next;
+};
+
+struct cfl_mpsc_queue {
+    /* producers only touch the head, keep it away from the consumer line */
+    struct cfl_mpsc_node *head;
+    char                  head_padding[CFL_CACHE_LINE_SIZE -
+                                       sizeof(struct cfl_mpsc_node *)];
+    struct cfl_mpsc_node *tail;
+    struct cfl_mpsc_node  stub;
+};
+
+void cfl_mpsc_queue_init(struct cfl_mpsc_queue *queue);
+void cfl_mpsc_queue_push(struct cfl_mpsc_queue *queue,
+                         struct cfl_mpsc_node *node);
+
+/* consumer side */
+struct cfl_mpsc_node *cfl_mpsc_queue_pop(struct cfl_mpsc_queue *queue);
+size_t cfl_mpsc_queue_pop_batch(struct cfl_mpsc_queue *queue,
+                                struct cfl_mpsc_node **nodes, size_t count);
+int cfl_mpsc_queue_is_empty(struct cfl_mpsc_queue *queue);
+
+#endif
@@ -0,0 +1,87 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_NDJSON_H
+#define CFL_NDJSON_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_kvlist.h>
+#include <cfl/cfl_arena.h>
+
+/*
+ * Reader for newline delimited JSON. Files are memory mapped read-only and
+ * lines are handed out as views into the mapping: a line ends at '\n', a
+ * trailing '\r' is dropped and empty lines are skipped.
+ *
+ * cfl_ndjson_decode() turns one JSON object into a kvlist. Nested objects
+ * become kvlists, arrays become arrays, integers become INT (UINT above
+ * INT64_MAX), other numbers DOUBLE, and true, false and null become BOOL
+ * and NULL variants. Strings without escapes reference the line, which must
+ * then outlive the kvlist; CFL_NDJSON_COPY copies them instead. Keys are
+ * always copied. UTF-8 is not validated.
+ */
+
+/* decode lines passed to the cfl_ndjson_reader_for_each() callback */
+#define CFL_NDJSON_DECODE  (1 << 0)
+
+/* copy string values instead of referencing the line */
+#define CFL_NDJSON_COPY    (1 << 1)
+
+struct cfl_ndjson_reader;
+
+/*
+ * 'record' is the decoded line, or NULL when decoding was not requested or
+ * the line is not a JSON object. It lives in the worker's arena, which is
+ * reset after the callback returns. 'worker' is the index of the calling
+ * worker. Return 0 to continue or any other value to stop all workers.
+ */
+typedef int (*cfl_ndjson_callback)(struct cfl_kvlist *record,
+                                   const char *line, size_t length,
+                                   int worker, void *data);
+
+/* map 'path', returns NULL when it cannot be opened or mapped */
+struct cfl_ndjson_reader *cfl_ndjson_reader_open(const char *path);
+
+/* read from a caller owned buffer that must outlive the reader */
+struct cfl_ndjson_reader *cfl_ndjson_reader_create(const char *data,
+                                                   size_t size);
+
+void cfl_ndjson_reader_destroy(struct cfl_ndjson_reader *reader);
+
+/* store the next line, returns 0 or -1 once all lines were read */
+int cfl_ndjson_reader_next(struct cfl_ndjson_reader *reader,
+                           const char **line, size_t *length);
+
+/*
+ * Run 'callback' on every line not read yet. With more than one worker the
+ * remaining data is split into line aligned ranges, one per thread, each
+ * with its own arena; lines are in order within a range only. Returns 0,
+ * or -1 when a callback stopped the run or resources ran out.
+ */
+int cfl_ndjson_reader_for_each(struct cfl_ndjson_reader *reader,
+                               int workers, int flags,
+                               cfl_ndjson_callback callback, void *data);
+
+/* new kvlist, allocated in 'arena' when it is not NULL */
+struct cfl_kvlist *cfl_ndjson_decode(struct cfl_arena *arena,
+                                     const char *line, size_t length,
+                                     int flags);
+
+#endif
@@ -0,0 +1,38 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_OBJECT_CACHE_H
+#define CFL_OBJECT_CACHE_H
+
+#include <stddef.h>
+
+/*
+ * Heap-mode variants, kvpairs, kvlists, arrays and short SDS strings are
+ * recycled through bounded per-thread caches, which are released when the
+ * thread exits. The cache is compiled in unless CFL_OBJECT_CACHE is turned
+ * off at configure time; both functions then do nothing.
+ */
+
+/* release the blocks cached by the calling thread */
+void cfl_object_cache_flush();
+
+/* bytes cached by the calling thread */
+size_t cfl_object_cache_size();
+
+#endif
@@ -0,0 +1,67 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_OTLP_H
+#define CFL_OTLP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cfl/cfl_variant.h>
+#include <cfl/cfl_array.h>
+#include <cfl/cfl_kvlist.h>
+
+/*
+ * OTLP common.proto wire encoder. A variant is written as the body of an
+ * AnyValue message: strings, booleans, integers, doubles, bytes, arrays and
+ * kvlists map to the matching AnyValue fields, unsigned integers are written
+ * as int_value, and nulls or references produce an empty AnyValue.
+ *
+ * Each *_size() call performs the sizing pass and each *_encode() call writes
+ * exactly that many bytes into the caller's buffer without allocating. The
+ * repeated-field encoders take the field number used by the enclosing
+ * message: field 1 produces an ArrayValue or KeyValueList body, other numbers
+ * can be used for fields such as LogRecord.attributes.
+ *
+ * Functions return 0 on success and -1 for invalid values, graphs deeper than
+ * CFL_OTLP_MAX_DEPTH, or a buffer that is smaller than the encoded size.
+ */
+
+#define CFL_OTLP_MAX_DEPTH 512
+
+int cfl_otlp_any_value_size(struct cfl_variant *value, size_t *size);
+int cfl_otlp_any_value_encode(struct cfl_variant *value,
+                              char *buffer, size_t buffer_size,
+                              size_t *encoded_size);
+
+int cfl_otlp_array_values_size(struct cfl_array *array,
+                               uint32_t field_number, size_t *size);
+int cfl_otlp_array_values_encode(struct cfl_array *array,
+                                 uint32_t field_number,
+                                 char *buffer, size_t buffer_size,
+                                 size_t *encoded_size);
+
+int cfl_otlp_key_values_size(struct cfl_kvlist *kvlist,
+                             uint32_t field_number, size_t *size);
+int cfl_otlp_key_values_encode(struct cfl_kvlist *kvlist,
+                               uint32_t field_number,
+                               char *buffer, size_t buffer_size,
+                               size_t *encoded_size);
+
+#endif
@@ -33,40 +33,107 @@ typedef char *cfl_sds_t;
 
 struct cfl_arena;
 
-#define CFL_SDS_HEADER_SIZE (sizeof(uint64_t) + sizeof(uint64_t))
+/*
+ * The header before the buffer stores the length and the capacity
+ * (excluding the header and the null terminator) as 8, 16, 32 or 64-bit
+ * fields, the narrowest that holds the capacity. The byte right before the
+ * buffer holds the flags; the low bits select the header width. Read the
+ * header through cfl_sds_len() and cfl_sds_alloc().
+ */
+#define CFL_SDS_TYPE_8      0
+#define CFL_SDS_TYPE_16     1
+#define CFL_SDS_TYPE_32     2
+#define CFL_SDS_TYPE_64     3
+#define CFL_SDS_TYPE_MASK   3
+
+/* the string lives in an arena */
+#define CFL_SDS_ARENA       (1 << 2)
+
+/* heap string in a block of an object cache size class */
+#define CFL_SDS_CACHED      (1 << 3)
 
 #pragma pack(push, 1)
-struct cfl_sds {
-    uint64_t len;        /* used */
-    uint64_t alloc;      /* excluding the header and null terminator */
+struct cfl_sds8 {
+    uint8_t len;         /* used */
+    uint8_t alloc;       /* excluding the header and null terminator */
+    unsigned char flags;
+    char buf[];
+};
+
+struct cfl_sds16 {
+    uint16_t len;
+    uint16_t alloc;
+    unsigned char flags;
+    char buf[];
+};
+
+struct cfl_sds32 {
+    uint32_t len;
+    uint32_t alloc;
+    unsigned char flags;
+    char buf[];
+};
+
+struct cfl_sds64 {
+    uint64_t len;
+    uint64_t alloc;
+    unsigned char flags;
     char buf[];
 };
 #pragma pack(pop)
 
-#define CFL_SDS_HEADER(s)  ((struct cfl_sds *) (s - CFL_SDS_HEADER_SIZE))
+/* the widest header */
+#define CFL_SDS_HEADER_SIZE (sizeof(struct cfl_sds64))
 
-size_t cfl_sds_alloc(cfl_sds_t s);
+#define CFL_SDS_FLAGS(s)   (((unsigned char *) (s))[-1])
 
-static inline void cfl_sds_len_set(cfl_sds_t s, size_t len)
+static inline size_t cfl_sds_header_size(cfl_sds_t s)
 {
-    struct cfl_sds *head;
-
-    if (s == NULL) {
-        return;
+    switch (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) {
+    case CFL_SDS_TYPE_8:
+        return sizeof(struct cfl_sds8);
+    case CFL_SDS_TYPE_16:
+        return sizeof(struct cfl_sds16);
+    case CFL_SDS_TYPE_32:
+        return sizeof(struct cfl_sds32);
+    default:
+        return sizeof(struct cfl_sds64);
     }
+}
 
-    head = CFL_SDS_HEADER(s);
-    if (len > cfl_sds_alloc(s)) {
-        return;
-    }
+size_t cfl_sds_alloc(cfl_sds_t s);
+size_t cfl_sds_len(cfl_sds_t s);
+void cfl_sds_set_len(cfl_sds_t s, size_t len);
+
+/*
+ * Typed view of the header for code written against the fixed 64-bit
+ * layout. CFL_SDS_HEADER() fills it from cfl_sds_len() and cfl_sds_alloc();
+ * it is a snapshot valid until the end of the enclosing block, not the
+ * header itself, so the fields are read-only: change the length with
+ * cfl_sds_len_set().
+ */
+struct cfl_sds {
+    const uint64_t len;      /* used */
+    const uint64_t alloc;    /* excluding the header and null terminator */
+    char *const buf;
+};
+
+#define CFL_SDS_HEADER(s)                                               \
+    (&(struct cfl_sds) { cfl_sds_len(s), cfl_sds_alloc(s), (s) })
 
-    head->len = len;
-    s[len] = '\0';
+/* start of the real header, its layout depends on the width in the flags */
+static inline void *cfl_sds_header_start(cfl_sds_t s)
+{
+    return s - cfl_sds_header_size(s);
+}
+
+static inline void cfl_sds_len_set(cfl_sds_t s, size_t len)
+{
+    cfl_sds_set_len(s, len);
 }
 
 size_t cfl_sds_avail(cfl_sds_t s);
 cfl_sds_t cfl_sds_increase(cfl_sds_t s, size_t len);
-size_t cfl_sds_len(cfl_sds_t s);
 cfl_sds_t cfl_sds_create_len(const char *str, int len);
 cfl_sds_t cfl_sds_create_len_in(struct cfl_arena *arena,
                                 const char *str, int len);
@@ -74,8 +141,12 @@ cfl_sds_t cfl_sds_create(const char *str);
 void cfl_sds_destroy(cfl_sds_t s);
 cfl_sds_t cfl_sds_cat(cfl_sds_t s, const char *str, int len);
 cfl_sds_t cfl_sds_create_size(size_t size);
-void cfl_sds_set_len(cfl_sds_t s, size_t len);
 void cfl_sds_cat_safe(cfl_sds_t *buf, const char *str, int len);
+/*
+ * Append formatted text. %d, %i, %u, %x, %X, %c, %s, %.*s, %f and %% with
+ * the l, ll, z and j length modifiers (including PRId64/PRIu64) are
+ * formatted natively in one sizing pass; other formats use vsnprintf().
+ */
 cfl_sds_t cfl_sds_printf(cfl_sds_t *sds, const char *fmt, ...);
 
 #endif
@@ -0,0 +1,77 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_SDS_BUILDER_H
+#define CFL_SDS_BUILDER_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_iovec.h>
+#include <cfl/cfl_sds.h>
+
+/*
+ * String builder that collects segments instead of growing one buffer.
+ * Appended SDS strings are owned by the builder and referenced slices are
+ * kept in place; segments shorter than CFL_SDS_BUILDER_INLINE_MAX are
+ * copied into builder-owned blocks, and consecutive copies share one
+ * segment. The result is either flattened into one SDS with a single
+ * allocation and one copy per byte, or handed out as an iovec array for
+ * writev().
+ *
+ * Referenced slices must stay valid and unmodified until the builder is
+ * reset or destroyed.
+ */
+
+#define CFL_SDS_BUILDER_INLINE_MAX  64
+
+struct cfl_sds_builder;
+
+struct cfl_sds_builder *cfl_sds_builder_create();
+void cfl_sds_builder_destroy(struct cfl_sds_builder *builder);
+
+/* drop the segments and destroy owned SDS, keeping the storage */
+void cfl_sds_builder_reset(struct cfl_sds_builder *builder);
+
+/* copy 'length' bytes */
+int cfl_sds_builder_append(struct cfl_sds_builder *builder,
+                           const void *data, size_t length);
+
+/* reference 'length' bytes without copying */
+int cfl_sds_builder_append_ref(struct cfl_sds_builder *builder,
+                               const void *data, size_t length);
+
+/*
+ * Take ownership of 's', which is destroyed by the builder, also when the
+ * append fails.
+ */
+int cfl_sds_builder_append_sds(struct cfl_sds_builder *builder, cfl_sds_t s);
+
+size_t cfl_sds_builder_length(struct cfl_sds_builder *builder);
+
+/*
+ * Segments in output order, valid until the next append, reset or
+ * destroy. The layout matches struct iovec for writev().
+ */
+struct cfl_iovec *cfl_sds_builder_iov(struct cfl_sds_builder *builder,
+                                      size_t *count);
+
+/* new SDS holding the concatenated segments, owned by the caller */
+cfl_sds_t cfl_sds_builder_flatten(struct cfl_sds_builder *builder);
+
+#endif
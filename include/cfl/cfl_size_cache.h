@@ -0,0 +1,55 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_SIZE_CACHE_H
+#define CFL_SIZE_CACHE_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_arena.h>
+#include <cfl/cfl_array.h>
+#include <cfl/cfl_kvlist.h>
+
+struct cfl_size_cache;
+
+/*
+ * A size cache memoizes the encoded size of array and kvlist subtrees for
+ * cfl_variant_encoded_size_cached(), and their structural hashes for
+ * cfl_variant_hash_cached(), so sizing or hashing a batch again after a few
+ * changes only walks the modified containers.
+ *
+ * The cache cannot observe mutations. After modifying a container, call
+ * cfl_size_cache_invalidate_array() or cfl_size_cache_invalidate_kvlist()
+ * on it; the entries of all its ancestors are dropped as well. Call
+ * cfl_size_cache_clear() before destroying containers that have been sized.
+ *
+ * When 'arena' is set, the cache and its table live in the arena and are
+ * released with it; cfl_size_cache_destroy() is then optional.
+ */
+struct cfl_size_cache *cfl_size_cache_create(struct cfl_arena *arena);
+void cfl_size_cache_destroy(struct cfl_size_cache *cache);
+void cfl_size_cache_clear(struct cfl_size_cache *cache);
+size_t cfl_size_cache_count(struct cfl_size_cache *cache);
+
+void cfl_size_cache_invalidate_array(struct cfl_size_cache *cache,
+                                     struct cfl_array *array);
+void cfl_size_cache_invalidate_kvlist(struct cfl_size_cache *cache,
+                                      struct cfl_kvlist *kvlist);
+
+#endif
@@ -0,0 +1,100 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CFL_SPSC_H
+#define CFL_SPSC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cfl/cfl_atomic.h>
+
+/*
+ * Bounded single-producer single-consumer ring of pointers. One thread
+ * pushes and one thread pops; NULL cannot be queued. Producer and consumer
+ * state live on separate cache lines and each side caches the other's
+ * position, so a transfer touches the shared lines only when the cached
+ * view runs out.
+ *
+ * Rings created with CFL_SPSC_RING_WAIT let the wait functions sleep on a
+ * futex (Linux) after spinning; every publish then pays a full fence to
+ * check for a sleeping peer. Without the flag, or on other systems, the
+ * wait functions spin and then yield.
+ */
+
+#define CFL_SPSC_RING_WAIT           (1 << 0)
+
+#define CFL_SPSC_RING_DEFAULT_SPINS  1024
+
+struct cfl_spsc_ring {
+    /* producer */
+    uint64_t head;
+    uint64_t producer_cached_tail;
+    char     producer_padding[CFL_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+
+    /* consumer */
+    uint64_t tail;
+    uint64_t consumer_cached_head;
+    char     consumer_padding[CFL_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+
+    /* sleep handshake, only used with CFL_SPSC_RING_WAIT */
+    uint32_t readable_event;
+    uint32_t reader_sleeping;
+    uint32_t writable_event;
+    uint32_t writer_sleeping;
+    char     wait_padding[CFL_CACHE_LINE_SIZE - 4 * sizeof(uint32_t)];
+
+    /* read only after creation */
+    int      flags;
+    uint32_t spins;
+    uint64_t mask;
+    void   **slots;
+};
+
+/* 'capacity' is rounded up to a power of two */
+struct cfl_spsc_ring *cfl_spsc_ring_create(size_t capacity, int flags);
+void cfl_spsc_ring_destroy(struct cfl_spsc_ring *ring);
+
+size_t cfl_spsc_ring_capacity(struct cfl_spsc_ring *ring);
+void cfl_spsc_ring_set_spins(struct cfl_spsc_ring *ring, uint32_t spins);
+
+/* producer side: push returns -1 when full, push_batch the number queued */
+int cfl_spsc_ring_push(struct cfl_spsc_ring *ring, void *item);
+size_t cfl_spsc_ring_push_batch(struct cfl_spsc_ring *ring,
+                                void **items, size_t count);
+
+/* consumer side: pop returns NULL when empty, pop_batch the number taken */
+void *cfl_spsc_ring_pop(struct cfl_spsc_ring *ring);
+size_t cfl_spsc_ring_pop_batch(struct cfl_spsc_ring *ring,
+                               void **items, size_t count);
+
+/*
+ * Wait until the ring has an item (consumer) or a free slot (producer).
+ * 'timeout_ns' below zero waits forever, zero only spins. Returns 0 when
+ * ready and -1 on timeout.
+ */
+int cfl_spsc_ring_wait_readable(struct cfl_spsc_ring *ring,
+                                int64_t timeout_ns);
+int cfl_spsc_ring_wait_writable(struct cfl_spsc_ring *ring,
+                                int64_t timeout_ns);
+
+/* approximate number of queued items */
+size_t cfl_spsc_ring_size(struct cfl_spsc_ring *ring);
+
+#endif
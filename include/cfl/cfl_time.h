@@ -22,6 +22,44 @@
 
 #include <stdint.h>
 
+/* wall clock, nanoseconds since the epoch */
 uint64_t cfl_time_now();
 
+/*
+ * Wall clock from the kernel tick (CLOCK_REALTIME_COARSE): a few
+ * milliseconds of resolution for a fraction of the cost.
+ */
+uint64_t cfl_time_now_coarse();
+
+/*
+ * Monotonic nanoseconds from an unspecified starting point, unaffected by
+ * wall clock changes; use these for intervals.
+ */
+uint64_t cfl_time_monotonic();
+uint64_t cfl_time_monotonic_coarse();
+
+/*
+ * Monotonic nanoseconds computed from the CPU timestamp counter, scaled
+ * against cfl_time_monotonic() on first use (a few milliseconds) and
+ * re-anchored to it every 100 ms by the calling thread. Each anchor pairs
+ * the counter with the midpoint of two monotonic reads, so the rate error
+ * is about twice that read latency over the interval: with ~50 ns reads
+ * the readings stay within a few microseconds of cfl_time_monotonic()
+ * after the first calibration and within about a microsecond afterwards.
+ * Falls back to cfl_time_monotonic() unless the CPU has an invariant TSC.
+ */
+uint64_t cfl_time_tsc();
+int cfl_time_tsc_available();
+
+/*
+ * Cached clocks: a background thread refreshes a wall and a monotonic
+ * timestamp every 'interval_ns' (0 selects 1 ms) so hot loops can read
+ * one with a single load. Before cfl_time_cache_start() and after
+ * cfl_time_cache_stop() the readers return the coarse clocks.
+ */
+int cfl_time_cache_start(uint64_t interval_ns);
+void cfl_time_cache_stop();
+uint64_t cfl_time_cached_now();
+uint64_t cfl_time_cached_monotonic();
+
 #endif
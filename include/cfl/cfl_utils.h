@@ -2,11 +2,14 @@
 #define CFL_UTILS_H
 
 #include <sys/types.h> /* off_t */
+#include <stdint.h>
 
 #include <cfl/cfl_sds.h>
 #include <cfl/cfl_list.h>
 #include <cfl/cfl_compat.h>
 
+struct cfl_arena;
+
 struct cfl_split_entry {
     char *value;
     int len;
@@ -19,4 +22,56 @@ struct cfl_list *cfl_utils_split(const char *line, int separator, int max_split)
 void cfl_utils_split_free_entry(struct cfl_split_entry *entry);
 void cfl_utils_split_free(struct cfl_list *list);
 
+/*
+ * A token of a line split without copying. 'value' points into the line, or
+ * into the scratch buffer when a quoted token contained escapes, and is not
+ * NUL terminated. 'last_pos' is the offset in the line where the token ends.
+ */
+struct cfl_split_view {
+    const char *value;
+    size_t len;
+    size_t last_pos;
+};
+
+/*
+ * Split 'length' bytes of 'line' into 'views' with the same tokenization
+ * rules as cfl_utils_split() and cfl_utils_split_quoted(). Return the number
+ * of views written, or -1 when the line holds more tokens than 'view_count'
+ * or on an unbalanced quote.
+ *
+ * The quoted variant unescapes tokens that contain escapes into 'scratch'.
+ * Unescaped tokens never need more than 'length' bytes in total; a NULL or
+ * too small scratch buffer is only an error when escapes are present.
+ */
+int cfl_utils_split_view(const char *line, size_t length, int separator,
+                         int max_split,
+                         struct cfl_split_view *views, size_t view_count);
+int cfl_utils_split_quoted_view(const char *line, size_t length,
+                                int separator, int max_split,
+                                struct cfl_split_view *views,
+                                size_t view_count,
+                                char *scratch, size_t scratch_size);
+
+/*
+ * Arena backed variant sizing the view array to the line. A scratch buffer
+ * is only allocated when a quoted token contains escapes. '*views' is NULL
+ * when no tokens are found.
+ */
+int cfl_utils_split_view_in(struct cfl_arena *arena,
+                            const char *line, size_t length, int separator,
+                            int max_split, int quoted,
+                            struct cfl_split_view **views);
+
+/*
+ * Locale-independent number parsers for exactly 'length' bytes of 'text',
+ * which does not need to be NUL terminated. Integers take an optional sign
+ * (only '+' for unsigned) and digits. Doubles also take a fraction and
+ * exponent, or inf, infinity and nan in any case, and are correctly
+ * rounded; out of range exponents give zero or infinity. Return 0, or -1
+ * on malformed input or integer overflow.
+ */
+int cfl_utils_parse_int64(const char *text, size_t length, int64_t *value);
+int cfl_utils_parse_uint64(const char *text, size_t length, uint64_t *value);
+int cfl_utils_parse_double(const char *text, size_t length, double *value);
+
 #endif
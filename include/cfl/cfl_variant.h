@@ -39,9 +39,23 @@
 #define CFL_VARIANT_ARRAY      9
 #define CFL_VARIANT_KVLIST    10
 
+/* serialization formats */
+#define CFL_VARIANT_FORMAT_JSON   1
+#define CFL_VARIANT_FORMAT_OTLP   2
+#define CFL_VARIANT_FORMAT_IMAGE  3
+
+/* cfl_variant_hash() and cfl_variant_equal() flags */
+#define CFL_VARIANT_KVLIST_UNORDERED     (1 << 0)   /* ignore key order */
+
+/* how cfl_variant_print_ex() renders CFL_VARIANT_BYTES values */
+#define CFL_VARIANT_PRINT_BYTES_RAW_HEX  0   /* unquoted hex, the default */
+#define CFL_VARIANT_PRINT_BYTES_HEX      1   /* quoted lowercase hex */
+#define CFL_VARIANT_PRINT_BYTES_BASE64   2   /* quoted padded base64 */
+
 struct cfl_array;
 struct cfl_kvlist;
 struct cfl_arena;
+struct cfl_size_cache;
 
 struct cfl_variant {
     int type;
@@ -76,6 +90,7 @@ struct cfl_variant {
 };
 
 int cfl_variant_print(FILE *fp, struct cfl_variant *val);
+int cfl_variant_print_ex(FILE *fp, struct cfl_variant *val, int bytes_format);
 struct cfl_variant *cfl_variant_create_from_string(char *value);
 struct cfl_variant *cfl_variant_create_from_string_s(char *value, size_t value_length, int referenced);
 struct cfl_variant *cfl_variant_create_from_bytes(char *value, size_t length, int referenced);
@@ -114,9 +129,50 @@ struct cfl_variant *cfl_variant_create_from_array_in(struct cfl_arena *arena,
 struct cfl_variant *cfl_variant_create_from_kvlist_in(struct cfl_arena *arena,
                                                        struct cfl_kvlist *value);
 
+/*
+ * Number from decimal text in a single pass: INT for integers that fit,
+ * UINT for larger positive integers up to UINT64_MAX, DOUBLE otherwise.
+ * Returns NULL when the text is not a decimal number.
+ */
+struct cfl_variant *cfl_variant_create_from_numeric_text_in(struct cfl_arena *arena,
+                                                            const char *text,
+                                                            size_t length);
+
 void cfl_variant_destroy(struct cfl_variant *instance);
 
 void cfl_variant_size_set(struct cfl_variant *var, size_t size);
 size_t cfl_variant_size_get(struct cfl_variant *var);
 
+/*
+ * Exact number of bytes the graph produces in 'format' (one of the
+ * CFL_VARIANT_FORMAT_* values): the cfl_variant_print() text for JSON, the
+ * AnyValue body for OTLP or a cfl_image graph image. The walk does not
+ * allocate; images are sized without the cache. The cached variant
+ * memoizes container sizes in 'cache', see cfl_size_cache.h.
+ */
+int cfl_variant_encoded_size(struct cfl_variant *value, int format,
+                             size_t *size);
+int cfl_variant_encoded_size_cached(struct cfl_variant *value, int format,
+                                    struct cfl_size_cache *cache,
+                                    size_t *size);
+
+/*
+ * Structural XXH3 hash of a graph. Types are part of the hash, so INT 1,
+ * UINT 1 and DOUBLE 1.0 differ; doubles hash by value (-0.0 and 0.0 match,
+ * as do all NaNs) and references by address. Kvlist keys are compared
+ * byte for byte. With CFL_VARIANT_KVLIST_UNORDERED, kvlists that hold the
+ * same pairs in any order hash the same. The cached variant memoizes
+ * container hashes in 'cache', see cfl_size_cache.h. Returns 0 or -1.
+ */
+int cfl_variant_hash(struct cfl_variant *value, int flags, uint64_t *hash);
+int cfl_variant_hash_cached(struct cfl_variant *value, int flags,
+                            struct cfl_size_cache *cache, uint64_t *hash);
+
+/*
+ * Deep equality under the same rules as cfl_variant_hash(), so equal graphs
+ * hash equally. Stops at the first type, size or value mismatch. Returns
+ * CFL_TRUE, CFL_FALSE, or -1 on NULL input or allocation failure.
+ */
+int cfl_variant_equal(struct cfl_variant *a, struct cfl_variant *b, int flags);
+
 #endif
@@ -19,8 +19,13 @@
 
 #include <cfl/cfl.h>
 
+#include "cfl_cpu_internal.h"
+
 int cfl_init()
 {
+    /* resolve the SIMD and checksum dispatch once at startup */
+    cfl_cpu_features();
+
     return cfl_atomic_initialize();
 }
 
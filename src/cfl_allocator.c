@@ -0,0 +1,277 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_allocator.h>
+#include <cfl/cfl_atomic.h>
+#include <cfl/cfl_object_cache.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/* keeps the payload of counted blocks aligned for any fundamental type */
+#define COUNTING_PREFIX_SIZE  16
+
+static void *libc_malloc(void *context, size_t size)
+{
+    (void) context;
+    return malloc(size);
+}
+
+static void *libc_calloc(void *context, size_t count, size_t size)
+{
+    (void) context;
+    return calloc(count, size);
+}
+
+static void *libc_realloc(void *context, void *pointer, size_t size)
+{
+    (void) context;
+    return realloc(pointer, size);
+}
+
+static void libc_free(void *context, void *pointer)
+{
+    (void) context;
+    free(pointer);
+}
+
+static struct cfl_allocator allocator = {
+    libc_malloc,
+    libc_calloc,
+    libc_realloc,
+    libc_free,
+    NULL,
+    NULL
+};
+
+static void *emulated_calloc(void *context, size_t count, size_t size)
+{
+    void *pointer;
+
+    (void) context;
+
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    pointer = allocator.malloc_fn(allocator.context, count * size);
+    if (pointer != NULL) {
+        memset(pointer, 0, count * size);
+    }
+
+    return pointer;
+}
+
+int cfl_set_allocator(const struct cfl_allocator *replacement)
+{
+    if (replacement != NULL &&
+        (replacement->malloc_fn == NULL ||
+         replacement->realloc_fn == NULL ||
+         replacement->free_fn == NULL)) {
+        return -1;
+    }
+
+    /* cached blocks belong to the allocator being replaced */
+    cfl_object_cache_flush();
+
+    if (replacement == NULL) {
+        allocator.malloc_fn = libc_malloc;
+        allocator.calloc_fn = libc_calloc;
+        allocator.realloc_fn = libc_realloc;
+        allocator.free_fn = libc_free;
+        allocator.free_sized_fn = NULL;
+        allocator.context = NULL;
+        return 0;
+    }
+
+    allocator = *replacement;
+    if (allocator.calloc_fn == NULL) {
+        allocator.calloc_fn = emulated_calloc;
+    }
+
+    return 0;
+}
+
+void cfl_get_allocator(struct cfl_allocator *current)
+{
+    if (current != NULL) {
+        *current = allocator;
+    }
+}
+
+void *cfl_malloc(size_t size)
+{
+    return allocator.malloc_fn(allocator.context, size);
+}
+
+void *cfl_calloc(size_t count, size_t size)
+{
+    return allocator.calloc_fn(allocator.context, count, size);
+}
+
+void *cfl_realloc(void *pointer, size_t size)
+{
+    return allocator.realloc_fn(allocator.context, pointer, size);
+}
+
+void cfl_free(void *pointer)
+{
+    if (pointer == NULL) {
+        return;
+    }
+
+    allocator.free_fn(allocator.context, pointer);
+}
+
+void cfl_free_sized(void *pointer, size_t size)
+{
+    if (pointer == NULL) {
+        return;
+    }
+
+    if (allocator.free_sized_fn != NULL) {
+        allocator.free_sized_fn(allocator.context, pointer, size);
+    }
+    else {
+        allocator.free_fn(allocator.context, pointer);
+    }
+}
+
+static void counting_add(struct cfl_allocator_counters *counters,
+                         size_t size)
+{
+    uint64_t peak;
+    uint64_t in_use;
+
+    in_use = cfl_atomic_fetch_add_explicit(&counters->bytes_in_use, size,
+                                           CFL_ATOMIC_RELAXED) + size;
+
+    peak = cfl_atomic_load_explicit(&counters->bytes_peak,
+                                    CFL_ATOMIC_RELAXED);
+    while (peak < in_use &&
+           !cfl_atomic_compare_exchange_explicit(&counters->bytes_peak,
+                                                 &peak, in_use,
+                                                 CFL_ATOMIC_RELAXED)) {
+    }
+}
+
+static void *counting_malloc(void *context, size_t size)
+{
+    char *block;
+
+    if (size > SIZE_MAX - COUNTING_PREFIX_SIZE) {
+        return NULL;
+    }
+
+    block = malloc(COUNTING_PREFIX_SIZE + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size_t));
+
+    cfl_atomic_fetch_add_explicit(&((struct cfl_allocator_counters *) context)->
+                                  allocations, 1, CFL_ATOMIC_RELAXED);
+    counting_add(context, size);
+
+    return block + COUNTING_PREFIX_SIZE;
+}
+
+static void *counting_calloc(void *context, size_t count, size_t size)
+{
+    void *pointer;
+
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    pointer = counting_malloc(context, count * size);
+    if (pointer != NULL) {
+        memset(pointer, 0, count * size);
+    }
+
+    return pointer;
+}
+
+static void counting_free(void *context, void *pointer)
+{
+    size_t size;
+    char *block;
+    struct cfl_allocator_counters *counters;
+
+    if (pointer == NULL) {
+        return;
+    }
+
+    counters = context;
+    block = (char *) pointer - COUNTING_PREFIX_SIZE;
+    memcpy(&size, block, sizeof(size_t));
+
+    cfl_atomic_fetch_add_explicit(&counters->frees, 1, CFL_ATOMIC_RELAXED);
+    cfl_atomic_fetch_sub_explicit(&counters->bytes_in_use, size,
+                                  CFL_ATOMIC_RELAXED);
+
+    free(block);
+}
+
+static void *counting_realloc(void *context, void *pointer, size_t size)
+{
+    size_t old_size;
+    char *block;
+    struct cfl_allocator_counters *counters;
+
+    if (pointer == NULL) {
+        return counting_malloc(context, size);
+    }
+
+    if (size > SIZE_MAX - COUNTING_PREFIX_SIZE) {
+        return NULL;
+    }
+
+    counters = context;
+    block = (char *) pointer - COUNTING_PREFIX_SIZE;
+    memcpy(&old_size, block, sizeof(size_t));
+
+    block = realloc(block, COUNTING_PREFIX_SIZE + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size_t));
+
+    cfl_atomic_fetch_add_explicit(&counters->reallocations, 1,
+                                  CFL_ATOMIC_RELAXED);
+    cfl_atomic_fetch_sub_explicit(&counters->bytes_in_use, old_size,
+                                  CFL_ATOMIC_RELAXED);
+    counting_add(counters, size);
+
+    return block + COUNTING_PREFIX_SIZE;
+}
+
+void cfl_allocator_counting_init(struct cfl_allocator *counting,
+                                 struct cfl_allocator_counters *counters)
+{
+    memset(counters, 0, sizeof(struct cfl_allocator_counters));
+
+    counting->malloc_fn = counting_malloc;
+    counting->calloc_fn = counting_calloc;
+    counting->realloc_fn = counting_realloc;
+    counting->free_fn = counting_free;
+    counting->free_sized_fn = NULL;
+    counting->context = counters;
+}
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdint.h>
 
+#include <cfl/cfl_allocator.h>
 #include <cfl/cfl_arena.h>
 
 #include "cfl_arena_internal.h"
@@ -66,13 +67,13 @@ struct cfl_arena {
 static void *arena_default_malloc(void *context, size_t size)
 {
     (void) context;
-    return malloc(size);
+    return cfl_malloc(size);
 }
 
 static void arena_default_free(void *context, void *pointer)
 {
     (void) context;
-    free(pointer);
+    cfl_free(pointer);
 }
 
 static void arena_chunks_destroy(struct cfl_arena *arena)
@@ -659,14 +660,28 @@ void cfl_arena_free_kvpair(struct cfl_arena *arena,
     arena_reusable_free(arena, &arena->free_kvpairs, pointer, size);
 }
 
+static const size_t sds_class_sizes[CFL_ARENA_SDS_CLASS_COUNT] = {
+    32, 64, 128, 256, 512, 1024
+};
+
+size_t cfl_arena_sds_class_size(size_t payload_size)
+{
+    size_t index;
+
+    for (index = 0; index < CFL_ARENA_SDS_CLASS_COUNT; index++) {
+        if (payload_size <= sds_class_sizes[index]) {
+            return sds_class_sizes[index];
+        }
+    }
+
+    return 0;
+}
+
 void *cfl_arena_alloc_sds(struct cfl_arena *arena,
                           size_t payload_size, size_t overhead_size,
                           uint8_t *allocation_class,
                           size_t *payload_capacity)
 {
-    static const size_t class_sizes[CFL_ARENA_SDS_CLASS_COUNT] = {
-        32, 64, 128, 256, 512, 1024
-    };
     size_t index;
 
     if (arena == NULL || allocation_class == NULL || payload_capacity == NULL) {
@@ -674,11 +689,12 @@ void *cfl_arena_alloc_sds(struct cfl_arena *arena,
     }
 
     for (index = 0; index < CFL_ARENA_SDS_CLASS_COUNT; index++) {
-        if (payload_size <= class_sizes[index]) {
+        if (payload_size <= sds_class_sizes[index]) {
             *allocation_class = (uint8_t) (index + 1);
-            *payload_capacity = class_sizes[index];
+            *payload_capacity = sds_class_sizes[index];
             return arena_reusable_alloc(arena, &arena->free_sds[index],
-                                        overhead_size + class_sizes[index] + 1);
+                                        overhead_size +
+                                        sds_class_sizes[index] + 1);
         }
     }
 
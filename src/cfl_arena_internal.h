@@ -18,6 +18,12 @@ void *cfl_arena_alloc_kvpair(struct cfl_arena *arena,
                              size_t size);
 void cfl_arena_free_kvpair(struct cfl_arena *arena,
                            void *pointer, size_t size);
+/*
+ * Payload capacity of the SDS class that holds 'payload_size' bytes, or 0
+ * when it is larger than every class. Slots of a class are reused, so the
+ * overhead passed to cfl_arena_alloc_sds() must only depend on the class.
+ */
+size_t cfl_arena_sds_class_size(size_t payload_size);
 void *cfl_arena_alloc_sds(struct cfl_arena *arena,
                           size_t payload_size, size_t overhead_size,
                           uint8_t *allocation_class,
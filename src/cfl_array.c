@@ -25,6 +25,7 @@
 
 #include <cfl/cfl_container.h>
 #include "cfl_arena_internal.h"
+#include "cfl_object_cache_internal.h"
 
 struct cfl_array *cfl_array_create(size_t slot_count)
 {
@@ -46,7 +47,7 @@ struct cfl_array *cfl_array_create_in(struct cfl_arena *arena,
     }
 
     if (arena == NULL) {
-        array = malloc(sizeof(struct cfl_array));
+        array = cfl_object_cache_alloc(sizeof(struct cfl_array));
     }
     else {
         array = cfl_arena_malloc(arena, sizeof(struct cfl_array));
@@ -61,7 +62,7 @@ struct cfl_array *cfl_array_create_in(struct cfl_arena *arena,
 
     /* allocate fixed number of entries */
     if (arena == NULL) {
-        array->entries = calloc(alloc_count, sizeof(void *));
+        array->entries = cfl_calloc(alloc_count, sizeof(void *));
     }
     else {
         array->entries = cfl_arena_calloc(arena, alloc_count,
@@ -70,7 +71,7 @@ struct cfl_array *cfl_array_create_in(struct cfl_arena *arena,
     if (array->entries == NULL) {
         cfl_errno();
         if (arena == NULL) {
-            free(array);
+            cfl_object_cache_free(array, sizeof(struct cfl_array));
         }
         return NULL;
     }
@@ -111,11 +112,11 @@ void cfl_array_destroy(struct cfl_array *array)
         }
 
         if (array->arena == NULL) {
-            free(array->entries);
+            cfl_free(array->entries);
         }
     }
     if (array->arena == NULL) {
-        free(array);
+        cfl_object_cache_free(array, sizeof(struct cfl_array));
     }
 }
 
@@ -219,7 +220,7 @@ int cfl_array_append(struct cfl_array *array,
             new_size = (new_slot_count * sizeof(void *));
 
             if (array->arena == NULL) {
-                tmp = realloc(array->entries, new_size);
+                tmp = cfl_realloc(array->entries, new_size);
             }
             else {
                 tmp = cfl_arena_malloc(array->arena, new_size);
@@ -537,6 +538,11 @@ int cfl_array_append_kvlist(struct cfl_array *array, struct cfl_kvlist *value)
 
 
 int cfl_array_print(FILE *fp, struct cfl_array *array)
+{
+    return cfl_array_print_ex(fp, array, CFL_VARIANT_PRINT_BYTES_RAW_HEX);
+}
+
+int cfl_array_print_ex(FILE *fp, struct cfl_array *array, int bytes_format)
 {
     size_t size;
     size_t i;
@@ -560,7 +566,7 @@ int cfl_array_print(FILE *fp, struct cfl_array *array)
     }
 
     for (i=0; i<size-1; i++) {
-        ret = cfl_variant_print(fp, array->entries[i]);
+        ret = cfl_variant_print_ex(fp, array->entries[i], bytes_format);
         if (ret < 0) {
             return -1;
         }
@@ -570,7 +576,8 @@ int cfl_array_print(FILE *fp, struct cfl_array *array)
         }
     }
 
-    ret = cfl_variant_print(fp, array->entries[size-1]);
+    ret = cfl_variant_print_ex(fp, array->entries[size-1],
+                               bytes_format);
     if (ret < 0) {
         return -1;
     }
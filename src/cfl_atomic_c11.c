@@ -0,0 +1,202 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdatomic.h>
+
+#include <cfl/cfl_atomic.h>
+
+#include "cfl_atomic_internal.h"
+
+#define CFL_ATOMIC_ORDER_RELAXED memory_order_relaxed
+#define CFL_ATOMIC_ORDER_ACQUIRE memory_order_acquire
+#define CFL_ATOMIC_ORDER_RELEASE memory_order_release
+#define CFL_ATOMIC_ORDER_ACQ_REL memory_order_acq_rel
+#define CFL_ATOMIC_ORDER_SEQ_CST memory_order_seq_cst
+
+/*
+ * The public interface works on plain integers so callers do not need
+ * C11; they are accessed through _Atomic qualified pointers of the same
+ * size and alignment.
+ */
+#define ATOMIC(type, pointer) ((_Atomic(type) *) (pointer))
+
+#define LOAD(mo)            return atomic_load_explicit(object, mo)
+#define STORE(mo)           atomic_store_explicit(object, value, mo); return
+#define EXCHANGE(mo)        return atomic_exchange_explicit(object, value, mo)
+#define FETCH_ADD(mo)       return atomic_fetch_add_explicit(object, value, mo)
+#define FETCH_SUB(mo)       return atomic_fetch_sub_explicit(object, value, mo)
+#define CAS(success, failure)                                           \
+    return atomic_compare_exchange_strong_explicit(object, expected,    \
+                                                   desired, success,    \
+                                                   failure)
+#define FENCE(mo)           atomic_thread_fence(mo); return
+
+int cfl_atomic_initialize()
+{
+    return 0;
+}
+
+const char *cfl_atomic_implementation()
+{
+    return "c11";
+}
+
+int cfl_atomic_compare_exchange(uint64_t *storage,
+                                uint64_t old_value, uint64_t new_value)
+{
+    return cfl_atomic_compare_exchange_explicit(storage, &old_value, new_value,
+                                                CFL_ATOMIC_SEQ_CST);
+}
+
+void cfl_atomic_store(uint64_t *storage, uint64_t new_value)
+{
+    cfl_atomic_store_explicit(storage, new_value, CFL_ATOMIC_SEQ_CST);
+}
+
+uint64_t cfl_atomic_load(uint64_t *storage)
+{
+    return cfl_atomic_load_explicit(storage, CFL_ATOMIC_SEQ_CST);
+}
+
+uint64_t cfl_atomic_load_explicit(uint64_t *storage, int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic_store_explicit(uint64_t *storage, uint64_t value, int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_ADD);
+}
+
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    _Atomic(uint64_t) *object = ATOMIC(uint64_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_SUB);
+}
+
+uint32_t cfl_atomic32_load_explicit(uint32_t *storage, int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic32_store_explicit(uint32_t *storage, uint32_t value, int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+uint32_t cfl_atomic32_exchange_explicit(uint32_t *storage, uint32_t value,
+                                        int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic32_compare_exchange_explicit(uint32_t *storage,
+                                           uint32_t *expected,
+                                           uint32_t desired, int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+uint32_t cfl_atomic32_fetch_add_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_ADD);
+}
+
+uint32_t cfl_atomic32_fetch_sub_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    _Atomic(uint32_t) *object = ATOMIC(uint32_t, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_SUB);
+}
+
+void *cfl_atomic_ptr_load_explicit(void **storage, int order)
+{
+    _Atomic(void *) *object = ATOMIC(void *, storage);
+
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic_ptr_store_explicit(void **storage, void *value, int order)
+{
+    _Atomic(void *) *object = ATOMIC(void *, storage);
+
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+void *cfl_atomic_ptr_exchange_explicit(void **storage, void *value, int order)
+{
+    _Atomic(void *) *object = ATOMIC(void *, storage);
+
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic_ptr_compare_exchange_explicit(void **storage, void **expected,
+                                             void *desired, int order)
+{
+    _Atomic(void *) *object = ATOMIC(void *, storage);
+
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+void cfl_atomic_thread_fence(int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FENCE);
+}
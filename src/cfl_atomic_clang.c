@@ -19,24 +19,142 @@
 
 #include <cfl/cfl_atomic.h>
 
+#include "cfl_atomic_internal.h"
+
+#define CFL_ATOMIC_ORDER_RELAXED __ATOMIC_RELAXED
+#define CFL_ATOMIC_ORDER_ACQUIRE __ATOMIC_ACQUIRE
+#define CFL_ATOMIC_ORDER_RELEASE __ATOMIC_RELEASE
+#define CFL_ATOMIC_ORDER_ACQ_REL __ATOMIC_ACQ_REL
+#define CFL_ATOMIC_ORDER_SEQ_CST __ATOMIC_SEQ_CST
+
+#define LOAD(mo)            return __atomic_load_n(storage, mo)
+#define STORE(mo)           __atomic_store_n(storage, value, mo); return
+#define EXCHANGE(mo)        return __atomic_exchange_n(storage, value, mo)
+#define FETCH_ADD(mo)       return __atomic_fetch_add(storage, value, mo)
+#define FETCH_SUB(mo)       return __atomic_fetch_sub(storage, value, mo)
+#define CAS(success, failure)                                         \
+    return __atomic_compare_exchange_n(storage, expected, desired, 0, \
+                                       success, failure)
+#define FENCE(mo)           __atomic_thread_fence(mo); return
+
 int cfl_atomic_initialize()
 {
     return 0;
 }
 
+const char *cfl_atomic_implementation()
+{
+    return "builtins";
+}
+
 int cfl_atomic_compare_exchange(uint64_t *storage,
                                 uint64_t old_value, uint64_t new_value)
 {
-    return __atomic_compare_exchange(storage, &old_value, &new_value, 0,
-                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return cfl_atomic_compare_exchange_explicit(storage, &old_value, new_value,
+                                                CFL_ATOMIC_SEQ_CST);
 }
 
 void cfl_atomic_store(uint64_t *storage, uint64_t new_value)
 {
-    __atomic_store_n(storage, new_value, __ATOMIC_SEQ_CST);
+    cfl_atomic_store_explicit(storage, new_value, CFL_ATOMIC_SEQ_CST);
 }
 
 uint64_t cfl_atomic_load(uint64_t *storage)
 {
-    return __atomic_load_n(storage, __ATOMIC_SEQ_CST);
+    return cfl_atomic_load_explicit(storage, CFL_ATOMIC_SEQ_CST);
+}
+
+uint64_t cfl_atomic_load_explicit(uint64_t *storage, int order)
+{
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic_store_explicit(uint64_t *storage, uint64_t value, int order)
+{
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order)
+{
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_ADD);
+}
+
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_SUB);
+}
+
+uint32_t cfl_atomic32_load_explicit(uint32_t *storage, int order)
+{
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic32_store_explicit(uint32_t *storage, uint32_t value, int order)
+{
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+uint32_t cfl_atomic32_exchange_explicit(uint32_t *storage, uint32_t value,
+                                        int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic32_compare_exchange_explicit(uint32_t *storage,
+                                           uint32_t *expected,
+                                           uint32_t desired, int order)
+{
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+uint32_t cfl_atomic32_fetch_add_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_ADD);
+}
+
+uint32_t cfl_atomic32_fetch_sub_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FETCH_SUB);
+}
+
+void *cfl_atomic_ptr_load_explicit(void **storage, int order)
+{
+    CFL_ATOMIC_LOAD_ORDER(order, LOAD);
+}
+
+void cfl_atomic_ptr_store_explicit(void **storage, void *value, int order)
+{
+    CFL_ATOMIC_STORE_ORDER(order, STORE);
+}
+
+void *cfl_atomic_ptr_exchange_explicit(void **storage, void *value, int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, EXCHANGE);
+}
+
+int cfl_atomic_ptr_compare_exchange_explicit(void **storage, void **expected,
+                                             void *desired, int order)
+{
+    CFL_ATOMIC_CAS_ORDER(order, CAS);
+}
+
+void cfl_atomic_thread_fence(int order)
+{
+    CFL_ATOMIC_RMW_ORDER(order, FENCE);
 }
@@ -21,19 +21,36 @@
 
 #include <cfl/cfl_atomic.h>
 
-static pthread_mutex_t cfl_atomic_operation_lock;
+/*
+ * Operations lock one mutex out of a table selected by the address of the
+ * storage, so unrelated atomics rarely contend. Every access to a given
+ * address, whatever its width, goes through the same stripe.
+ */
+#define CFL_ATOMIC_STRIPE_BITS  6
+#define CFL_ATOMIC_STRIPE_COUNT (1 << CFL_ATOMIC_STRIPE_BITS)
+
+static pthread_mutex_t cfl_atomic_operation_locks[CFL_ATOMIC_STRIPE_COUNT];
 static pthread_once_t  cfl_atomic_operation_system_once = PTHREAD_ONCE_INIT;
 static int             cfl_atomic_operation_system_initialized = 0;
 static int             cfl_atomic_operation_system_status = 0;
 
 static void cfl_atomic_bootstrap()
 {
-    cfl_atomic_operation_system_status =
-        pthread_mutex_init(&cfl_atomic_operation_lock, NULL);
+    int index;
+
+    for (index = 0; index < CFL_ATOMIC_STRIPE_COUNT; index++) {
+        cfl_atomic_operation_system_status =
+            pthread_mutex_init(&cfl_atomic_operation_locks[index], NULL);
 
-    if (cfl_atomic_operation_system_status == 0) {
-        cfl_atomic_operation_system_initialized = 1;
+        if (cfl_atomic_operation_system_status != 0) {
+            while (index > 0) {
+                pthread_mutex_destroy(&cfl_atomic_operation_locks[--index]);
+            }
+            return;
+        }
     }
+
+    cfl_atomic_operation_system_initialized = 1;
 }
 
 int cfl_atomic_initialize()
@@ -47,75 +64,231 @@ int cfl_atomic_initialize()
     return 0;
 }
 
-int cfl_atomic_compare_exchange(uint64_t *storage,
-                                uint64_t old_value, uint64_t new_value)
+const char *cfl_atomic_implementation()
 {
-    int result;
+    return "pthread";
+}
+
+/* returns the locked stripe guarding 'address' or NULL */
+static pthread_mutex_t *stripe_lock(const void *address)
+{
+    uint64_t         key;
+    pthread_mutex_t *lock;
 
     if (cfl_atomic_initialize() != 0 ||
         cfl_atomic_operation_system_initialized == 0) {
-        return 0;
+        return NULL;
     }
 
-    result = pthread_mutex_lock(&cfl_atomic_operation_lock);
-
-    if (result != 0) {
-        return 0;
-    }
+    /* fibonacci hashing spreads neighbouring words across the table */
+    key = (uint64_t) (uintptr_t) address;
+    key = (key >> 2) * UINT64_C(0x9E3779B97F4A7C15);
 
-    if (*storage == old_value) {
-        *storage = new_value;
+    lock = &cfl_atomic_operation_locks[key >> (64 - CFL_ATOMIC_STRIPE_BITS)];
 
-        result = 1;
-    }
-    else {
-        result = 0;
+    if (pthread_mutex_lock(lock) != 0) {
+        return NULL;
     }
 
-    pthread_mutex_unlock(&cfl_atomic_operation_lock);
+    return lock;
+}
 
-    return result;
+int cfl_atomic_compare_exchange(uint64_t *storage,
+                                uint64_t old_value, uint64_t new_value)
+{
+    return cfl_atomic_compare_exchange_explicit(storage, &old_value, new_value,
+                                                CFL_ATOMIC_SEQ_CST);
 }
 
 void cfl_atomic_store(uint64_t *storage, uint64_t new_value)
 {
-    int result;
+    cfl_atomic_store_explicit(storage, new_value, CFL_ATOMIC_SEQ_CST);
+}
 
-    if (cfl_atomic_initialize() != 0 ||
-        cfl_atomic_operation_system_initialized == 0) {
-        return;
-    }
+uint64_t cfl_atomic_load(uint64_t *storage)
+{
+    return cfl_atomic_load_explicit(storage, CFL_ATOMIC_SEQ_CST);
+}
+
+/*
+ * The mutexes order every access, the memory order arguments are
+ * accepted and ignored.
+ */
+#define STRIPED_LOAD(type, storage)                   \
+    pthread_mutex_t *lock;                            \
+    type             result;                          \
+                                                      \
+    (void) order;                                     \
+                                                      \
+    lock = stripe_lock(storage);                      \
+    if (lock == NULL) {                               \
+        return 0;                                     \
+    }                                                 \
+                                                      \
+    result = *(storage);                              \
+                                                      \
+    pthread_mutex_unlock(lock);                       \
+                                                      \
+    return result
 
-    result = pthread_mutex_lock(&cfl_atomic_operation_lock);
+#define STRIPED_STORE(storage, value)                 \
+    pthread_mutex_t *lock;                            \
+                                                      \
+    (void) order;                                     \
+                                                      \
+    lock = stripe_lock(storage);                      \
+    if (lock == NULL) {                               \
+        return;                                       \
+    }                                                 \
+                                                      \
+    *(storage) = (value);                             \
+                                                      \
+    pthread_mutex_unlock(lock)
 
-    if (result != 0) {
-        return;
-    }
+/* stores 'update' computed from 'result' and returns the previous value */
+#define STRIPED_UPDATE(type, storage, update)         \
+    pthread_mutex_t *lock;                            \
+    type             result;                          \
+                                                      \
+    (void) order;                                     \
+                                                      \
+    lock = stripe_lock(storage);                      \
+    if (lock == NULL) {                               \
+        return 0;                                     \
+    }                                                 \
+                                                      \
+    result = *(storage);                              \
+    *(storage) = (update);                            \
+                                                      \
+    pthread_mutex_unlock(lock);                       \
+                                                      \
+    return result
 
-    *storage = new_value;
+#define STRIPED_COMPARE_EXCHANGE(storage, expected, desired) \
+    pthread_mutex_t *lock;                            \
+    int              result;                          \
+                                                      \
+    (void) order;                                     \
+                                                      \
+    lock = stripe_lock(storage);                      \
+    if (lock == NULL) {                               \
+        return 0;                                     \
+    }                                                 \
+                                                      \
+    if (*(storage) == *(expected)) {                  \
+        *(storage) = (desired);                       \
+        result = 1;                                   \
+    }                                                 \
+    else {                                            \
+        *(expected) = *(storage);                     \
+        result = 0;                                   \
+    }                                                 \
+                                                      \
+    pthread_mutex_unlock(lock);                       \
+                                                      \
+    return result
 
-    pthread_mutex_unlock(&cfl_atomic_operation_lock);
+uint64_t cfl_atomic_load_explicit(uint64_t *storage, int order)
+{
+    STRIPED_LOAD(uint64_t, storage);
 }
 
-uint64_t cfl_atomic_load(uint64_t *storage)
+void cfl_atomic_store_explicit(uint64_t *storage, uint64_t value, int order)
 {
-    int      result;
-    uint64_t retval;
+    STRIPED_STORE(storage, value);
+}
 
-    if (cfl_atomic_initialize() != 0 ||
-        cfl_atomic_operation_system_initialized == 0) {
-        return 0;
-    }
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order)
+{
+    STRIPED_UPDATE(uint64_t, storage, value);
+}
 
-    result = pthread_mutex_lock(&cfl_atomic_operation_lock);
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order)
+{
+    STRIPED_COMPARE_EXCHANGE(storage, expected, desired);
+}
 
-    if (result != 0) {
-        return 0;
-    }
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    STRIPED_UPDATE(uint64_t, storage, result + value);
+}
+
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    STRIPED_UPDATE(uint64_t, storage, result - value);
+}
+
+uint32_t cfl_atomic32_load_explicit(uint32_t *storage, int order)
+{
+    STRIPED_LOAD(uint32_t, storage);
+}
+
+void cfl_atomic32_store_explicit(uint32_t *storage, uint32_t value, int order)
+{
+    STRIPED_STORE(storage, value);
+}
 
-    retval = *storage;
+uint32_t cfl_atomic32_exchange_explicit(uint32_t *storage, uint32_t value,
+                                        int order)
+{
+    STRIPED_UPDATE(uint32_t, storage, value);
+}
+
+int cfl_atomic32_compare_exchange_explicit(uint32_t *storage,
+                                           uint32_t *expected,
+                                           uint32_t desired, int order)
+{
+    STRIPED_COMPARE_EXCHANGE(storage, expected, desired);
+}
 
-    pthread_mutex_unlock(&cfl_atomic_operation_lock);
+uint32_t cfl_atomic32_fetch_add_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    STRIPED_UPDATE(uint32_t, storage, result + value);
+}
 
-    return retval;
+uint32_t cfl_atomic32_fetch_sub_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    STRIPED_UPDATE(uint32_t, storage, result - value);
+}
+
+void *cfl_atomic_ptr_load_explicit(void **storage, int order)
+{
+    STRIPED_LOAD(void *, storage);
+}
+
+void cfl_atomic_ptr_store_explicit(void **storage, void *value, int order)
+{
+    STRIPED_STORE(storage, value);
+}
+
+void *cfl_atomic_ptr_exchange_explicit(void **storage, void *value, int order)
+{
+    STRIPED_UPDATE(void *, storage, value);
+}
+
+int cfl_atomic_ptr_compare_exchange_explicit(void **storage, void **expected,
+                                             void *desired, int order)
+{
+    STRIPED_COMPARE_EXCHANGE(storage, expected, desired);
+}
+
+void cfl_atomic_thread_fence(int order)
+{
+    pthread_mutex_t *lock;
+
+    if (order == CFL_ATOMIC_RELAXED) {
+        return;
+    }
+
+    /* taking and releasing a mutex is a full barrier */
+    lock = stripe_lock(&cfl_atomic_operation_system_status);
+    if (lock != NULL) {
+        pthread_mutex_unlock(lock);
+    }
 }
@@ -0,0 +1,71 @@
+#ifndef CFL_ATOMIC_INTERNAL_H
+#define CFL_ATOMIC_INTERNAL_H
+
+#include <cfl/cfl_atomic.h>
+
+/*
+ * Compilers only honor a memory order that is a constant expression and
+ * silently use sequential consistency for anything else. The backends
+ * expand 'operation(order)' once per order the operation accepts so the
+ * runtime argument selects a constant. Each expansion must return.
+ *
+ * The including backend maps CFL_ATOMIC_ORDER_*() to its own constants.
+ */
+#define CFL_ATOMIC_LOAD_ORDER(order, operation)                  \
+    switch (order) {                                             \
+    case CFL_ATOMIC_RELAXED:                                     \
+        operation(CFL_ATOMIC_ORDER_RELAXED);                     \
+    case CFL_ATOMIC_CONSUME:                                     \
+    case CFL_ATOMIC_ACQUIRE:                                     \
+        operation(CFL_ATOMIC_ORDER_ACQUIRE);                     \
+    default:                                                     \
+        operation(CFL_ATOMIC_ORDER_SEQ_CST);                     \
+    }
+
+#define CFL_ATOMIC_STORE_ORDER(order, operation)                 \
+    switch (order) {                                             \
+    case CFL_ATOMIC_RELAXED:                                     \
+        operation(CFL_ATOMIC_ORDER_RELAXED);                     \
+    case CFL_ATOMIC_RELEASE:                                     \
+        operation(CFL_ATOMIC_ORDER_RELEASE);                     \
+    default:                                                     \
+        operation(CFL_ATOMIC_ORDER_SEQ_CST);                     \
+    }
+
+#define CFL_ATOMIC_RMW_ORDER(order, operation)                   \
+    switch (order) {                                             \
+    case CFL_ATOMIC_RELAXED:                                     \
+        operation(CFL_ATOMIC_ORDER_RELAXED);                     \
+    case CFL_ATOMIC_CONSUME:                                     \
+    case CFL_ATOMIC_ACQUIRE:                                     \
+        operation(CFL_ATOMIC_ORDER_ACQUIRE);                     \
+    case CFL_ATOMIC_RELEASE:                                     \
+        operation(CFL_ATOMIC_ORDER_RELEASE);                     \
+    case CFL_ATOMIC_ACQ_REL:                                     \
+        operation(CFL_ATOMIC_ORDER_ACQ_REL);                     \
+    default:                                                     \
+        operation(CFL_ATOMIC_ORDER_SEQ_CST);                     \
+    }
+
+/* 'operation(success, failure)' */
+#define CFL_ATOMIC_CAS_ORDER(order, operation)                   \
+    switch (order) {                                             \
+    case CFL_ATOMIC_RELAXED:                                     \
+        operation(CFL_ATOMIC_ORDER_RELAXED,                      \
+                  CFL_ATOMIC_ORDER_RELAXED);                     \
+    case CFL_ATOMIC_CONSUME:                                     \
+    case CFL_ATOMIC_ACQUIRE:                                     \
+        operation(CFL_ATOMIC_ORDER_ACQUIRE,                      \
+                  CFL_ATOMIC_ORDER_ACQUIRE);                     \
+    case CFL_ATOMIC_RELEASE:                                     \
+        operation(CFL_ATOMIC_ORDER_RELEASE,                      \
+                  CFL_ATOMIC_ORDER_RELAXED);                     \
+    case CFL_ATOMIC_ACQ_REL:                                     \
+        operation(CFL_ATOMIC_ORDER_ACQ_REL,                      \
+                  CFL_ATOMIC_ORDER_ACQUIRE);                     \
+    default:                                                     \
+        operation(CFL_ATOMIC_ORDER_SEQ_CST,                      \
+                  CFL_ATOMIC_ORDER_SEQ_CST);                     \
+    }
+
+#endif
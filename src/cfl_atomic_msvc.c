@@ -27,9 +27,7 @@
 #include <windows.h>
 #endif
 
-#ifdef _WIN64
 #include <intrin.h>
-#endif
 
 #ifndef _WIN64
 static CRITICAL_SECTION cfl_atomic_operation_lock;
@@ -124,6 +122,91 @@ uint64_t cfl_atomic_load(uint64_t *storage)
     return result;
 }
 
+/* 32 bit Windows has no 64 bit interlocked read-modify-write intrinsics */
+static uint64_t atomic_update(uint64_t *storage, uint64_t value, int operation)
+{
+    uint64_t result;
+
+    if (cfl_atomic_initialize() != 0 ||
+        cfl_atomic_operation_system_initialized == 0 ||
+        cfl_atomic_operation_system_status != 0) {
+        return 0;
+    }
+
+    EnterCriticalSection(&cfl_atomic_operation_lock);
+
+    result = *storage;
+
+    if (operation == '+') {
+        *storage = result + value;
+    }
+    else if (operation == '-') {
+        *storage = result - value;
+    }
+    else {
+        *storage = value;
+    }
+
+    LeaveCriticalSection(&cfl_atomic_operation_lock);
+
+    return result;
+}
+
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order)
+{
+    (void) order;
+
+    return atomic_update(storage, value, '=');
+}
+
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    (void) order;
+
+    return atomic_update(storage, value, '+');
+}
+
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    (void) order;
+
+    return atomic_update(storage, value, '-');
+}
+
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order)
+{
+    int result;
+
+    (void) order;
+
+    if (cfl_atomic_initialize() != 0 ||
+        cfl_atomic_operation_system_initialized == 0 ||
+        cfl_atomic_operation_system_status != 0) {
+        return 0;
+    }
+
+    EnterCriticalSection(&cfl_atomic_operation_lock);
+
+    if (*storage == *expected) {
+        *storage = desired;
+
+        result = 1;
+    }
+    else {
+        *expected = *storage;
+
+        result = 0;
+    }
+
+    LeaveCriticalSection(&cfl_atomic_operation_lock);
+
+    return result;
+}
+
 #else /* _WIN64 */
 
 int cfl_atomic_initialize()
@@ -157,4 +240,182 @@ uint64_t cfl_atomic_load(uint64_t *storage)
     return (uint64_t) _InterlockedOr64((volatile __int64 *) storage, 0);
 }
 
+uint64_t cfl_atomic_exchange_explicit(uint64_t *storage, uint64_t value,
+                                      int order)
+{
+    (void) order;
+
+    return (uint64_t) _InterlockedExchange64((volatile __int64 *) storage,
+                                             (__int64) value);
+}
+
+uint64_t cfl_atomic_fetch_add_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    (void) order;
+
+    return (uint64_t) _InterlockedExchangeAdd64((volatile __int64 *) storage,
+                                                (__int64) value);
+}
+
+uint64_t cfl_atomic_fetch_sub_explicit(uint64_t *storage, uint64_t value,
+                                       int order)
+{
+    (void) order;
+
+    return (uint64_t) _InterlockedExchangeAdd64((volatile __int64 *) storage,
+                                                -(__int64) value);
+}
+
+int cfl_atomic_compare_exchange_explicit(uint64_t *storage, uint64_t *expected,
+                                         uint64_t desired, int order)
+{
+    __int64 result;
+
+    (void) order;
+
+    result = _InterlockedCompareExchange64((volatile __int64 *) storage,
+                                           (__int64) desired,
+                                           (__int64) *expected);
+
+    if ((uint64_t) result != *expected) {
+        *expected = (uint64_t) result;
+
+        return 0;
+    }
+
+    return 1;
+}
+
 #endif
+
+/*
+ * The interlocked intrinsics are full barriers, every memory order is
+ * served by the sequentially consistent form.
+ */
+
+const char *cfl_atomic_implementation()
+{
+    return "msvc";
+}
+
+uint64_t cfl_atomic_load_explicit(uint64_t *storage, int order)
+{
+    (void) order;
+
+    return cfl_atomic_load(storage);
+}
+
+void cfl_atomic_store_explicit(uint64_t *storage, uint64_t value, int order)
+{
+    (void) order;
+
+    cfl_atomic_store(storage, value);
+}
+
+uint32_t cfl_atomic32_load_explicit(uint32_t *storage, int order)
+{
+    (void) order;
+
+    return (uint32_t) _InterlockedOr((volatile long *) storage, 0);
+}
+
+void cfl_atomic32_store_explicit(uint32_t *storage, uint32_t value, int order)
+{
+    (void) order;
+
+    _InterlockedExchange((volatile long *) storage, (long) value);
+}
+
+uint32_t cfl_atomic32_exchange_explicit(uint32_t *storage, uint32_t value,
+                                        int order)
+{
+    (void) order;
+
+    return (uint32_t) _InterlockedExchange((volatile long *) storage,
+                                           (long) value);
+}
+
+int cfl_atomic32_compare_exchange_explicit(uint32_t *storage,
+                                           uint32_t *expected,
+                                           uint32_t desired, int order)
+{
+    long result;
+
+    (void) order;
+
+    result = _InterlockedCompareExchange((volatile long *) storage,
+                                         (long) desired, (long) *expected);
+
+    if ((uint32_t) result != *expected) {
+        *expected = (uint32_t) result;
+
+        return 0;
+    }
+
+    return 1;
+}
+
+uint32_t cfl_atomic32_fetch_add_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    (void) order;
+
+    return (uint32_t) _InterlockedExchangeAdd((volatile long *) storage,
+                                              (long) value);
+}
+
+uint32_t cfl_atomic32_fetch_sub_explicit(uint32_t *storage, uint32_t value,
+                                         int order)
+{
+    (void) order;
+
+    return (uint32_t) _InterlockedExchangeAdd((volatile long *) storage,
+                                              (long) (0u - value));
+}
+
+void *cfl_atomic_ptr_load_explicit(void **storage, int order)
+{
+    (void) order;
+
+    return _InterlockedCompareExchangePointer(storage, NULL, NULL);
+}
+
+void cfl_atomic_ptr_store_explicit(void **storage, void *value, int order)
+{
+    (void) order;
+
+    _InterlockedExchangePointer(storage, value);
+}
+
+void *cfl_atomic_ptr_exchange_explicit(void **storage, void *value, int order)
+{
+    (void) order;
+
+    return _InterlockedExchangePointer(storage, value);
+}
+
+int cfl_atomic_ptr_compare_exchange_explicit(void **storage, void **expected,
+                                             void *desired, int order)
+{
+    void *result;
+
+    (void) order;
+
+    result = _InterlockedCompareExchangePointer(storage, desired, *expected);
+
+    if (result != *expected) {
+        *expected = result;
+
+        return 0;
+    }
+
+    return 1;
+}
+
+void cfl_atomic_thread_fence(int order)
+{
+    if (order != CFL_ATOMIC_RELAXED) {
+        MemoryBarrier();
+    }
+}
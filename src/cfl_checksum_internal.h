@@ -0,0 +1,12 @@
+#ifndef CFL_CHECKSUM_INTERNAL_H
+#define CFL_CHECKSUM_INTERNAL_H
+
+/*
+ * Force the CRC32C kernel, by the name cfl_checksum_crc32c_implementation()
+ * reports, so tests can run every kernel the host supports. Returns -1 when
+ * the kernel is unknown or the CPU lacks it; NULL restores the automatic
+ * choice. Not thread safe against concurrent checksums.
+ */
+int cfl_checksum_crc32c_select(const char *name);
+
+#endif
@@ -0,0 +1,675 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl_codec.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cfl_cpu_internal.h"
+
+#if defined(CFL_CPU_X86_64)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+#if defined(CFL_CPU_AARCH64)
+#include <arm_neon.h>
+#endif
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static const char base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* base64 character to 6-bit value, 0xff for characters outside the alphabet */
+static const uint8_t base64_values[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12,
+    0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
+    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30,
+    0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff
+};
+
+static int hex_value(unsigned char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    return -1;
+}
+
+#if defined(CFL_CPU_X86_64)
+
+static __m128i hex_digits_sse2(__m128i nibbles)
+{
+    __m128i letters;
+
+    /* '0' + n, plus the distance to 'a' for n > 9 */
+    letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                            _mm_set1_epi8('a' - '0' - 10));
+
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+static size_t hex_encode_sse2(const unsigned char *input, size_t length,
+                              char *output)
+{
+    size_t index;
+    __m128i in;
+    __m128i high;
+    __m128i low;
+    __m128i mask;
+
+    mask = _mm_set1_epi8(0x0f);
+    for (index = 0; index + 16 <= length; index += 16) {
+        in = _mm_loadu_si128((const __m128i *) (input + index));
+        high = hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        low = hex_digits_sse2(_mm_and_si128(in, mask));
+
+        _mm_storeu_si128((__m128i *) (output + index * 2),
+                         _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i *) (output + index * 2 + 16),
+                         _mm_unpackhi_epi8(high, low));
+    }
+
+    return index;
+}
+
+/* converts 16 hex characters to nibbles, 'valid' is set for good lanes */
+static __m128i hex_nibbles_sse2(__m128i in, __m128i *valid)
+{
+    __m128i digit;
+    __m128i letter;
+    __m128i is_digit;
+    __m128i is_letter;
+
+    digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+    is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+    letter = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)),
+                          _mm_set1_epi8('a'));
+    is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)),
+                               letter);
+
+    *valid = _mm_or_si128(is_digit, is_letter);
+
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_letter,
+                                      _mm_add_epi8(letter,
+                                                   _mm_set1_epi8(10))));
+}
+
+/* joins the nibble pairs of each 16-bit lane into one byte */
+static __m128i hex_pack_sse2(__m128i nibbles)
+{
+    return _mm_or_si128(
+        _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00ff)), 4),
+        _mm_srli_epi16(nibbles, 8));
+}
+
+static size_t hex_decode_sse2(const char *input, size_t length,
+                              unsigned char *output)
+{
+    size_t index;
+    __m128i first;
+    __m128i second;
+    __m128i first_valid;
+    __m128i second_valid;
+
+    for (index = 0; index + 32 <= length; index += 32) {
+        first = hex_nibbles_sse2(
+                    _mm_loadu_si128((const __m128i *) (input + index)),
+                    &first_valid);
+        second = hex_nibbles_sse2(
+                    _mm_loadu_si128((const __m128i *) (input + index + 16)),
+                    &second_valid);
+
+        if (_mm_movemask_epi8(_mm_and_si128(first_valid,
+                                            second_valid)) != 0xffff) {
+            break;
+        }
+
+        _mm_storeu_si128((__m128i *) (output + index / 2),
+                         _mm_packus_epi16(hex_pack_sse2(first),
+                                          hex_pack_sse2(second)));
+    }
+
+    return index;
+}
+
+/* 12 input bytes to 16 characters per round, see Mula and Lemire 2018 */
+CFL_CPU_TARGET("ssse3")
+static size_t base64_encode_ssse3(const unsigned char *input, size_t length,
+                                  char *output)
+{
+    size_t index;
+    size_t written;
+    __m128i in;
+    __m128i t0;
+    __m128i t1;
+    __m128i t2;
+    __m128i t3;
+    __m128i indices;
+    __m128i result;
+    __m128i less;
+    const __m128i shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    written = 0;
+    for (index = 0; index + 16 <= length; index += 12) {
+        in = _mm_loadu_si128((const __m128i *) (input + index));
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                               4, 5, 3, 4, 1, 2, 0, 1));
+
+        t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        indices = _mm_or_si128(t1, t3);
+
+        result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        result = _mm_or_si128(result,
+                              _mm_and_si128(less, _mm_set1_epi8(13)));
+        result = _mm_add_epi8(_mm_shuffle_epi8(shift_lut, result), indices);
+
+        _mm_storeu_si128((__m128i *) (output + written), result);
+        written += 16;
+    }
+
+    return index;
+}
+
+/* 16 characters to 12 bytes per round; stores 16 bytes */
+CFL_CPU_TARGET("ssse3")
+static size_t base64_decode_ssse3(const char *input, size_t length,
+                                  unsigned char *output, size_t output_size)
+{
+    size_t index;
+    size_t written;
+    __m128i in;
+    __m128i high;
+    __m128i low;
+    __m128i roll;
+    __m128i merged;
+    const __m128i lut_low = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_high = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    written = 0;
+    for (index = 0; index + 16 <= length && written + 16 <= output_size;
+         index += 16) {
+        in = _mm_loadu_si128((const __m128i *) (input + index));
+        high = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+        low = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(
+                _mm_and_si128(_mm_shuffle_epi8(lut_low, low),
+                              _mm_shuffle_epi8(lut_high, high)),
+                _mm_setzero_si128())) != 0) {
+            break;
+        }
+
+        roll = _mm_shuffle_epi8(lut_roll,
+                                _mm_add_epi8(_mm_cmpeq_epi8(
+                                                 in, _mm_set1_epi8('/')),
+                                             high));
+        in = _mm_add_epi8(in, roll);
+
+        merged = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        merged = _mm_shuffle_epi8(merged,
+                                  _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                14, 13, 12, -1, -1, -1, -1));
+
+        _mm_storeu_si128((__m128i *) (output + written), merged);
+        written += 12;
+    }
+
+    return index;
+}
+
+#endif
+
+#if defined(CFL_CPU_AARCH64)
+
+static size_t hex_encode_neon(const unsigned char *input, size_t length,
+                              char *output)
+{
+    size_t index;
+    uint8x16_t in;
+    uint8x16_t table;
+    uint8x16x2_t out;
+
+    table = vld1q_u8((const uint8_t *) hex_digits);
+    for (index = 0; index + 16 <= length; index += 16) {
+        in = vld1q_u8(input + index);
+        out.val[0] = vqtbl1q_u8(table, vshrq_n_u8(in, 4));
+        out.val[1] = vqtbl1q_u8(table, vandq_u8(in, vdupq_n_u8(0x0f)));
+        vst2q_u8((uint8_t *) output + index * 2, out);
+    }
+
+    return index;
+}
+
+static uint8x16_t hex_nibbles_neon(uint8x16_t in, uint8x16_t *valid)
+{
+    uint8x16_t digit;
+    uint8x16_t letter;
+    uint8x16_t is_digit;
+    uint8x16_t is_letter;
+
+    digit = vsubq_u8(in, vdupq_n_u8('0'));
+    is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+
+    letter = vsubq_u8(vorrq_u8(in, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    is_letter = vcleq_u8(letter, vdupq_n_u8(5));
+
+    *valid = vorrq_u8(is_digit, is_letter);
+
+    return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+static size_t hex_decode_neon(const char *input, size_t length,
+                              unsigned char *output)
+{
+    size_t index;
+    uint8x16_t high;
+    uint8x16_t low;
+    uint8x16_t high_valid;
+    uint8x16_t low_valid;
+    uint8x16x2_t in;
+
+    for (index = 0; index + 32 <= length; index += 32) {
+        in = vld2q_u8((const uint8_t *) input + index);
+        high = hex_nibbles_neon(in.val[0], &high_valid);
+        low = hex_nibbles_neon(in.val[1], &low_valid);
+
+        if (vminvq_u8(vandq_u8(high_valid, low_valid)) != 0xff) {
+            break;
+        }
+
+        vst1q_u8(output + index / 2, vorrq_u8(vshlq_n_u8(high, 4), low));
+    }
+
+    return index;
+}
+
+static uint8x16x4_t base64_table_neon(const uint8_t *table)
+{
+    uint8x16x4_t result;
+
+    result.val[0] = vld1q_u8(table);
+    result.val[1] = vld1q_u8(table + 16);
+    result.val[2] = vld1q_u8(table + 32);
+    result.val[3] = vld1q_u8(table + 48);
+
+    return result;
+}
+
+/* 48 input bytes to 64 characters per round */
+static size_t base64_encode_neon(const unsigned char *input, size_t length,
+                                 char *output)
+{
+    size_t index;
+    size_t written;
+    uint8x16x3_t in;
+    uint8x16x4_t out;
+    uint8x16x4_t table;
+    uint8x16_t mask;
+
+    table = base64_table_neon((const uint8_t *) base64_alphabet);
+    mask = vdupq_n_u8(0x3f);
+
+    written = 0;
+    for (index = 0; index + 48 <= length; index += 48) {
+        in = vld3q_u8(input + index);
+
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4),
+                                       vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2),
+                                       vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+
+        out.val[0] = vqtbl4q_u8(table, out.val[0]);
+        out.val[1] = vqtbl4q_u8(table, out.val[1]);
+        out.val[2] = vqtbl4q_u8(table, out.val[2]);
+        out.val[3] = vqtbl4q_u8(table, out.val[3]);
+
+        vst4q_u8((uint8_t *) output + written, out);
+        written += 64;
+    }
+
+    return index;
+}
+
+static uint8x16_t base64_values_neon(uint8x16x4_t low, uint8x16x4_t high,
+                                     uint8x16_t in)
+{
+    return vqtbx4q_u8(vqtbl4q_u8(low, in), high,
+                      vsubq_u8(in, vdupq_n_u8(64)));
+}
+
+/* 64 characters to 48 bytes per round */
+static size_t base64_decode_neon(const char *input, size_t length,
+                                 unsigned char *output)
+{
+    size_t index;
+    size_t written;
+    uint8x16x4_t in;
+    uint8x16x4_t low;
+    uint8x16x4_t high;
+    uint8x16x3_t out;
+    uint8x16_t bits;
+
+    low = base64_table_neon(base64_values);
+    high = base64_table_neon(base64_values + 64);
+
+    written = 0;
+    for (index = 0; index + 64 <= length; index += 64) {
+        in = vld4q_u8((const uint8_t *) input + index);
+
+        /* non-ASCII input is not covered by the two tables */
+        bits = vandq_u8(vorrq_u8(vorrq_u8(in.val[0], in.val[1]),
+                                 vorrq_u8(in.val[2], in.val[3])),
+                        vdupq_n_u8(0x80));
+
+        in.val[0] = base64_values_neon(low, high, in.val[0]);
+        in.val[1] = base64_values_neon(low, high, in.val[1]);
+        in.val[2] = base64_values_neon(low, high, in.val[2]);
+        in.val[3] = base64_values_neon(low, high, in.val[3]);
+
+        bits = vorrq_u8(bits, vorrq_u8(vorrq_u8(in.val[0], in.val[1]),
+                                       vorrq_u8(in.val[2], in.val[3])));
+        if (vmaxvq_u8(bits) >= 0x40) {
+            break;
+        }
+
+        out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2),
+                              vshrq_n_u8(in.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4),
+                              vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+
+        vst3q_u8(output + written, out);
+        written += 48;
+    }
+
+    return index;
+}
+
+#endif
+
+size_t cfl_hex_encoded_size(size_t length)
+{
+    return length * 2;
+}
+
+size_t cfl_hex_encode(const void *input, size_t length, char *output)
+{
+    size_t index;
+    const unsigned char *in;
+
+    if ((input == NULL || output == NULL) && length > 0) {
+        return 0;
+    }
+
+    in = input;
+    index = 0;
+
+#if defined(CFL_CPU_X86_64)
+    index = hex_encode_sse2(in, length, output);
+#elif defined(CFL_CPU_AARCH64)
+    index = hex_encode_neon(in, length, output);
+#endif
+
+    for (; index < length; index++) {
+        output[index * 2] = hex_digits[in[index] >> 4];
+        output[index * 2 + 1] = hex_digits[in[index] & 0x0f];
+    }
+
+    return length * 2;
+}
+
+int cfl_hex_decode(const char *input, size_t length,
+                   void *output, size_t *decoded_size)
+{
+    int high;
+    int low;
+    size_t index;
+    unsigned char *out;
+
+    if ((length & 1) != 0 ||
+        ((input == NULL || output == NULL) && length > 0)) {
+        return -1;
+    }
+
+    out = output;
+    index = 0;
+
+#if defined(CFL_CPU_X86_64)
+    index = hex_decode_sse2(input, length, out);
+#elif defined(CFL_CPU_AARCH64)
+    index = hex_decode_neon(input, length, out);
+#endif
+
+    for (; index < length; index += 2) {
+        high = hex_value((unsigned char) input[index]);
+        low = hex_value((unsigned char) input[index + 1]);
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+        out[index / 2] = (unsigned char) ((high << 4) | low);
+    }
+
+    if (decoded_size != NULL) {
+        *decoded_size = length / 2;
+    }
+
+    return 0;
+}
+
+size_t cfl_base64_encoded_size(size_t length)
+{
+    return (length + 2) / 3 * 4;
+}
+
+size_t cfl_base64_encode(const void *input, size_t length, char *output)
+{
+    size_t index;
+    size_t written;
+    uint32_t group;
+    const unsigned char *in;
+
+    if ((input == NULL || output == NULL) && length > 0) {
+        return 0;
+    }
+
+    in = input;
+    index = 0;
+
+#if defined(CFL_CPU_X86_64)
+    if (cfl_cpu_features() & CFL_CPU_X86_SSSE3) {
+        index = base64_encode_ssse3(in, length, output);
+    }
+#elif defined(CFL_CPU_AARCH64)
+    index = base64_encode_neon(in, length, output);
+#endif
+
+    written = index / 3 * 4;
+    for (; index + 3 <= length; index += 3) {
+        group = ((uint32_t) in[index] << 16) |
+                ((uint32_t) in[index + 1] << 8) | in[index + 2];
+        output[written++] = base64_alphabet[(group >> 18) & 0x3f];
+        output[written++] = base64_alphabet[(group >> 12) & 0x3f];
+        output[written++] = base64_alphabet[(group >> 6) & 0x3f];
+        output[written++] = base64_alphabet[group & 0x3f];
+    }
+
+    if (index < length) {
+        group = (uint32_t) in[index] << 16;
+        if (index + 1 < length) {
+            group |= (uint32_t) in[index + 1] << 8;
+        }
+        output[written++] = base64_alphabet[(group >> 18) & 0x3f];
+        output[written++] = base64_alphabet[(group >> 12) & 0x3f];
+        output[written++] = index + 1 < length ?
+                            base64_alphabet[(group >> 6) & 0x3f] : '=';
+        output[written++] = '=';
+    }
+
+    return written;
+}
+
+/* length of the input without trailing padding of a padded last quantum */
+static size_t base64_data_length(const char *input, size_t length)
+{
+    if (length >= 4 && (length & 3) == 0) {
+        if (input[length - 1] == '=') {
+            length--;
+        }
+        if (input[length - 1] == '=') {
+            length--;
+        }
+    }
+
+    return length;
+}
+
+size_t cfl_base64_decoded_size(const char *input, size_t length)
+{
+    size_t size;
+
+    if (input == NULL) {
+        return 0;
+    }
+
+    length = base64_data_length(input, length);
+    size = length / 4 * 3;
+    if ((length & 3) > 1) {
+        size += (length & 3) - 1;
+    }
+
+    return size;
+}
+
+int cfl_base64_decode(const char *input, size_t length,
+                      void *output, size_t *decoded_size)
+{
+    size_t index;
+    size_t size;
+    size_t written;
+    uint32_t group;
+    uint8_t value;
+    unsigned char *out;
+    int count;
+
+    if ((input == NULL || output == NULL) && length > 0) {
+        return -1;
+    }
+
+    if (length == 0) {
+        if (decoded_size != NULL) {
+            *decoded_size = 0;
+        }
+        return 0;
+    }
+
+    size = cfl_base64_decoded_size(input, length);
+    length = base64_data_length(input, length);
+    if ((length & 3) == 1) {
+        return -1;
+    }
+
+    out = output;
+    index = 0;
+
+#if defined(CFL_CPU_X86_64)
+    if (cfl_cpu_features() & CFL_CPU_X86_SSSE3) {
+        index = base64_decode_ssse3(input, length, out, size);
+    }
+#elif defined(CFL_CPU_AARCH64)
+    index = base64_decode_neon(input, length, out);
+#endif
+
+    written = index / 4 * 3;
+    group = 0;
+    count = 0;
+    for (; index < length; index++) {
+        value = base64_values[(unsigned char) input[index]];
+        if (value == 0xff) {
+            return -1;
+        }
+
+        group = (group << 6) | value;
+        if (++count == 4) {
+            out[written++] = (unsigned char) (group >> 16);
+            out[written++] = (unsigned char) (group >> 8);
+            out[written++] = (unsigned char) group;
+            group = 0;
+            count = 0;
+        }
+    }
+
+    if (count == 3) {
+        out[written++] = (unsigned char) (group >> 10);
+        out[written++] = (unsigned char) (group >> 2);
+    }
+    else if (count == 2) {
+        out[written++] = (unsigned char) (group >> 4);
+    }
+
+    if (decoded_size != NULL) {
+        *decoded_size = written;
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifdef CFL_HAVE_SCHED_GETCPU
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_counter.h>
+
+#ifdef CFL_HAVE_RSEQ
+#include <sys/rseq.h>
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "cfl_thread_internal.h"
+
+#define COUNTER_MAX_SLOTS 1024
+
+static uint32_t                  thread_slot_sequence = 0;
+static CFL_THREAD_LOCAL uint32_t thread_slot = 0;
+
+static size_t cpu_count()
+{
+    long count;
+
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    count = (long) info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_CONF)
+    count = sysconf(_SC_NPROCESSORS_CONF);
+#else
+    count = 1;
+#endif
+
+    if (count < 1) {
+        count = 1;
+    }
+
+    return (size_t) count;
+}
+
+/* slot of the calling thread: its CPU when known, else a thread index */
+static inline uint32_t current_slot()
+{
+#if defined(CFL_HAVE_RSEQ)
+    struct rseq *area;
+    uint32_t     cpu;
+
+    if (__rseq_size > 0) {
+        area = (struct rseq *) ((char *) __builtin_thread_pointer() +
+                                __rseq_offset);
+        cpu = *(volatile uint32_t *) &area->cpu_id;
+
+        /* RSEQ_CPU_ID_UNINITIALIZED and _REGISTRATION_FAILED are negative */
+        if ((int32_t) cpu >= 0) {
+            return cpu;
+        }
+    }
+#endif
+
+#if defined(CFL_HAVE_SCHED_GETCPU)
+    {
+        int index;
+
+        index = sched_getcpu();
+        if (index >= 0) {
+            return (uint32_t) index;
+        }
+    }
+#elif defined(_WIN32)
+    return (uint32_t) GetCurrentProcessorNumber();
+#endif
+
+    if (thread_slot == 0) {
+        thread_slot = cfl_atomic32_fetch_add_explicit(&thread_slot_sequence, 1,
+                                                      CFL_ATOMIC_RELAXED) + 1;
+    }
+
+    return thread_slot - 1;
+}
+
+struct cfl_counter *cfl_counter_create(size_t slot_count)
+{
+    size_t              count;
+    uintptr_t           aligned;
+    struct cfl_counter *counter;
+
+    if (slot_count == 0) {
+        slot_count = cpu_count();
+    }
+    if (slot_count > COUNTER_MAX_SLOTS) {
+        slot_count = COUNTER_MAX_SLOTS;
+    }
+
+    count = 1;
+    while (count < slot_count) {
+        count <<= 1;
+    }
+
+    counter = cfl_calloc(1, sizeof(struct cfl_counter));
+    if (counter == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    /* one spare line to align the slots to the cache line size */
+    counter->allocation = cfl_calloc(count + 1,
+                                     sizeof(struct cfl_counter_slot));
+    if (counter->allocation == NULL) {
+        cfl_errno();
+        cfl_free(counter);
+        return NULL;
+    }
+
+    aligned = (uintptr_t) counter->allocation;
+    aligned = (aligned + CFL_CACHE_LINE_SIZE - 1) &
+              ~((uintptr_t) CFL_CACHE_LINE_SIZE - 1);
+
+    counter->slots = (struct cfl_counter_slot *) aligned;
+    counter->mask = (uint32_t) (count - 1);
+
+    return counter;
+}
+
+void cfl_counter_destroy(struct cfl_counter *counter)
+{
+    if (counter == NULL) {
+        return;
+    }
+
+    cfl_free(counter->allocation);
+    cfl_free(counter);
+}
+
+void cfl_counter_add(struct cfl_counter *counter, uint64_t value)
+{
+    struct cfl_counter_slot *slot;
+
+    /*
+     * The slot is uncontended unless the thread migrates or two threads
+     * share a CPU, so the atomic add stays in the local cache.
+     */
+    slot = &counter->slots[current_slot() & counter->mask];
+    cfl_atomic_fetch_add_explicit(&slot->value, value, CFL_ATOMIC_RELAXED);
+}
+
+void cfl_counter_inc(struct cfl_counter *counter)
+{
+    cfl_counter_add(counter, 1);
+}
+
+uint64_t cfl_counter_get(struct cfl_counter *counter)
+{
+    uint32_t index;
+    uint64_t total;
+
+    total = 0;
+    for (index = 0; index <= counter->mask; index++) {
+        total += cfl_atomic_load_explicit(&counter->slots[index].value,
+                                          CFL_ATOMIC_RELAXED);
+    }
+
+    return total;
+}
+
+uint64_t cfl_counter_reset(struct cfl_counter *counter)
+{
+    uint32_t index;
+    uint64_t total;
+
+    total = 0;
+    for (index = 0; index <= counter->mask; index++) {
+        total += cfl_atomic_exchange_explicit(&counter->slots[index].value, 0,
+                                              CFL_ATOMIC_RELAXED);
+    }
+
+    return total;
+}
@@ -0,0 +1,111 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cfl_cpu_internal.h"
+
+#if defined(CFL_CPU_X86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(CFL_CPU_AARCH64) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+static int cpu_detect(void)
+{
+    int features;
+#if defined(CFL_CPU_X86_64)
+    unsigned int ecx;
+#if defined(_MSC_VER)
+    int registers[4];
+
+    __cpuid(registers, 1);
+    ecx = (unsigned int) registers[2];
+#else
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int edx;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return 0;
+    }
+#endif
+#endif
+
+    features = 0;
+
+#if defined(CFL_CPU_X86_64)
+    if (ecx & (1u << 9)) {
+        features |= CFL_CPU_X86_SSSE3;
+    }
+    if (ecx & (1u << 20)) {
+        features |= CFL_CPU_X86_SSE42;
+    }
+    if (ecx & (1u << 1)) {
+        features |= CFL_CPU_X86_PCLMUL;
+    }
+
+    /* the TSC ticks at a constant rate across P-, C- and T-states */
+#if defined(_MSC_VER)
+    __cpuid(registers, 0x80000000);
+    if ((unsigned int) registers[0] >= 0x80000007) {
+        __cpuid(registers, 0x80000007);
+        if ((unsigned int) registers[3] & (1u << 8)) {
+            features |= CFL_CPU_X86_INVARIANT_TSC;
+        }
+    }
+#else
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) &&
+        (edx & (1u << 8))) {
+        features |= CFL_CPU_X86_INVARIANT_TSC;
+    }
+#endif
+#endif
+
+#if defined(CFL_CPU_AARCH64)
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+    features |= CFL_CPU_ARM_CRC32;
+#elif defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        features |= CFL_CPU_ARM_CRC32;
+    }
+#endif
+#endif
+
+    return features;
+}
+
+int cfl_cpu_features(void)
+{
+    /* detection is idempotent, concurrent first calls store the same value */
+    static volatile int features = -1;
+
+    if (features < 0) {
+        features = cpu_detect();
+    }
+
+    return features;
+}
@@ -0,0 +1,50 @@
+#ifndef CFL_CPU_INTERNAL_H
+#define CFL_CPU_INTERNAL_H
+
+/*
+ * SIMD kernels are built for 64-bit x86 (SSE2 is part of the baseline) and
+ * AArch64 (NEON is part of the baseline). Instruction sets beyond the
+ * baseline are compiled per function with CFL_CPU_TARGET() and selected at
+ * runtime with cfl_cpu_features().
+ */
+#if defined(__x86_64__) || defined(_M_X64)
+#define CFL_CPU_X86_64 1
+#endif
+
+#if defined(__aarch64__)
+#define CFL_CPU_AARCH64 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CFL_CPU_TARGET(features) __attribute__((target(features)))
+#else
+#define CFL_CPU_TARGET(features)
+#endif
+
+#define CFL_CPU_X86_SSSE3      (1 << 0)
+#define CFL_CPU_X86_SSE42      (1 << 1)
+#define CFL_CPU_X86_PCLMUL     (1 << 2)
+#define CFL_CPU_ARM_CRC32      (1 << 3)
+#define CFL_CPU_X86_INVARIANT_TSC (1 << 4)
+
+int cfl_cpu_features(void);
+
+/* keeps the compiler from moving memory accesses across it */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define cfl_compiler_barrier() _ReadWriteBarrier()
+#else
+#define cfl_compiler_barrier() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/* spin-wait hint for busy loops */
+#if defined(CFL_CPU_X86_64)
+#include <immintrin.h>
+#define cfl_cpu_relax() _mm_pause()
+#elif defined(CFL_CPU_AARCH64) && (defined(__GNUC__) || defined(__clang__))
+#define cfl_cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define cfl_cpu_relax() do { } while (0)
+#endif
+
+#endif
@@ -0,0 +1,956 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_codec.h>
+#include <cfl/cfl_encoder.h>
+#include <cfl/cfl_otlp.h>
+#include <cfl/cfl_size_cache.h>
+
+#include <math.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <float.h>
+#endif
+
+#include "cfl_otlp_internal.h"
+
+#define ENCODER_PENDING_SIZE   512
+#define ENCODER_HEX_BLOCK      128
+
+#define FRAME_VALUE            0
+#define FRAME_STRING           1
+#define FRAME_BYTES            2
+#define FRAME_ARRAY            3
+#define FRAME_KVLIST           4
+#define FRAME_RAW              5
+#define FRAME_HEADER           6
+
+/* container states */
+#define STATE_OPEN             0
+#define STATE_NEXT             1
+#define STATE_ENTRY            2
+#define STATE_COLON            3
+#define STATE_VALUE            4
+#define STATE_BODY             5
+#define STATE_CLOSE            6
+
+#define OTLP_WIRE_VARINT       0
+#define OTLP_WIRE_FIXED64      1
+#define OTLP_WIRE_LEN          2
+
+struct encoder_frame {
+    int type;
+    int state;
+    int printed;
+    struct cfl_variant *value;
+    struct cfl_array *array;
+    struct cfl_kvlist *kvlist;
+    struct cfl_list *position;
+    const char *data;
+    size_t length;
+    size_t offset;
+    size_t index;
+    uint32_t field_number;
+};
+
+struct encoder_chunk {
+    const char *data;
+    size_t length;
+    int referenced;
+};
+
+struct cfl_encoder {
+    int format;
+    int failed;
+    struct encoder_frame *frames;
+    size_t depth;
+    size_t capacity;
+    struct encoder_chunk chunk;
+    size_t chunk_offset;
+    char pending[ENCODER_PENDING_SIZE];
+
+    /* nested OTLP message sizes, so every container is sized once */
+    struct cfl_size_cache *sizes;
+};
+
+static int double_is_finite(double value)
+{
+#if defined(_MSC_VER)
+    return _finite(value);
+#else
+    return isfinite(value);
+#endif
+}
+
+static struct encoder_frame *frame_push(struct cfl_encoder *encoder, int type)
+{
+    size_t capacity;
+    struct encoder_frame *frames;
+    struct encoder_frame *frame;
+
+    if (encoder->depth >= CFL_ENCODER_MAX_DEPTH * 3) {
+        return NULL;
+    }
+
+    if (encoder->depth == encoder->capacity) {
+        capacity = encoder->capacity * 2;
+        frames = cfl_realloc(encoder->frames,
+                             capacity * sizeof(struct encoder_frame));
+        if (frames == NULL) {
+            cfl_errno();
+            return NULL;
+        }
+        encoder->frames = frames;
+        encoder->capacity = capacity;
+    }
+
+    frame = &encoder->frames[encoder->depth++];
+    memset(frame, 0, sizeof(struct encoder_frame));
+    frame->type = type;
+
+    return frame;
+}
+
+static void frame_pop(struct cfl_encoder *encoder)
+{
+    encoder->depth--;
+}
+
+static struct encoder_frame *frame_top(struct cfl_encoder *encoder)
+{
+    return &encoder->frames[encoder->depth - 1];
+}
+
+static int push_value(struct cfl_encoder *encoder, struct cfl_variant *value)
+{
+    struct encoder_frame *frame;
+
+    if (value == NULL) {
+        return -1;
+    }
+
+    frame = frame_push(encoder, FRAME_VALUE);
+    if (frame == NULL) {
+        return -1;
+    }
+    frame->value = value;
+
+    return 0;
+}
+
+static int push_raw(struct cfl_encoder *encoder,
+                    const char *data, size_t length)
+{
+    struct encoder_frame *frame;
+
+    frame = frame_push(encoder, FRAME_RAW);
+    if (frame == NULL) {
+        return -1;
+    }
+    frame->data = data;
+    frame->length = length;
+
+    return 0;
+}
+
+static void emit_static(struct cfl_encoder *encoder, const char *token)
+{
+    encoder->chunk.data = token;
+    encoder->chunk.length = strlen(token);
+    encoder->chunk.referenced = CFL_TRUE;
+}
+
+static void emit_reference(struct cfl_encoder *encoder,
+                           const char *data, size_t length)
+{
+    encoder->chunk.data = data;
+    encoder->chunk.length = length;
+    encoder->chunk.referenced = CFL_TRUE;
+}
+
+static void emit_pending(struct cfl_encoder *encoder, size_t length)
+{
+    encoder->chunk.data = encoder->pending;
+    encoder->chunk.length = length;
+    encoder->chunk.referenced = CFL_FALSE;
+}
+
+static int json_escape_needed(unsigned char c)
+{
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+static const char *json_escape_sequence(unsigned char c)
+{
+    switch (c) {
+    case '"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\b':
+        return "\\b";
+    case '\f':
+        return "\\f";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        return NULL;
+    }
+}
+
+static int json_string_step(struct cfl_encoder *encoder,
+                            struct encoder_frame *frame)
+{
+    size_t run;
+    unsigned char c;
+    const char *sequence;
+
+    if (frame->state == STATE_OPEN) {
+        frame->state = STATE_BODY;
+        emit_static(encoder, "\"");
+        return 1;
+    }
+
+    if (frame->state == STATE_CLOSE || frame->offset >= frame->length) {
+        frame_pop(encoder);
+        emit_static(encoder, "\"");
+        return 1;
+    }
+
+    run = 0;
+    while (frame->offset + run < frame->length &&
+           !json_escape_needed((unsigned char) frame->data[frame->offset + run])) {
+        run++;
+    }
+
+    if (run > 0) {
+        emit_reference(encoder, frame->data + frame->offset, run);
+        frame->offset += run;
+        return 1;
+    }
+
+    c = (unsigned char) frame->data[frame->offset++];
+    sequence = json_escape_sequence(c);
+    if (sequence != NULL) {
+        emit_static(encoder, sequence);
+    }
+    else {
+        emit_pending(encoder, snprintf(encoder->pending,
+                                       sizeof(encoder->pending),
+                                       "\\u%04x", c));
+    }
+
+    return 1;
+}
+
+static int json_bytes_step(struct cfl_encoder *encoder,
+                           struct encoder_frame *frame)
+{
+    size_t count;
+
+    if (frame->offset >= frame->length) {
+        frame_pop(encoder);
+        return 0;
+    }
+
+    count = frame->length - frame->offset;
+    if (count > ENCODER_HEX_BLOCK) {
+        count = ENCODER_HEX_BLOCK;
+    }
+
+    cfl_hex_encode(frame->data + frame->offset, count, encoder->pending);
+    frame->offset += count;
+    emit_pending(encoder, count * 2);
+
+    return 1;
+}
+
+static int json_value_step(struct cfl_encoder *encoder,
+                           struct encoder_frame *frame)
+{
+    struct cfl_variant *value;
+    int length;
+
+    value = frame->value;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+        if (value->data.as_string == NULL && value->size > 0) {
+            return -1;
+        }
+        frame->type = FRAME_STRING;
+        frame->state = STATE_OPEN;
+        frame->data = value->data.as_string;
+        frame->length = value->size;
+        return 0;
+    case CFL_VARIANT_BYTES:
+        if (value->data.as_bytes == NULL && value->size > 0) {
+            return -1;
+        }
+        frame->type = FRAME_BYTES;
+        frame->data = value->data.as_bytes;
+        frame->length = value->size;
+        return 0;
+    case CFL_VARIANT_ARRAY:
+        if (value->data.as_array == NULL) {
+            return -1;
+        }
+        frame->type = FRAME_ARRAY;
+        frame->state = STATE_OPEN;
+        frame->array = value->data.as_array;
+        return 0;
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL) {
+            return -1;
+        }
+        frame->type = FRAME_KVLIST;
+        frame->state = STATE_OPEN;
+        frame->kvlist = value->data.as_kvlist;
+        return 0;
+    case CFL_VARIANT_BOOL:
+        frame_pop(encoder);
+        emit_static(encoder, value->data.as_bool ? "true" : "false");
+        return 1;
+    case CFL_VARIANT_INT:
+        frame_pop(encoder);
+        length = snprintf(encoder->pending, sizeof(encoder->pending),
+                          "%" PRId64, value->data.as_int64);
+        break;
+    case CFL_VARIANT_UINT:
+        frame_pop(encoder);
+        length = snprintf(encoder->pending, sizeof(encoder->pending),
+                          "%" PRIu64, value->data.as_uint64);
+        break;
+    case CFL_VARIANT_DOUBLE:
+        frame_pop(encoder);
+        if (!double_is_finite(value->data.as_double)) {
+            emit_static(encoder, "null");
+            return 1;
+        }
+        length = snprintf(encoder->pending, sizeof(encoder->pending),
+                          "%lf", value->data.as_double);
+        break;
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        frame_pop(encoder);
+        emit_static(encoder, "null");
+        return 1;
+    default:
+        return -1;
+    }
+
+    if (length < 0 || (size_t) length >= sizeof(encoder->pending)) {
+        return -1;
+    }
+    emit_pending(encoder, (size_t) length);
+
+    return 1;
+}
+
+static int json_array_step(struct cfl_encoder *encoder,
+                           struct encoder_frame *frame)
+{
+    struct cfl_array *array;
+    struct cfl_variant *entry;
+
+    array = frame->array;
+    switch (frame->state) {
+    case STATE_OPEN:
+        if (array->entry_count == 0) {
+            frame_pop(encoder);
+            emit_static(encoder, "[]");
+            return 1;
+        }
+        frame->state = STATE_ENTRY;
+        emit_static(encoder, "[");
+        return 1;
+    case STATE_NEXT:
+        if (frame->index >= array->entry_count) {
+            frame_pop(encoder);
+            emit_static(encoder, "]");
+            return 1;
+        }
+        frame->state = STATE_ENTRY;
+        emit_static(encoder, ",");
+        return 1;
+    case STATE_ENTRY:
+        entry = array->entries[frame->index++];
+        frame->state = STATE_NEXT;
+        return push_value(encoder, entry);
+    }
+
+    return -1;
+}
+
+static int json_kvlist_step(struct cfl_encoder *encoder,
+                            struct encoder_frame *frame)
+{
+    struct cfl_kvpair *pair;
+    struct encoder_frame *key;
+
+    switch (frame->state) {
+    case STATE_OPEN:
+        frame->position = frame->kvlist->list.next;
+        frame->state = STATE_NEXT;
+        emit_static(encoder, "{");
+        return 1;
+    case STATE_NEXT:
+        while (frame->position != &frame->kvlist->list) {
+            pair = cfl_list_entry(frame->position, struct cfl_kvpair, _head);
+            if (pair->key != NULL && pair->val != NULL) {
+                break;
+            }
+            frame->position = frame->position->next;
+        }
+        if (frame->position == &frame->kvlist->list) {
+            frame_pop(encoder);
+            emit_static(encoder, "}");
+            return 1;
+        }
+        frame->state = STATE_ENTRY;
+        if (frame->printed) {
+            emit_static(encoder, ",");
+            return 1;
+        }
+        return 0;
+    case STATE_ENTRY:
+        pair = cfl_list_entry(frame->position, struct cfl_kvpair, _head);
+        frame->state = STATE_COLON;
+        key = frame_push(encoder, FRAME_STRING);
+        if (key == NULL) {
+            return -1;
+        }
+        key->state = STATE_OPEN;
+        key->data = pair->key;
+        key->length = cfl_sds_len(pair->key);
+        return 0;
+    case STATE_COLON:
+        frame->state = STATE_VALUE;
+        emit_static(encoder, ":");
+        return 1;
+    case STATE_VALUE:
+        pair = cfl_list_entry(frame->position, struct cfl_kvpair, _head);
+        frame->position = frame->position->next;
+        frame->printed = CFL_TRUE;
+        frame->state = STATE_NEXT;
+        return push_value(encoder, pair->val);
+    }
+
+    return -1;
+}
+
+/*
+ * Produce the next JSON chunk. Returns 1 when a chunk was produced, 0 when
+ * the frame stack changed without output, and -1 on error.
+ */
+static int json_step(struct cfl_encoder *encoder)
+{
+    struct encoder_frame *frame;
+
+    frame = frame_top(encoder);
+    switch (frame->type) {
+    case FRAME_VALUE:
+        return json_value_step(encoder, frame);
+    case FRAME_STRING:
+        return json_string_step(encoder, frame);
+    case FRAME_BYTES:
+        return json_bytes_step(encoder, frame);
+    case FRAME_ARRAY:
+        return json_array_step(encoder, frame);
+    case FRAME_KVLIST:
+        return json_kvlist_step(encoder, frame);
+    }
+
+    return -1;
+}
+
+static size_t varint_put(char *out, uint64_t value)
+{
+    size_t length;
+
+    length = 0;
+    while (value >= 0x80) {
+        out[length++] = (char) (value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (char) value;
+
+    return length;
+}
+
+static size_t varint_size(uint64_t value)
+{
+    size_t size;
+
+    size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+static size_t tag_put(char *out, uint32_t field_number, int wire_type)
+{
+    return varint_put(out, ((uint64_t) field_number << 3) | wire_type);
+}
+
+static int otlp_value_step(struct cfl_encoder *encoder,
+                           struct encoder_frame *frame)
+{
+    size_t length;
+    size_t nested;
+    uint64_t bits;
+    int index;
+    struct cfl_variant *value;
+
+    value = frame->value;
+    length = 0;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        if (value->data.as_string == NULL && value->size > 0) {
+            return -1;
+        }
+        length = tag_put(encoder->pending,
+                         value->type == CFL_VARIANT_STRING ? 1 : 7,
+                         OTLP_WIRE_LEN);
+        length += varint_put(encoder->pending + length, value->size);
+        frame->type = FRAME_RAW;
+        frame->data = value->data.as_string;
+        frame->length = value->size;
+        break;
+    case CFL_VARIANT_BOOL:
+        frame_pop(encoder);
+        length = tag_put(encoder->pending, 2, OTLP_WIRE_VARINT);
+        encoder->pending[length++] = value->data.as_bool ? 1 : 0;
+        break;
+    case CFL_VARIANT_INT:
+        frame_pop(encoder);
+        length = tag_put(encoder->pending, 3, OTLP_WIRE_VARINT);
+        length += varint_put(encoder->pending + length,
+                             (uint64_t) value->data.as_int64);
+        break;
+    case CFL_VARIANT_UINT:
+        frame_pop(encoder);
+        length = tag_put(encoder->pending, 3, OTLP_WIRE_VARINT);
+        length += varint_put(encoder->pending + length,
+                             value->data.as_uint64);
+        break;
+    case CFL_VARIANT_DOUBLE:
+        frame_pop(encoder);
+        memcpy(&bits, &value->data.as_double, sizeof(bits));
+        length = tag_put(encoder->pending, 4, OTLP_WIRE_FIXED64);
+        for (index = 0; index < 8; index++) {
+            encoder->pending[length++] = (char) (bits >> (index * 8));
+        }
+        break;
+    case CFL_VARIANT_ARRAY:
+        if (value->data.as_array == NULL ||
+            cfl_otlp_array_values_size_cached(value->data.as_array,
+                                              encoder->sizes, &nested) != 0) {
+            return -1;
+        }
+        length = tag_put(encoder->pending, 5, OTLP_WIRE_LEN);
+        length += varint_put(encoder->pending + length, nested);
+        frame->type = FRAME_ARRAY;
+        frame->array = value->data.as_array;
+        break;
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL ||
+            cfl_otlp_key_values_size_cached(value->data.as_kvlist,
+                                            encoder->sizes, &nested) != 0) {
+            return -1;
+        }
+        length = tag_put(encoder->pending, 6, OTLP_WIRE_LEN);
+        length += varint_put(encoder->pending + length, nested);
+        frame->type = FRAME_KVLIST;
+        frame->kvlist = value->data.as_kvlist;
+        frame->position = value->data.as_kvlist->list.next;
+        break;
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        frame_pop(encoder);
+        return 0;
+    default:
+        return -1;
+    }
+
+    emit_pending(encoder, length);
+
+    return 1;
+}
+
+static int otlp_array_step(struct cfl_encoder *encoder,
+                           struct encoder_frame *frame)
+{
+    size_t length;
+    size_t nested;
+    struct cfl_variant *entry;
+
+    if (frame->index >= frame->array->entry_count) {
+        frame_pop(encoder);
+        return 0;
+    }
+
+    entry = frame->array->entries[frame->index++];
+    if (cfl_otlp_any_value_size_cached(entry, encoder->sizes,
+                                       &nested) != 0) {
+        return -1;
+    }
+
+    length = tag_put(encoder->pending, 1, OTLP_WIRE_LEN);
+    length += varint_put(encoder->pending + length, nested);
+    if (push_value(encoder, entry) != 0) {
+        return -1;
+    }
+    emit_pending(encoder, length);
+
+    return 1;
+}
+
+static int otlp_kvlist_step(struct cfl_encoder *encoder,
+                            struct encoder_frame *frame)
+{
+    size_t length;
+    size_t key_size;
+    size_t value_size;
+    size_t pair_size;
+    struct cfl_kvpair *pair;
+    struct encoder_frame *header;
+
+    while (frame->position != &frame->kvlist->list) {
+        pair = cfl_list_entry(frame->position, struct cfl_kvpair, _head);
+        if (pair->key != NULL && pair->val != NULL) {
+            break;
+        }
+        frame->position = frame->position->next;
+    }
+    if (frame->position == &frame->kvlist->list) {
+        frame_pop(encoder);
+        return 0;
+    }
+
+    pair = cfl_list_entry(frame->position, struct cfl_kvpair, _head);
+    frame->position = frame->position->next;
+
+    if (cfl_otlp_any_value_size_cached(pair->val, encoder->sizes,
+                                       &value_size) != 0) {
+        return -1;
+    }
+    key_size = cfl_sds_len(pair->key);
+    pair_size = 1 + varint_size(key_size) + key_size +
+                1 + varint_size(value_size) + value_size;
+
+    /* KeyValue header and key prefix, then key, value prefix and value */
+    length = tag_put(encoder->pending, 1, OTLP_WIRE_LEN);
+    length += varint_put(encoder->pending + length, pair_size);
+    length += tag_put(encoder->pending + length, 1, OTLP_WIRE_LEN);
+    length += varint_put(encoder->pending + length, key_size);
+
+    if (push_value(encoder, pair->val) != 0) {
+        return -1;
+    }
+    header = frame_push(encoder, FRAME_HEADER);
+    if (header == NULL) {
+        return -1;
+    }
+    header->field_number = 2;
+    header->length = value_size;
+    if (push_raw(encoder, pair->key, key_size) != 0) {
+        return -1;
+    }
+    emit_pending(encoder, length);
+
+    return 1;
+}
+
+static int otlp_step(struct cfl_encoder *encoder)
+{
+    size_t length;
+    struct encoder_frame *frame;
+
+    frame = frame_top(encoder);
+    switch (frame->type) {
+    case FRAME_VALUE:
+        return otlp_value_step(encoder, frame);
+    case FRAME_ARRAY:
+        return otlp_array_step(encoder, frame);
+    case FRAME_KVLIST:
+        return otlp_kvlist_step(encoder, frame);
+    case FRAME_RAW:
+        frame_pop(encoder);
+        if (frame->length == 0) {
+            return 0;
+        }
+        emit_reference(encoder, frame->data, frame->length);
+        return 1;
+    case FRAME_HEADER:
+        frame_pop(encoder);
+        length = tag_put(encoder->pending, frame->field_number,
+                         OTLP_WIRE_LEN);
+        length += varint_put(encoder->pending + length, frame->length);
+        emit_pending(encoder, length);
+        return 1;
+    }
+
+    return -1;
+}
+
+/*
+ * Advance to the next non-empty chunk. Returns 1 when a chunk is available,
+ * 0 when the graph has been fully encoded and -1 on error.
+ */
+static int next_chunk(struct cfl_encoder *encoder)
+{
+    int ret;
+
+    encoder->chunk.length = 0;
+    encoder->chunk_offset = 0;
+
+    while (encoder->depth > 0) {
+        if (encoder->format == CFL_VARIANT_FORMAT_JSON) {
+            ret = json_step(encoder);
+        }
+        else {
+            ret = otlp_step(encoder);
+        }
+
+        if (ret < 0) {
+            encoder->failed = CFL_TRUE;
+            return -1;
+        }
+        if (ret > 0 && encoder->chunk.length > 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+struct cfl_encoder *cfl_encoder_create(int format)
+{
+    struct cfl_encoder *encoder;
+
+    if (format != CFL_VARIANT_FORMAT_JSON &&
+        format != CFL_VARIANT_FORMAT_OTLP) {
+        return NULL;
+    }
+
+    encoder = cfl_calloc(1, sizeof(struct cfl_encoder));
+    if (encoder == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    encoder->capacity = 16;
+    encoder->frames = cfl_calloc(encoder->capacity,
+                                 sizeof(struct encoder_frame));
+    if (encoder->frames == NULL) {
+        cfl_errno();
+        cfl_free(encoder);
+        return NULL;
+    }
+
+    if (format == CFL_VARIANT_FORMAT_OTLP) {
+        encoder->sizes = cfl_size_cache_create(NULL);
+        if (encoder->sizes == NULL) {
+            cfl_free(encoder->frames);
+            cfl_free(encoder);
+            return NULL;
+        }
+    }
+    encoder->format = format;
+
+    return encoder;
+}
+
+void cfl_encoder_destroy(struct cfl_encoder *encoder)
+{
+    if (encoder == NULL) {
+        return;
+    }
+
+    cfl_size_cache_destroy(encoder->sizes);
+    cfl_free(encoder->frames);
+    cfl_free(encoder);
+}
+
+int cfl_encoder_begin(struct cfl_encoder *encoder, struct cfl_variant *value)
+{
+    if (encoder == NULL || value == NULL) {
+        return -1;
+    }
+
+    encoder->depth = 0;
+    encoder->failed = CFL_FALSE;
+    cfl_size_cache_clear(encoder->sizes);
+    encoder->chunk.length = 0;
+    encoder->chunk_offset = 0;
+
+    return push_value(encoder, value);
+}
+
+int cfl_encoder_write(struct cfl_encoder *encoder,
+                      char *buffer, size_t buffer_size, size_t *written)
+{
+    int ret;
+    size_t used;
+    size_t count;
+
+    if (written != NULL) {
+        *written = 0;
+    }
+
+    if (encoder == NULL || (buffer == NULL && buffer_size > 0) ||
+        encoder->failed) {
+        return CFL_ENCODER_ERROR;
+    }
+
+    used = 0;
+    while (1) {
+        count = encoder->chunk.length - encoder->chunk_offset;
+        if (count > 0) {
+            if (count > buffer_size - used) {
+                count = buffer_size - used;
+            }
+            memcpy(buffer + used, encoder->chunk.data + encoder->chunk_offset,
+                   count);
+            used += count;
+            encoder->chunk_offset += count;
+
+            if (encoder->chunk_offset < encoder->chunk.length) {
+                ret = CFL_ENCODER_NEED_SPACE;
+                break;
+            }
+        }
+
+        ret = next_chunk(encoder);
+        if (ret < 0) {
+            ret = CFL_ENCODER_ERROR;
+            break;
+        }
+        if (ret == 0) {
+            ret = CFL_ENCODER_DONE;
+            break;
+        }
+        if (used == buffer_size) {
+            ret = CFL_ENCODER_NEED_SPACE;
+            break;
+        }
+    }
+
+    if (written != NULL) {
+        *written = used;
+    }
+
+    return ret;
+}
+
+int cfl_encoder_write_iov(struct cfl_encoder *encoder,
+                          struct cfl_iovec *iov, size_t iov_count,
+                          size_t *iov_used,
+                          char *scratch, size_t scratch_size)
+{
+    int ret;
+    size_t used;
+    size_t count;
+    size_t scratch_used;
+    const char *source;
+    struct cfl_iovec *last;
+
+    if (iov_used != NULL) {
+        *iov_used = 0;
+    }
+
+    if (encoder == NULL || iov == NULL ||
+        (scratch == NULL && scratch_size > 0) || encoder->failed) {
+        return CFL_ENCODER_ERROR;
+    }
+
+    used = 0;
+    scratch_used = 0;
+    while (1) {
+        count = encoder->chunk.length - encoder->chunk_offset;
+        source = encoder->chunk.data + encoder->chunk_offset;
+
+        if (count > 0 && encoder->chunk.referenced) {
+            if (used == iov_count) {
+                ret = CFL_ENCODER_NEED_SPACE;
+                break;
+            }
+            iov[used].iov_base = (void *) source;
+            iov[used].iov_len = count;
+            used++;
+            encoder->chunk_offset += count;
+        }
+        else if (count > 0) {
+            if (count > scratch_size - scratch_used) {
+                count = scratch_size - scratch_used;
+            }
+
+            /* extend the previous segment when it ends at the scratch tail */
+            last = used > 0 ? &iov[used - 1] : NULL;
+            if (count > 0 && last != NULL &&
+                (char *) last->iov_base + last->iov_len ==
+                scratch + scratch_used) {
+                last->iov_len += count;
+            }
+            else if (count > 0 && used < iov_count) {
+                iov[used].iov_base = scratch + scratch_used;
+                iov[used].iov_len = count;
+                used++;
+            }
+            else {
+                ret = CFL_ENCODER_NEED_SPACE;
+                break;
+            }
+
+            memcpy(scratch + scratch_used, source, count);
+            scratch_used += count;
+            encoder->chunk_offset += count;
+
+            if (encoder->chunk_offset < encoder->chunk.length) {
+                ret = CFL_ENCODER_NEED_SPACE;
+                break;
+            }
+        }
+
+        ret = next_chunk(encoder);
+        if (ret < 0) {
+            ret = CFL_ENCODER_ERROR;
+            break;
+        }
+        if (ret == 0) {
+            ret = CFL_ENCODER_DONE;
+            break;
+        }
+    }
+
+    if (iov_used != NULL) {
+        *iov_used = used;
+    }
+
+    return ret;
+}
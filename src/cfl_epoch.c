@@ -0,0 +1,401 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_epoch.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "cfl_cpu_internal.h"
+#include "cfl_thread_internal.h"
+
+#if defined(__linux__) && defined(SYS_membarrier)
+#define EPOCH_HAVE_MEMBARRIER 1
+
+/* from linux/membarrier.h, which older headers lack */
+#define EPOCH_MEMBARRIER_CMD_QUERY                      0
+#define EPOCH_MEMBARRIER_CMD_PRIVATE_EXPEDITED          (1 << 3)
+#define EPOCH_MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED (1 << 4)
+#endif
+
+#define EPOCH_BARRIER_FENCE      0
+#define EPOCH_BARRIER_MEMBARRIER 1
+#define EPOCH_BARRIER_FLUSH      2
+
+/* deferred callbacks queued before a reclaim attempt is made */
+#define EPOCH_RECLAIM_THRESHOLD  64
+
+struct cfl_epoch_reader {
+    /* 0 while outside of a section, else the epoch it entered in */
+    uint64_t          epoch;
+    uint32_t          nesting;
+    struct cfl_epoch *domain;
+    void             *allocation;
+    struct cfl_list   _head;
+};
+
+struct cfl_epoch {
+    /* global epoch, starts at 1 */
+    uint64_t        epoch;
+    int             barrier;
+    size_t          deferred_count;
+    cfl_mutex_t     lock;
+    struct cfl_list readers;
+    struct cfl_list deferred;
+};
+
+struct epoch_deferred {
+    uint64_t             epoch;
+    cfl_epoch_destroy_cb callback;
+    void                *data;
+    struct cfl_list      _head;
+};
+
+static int barrier_detect()
+{
+#if defined(EPOCH_HAVE_MEMBARRIER)
+    long commands;
+
+    commands = syscall(SYS_membarrier, EPOCH_MEMBARRIER_CMD_QUERY, 0);
+    if (commands >= 0 &&
+        (commands & EPOCH_MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+        syscall(SYS_membarrier,
+                EPOCH_MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0) {
+        return EPOCH_BARRIER_MEMBARRIER;
+    }
+#elif defined(_WIN32)
+    return EPOCH_BARRIER_FLUSH;
+#endif
+
+    return EPOCH_BARRIER_FENCE;
+}
+
+/*
+ * Writer side of the asymmetric barrier: every thread of the process
+ * executes a full barrier before this returns, which stands in for the
+ * fence the readers skip.
+ */
+static void barrier_heavy(struct cfl_epoch *domain)
+{
+#if defined(EPOCH_HAVE_MEMBARRIER)
+    if (domain->barrier == EPOCH_BARRIER_MEMBARRIER) {
+        syscall(SYS_membarrier, EPOCH_MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+        return;
+    }
+#elif defined(_WIN32)
+    if (domain->barrier == EPOCH_BARRIER_FLUSH) {
+        FlushProcessWriteBuffers();
+        return;
+    }
+#endif
+
+    cfl_atomic_thread_fence(CFL_ATOMIC_SEQ_CST);
+}
+
+struct cfl_epoch *cfl_epoch_create()
+{
+    struct cfl_epoch *domain;
+
+    domain = cfl_calloc(1, sizeof(struct cfl_epoch));
+    if (domain == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    if (cfl_mutex_init(&domain->lock) != 0) {
+        cfl_free(domain);
+        return NULL;
+    }
+
+    domain->epoch = 1;
+    domain->barrier = barrier_detect();
+    cfl_list_init(&domain->readers);
+    cfl_list_init(&domain->deferred);
+
+    return domain;
+}
+
+void cfl_epoch_destroy(struct cfl_epoch *domain)
+{
+    struct cfl_list       *head;
+    struct cfl_list       *tmp;
+    struct epoch_deferred *entry;
+
+    if (domain == NULL) {
+        return;
+    }
+
+    cfl_list_foreach_safe(head, tmp, &domain->deferred) {
+        entry = cfl_list_entry(head, struct epoch_deferred, _head);
+        cfl_list_del(&entry->_head);
+        entry->callback(entry->data);
+        cfl_free(entry);
+    }
+
+    cfl_mutex_destroy(&domain->lock);
+    cfl_free(domain);
+}
+
+const char *cfl_epoch_barrier_implementation(struct cfl_epoch *domain)
+{
+    if (domain->barrier == EPOCH_BARRIER_MEMBARRIER) {
+        return "membarrier";
+    }
+    else if (domain->barrier == EPOCH_BARRIER_FLUSH) {
+        return "flush-process-write-buffers";
+    }
+
+    return "fence";
+}
+
+struct cfl_epoch_reader *cfl_epoch_reader_create(struct cfl_epoch *domain)
+{
+    void                    *allocation;
+    uintptr_t                aligned;
+    struct cfl_epoch_reader *reader;
+
+    /* readers get a cache line of their own */
+    allocation = cfl_calloc(1, sizeof(struct cfl_epoch_reader) +
+                               2 * CFL_CACHE_LINE_SIZE);
+    if (allocation == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    aligned = ((uintptr_t) allocation + CFL_CACHE_LINE_SIZE) &
+              ~((uintptr_t) CFL_CACHE_LINE_SIZE - 1);
+
+    reader = (struct cfl_epoch_reader *) aligned;
+    reader->domain = domain;
+    reader->allocation = allocation;
+
+    cfl_mutex_lock(&domain->lock);
+    cfl_list_add(&reader->_head, &domain->readers);
+    cfl_mutex_unlock(&domain->lock);
+
+    return reader;
+}
+
+void cfl_epoch_reader_destroy(struct cfl_epoch_reader *reader)
+{
+    struct cfl_epoch *domain;
+
+    if (reader == NULL) {
+        return;
+    }
+
+    domain = reader->domain;
+
+    cfl_mutex_lock(&domain->lock);
+    cfl_list_del(&reader->_head);
+    cfl_mutex_unlock(&domain->lock);
+
+    cfl_free(reader->allocation);
+}
+
+void cfl_epoch_enter(struct cfl_epoch_reader *reader)
+{
+    uint64_t epoch;
+
+    if (reader->nesting++ > 0) {
+        return;
+    }
+
+    epoch = cfl_atomic_load_explicit(&reader->domain->epoch,
+                                     CFL_ATOMIC_RELAXED);
+    cfl_atomic_store_explicit(&reader->epoch, epoch, CFL_ATOMIC_RELAXED);
+
+    /*
+     * The announcement must be visible before the section reads shared
+     * data. With an asymmetric barrier the writer enforces that, and only
+     * the compiler has to be kept in order.
+     */
+    if (reader->domain->barrier == EPOCH_BARRIER_FENCE) {
+        cfl_atomic_thread_fence(CFL_ATOMIC_SEQ_CST);
+    }
+    else {
+        cfl_compiler_barrier();
+    }
+}
+
+void cfl_epoch_exit(struct cfl_epoch_reader *reader)
+{
+    if (--reader->nesting > 0) {
+        return;
+    }
+
+    /* section reads complete before the reader is seen as gone */
+    cfl_atomic_store_explicit(&reader->epoch, 0, CFL_ATOMIC_RELEASE);
+}
+
+void *cfl_epoch_publish(void **slot, void *value)
+{
+    return cfl_atomic_ptr_exchange_explicit(slot, value, CFL_ATOMIC_ACQ_REL);
+}
+
+void *cfl_epoch_dereference(void **slot)
+{
+    return cfl_atomic_ptr_load_explicit(slot, CFL_ATOMIC_ACQUIRE);
+}
+
+/*
+ * Advance the global epoch when every active reader is in the current
+ * one. Called with the domain lock held.
+ */
+static void epoch_try_advance(struct cfl_epoch *domain)
+{
+    uint64_t                 current;
+    uint64_t                 epoch;
+    struct cfl_list         *head;
+    struct cfl_epoch_reader *reader;
+
+    current = domain->epoch;
+
+    barrier_heavy(domain);
+
+    cfl_list_foreach(head, &domain->readers) {
+        reader = cfl_list_entry(head, struct cfl_epoch_reader, _head);
+
+        epoch = cfl_atomic_load_explicit(&reader->epoch, CFL_ATOMIC_ACQUIRE);
+        if (epoch != 0 && epoch != current) {
+            return;
+        }
+    }
+
+    cfl_atomic_store_explicit(&domain->epoch, current + 1,
+                              CFL_ATOMIC_SEQ_CST);
+}
+
+size_t cfl_epoch_reclaim(struct cfl_epoch *domain)
+{
+    size_t                 count;
+    struct cfl_list        ready;
+    struct cfl_list       *head;
+    struct cfl_list       *tmp;
+    struct epoch_deferred *entry;
+
+    cfl_list_init(&ready);
+
+    cfl_mutex_lock(&domain->lock);
+
+    epoch_try_advance(domain);
+
+    /*
+     * Readers that could have seen an object unpublished in epoch N were
+     * in N or N - 1; once the global epoch reaches N + 2 they have all
+     * left. Entries are queued in epoch order.
+     */
+    cfl_list_foreach_safe(head, tmp, &domain->deferred) {
+        entry = cfl_list_entry(head, struct epoch_deferred, _head);
+        if (entry->epoch + 2 > domain->epoch) {
+            break;
+        }
+        cfl_list_del(&entry->_head);
+        cfl_list_add(&entry->_head, &ready);
+        domain->deferred_count--;
+    }
+
+    cfl_mutex_unlock(&domain->lock);
+
+    /* callbacks run unlocked, they may defer more work */
+    count = 0;
+    cfl_list_foreach_safe(head, tmp, &ready) {
+        entry = cfl_list_entry(head, struct epoch_deferred, _head);
+        cfl_list_del(&entry->_head);
+        entry->callback(entry->data);
+        cfl_free(entry);
+        count++;
+    }
+
+    return count;
+}
+
+int cfl_epoch_defer(struct cfl_epoch *domain,
+                    cfl_epoch_destroy_cb callback, void *data)
+{
+    size_t                 pending;
+    struct epoch_deferred *entry;
+
+    entry = cfl_malloc(sizeof(struct epoch_deferred));
+    if (entry == NULL) {
+        cfl_errno();
+        return -1;
+    }
+
+    entry->callback = callback;
+    entry->data = data;
+
+    cfl_mutex_lock(&domain->lock);
+    entry->epoch = domain->epoch;
+    cfl_list_add(&entry->_head, &domain->deferred);
+    pending = ++domain->deferred_count;
+    cfl_mutex_unlock(&domain->lock);
+
+    if (pending >= EPOCH_RECLAIM_THRESHOLD) {
+        cfl_epoch_reclaim(domain);
+    }
+
+    return 0;
+}
+
+static void destroy_variant(void *data)
+{
+    cfl_variant_destroy(data);
+}
+
+static void destroy_arena(void *data)
+{
+    cfl_arena_destroy(data);
+}
+
+int cfl_epoch_defer_variant_destroy(struct cfl_epoch *domain,
+                                    struct cfl_variant *variant)
+{
+    return cfl_epoch_defer(domain, destroy_variant, variant);
+}
+
+int cfl_epoch_defer_arena_destroy(struct cfl_epoch *domain,
+                                  struct cfl_arena *arena)
+{
+    return cfl_epoch_defer(domain, destroy_arena, arena);
+}
+
+void cfl_epoch_synchronize(struct cfl_epoch *domain)
+{
+    uint64_t target;
+    uint64_t epoch;
+
+    cfl_mutex_lock(&domain->lock);
+    target = domain->epoch + 2;
+    cfl_mutex_unlock(&domain->lock);
+
+    while (1) {
+        cfl_epoch_reclaim(domain);
+
+        epoch = cfl_atomic_load_explicit(&domain->epoch, CFL_ATOMIC_ACQUIRE);
+        if (epoch >= target) {
+            break;
+        }
+
+        cfl_thread_yield();
+    }
+}
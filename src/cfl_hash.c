@@ -0,0 +1,146 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl_hash.h>
+
+/*
+ * The dispatcher replaces the one-shot and update functions; resets and
+ * digests do not touch the long-input kernels and stay as they are. Its
+ * header cannot be used here: xxh3.h inlines xxHash, which turns every
+ * XXH_PUBLIC_API declaration static.
+ */
+#if defined(CFL_HAVE_XXHASH_DISPATCH)
+int XXH_featureTest(void);
+XXH64_hash_t XXH3_64bits_dispatch(const void *input, size_t length);
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(const void *input, size_t length,
+                                           XXH64_hash_t seed);
+XXH_errorcode XXH3_64bits_update_dispatch(XXH3_state_t *state,
+                                          const void *input, size_t length);
+XXH128_hash_t XXH3_128bits_dispatch(const void *input, size_t length);
+XXH128_hash_t XXH3_128bits_withSeed_dispatch(const void *input, size_t length,
+                                             XXH64_hash_t seed);
+XXH_errorcode XXH3_128bits_update_dispatch(XXH3_state_t *state,
+                                           const void *input, size_t length);
+
+#define HASH_64              XXH3_64bits_dispatch
+#define HASH_64_SEED         XXH3_64bits_withSeed_dispatch
+#define HASH_64_UPDATE       XXH3_64bits_update_dispatch
+#define HASH_128             XXH3_128bits_dispatch
+#define HASH_128_SEED        XXH3_128bits_withSeed_dispatch
+#define HASH_128_UPDATE      XXH3_128bits_update_dispatch
+#else
+#define HASH_64              XXH3_64bits
+#define HASH_64_SEED         XXH3_64bits_withSeed
+#define HASH_64_UPDATE       XXH3_64bits_update
+#define HASH_128             XXH3_128bits
+#define HASH_128_SEED        XXH3_128bits_withSeed
+#define HASH_128_UPDATE      XXH3_128bits_update
+#endif
+
+cfl_hash_64bits_t cfl_hash_64bits(const void *input, size_t length)
+{
+    return HASH_64(input, length);
+}
+
+cfl_hash_64bits_t cfl_hash_64bits_with_seed(const void *input, size_t length,
+                                            uint64_t seed)
+{
+    return HASH_64_SEED(input, length, seed);
+}
+
+XXH_errorcode cfl_hash_64bits_reset(cfl_hash_state_t *state)
+{
+    return XXH3_64bits_reset(state);
+}
+
+XXH_errorcode cfl_hash_64bits_reset_with_seed(cfl_hash_state_t *state,
+                                              uint64_t seed)
+{
+    return XXH3_64bits_reset_withSeed(state, seed);
+}
+
+XXH_errorcode cfl_hash_64bits_update(cfl_hash_state_t *state,
+                                     const void *input, size_t length)
+{
+    return HASH_64_UPDATE(state, input, length);
+}
+
+cfl_hash_64bits_t cfl_hash_64bits_digest(const cfl_hash_state_t *state)
+{
+    return XXH3_64bits_digest(state);
+}
+
+cfl_hash_128bits_t cfl_hash_128bits(const void *input, size_t length)
+{
+    return HASH_128(input, length);
+}
+
+cfl_hash_128bits_t cfl_hash_128bits_with_seed(const void *input,
+                                              size_t length, uint64_t seed)
+{
+    return HASH_128_SEED(input, length, seed);
+}
+
+XXH_errorcode cfl_hash_128bits_reset(cfl_hash_state_t *state)
+{
+    return XXH3_128bits_reset(state);
+}
+
+XXH_errorcode cfl_hash_128bits_reset_with_seed(cfl_hash_state_t *state,
+                                               uint64_t seed)
+{
+    return XXH3_128bits_reset_withSeed(state, seed);
+}
+
+XXH_errorcode cfl_hash_128bits_update(cfl_hash_state_t *state,
+                                      const void *input, size_t length)
+{
+    return HASH_128_UPDATE(state, input, length);
+}
+
+cfl_hash_128bits_t cfl_hash_128bits_digest(const cfl_hash_state_t *state)
+{
+    return XXH3_128bits_digest(state);
+}
+
+const char *cfl_hash_implementation(void)
+{
+#if defined(CFL_HAVE_XXHASH_DISPATCH)
+    switch (XXH_featureTest()) {
+    case XXH_AVX512:
+        return "avx512";
+    case XXH_AVX2:
+        return "avx2";
+    case XXH_SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+#elif defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "sse2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
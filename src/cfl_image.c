@@ -0,0 +1,884 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_image.h>
+
+#include <ctype.h>
+#include <string.h>
+
+#define IMAGE_HEADER_SIZE     16
+#define IMAGE_SLOT_SIZE       16
+#define IMAGE_ENTRY_SIZE      24
+#define IMAGE_COUNT_SIZE       8
+
+static const unsigned char image_magic[4] = {'C', 'F', 'L', 'I'};
+
+struct image_writer {
+    unsigned char *buffer;
+    size_t size;
+    size_t cursor;
+};
+
+static uint32_t load_u32(const unsigned char *in)
+{
+    return (uint32_t) in[0] | ((uint32_t) in[1] << 8) |
+           ((uint32_t) in[2] << 16) | ((uint32_t) in[3] << 24);
+}
+
+static uint64_t load_u64(const unsigned char *in)
+{
+    return (uint64_t) load_u32(in) | ((uint64_t) load_u32(in + 4) << 32);
+}
+
+static void store_u32(unsigned char *out, uint32_t value)
+{
+    out[0] = (unsigned char) value;
+    out[1] = (unsigned char) (value >> 8);
+    out[2] = (unsigned char) (value >> 16);
+    out[3] = (unsigned char) (value >> 24);
+}
+
+static void store_u64(unsigned char *out, uint64_t value)
+{
+    store_u32(out, (uint32_t) value);
+    store_u32(out + 4, (uint32_t) (value >> 32));
+}
+
+static int size_add(size_t *total, size_t value)
+{
+    if (*total > SIZE_MAX - value) {
+        return -1;
+    }
+
+    *total += value;
+
+    return 0;
+}
+
+static int size_align(size_t *size)
+{
+    return size_add(size, (8 - (*size & 7)) & 7);
+}
+
+/* uint64 length, data and NUL terminator, padded to 8 bytes */
+static int blob_size(size_t length, size_t *size)
+{
+    size_t total;
+
+    total = IMAGE_COUNT_SIZE;
+    if (size_add(&total, length) != 0 ||
+        size_add(&total, 1) != 0 ||
+        size_align(&total) != 0) {
+        return -1;
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static int pair_is_valid(struct cfl_kvpair *pair)
+{
+    return pair->key != NULL && pair->val != NULL;
+}
+
+/* size of the blocks a value references, excluding its own slot */
+static int blocks_size(struct cfl_variant *value, size_t depth, size_t *size)
+{
+    size_t index;
+    size_t count;
+    size_t total;
+    size_t nested;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+    struct cfl_array *array;
+
+    if (value == NULL || depth > CFL_IMAGE_MAX_DEPTH) {
+        return -1;
+    }
+
+    total = 0;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        if (value->data.as_string == NULL && value->size > 0) {
+            return -1;
+        }
+        if (blob_size(value->size, &total) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_ARRAY:
+        array = value->data.as_array;
+        if (array == NULL ||
+            array->entry_count > (SIZE_MAX - IMAGE_COUNT_SIZE) /
+                                 IMAGE_SLOT_SIZE) {
+            return -1;
+        }
+        total = IMAGE_COUNT_SIZE + array->entry_count * IMAGE_SLOT_SIZE;
+        for (index = 0; index < array->entry_count; index++) {
+            if (blocks_size(array->entries[index], depth + 1,
+                            &nested) != 0 ||
+                size_add(&total, nested) != 0) {
+                return -1;
+            }
+        }
+        break;
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL) {
+            return -1;
+        }
+        count = 0;
+        total = IMAGE_COUNT_SIZE;
+        cfl_list_foreach(head, &value->data.as_kvlist->list) {
+            pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+            if (!pair_is_valid(pair)) {
+                continue;
+            }
+            count++;
+            if (size_add(&total, IMAGE_ENTRY_SIZE + sizeof(uint32_t)) != 0 ||
+                blob_size(cfl_sds_len(pair->key), &nested) != 0 ||
+                size_add(&total, nested) != 0 ||
+                blocks_size(pair->val, depth + 1, &nested) != 0 ||
+                size_add(&total, nested) != 0) {
+                return -1;
+            }
+        }
+        /* the uint32 directory is padded to keep blocks aligned */
+        if (count > UINT32_MAX || size_add(&total, (count & 1) * 4) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_BOOL:
+    case CFL_VARIANT_INT:
+    case CFL_VARIANT_UINT:
+    case CFL_VARIANT_DOUBLE:
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        break;
+    default:
+        return -1;
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+int cfl_image_size(struct cfl_variant *value, size_t *size)
+{
+    size_t total;
+    size_t nested;
+
+    if (size == NULL || blocks_size(value, 0, &nested) != 0) {
+        return -1;
+    }
+
+    total = IMAGE_HEADER_SIZE + IMAGE_SLOT_SIZE;
+    if (size_add(&total, nested) != 0) {
+        return -1;
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static size_t writer_reserve(struct image_writer *writer, size_t length)
+{
+    size_t offset;
+
+    /* the sizing pass guarantees the space, blocks keep 8 byte alignment */
+    offset = writer->cursor;
+    memset(writer->buffer + offset, 0, length);
+    writer->cursor += length;
+
+    return offset;
+}
+
+static size_t writer_blob(struct image_writer *writer,
+                          const char *data, size_t length)
+{
+    size_t size;
+    size_t offset;
+
+    size = 0;
+    blob_size(length, &size);
+    offset = writer_reserve(writer, size);
+    store_u64(writer->buffer + offset, length);
+    if (length > 0) {
+        memcpy(writer->buffer + offset + IMAGE_COUNT_SIZE, data, length);
+    }
+
+    return offset;
+}
+
+static void slot_store(unsigned char *slot, int type, uint64_t payload)
+{
+    memset(slot, 0, IMAGE_SLOT_SIZE);
+    slot[0] = (unsigned char) type;
+    store_u64(slot + 8, payload);
+}
+
+static int key_compare(const unsigned char *a, size_t a_length,
+                       const unsigned char *b, size_t b_length)
+{
+    size_t index;
+    size_t length;
+    int difference;
+
+    length = a_length < b_length ? a_length : b_length;
+    for (index = 0; index < length; index++) {
+        difference = tolower(a[index]) - tolower(b[index]);
+        if (difference != 0) {
+            return difference;
+        }
+    }
+
+    if (a_length != b_length) {
+        return a_length < b_length ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static int directory_compare(struct image_writer *writer,
+                             const unsigned char *entries,
+                             uint32_t a, uint32_t b)
+{
+    int ret;
+    const unsigned char *a_key;
+    const unsigned char *b_key;
+
+    a_key = writer->buffer + load_u64(entries + a * IMAGE_ENTRY_SIZE);
+    b_key = writer->buffer + load_u64(entries + b * IMAGE_ENTRY_SIZE);
+
+    ret = key_compare(a_key + IMAGE_COUNT_SIZE, load_u64(a_key),
+                      b_key + IMAGE_COUNT_SIZE, load_u64(b_key));
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* equal keys keep insertion order, so the first match wins */
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static void directory_sift(struct image_writer *writer,
+                           const unsigned char *entries,
+                           unsigned char *directory,
+                           size_t root, size_t count)
+{
+    size_t child;
+    uint32_t value;
+    uint32_t child_value;
+
+    value = load_u32(directory + root * 4);
+    while ((child = root * 2 + 1) < count) {
+        child_value = load_u32(directory + child * 4);
+        if (child + 1 < count &&
+            directory_compare(writer, entries, child_value,
+                              load_u32(directory + (child + 1) * 4)) < 0) {
+            child++;
+            child_value = load_u32(directory + child * 4);
+        }
+        if (directory_compare(writer, entries, value, child_value) >= 0) {
+            break;
+        }
+        store_u32(directory + root * 4, child_value);
+        root = child;
+    }
+    store_u32(directory + root * 4, value);
+}
+
+/* in-place heap sort, the writer does not allocate */
+static void directory_sort(struct image_writer *writer,
+                           const unsigned char *entries,
+                           unsigned char *directory, size_t count)
+{
+    size_t index;
+    uint32_t value;
+
+    for (index = count / 2; index > 0; index--) {
+        directory_sift(writer, entries, directory, index - 1, count);
+    }
+
+    for (index = count; index > 1; index--) {
+        value = load_u32(directory);
+        store_u32(directory, load_u32(directory + (index - 1) * 4));
+        store_u32(directory + (index - 1) * 4, value);
+        directory_sift(writer, entries, directory, 0, index - 1);
+    }
+}
+
+static void value_write(struct image_writer *writer,
+                        struct cfl_variant *value, size_t slot);
+
+static void array_write(struct image_writer *writer,
+                        struct cfl_array *array, size_t slot)
+{
+    size_t index;
+    size_t block;
+
+    block = writer_reserve(writer, IMAGE_COUNT_SIZE +
+                                   array->entry_count * IMAGE_SLOT_SIZE);
+    store_u64(writer->buffer + block, array->entry_count);
+    slot_store(writer->buffer + slot, CFL_VARIANT_ARRAY, block);
+
+    for (index = 0; index < array->entry_count; index++) {
+        value_write(writer, array->entries[index],
+                    block + IMAGE_COUNT_SIZE + index * IMAGE_SLOT_SIZE);
+    }
+}
+
+static void kvlist_write(struct image_writer *writer,
+                         struct cfl_kvlist *kvlist, size_t slot)
+{
+    size_t count;
+    size_t index;
+    size_t block;
+    size_t entry;
+    size_t directory;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+
+    count = 0;
+    cfl_list_foreach(head, &kvlist->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (pair_is_valid(pair)) {
+            count++;
+        }
+    }
+
+    block = writer_reserve(writer, IMAGE_COUNT_SIZE +
+                                   count * IMAGE_ENTRY_SIZE +
+                                   ((count + 1) & ~((size_t) 1)) * 4);
+    directory = block + IMAGE_COUNT_SIZE + count * IMAGE_ENTRY_SIZE;
+    store_u64(writer->buffer + block, count);
+    slot_store(writer->buffer + slot, CFL_VARIANT_KVLIST, block);
+
+    index = 0;
+    cfl_list_foreach(head, &kvlist->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (!pair_is_valid(pair)) {
+            continue;
+        }
+
+        entry = block + IMAGE_COUNT_SIZE + index * IMAGE_ENTRY_SIZE;
+        store_u64(writer->buffer + entry,
+                  writer_blob(writer, pair->key, cfl_sds_len(pair->key)));
+        value_write(writer, pair->val, entry + 8);
+        store_u32(writer->buffer + directory + index * 4, (uint32_t) index);
+        index++;
+    }
+
+    directory_sort(writer, writer->buffer + block + IMAGE_COUNT_SIZE,
+                   writer->buffer + directory, count);
+}
+
+static void value_write(struct image_writer *writer,
+                        struct cfl_variant *value, size_t slot)
+{
+    uint64_t bits;
+    unsigned char *out;
+
+    out = writer->buffer + slot;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        slot_store(out, value->type,
+                   writer_blob(writer, value->data.as_string, value->size));
+        break;
+    case CFL_VARIANT_BOOL:
+        slot_store(out, value->type, value->data.as_bool ? 1 : 0);
+        break;
+    case CFL_VARIANT_INT:
+        slot_store(out, value->type, (uint64_t) value->data.as_int64);
+        break;
+    case CFL_VARIANT_UINT:
+        slot_store(out, value->type, value->data.as_uint64);
+        break;
+    case CFL_VARIANT_DOUBLE:
+        memcpy(&bits, &value->data.as_double, sizeof(bits));
+        slot_store(out, value->type, bits);
+        break;
+    case CFL_VARIANT_ARRAY:
+        array_write(writer, value->data.as_array, slot);
+        break;
+    case CFL_VARIANT_KVLIST:
+        kvlist_write(writer, value->data.as_kvlist, slot);
+        break;
+    default:
+        slot_store(out, CFL_VARIANT_NULL, 0);
+        break;
+    }
+}
+
+int cfl_image_encode(struct cfl_variant *value,
+                     char *buffer, size_t buffer_size, size_t *encoded_size)
+{
+    size_t size;
+    struct image_writer writer;
+
+    if (buffer == NULL || cfl_image_size(value, &size) != 0 ||
+        buffer_size < size) {
+        return -1;
+    }
+
+    writer.buffer = (unsigned char *) buffer;
+    writer.size = size;
+    writer.cursor = 0;
+
+    writer_reserve(&writer, IMAGE_HEADER_SIZE + IMAGE_SLOT_SIZE);
+    memcpy(writer.buffer, image_magic, sizeof(image_magic));
+    store_u32(writer.buffer + 4, CFL_IMAGE_VERSION);
+    store_u64(writer.buffer + 8, size);
+
+    value_write(&writer, value, IMAGE_HEADER_SIZE);
+
+    /* the sizing pass and the writer must agree byte for byte */
+    if (writer.cursor != size) {
+        return -1;
+    }
+
+    if (encoded_size != NULL) {
+        *encoded_size = size;
+    }
+
+    return 0;
+}
+
+int cfl_image_open(struct cfl_image *image, const void *buffer, size_t size)
+{
+    uint64_t image_size;
+    const unsigned char *in;
+
+    if (image == NULL || buffer == NULL ||
+        size < IMAGE_HEADER_SIZE + IMAGE_SLOT_SIZE) {
+        return -1;
+    }
+
+    in = buffer;
+    if (memcmp(in, image_magic, sizeof(image_magic)) != 0 ||
+        load_u32(in + 4) != CFL_IMAGE_VERSION) {
+        return -1;
+    }
+
+    image_size = load_u64(in + 8);
+    if (image_size < IMAGE_HEADER_SIZE + IMAGE_SLOT_SIZE ||
+        image_size > size) {
+        return -1;
+    }
+
+    image->buffer = in;
+    image->size = (size_t) image_size;
+
+    return 0;
+}
+
+const struct cfl_image_slot *cfl_image_root(struct cfl_image *image)
+{
+    if (image == NULL || image->buffer == NULL) {
+        return NULL;
+    }
+
+    return (const struct cfl_image_slot *) (image->buffer + IMAGE_HEADER_SIZE);
+}
+
+/* returns the slot bytes when the slot lies inside the image */
+static const unsigned char *slot_bytes(struct cfl_image *image,
+                                       const struct cfl_image_slot *slot)
+{
+    const unsigned char *in;
+
+    if (image == NULL || image->buffer == NULL || slot == NULL) {
+        return NULL;
+    }
+
+    in = (const unsigned char *) slot;
+    if (in < image->buffer ||
+        (size_t) (in - image->buffer) > image->size - IMAGE_SLOT_SIZE) {
+        return NULL;
+    }
+
+    return in;
+}
+
+/* returns the block referenced by a slot of 'type' after bounds checks */
+static const unsigned char *slot_block(struct cfl_image *image,
+                                       const struct cfl_image_slot *slot,
+                                       int type, uint64_t *count)
+{
+    uint64_t offset;
+    const unsigned char *in;
+
+    in = slot_bytes(image, slot);
+    if (in == NULL || in[0] != type) {
+        return NULL;
+    }
+
+    offset = load_u64(in + 8);
+    if ((offset & 7) != 0 || offset < IMAGE_HEADER_SIZE + IMAGE_SLOT_SIZE ||
+        offset > image->size - IMAGE_COUNT_SIZE) {
+        return NULL;
+    }
+
+    *count = load_u64(image->buffer + offset);
+
+    return image->buffer + offset;
+}
+
+static const unsigned char *blob_at(struct cfl_image *image, uint64_t offset,
+                                    size_t *length)
+{
+    uint64_t size;
+
+    if ((offset & 7) != 0 ||
+        offset > image->size - IMAGE_COUNT_SIZE) {
+        return NULL;
+    }
+
+    size = load_u64(image->buffer + offset);
+    if (size >= image->size - offset - IMAGE_COUNT_SIZE) {
+        return NULL;
+    }
+
+    *length = (size_t) size;
+
+    return image->buffer + offset + IMAGE_COUNT_SIZE;
+}
+
+int cfl_image_type(struct cfl_image *image,
+                   const struct cfl_image_slot *slot)
+{
+    const unsigned char *in;
+
+    in = slot_bytes(image, slot);
+    if (in == NULL) {
+        return -1;
+    }
+
+    switch (in[0]) {
+    case CFL_VARIANT_BOOL:
+    case CFL_VARIANT_INT:
+    case CFL_VARIANT_UINT:
+    case CFL_VARIANT_DOUBLE:
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+    case CFL_VARIANT_ARRAY:
+    case CFL_VARIANT_KVLIST:
+        return in[0];
+    }
+
+    return -1;
+}
+
+static int slot_scalar(struct cfl_image *image,
+                       const struct cfl_image_slot *slot, int type,
+                       uint64_t *payload)
+{
+    const unsigned char *in;
+
+    in = slot_bytes(image, slot);
+    if (in == NULL || in[0] != type) {
+        return -1;
+    }
+
+    *payload = load_u64(in + 8);
+
+    return 0;
+}
+
+int cfl_image_get_bool(struct cfl_image *image,
+                       const struct cfl_image_slot *slot, int *value)
+{
+    uint64_t payload;
+
+    if (value == NULL ||
+        slot_scalar(image, slot, CFL_VARIANT_BOOL, &payload) != 0) {
+        return -1;
+    }
+
+    *value = payload != 0 ? CFL_TRUE : CFL_FALSE;
+
+    return 0;
+}
+
+int cfl_image_get_int64(struct cfl_image *image,
+                        const struct cfl_image_slot *slot, int64_t *value)
+{
+    uint64_t payload;
+
+    if (value == NULL ||
+        slot_scalar(image, slot, CFL_VARIANT_INT, &payload) != 0) {
+        return -1;
+    }
+
+    *value = (int64_t) payload;
+
+    return 0;
+}
+
+int cfl_image_get_uint64(struct cfl_image *image,
+                         const struct cfl_image_slot *slot, uint64_t *value)
+{
+    if (value == NULL ||
+        slot_scalar(image, slot, CFL_VARIANT_UINT, value) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int cfl_image_get_double(struct cfl_image *image,
+                         const struct cfl_image_slot *slot, double *value)
+{
+    uint64_t payload;
+
+    if (value == NULL ||
+        slot_scalar(image, slot, CFL_VARIANT_DOUBLE, &payload) != 0) {
+        return -1;
+    }
+
+    memcpy(value, &payload, sizeof(payload));
+
+    return 0;
+}
+
+int cfl_image_get_string(struct cfl_image *image,
+                         const struct cfl_image_slot *slot,
+                         const char **data, size_t *length)
+{
+    const unsigned char *in;
+    const unsigned char *blob;
+
+    in = slot_bytes(image, slot);
+    if (in == NULL || data == NULL || length == NULL ||
+        (in[0] != CFL_VARIANT_STRING && in[0] != CFL_VARIANT_BYTES)) {
+        return -1;
+    }
+
+    blob = blob_at(image, load_u64(in + 8), length);
+    if (blob == NULL) {
+        return -1;
+    }
+
+    *data = (const char *) blob;
+
+    return 0;
+}
+
+static const unsigned char *array_block(struct cfl_image *image,
+                                        const struct cfl_image_slot *slot,
+                                        size_t *count)
+{
+    uint64_t entries;
+    const unsigned char *block;
+
+    block = slot_block(image, slot, CFL_VARIANT_ARRAY, &entries);
+    if (block == NULL ||
+        entries > (image->size - (size_t) (block - image->buffer) -
+                   IMAGE_COUNT_SIZE) / IMAGE_SLOT_SIZE) {
+        return NULL;
+    }
+
+    *count = (size_t) entries;
+
+    return block;
+}
+
+size_t cfl_image_array_count(struct cfl_image *image,
+                             const struct cfl_image_slot *slot)
+{
+    size_t count;
+
+    if (array_block(image, slot, &count) == NULL) {
+        return 0;
+    }
+
+    return count;
+}
+
+const struct cfl_image_slot *cfl_image_array_fetch_by_index(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    size_t index)
+{
+    size_t count;
+    const unsigned char *block;
+
+    block = array_block(image, slot, &count);
+    if (block == NULL || index >= count) {
+        return NULL;
+    }
+
+    return (const struct cfl_image_slot *)
+           (block + IMAGE_COUNT_SIZE + index * IMAGE_SLOT_SIZE);
+}
+
+static const unsigned char *kvlist_block(struct cfl_image *image,
+                                         const struct cfl_image_slot *slot,
+                                         size_t *count)
+{
+    uint64_t entries;
+    const unsigned char *block;
+
+    block = slot_block(image, slot, CFL_VARIANT_KVLIST, &entries);
+    if (block == NULL ||
+        entries > (image->size - (size_t) (block - image->buffer) -
+                   IMAGE_COUNT_SIZE) / (IMAGE_ENTRY_SIZE + 4)) {
+        return NULL;
+    }
+
+    *count = (size_t) entries;
+
+    return block;
+}
+
+static const unsigned char *kvlist_key(struct cfl_image *image,
+                                       const unsigned char *block,
+                                       size_t index, size_t *length)
+{
+    return blob_at(image,
+                   load_u64(block + IMAGE_COUNT_SIZE +
+                            index * IMAGE_ENTRY_SIZE),
+                   length);
+}
+
+size_t cfl_image_kvlist_count(struct cfl_image *image,
+                              const struct cfl_image_slot *slot)
+{
+    size_t count;
+
+    if (kvlist_block(image, slot, &count) == NULL) {
+        return 0;
+    }
+
+    return count;
+}
+
+int cfl_image_kvlist_entry(struct cfl_image *image,
+                           const struct cfl_image_slot *slot, size_t index,
+                           const char **key, size_t *key_length,
+                           const struct cfl_image_slot **value)
+{
+    size_t count;
+    size_t length;
+    const unsigned char *block;
+    const unsigned char *name;
+
+    block = kvlist_block(image, slot, &count);
+    if (block == NULL || index >= count) {
+        return -1;
+    }
+
+    name = kvlist_key(image, block, index, &length);
+    if (name == NULL) {
+        return -1;
+    }
+
+    if (key != NULL) {
+        *key = (const char *) name;
+    }
+    if (key_length != NULL) {
+        *key_length = length;
+    }
+    if (value != NULL) {
+        *value = (const struct cfl_image_slot *)
+                 (block + IMAGE_COUNT_SIZE + index * IMAGE_ENTRY_SIZE + 8);
+    }
+
+    return 0;
+}
+
+static const struct cfl_image_slot *kvlist_fetch(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    const char *key, size_t key_size, int case_sensitive)
+{
+    size_t low;
+    size_t high;
+    size_t middle;
+    size_t count;
+    size_t length;
+    uint32_t entry;
+    const unsigned char *name;
+    const unsigned char *block;
+    const unsigned char *directory;
+
+    if (key == NULL) {
+        return NULL;
+    }
+
+    block = kvlist_block(image, slot, &count);
+    if (block == NULL) {
+        return NULL;
+    }
+    directory = block + IMAGE_COUNT_SIZE + count * IMAGE_ENTRY_SIZE;
+
+    /* lower bound of the case-folded key in the sorted directory */
+    low = 0;
+    high = count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        entry = load_u32(directory + middle * 4);
+        if (entry >= count ||
+            (name = kvlist_key(image, block, entry, &length)) == NULL) {
+            return NULL;
+        }
+
+        if (key_compare(name, length,
+                        (const unsigned char *) key, key_size) < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    for (; low < count; low++) {
+        entry = load_u32(directory + low * 4);
+        if (entry >= count ||
+            (name = kvlist_key(image, block, entry, &length)) == NULL ||
+            key_compare(name, length,
+                        (const unsigned char *) key, key_size) != 0) {
+            return NULL;
+        }
+
+        if (!case_sensitive || memcmp(name, key, key_size) == 0) {
+            return (const struct cfl_image_slot *)
+                   (block + IMAGE_COUNT_SIZE + entry * IMAGE_ENTRY_SIZE + 8);
+        }
+    }
+
+    return NULL;
+}
+
+const struct cfl_image_slot *cfl_image_kvlist_fetch_s(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    const char *key, size_t key_size)
+{
+    return kvlist_fetch(image, slot, key, key_size, CFL_FALSE);
+}
+
+const struct cfl_image_slot *cfl_image_kvlist_fetch_case_s(
+    struct cfl_image *image, const struct cfl_image_slot *slot,
+    const char *key, size_t key_size)
+{
+    return kvlist_fetch(image, slot, key, key_size, CFL_TRUE);
+}
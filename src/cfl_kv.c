@@ -46,7 +46,7 @@ struct cfl_kv *cfl_kv_item_create_len(struct cfl_list *list,
         return NULL;
     }
 
-    kv = calloc(1, sizeof(struct cfl_kv));
+    kv = cfl_calloc(1, sizeof(struct cfl_kv));
 
     if (kv == NULL) {
         cfl_report_runtime_error();
@@ -57,7 +57,7 @@ struct cfl_kv *cfl_kv_item_create_len(struct cfl_list *list,
     kv->key = cfl_sds_create_len(k_buf, (int) k_len);
 
     if (kv->key == NULL) {
-        free(kv);
+        cfl_free(kv);
 
         return NULL;
     }
@@ -67,7 +67,7 @@ struct cfl_kv *cfl_kv_item_create_len(struct cfl_list *list,
 
         if (kv->val == NULL) {
             cfl_sds_destroy(kv->key);
-            free(kv);
+            cfl_free(kv);
 
             return NULL;
         }
@@ -120,7 +120,7 @@ void cfl_kv_item_destroy(struct cfl_kv *kv)
 
     cfl_list_del(&kv->_head);
 
-    free(kv);
+    cfl_free(kv);
 }
 
 void cfl_kv_release(struct cfl_list *list)
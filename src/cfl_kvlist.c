@@ -22,6 +22,7 @@
 #include <cfl/cfl_array.h>
 #include <cfl/cfl_variant.h>
 #include "cfl_arena_internal.h"
+#include "cfl_object_cache_internal.h"
 #include <cfl/cfl_compat.h>
 
 #include <ctype.h>
@@ -96,7 +97,7 @@ struct cfl_kvlist *cfl_kvlist_create_in(struct cfl_arena *arena)
     struct cfl_kvlist *list;
 
     if (arena == NULL) {
-        list = malloc(sizeof(struct cfl_kvlist));
+        list = cfl_object_cache_alloc(sizeof(struct cfl_kvlist));
     }
     else {
         list = cfl_arena_malloc(arena, sizeof(struct cfl_kvlist));
@@ -146,7 +147,7 @@ void cfl_kvlist_destroy(struct cfl_kvlist *list)
         }
         cfl_list_del(&pair->_head);
         if (pair->arena == NULL) {
-            free(pair);
+            cfl_object_cache_free(pair, sizeof(struct cfl_kvpair));
         }
         else {
             cfl_arena_free_kvpair(pair->arena, pair,
@@ -155,7 +156,7 @@ void cfl_kvlist_destroy(struct cfl_kvlist *list)
     }
 
     if (list->arena == NULL) {
-        free(list);
+        cfl_object_cache_free(list, sizeof(struct cfl_kvlist));
     }
 }
 
@@ -451,7 +452,7 @@ int cfl_kvlist_insert_s(struct cfl_kvlist *list,
     }
 
     if (list->arena == NULL) {
-        pair = malloc(sizeof(struct cfl_kvpair));
+        pair = cfl_object_cache_alloc(sizeof(struct cfl_kvpair));
     }
     else {
         pair = cfl_arena_alloc_kvpair(list->arena,
@@ -465,7 +466,7 @@ int cfl_kvlist_insert_s(struct cfl_kvlist *list,
     pair->key = cfl_sds_create_len_in(list->arena, key, (int) key_size);
     if (pair->key == NULL) {
         if (list->arena == NULL) {
-            free(pair);
+            cfl_object_cache_free(pair, sizeof(struct cfl_kvpair));
         }
         else {
             cfl_arena_free_kvpair(list->arena, pair,
@@ -478,7 +479,7 @@ int cfl_kvlist_insert_s(struct cfl_kvlist *list,
     if (cfl_container_move_variant_to_kvlist(list, value) != 0) {
         cfl_sds_destroy(pair->key);
         if (list->arena == NULL) {
-            free(pair);
+            cfl_object_cache_free(pair, sizeof(struct cfl_kvpair));
         }
         else {
             cfl_arena_free_kvpair(list->arena, pair,
@@ -705,6 +706,11 @@ int cfl_kvlist_count(struct cfl_kvlist *list)
 }
 
 int cfl_kvlist_print(FILE *fp, struct cfl_kvlist *list)
+{
+    return cfl_kvlist_print_ex(fp, list, CFL_VARIANT_PRINT_BYTES_RAW_HEX);
+}
+
+int cfl_kvlist_print_ex(FILE *fp, struct cfl_kvlist *list, int bytes_format)
 {
     size_t key_size;
     int printed;
@@ -744,7 +750,7 @@ int cfl_kvlist_print(FILE *fp, struct cfl_kvlist *list)
             return -1;
         }
 
-        ret = cfl_variant_print(fp, pair->val);
+        ret = cfl_variant_print_ex(fp, pair->val, bytes_format);
         if (ret < 0) {
             return -1;
         }
@@ -843,7 +849,7 @@ void cfl_kvpair_destroy(struct cfl_kvpair *pair)
         }
 
         if (pair->arena == NULL) {
-            free(pair);
+            cfl_object_cache_free(pair, sizeof(struct cfl_kvpair));
         }
         else {
             cfl_arena_free_kvpair(pair->arena, pair,
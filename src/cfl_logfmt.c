@@ -0,0 +1,303 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_logfmt.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfl_number_internal.h"
+#include "cfl_scan_internal.h"
+
+struct logfmt_parser {
+    const char *line;
+    size_t length;
+    struct cfl_scan delimiters;     /* ' ', '\t' and '=' */
+    struct cfl_scan quotes;         /* '"' and '\\' */
+};
+
+static int is_space(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/* 'value' must hold 'length' bytes */
+static size_t unescape(char *value, const char *input, size_t length)
+{
+    size_t index;
+    size_t run;
+    size_t size = 0;
+
+    index = 0;
+    while (index < length) {
+        run = cfl_scan_find(input + index, length - index, '\\', '\\', '\\');
+        memcpy(value + size, input + index, run);
+        size += run;
+        index += run;
+        if (index + 1 >= length) {
+            break;
+        }
+
+        switch (input[index + 1]) {
+        case '"':
+        case '\\':
+            value[size++] = input[index + 1];
+            break;
+        case 'n':
+            value[size++] = '\n';
+            break;
+        case 'r':
+            value[size++] = '\r';
+            break;
+        case 't':
+            value[size++] = '\t';
+            break;
+        default:
+            value[size++] = '\\';
+            value[size++] = input[index + 1];
+            break;
+        }
+        index += 2;
+    }
+
+    return size;
+}
+
+static int insert_escaped(struct cfl_kvlist *list,
+                          const char *key, size_t key_length,
+                          const char *value, size_t length)
+{
+    cfl_sds_t buffer;
+    struct cfl_variant *variant;
+
+    if (length > INT_MAX) {
+        return -1;
+    }
+
+    buffer = cfl_sds_create_len_in(list->arena, NULL, (int) length);
+    if (buffer == NULL) {
+        return -1;
+    }
+    cfl_sds_len_set(buffer, unescape(buffer, value, length));
+
+    variant = cfl_variant_create_in(list->arena);
+    if (variant == NULL) {
+        cfl_sds_destroy(buffer);
+        return -1;
+    }
+    variant->type = CFL_VARIANT_STRING;
+    variant->referenced = CFL_FALSE;
+    variant->data.as_string = buffer;
+    variant->size = cfl_sds_len(buffer);
+
+    if (cfl_kvlist_insert_s(list, (char *) key, key_length, variant) != 0) {
+        cfl_variant_destroy(variant);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int insert_value(struct cfl_kvlist *list,
+                        const char *key, size_t key_length,
+                        const char *value, size_t length, int flags)
+{
+    struct cfl_number number;
+
+    if ((flags & CFL_LOGFMT_INFER_TYPES) && length > 0) {
+        if (length == 4 && memcmp(value, "true", 4) == 0) {
+            return cfl_kvlist_insert_bool_s(list, (char *) key, key_length,
+                                            CFL_TRUE);
+        }
+        if (length == 5 && memcmp(value, "false", 5) == 0) {
+            return cfl_kvlist_insert_bool_s(list, (char *) key, key_length,
+                                            CFL_FALSE);
+        }
+
+        if (cfl_number_parse(value, length, &number) == 0) {
+            if (number.type == CFL_VARIANT_INT) {
+                return cfl_kvlist_insert_int64_s(list, (char *) key, key_length,
+                                                 number.data.as_int64);
+            }
+            else if (number.type == CFL_VARIANT_UINT) {
+                return cfl_kvlist_insert_uint64_s(list, (char *) key, key_length,
+                                                  number.data.as_uint64);
+            }
+            return cfl_kvlist_insert_double_s(list, (char *) key, key_length,
+                                              number.data.as_double);
+        }
+    }
+
+    return cfl_kvlist_insert_string_s(list, (char *) key, key_length,
+                                      (char *) value, length,
+                                      !(flags & CFL_LOGFMT_COPY));
+}
+
+static int insert_null(struct cfl_kvlist *list,
+                       const char *key, size_t key_length)
+{
+    struct cfl_variant *variant;
+
+    variant = cfl_variant_create_from_null_in(list->arena);
+    if (variant == NULL) {
+        return -1;
+    }
+
+    if (cfl_kvlist_insert_s(list, (char *) key, key_length, variant) != 0) {
+        cfl_variant_destroy(variant);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* parse the quoted value starting at the opening quote at 'offset' */
+static int decode_quoted(struct logfmt_parser *parser, size_t *offset,
+                         struct cfl_kvlist *list,
+                         const char *key, size_t key_length, int flags)
+{
+    int escapes = CFL_FALSE;
+    size_t start;
+    size_t end;
+    const char *line = parser->line;
+
+    start = *offset + 1;
+    end = start;
+    while ((end = cfl_scan_next(&parser->quotes, end)) < parser->length) {
+        if (line[end] == '"') {
+            break;
+        }
+
+        /* a backslash escapes the byte after it */
+        escapes = CFL_TRUE;
+        end += 2;
+    }
+
+    if (end >= parser->length) {
+        /* the closing quote is missing */
+        return -1;
+    }
+
+    /* the closing quote ends the pair */
+    if (end + 1 < parser->length && !is_space(line[end + 1])) {
+        return -1;
+    }
+    *offset = end + 1;
+
+    if (escapes) {
+        return insert_escaped(list, key, key_length,
+                              line + start, end - start);
+    }
+
+    return cfl_kvlist_insert_string_s(list, (char *) key, key_length,
+                                      (char *) line + start, end - start,
+                                      !(flags & CFL_LOGFMT_COPY));
+}
+
+int cfl_logfmt_decode(struct cfl_kvlist *list,
+                      const char *line, size_t length, int flags)
+{
+    int ret;
+    size_t offset;
+    size_t end;
+    size_t key_length;
+    const char *key;
+    struct logfmt_parser parser;
+
+    if (list == NULL || (line == NULL && length > 0)) {
+        return -1;
+    }
+
+    parser.line = line;
+    parser.length = length;
+    cfl_scan_init(&parser.delimiters, line, length, ' ', '\t', '=');
+    cfl_scan_init(&parser.quotes, line, length, '"', '\\', '\\');
+
+    offset = 0;
+    while (CFL_TRUE) {
+        while (offset < length && is_space(line[offset])) {
+            offset++;
+        }
+        if (offset == length) {
+            break;
+        }
+
+        if (line[offset] == '=' || line[offset] == '"') {
+            return -1;
+        }
+
+        /* the key ends at '=' or at a space for a key without value */
+        key = line + offset;
+        end = cfl_scan_next(&parser.delimiters, offset);
+        key_length = end - offset;
+
+        if (end == length || line[end] != '=') {
+            if (insert_null(list, key, key_length) != 0) {
+                return -1;
+            }
+            offset = end;
+            continue;
+        }
+        offset = end + 1;
+
+        if (offset < length && line[offset] == '"') {
+            ret = decode_quoted(&parser, &offset, list, key, key_length,
+                                flags);
+        }
+        else {
+            /* unquoted values may contain '=' */
+            end = offset;
+            while ((end = cfl_scan_next(&parser.delimiters, end)) < length &&
+                   line[end] == '=') {
+                end++;
+            }
+
+            ret = insert_value(list, key, key_length,
+                               line + offset, end - offset, flags);
+            offset = end;
+        }
+
+        if (ret != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+struct cfl_kvlist *cfl_logfmt_parse(struct cfl_arena *arena,
+                                    const char *line, size_t length,
+                                    int flags)
+{
+    struct cfl_kvlist *list;
+
+    list = cfl_kvlist_create_in(arena);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    if (cfl_logfmt_decode(list, line, length, flags) != 0) {
+        cfl_kvlist_destroy(list);
+        return NULL;
+    }
+
+    return list;
+}
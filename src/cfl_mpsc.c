@@ -0,0 +1,123 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl_mpsc.h>
+
+/* node links are read and written by several threads */
+#define NEXT(node) ((void **) &(node)->next)
+
+void cfl_mpsc_queue_init(struct cfl_mpsc_queue *queue)
+{
+    cfl_atomic_ptr_store_explicit(NEXT(&queue->stub), NULL, CFL_ATOMIC_RELAXED);
+    cfl_atomic_ptr_store_explicit((void **) &queue->head, &queue->stub,
+                                  CFL_ATOMIC_RELAXED);
+    queue->tail = &queue->stub;
+}
+
+void cfl_mpsc_queue_push(struct cfl_mpsc_queue *queue,
+                         struct cfl_mpsc_node *node)
+{
+    struct cfl_mpsc_node *previous;
+
+    cfl_atomic_ptr_store_explicit(NEXT(node), NULL, CFL_ATOMIC_RELAXED);
+
+    /* claim the head, then link the previous head to the new node */
+    previous = cfl_atomic_ptr_exchange_explicit((void **) &queue->head, node,
+                                                CFL_ATOMIC_ACQ_REL);
+    cfl_atomic_ptr_store_explicit(NEXT(previous), node, CFL_ATOMIC_RELEASE);
+}
+
+struct cfl_mpsc_node *cfl_mpsc_queue_pop(struct cfl_mpsc_queue *queue)
+{
+    struct cfl_mpsc_node *tail;
+    struct cfl_mpsc_node *next;
+    struct cfl_mpsc_node *head;
+
+    tail = queue->tail;
+    next = cfl_atomic_ptr_load_explicit(NEXT(tail), CFL_ATOMIC_ACQUIRE);
+
+    /* skip the stub, it is never handed out */
+    if (tail == &queue->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+
+        queue->tail = next;
+        tail = next;
+        next = cfl_atomic_ptr_load_explicit(NEXT(tail), CFL_ATOMIC_ACQUIRE);
+    }
+
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    head = cfl_atomic_ptr_load_explicit((void **) &queue->head,
+                                        CFL_ATOMIC_ACQUIRE);
+
+    /* a producer claimed the head but has not linked its node yet */
+    if (tail != head) {
+        return NULL;
+    }
+
+    /*
+     * 'tail' is the last node and producers still link to it: queue the
+     * stub behind it so it can be handed out.
+     */
+    cfl_mpsc_queue_push(queue, &queue->stub);
+
+    next = cfl_atomic_ptr_load_explicit(NEXT(tail), CFL_ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
+
+size_t cfl_mpsc_queue_pop_batch(struct cfl_mpsc_queue *queue,
+                                struct cfl_mpsc_node **nodes, size_t count)
+{
+    size_t                index;
+    struct cfl_mpsc_node *node;
+
+    for (index = 0; index < count; index++) {
+        node = cfl_mpsc_queue_pop(queue);
+        if (node == NULL) {
+            break;
+        }
+        nodes[index] = node;
+    }
+
+    return index;
+}
+
+int cfl_mpsc_queue_is_empty(struct cfl_mpsc_queue *queue)
+{
+    struct cfl_mpsc_node *head;
+
+    if (queue->tail != &queue->stub) {
+        return CFL_FALSE;
+    }
+
+    head = cfl_atomic_ptr_load_explicit((void **) &queue->head,
+                                        CFL_ATOMIC_ACQUIRE);
+
+    return head == &queue->stub;
+}
@@ -0,0 +1,29 @@
+#ifndef CFL_NUMBER_INTERNAL_H
+#define CFL_NUMBER_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Result of cfl_number_parse(): 'type' is CFL_VARIANT_INT, CFL_VARIANT_UINT
+ * or CFL_VARIANT_DOUBLE, whichever is the narrowest to hold the value.
+ */
+struct cfl_number {
+    int type;
+    union {
+        int64_t as_int64;
+        uint64_t as_uint64;
+        double as_double;
+    } data;
+};
+
+/*
+ * Parse a decimal number, an optional sign, digits, an optional fraction
+ * and exponent, spanning exactly 'length' bytes. Integers that fit become
+ * INT, or UINT above INT64_MAX; everything else becomes DOUBLE. Returns 0,
+ * or -1 when the text is not a number.
+ */
+int cfl_number_parse(const char *text, size_t length,
+                     struct cfl_number *number);
+
+#endif
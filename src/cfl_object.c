@@ -33,7 +33,7 @@ struct cfl_object *cfl_object_create()
 {
     struct cfl_object *o;
 
-    o = calloc(1, sizeof(struct cfl_object));
+    o = cfl_calloc(1, sizeof(struct cfl_object));
     if (!o) {
         cfl_errno();
         return NULL;
@@ -166,5 +166,5 @@ void cfl_object_destroy(struct cfl_object *o)
         cfl_variant_destroy(o->variant);
     }
 
-    free(o);
+    cfl_free(o);
 }
@@ -0,0 +1,210 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_object_cache.h>
+
+#include "cfl_object_cache_internal.h"
+
+#ifdef CFL_HAVE_OBJECT_CACHE
+
+#include "cfl_thread_internal.h"
+
+#define OBJECT_CACHE_CLASSES   (CFL_OBJECT_CACHE_MAX_SIZE >> 4)
+
+struct object_cache_block {
+    struct object_cache_block *next;
+};
+
+struct object_cache {
+    int registered;
+    size_t size;
+    size_t count[OBJECT_CACHE_CLASSES + 1];
+    struct object_cache_block *blocks[OBJECT_CACHE_CLASSES + 1];
+};
+
+static CFL_THREAD_LOCAL struct object_cache thread_cache;
+
+static void object_cache_release(struct object_cache *cache)
+{
+    size_t index;
+    struct object_cache_block *block;
+
+    for (index = 1 ; index <= OBJECT_CACHE_CLASSES ; index++) {
+        while (cache->blocks[index] != NULL) {
+            block = cache->blocks[index];
+            cache->blocks[index] = block->next;
+            cfl_free_sized(block, index << 4);
+        }
+        cache->count[index] = 0;
+    }
+    cache->size = 0;
+}
+
+/*
+ * The thread exit hook holds a pointer to the thread's cache; a cache that
+ * is used again by a later destructor registers itself once more.
+ */
+#if defined(_WIN32)
+static INIT_ONCE object_cache_once = INIT_ONCE_STATIC_INIT;
+static DWORD object_cache_key = FLS_OUT_OF_INDEXES;
+
+static void WINAPI object_cache_thread_exit(void *data)
+{
+    struct object_cache *cache = data;
+
+    if (cache != NULL) {
+        object_cache_release(cache);
+        cache->registered = 0;
+    }
+}
+
+static BOOL CALLBACK object_cache_key_create(INIT_ONCE *once, void *parameter,
+                                             void **context)
+{
+    object_cache_key = FlsAlloc(object_cache_thread_exit);
+    return TRUE;
+}
+
+static int object_cache_register(struct object_cache *cache)
+{
+    InitOnceExecuteOnce(&object_cache_once, object_cache_key_create,
+                        NULL, NULL);
+    if (object_cache_key == FLS_OUT_OF_INDEXES ||
+        !FlsSetValue(object_cache_key, cache)) {
+        return -1;
+    }
+
+    return 0;
+}
+#else
+static pthread_once_t object_cache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t object_cache_key;
+static int object_cache_key_status = -1;
+
+static void object_cache_thread_exit(void *data)
+{
+    struct object_cache *cache = data;
+
+    object_cache_release(cache);
+    cache->registered = 0;
+}
+
+static void object_cache_key_create()
+{
+    object_cache_key_status = pthread_key_create(&object_cache_key,
+                                                 object_cache_thread_exit);
+}
+
+static int object_cache_register(struct object_cache *cache)
+{
+    pthread_once(&object_cache_once, object_cache_key_create);
+    if (object_cache_key_status != 0 ||
+        pthread_setspecific(object_cache_key, cache) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+void *cfl_object_cache_alloc(size_t size)
+{
+    size_t index;
+    struct object_cache *cache;
+    struct object_cache_block *block;
+
+    index = cfl_object_cache_class(size);
+    if (index == 0) {
+        return cfl_malloc(size);
+    }
+
+    cache = &thread_cache;
+    block = cache->blocks[index];
+    if (block == NULL) {
+        return cfl_malloc(index << 4);
+    }
+
+    cache->blocks[index] = block->next;
+    cache->count[index]--;
+    cache->size -= index << 4;
+
+    return block;
+}
+
+void cfl_object_cache_free(void *ptr, size_t size)
+{
+    size_t index;
+    struct object_cache *cache;
+    struct object_cache_block *block;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    index = cfl_object_cache_class(size);
+    if (index == 0) {
+        cfl_free_sized(ptr, size);
+        return;
+    }
+
+    cache = &thread_cache;
+    if ((cache->count[index] + 1) * (index << 4) >
+        CFL_OBJECT_CACHE_CLASS_BYTES) {
+        cfl_free_sized(ptr, index << 4);
+        return;
+    }
+
+    if (!cache->registered) {
+        if (object_cache_register(cache) != 0) {
+            cfl_free_sized(ptr, index << 4);
+            return;
+        }
+        cache->registered = 1;
+    }
+
+    block = ptr;
+    block->next = cache->blocks[index];
+    cache->blocks[index] = block;
+    cache->count[index]++;
+    cache->size += index << 4;
+}
+
+void cfl_object_cache_flush()
+{
+    object_cache_release(&thread_cache);
+}
+
+size_t cfl_object_cache_size()
+{
+    return thread_cache.size;
+}
+
+#else
+
+void cfl_object_cache_flush()
+{
+}
+
+size_t cfl_object_cache_size()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef CFL_OBJECT_CACHE_INTERNAL_H
+#define CFL_OBJECT_CACHE_INTERNAL_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_allocator.h>
+#include <cfl/cfl_object_cache.h>
+
+/*
+ * Per-thread free lists of heap objects up to CFL_OBJECT_CACHE_MAX_SIZE
+ * bytes in 16-byte size classes. cfl_object_cache_alloc() returns a block
+ * of the class size, and the caller passes the same 'size' to
+ * cfl_object_cache_free(); a block freed by another thread than the one
+ * that allocated it goes to the freeing thread's cache. Each class keeps
+ * up to CFL_OBJECT_CACHE_CLASS_BYTES bytes and the rest goes back to
+ * the allocator. Without CFL_HAVE_OBJECT_CACHE these are cfl_malloc() and
+ * cfl_free_sized().
+ */
+#define CFL_OBJECT_CACHE_MAX_SIZE     256
+#define CFL_OBJECT_CACHE_CLASS_BYTES  16384
+
+#ifdef CFL_HAVE_OBJECT_CACHE
+
+/* the class 'size' falls in, 0 when it is not cached */
+static inline size_t cfl_object_cache_class(size_t size)
+{
+    if (size == 0 || size > CFL_OBJECT_CACHE_MAX_SIZE) {
+        return 0;
+    }
+
+    return (size + 15) >> 4;
+}
+
+void *cfl_object_cache_alloc(size_t size);
+void cfl_object_cache_free(void *ptr, size_t size);
+
+#else
+
+#define cfl_object_cache_class(size)       ((size_t) 0)
+#define cfl_object_cache_alloc(size)       cfl_malloc(size)
+#define cfl_object_cache_free(ptr, size)   cfl_free_sized(ptr, size)
+
+#endif
+
+#endif
@@ -0,0 +1,621 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_otlp.h>
+
+#include <string.h>
+
+#include "cfl_otlp_internal.h"
+#include "cfl_size_cache_internal.h"
+
+#define OTLP_WIRE_VARINT     0
+#define OTLP_WIRE_FIXED64    1
+#define OTLP_WIRE_LEN        2
+
+/* AnyValue */
+#define OTLP_ANY_STRING      1
+#define OTLP_ANY_BOOL        2
+#define OTLP_ANY_INT         3
+#define OTLP_ANY_DOUBLE      4
+#define OTLP_ANY_ARRAY       5
+#define OTLP_ANY_KVLIST      6
+#define OTLP_ANY_BYTES       7
+
+/* ArrayValue.values and KeyValueList.values */
+#define OTLP_VALUES          1
+
+/* KeyValue */
+#define OTLP_KEY_VALUE_KEY   1
+#define OTLP_KEY_VALUE_VALUE 2
+
+#define OTLP_MAX_FIELD_NUMBER ((UINT32_C(1) << 29) - 1)
+
+/*
+ * The encoder writes from the end of the output towards its start. Once a
+ * nested message has been written its length is known, so the length prefix
+ * and tag are emitted in front of it without a second sizing pass.
+ */
+struct otlp_writer {
+    char *start;
+    char *cursor;
+};
+
+static size_t varint_size(uint64_t value)
+{
+    size_t size;
+
+    size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+static size_t tag_size(uint32_t field_number)
+{
+    return varint_size((uint64_t) field_number << 3);
+}
+
+static int size_add(size_t *total, size_t value)
+{
+    if (*total > SIZE_MAX - value) {
+        return -1;
+    }
+
+    *total += value;
+
+    return 0;
+}
+
+static int size_add_length_delimited(size_t *total, uint32_t field_number,
+                                     size_t length)
+{
+    if (size_add(total, tag_size(field_number)) != 0 ||
+        size_add(total, varint_size(length)) != 0 ||
+        size_add(total, length) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int any_value_size(struct cfl_variant *value,
+                          struct cfl_size_cache *cache, size_t depth,
+                          size_t *size);
+
+/*
+ * Only bodies of field 1 (ArrayValue and KeyValueList) are cached, that is
+ * the size every nested container contributes to its parent.
+ */
+static int array_values_size(struct cfl_array *array, uint32_t field_number,
+                             struct cfl_size_cache *cache, size_t depth,
+                             size_t *size)
+{
+    size_t index;
+    size_t total;
+    size_t entry_size;
+
+    if (depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    if (field_number == OTLP_VALUES &&
+        cfl_size_cache_lookup(cache, array, CFL_VARIANT_FORMAT_OTLP,
+                              size) == 0) {
+        return 0;
+    }
+
+    total = 0;
+    for (index = 0; index < array->entry_count; index++) {
+        if (any_value_size(array->entries[index], cache, depth + 1,
+                           &entry_size) != 0 ||
+            size_add_length_delimited(&total, field_number,
+                                      entry_size) != 0) {
+            return -1;
+        }
+    }
+
+    if (field_number == OTLP_VALUES) {
+        cfl_size_cache_store(cache, array, CFL_VARIANT_FORMAT_OTLP, total);
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static int key_values_size(struct cfl_kvlist *kvlist, uint32_t field_number,
+                           struct cfl_size_cache *cache, size_t depth,
+                           size_t *size)
+{
+    size_t total;
+    size_t pair_size;
+    size_t value_size;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+
+    if (depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    if (field_number == OTLP_VALUES &&
+        cfl_size_cache_lookup(cache, kvlist, CFL_VARIANT_FORMAT_OTLP,
+                              size) == 0) {
+        return 0;
+    }
+
+    total = 0;
+    cfl_list_foreach(head, &kvlist->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (pair->key == NULL || pair->val == NULL) {
+            continue;
+        }
+
+        pair_size = 0;
+        if (size_add_length_delimited(&pair_size, OTLP_KEY_VALUE_KEY,
+                                      cfl_sds_len(pair->key)) != 0 ||
+            any_value_size(pair->val, cache, depth + 1, &value_size) != 0 ||
+            size_add_length_delimited(&pair_size, OTLP_KEY_VALUE_VALUE,
+                                      value_size) != 0 ||
+            size_add_length_delimited(&total, field_number,
+                                      pair_size) != 0) {
+            return -1;
+        }
+    }
+
+    if (field_number == OTLP_VALUES) {
+        cfl_size_cache_store(cache, kvlist, CFL_VARIANT_FORMAT_OTLP, total);
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static int any_value_size(struct cfl_variant *value,
+                          struct cfl_size_cache *cache, size_t depth,
+                          size_t *size)
+{
+    size_t nested;
+    size_t total;
+    int field_number;
+
+    if (value == NULL || depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    total = 0;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        if (value->data.as_string == NULL && value->size > 0) {
+            return -1;
+        }
+        field_number = OTLP_ANY_STRING;
+        if (value->type == CFL_VARIANT_BYTES) {
+            field_number = OTLP_ANY_BYTES;
+        }
+        if (size_add_length_delimited(&total, field_number,
+                                      value->size) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_BOOL:
+        total = tag_size(OTLP_ANY_BOOL) + 1;
+        break;
+    case CFL_VARIANT_INT:
+        total = tag_size(OTLP_ANY_INT) +
+                varint_size((uint64_t) value->data.as_int64);
+        break;
+    case CFL_VARIANT_UINT:
+        total = tag_size(OTLP_ANY_INT) + varint_size(value->data.as_uint64);
+        break;
+    case CFL_VARIANT_DOUBLE:
+        total = tag_size(OTLP_ANY_DOUBLE) + sizeof(uint64_t);
+        break;
+    case CFL_VARIANT_ARRAY:
+        if (value->data.as_array == NULL ||
+            array_values_size(value->data.as_array, OTLP_VALUES,
+                              cache, depth + 1, &nested) != 0 ||
+            size_add_length_delimited(&total, OTLP_ANY_ARRAY, nested) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL ||
+            key_values_size(value->data.as_kvlist, OTLP_VALUES,
+                            cache, depth + 1, &nested) != 0 ||
+            size_add_length_delimited(&total, OTLP_ANY_KVLIST, nested) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        break;
+    default:
+        return -1;
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static int writer_bytes(struct otlp_writer *writer,
+                        const void *data, size_t length)
+{
+    if ((size_t) (writer->cursor - writer->start) < length) {
+        return -1;
+    }
+
+    writer->cursor -= length;
+    if (length > 0) {
+        memcpy(writer->cursor, data, length);
+    }
+
+    return 0;
+}
+
+static int writer_varint(struct otlp_writer *writer, uint64_t value)
+{
+    size_t length;
+    unsigned char *out;
+
+    length = varint_size(value);
+    if ((size_t) (writer->cursor - writer->start) < length) {
+        return -1;
+    }
+
+    writer->cursor -= length;
+    out = (unsigned char *) writer->cursor;
+    while (value >= 0x80) {
+        *out++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    *out = (unsigned char) value;
+
+    return 0;
+}
+
+static int writer_tag(struct otlp_writer *writer, uint32_t field_number,
+                      int wire_type)
+{
+    return writer_varint(writer, ((uint64_t) field_number << 3) | wire_type);
+}
+
+static int writer_fixed64(struct otlp_writer *writer, uint64_t value)
+{
+    unsigned char out[8];
+    int index;
+
+    for (index = 0; index < 8; index++) {
+        out[index] = (unsigned char) (value >> (index * 8));
+    }
+
+    return writer_bytes(writer, out, sizeof(out));
+}
+
+/* Prefix the bytes written since 'end' with their length and field tag. */
+static int writer_close_message(struct otlp_writer *writer, char *end,
+                                uint32_t field_number)
+{
+    if (writer_varint(writer, (uint64_t) (end - writer->cursor)) != 0 ||
+        writer_tag(writer, field_number, OTLP_WIRE_LEN) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int any_value_write(struct otlp_writer *writer,
+                           struct cfl_variant *value, size_t depth);
+
+static int array_values_write(struct otlp_writer *writer,
+                              struct cfl_array *array,
+                              uint32_t field_number, size_t depth)
+{
+    size_t index;
+    char *end;
+
+    if (depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    for (index = array->entry_count; index > 0; index--) {
+        end = writer->cursor;
+        if (any_value_write(writer, array->entries[index - 1],
+                            depth + 1) != 0 ||
+            writer_close_message(writer, end, field_number) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int key_values_write(struct otlp_writer *writer,
+                            struct cfl_kvlist *kvlist,
+                            uint32_t field_number, size_t depth)
+{
+    char *pair_end;
+    char *value_end;
+    size_t key_size;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+
+    if (depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    cfl_list_foreach_r(head, &kvlist->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (pair->key == NULL || pair->val == NULL) {
+            continue;
+        }
+
+        pair_end = writer->cursor;
+
+        value_end = writer->cursor;
+        if (any_value_write(writer, pair->val, depth + 1) != 0 ||
+            writer_close_message(writer, value_end,
+                                 OTLP_KEY_VALUE_VALUE) != 0) {
+            return -1;
+        }
+
+        key_size = cfl_sds_len(pair->key);
+        if (writer_bytes(writer, pair->key, key_size) != 0 ||
+            writer_varint(writer, key_size) != 0 ||
+            writer_tag(writer, OTLP_KEY_VALUE_KEY, OTLP_WIRE_LEN) != 0) {
+            return -1;
+        }
+
+        if (writer_close_message(writer, pair_end, field_number) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int any_value_write(struct otlp_writer *writer,
+                           struct cfl_variant *value, size_t depth)
+{
+    char *end;
+    uint64_t bits;
+    int field_number;
+
+    if (value == NULL || depth > CFL_OTLP_MAX_DEPTH) {
+        return -1;
+    }
+
+    end = writer->cursor;
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        if (value->data.as_string == NULL && value->size > 0) {
+            return -1;
+        }
+        field_number = OTLP_ANY_STRING;
+        if (value->type == CFL_VARIANT_BYTES) {
+            field_number = OTLP_ANY_BYTES;
+        }
+        if (writer_bytes(writer, value->data.as_string, value->size) != 0 ||
+            writer_varint(writer, value->size) != 0 ||
+            writer_tag(writer, field_number, OTLP_WIRE_LEN) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_BOOL:
+        if (writer_varint(writer, value->data.as_bool ? 1 : 0) != 0 ||
+            writer_tag(writer, OTLP_ANY_BOOL, OTLP_WIRE_VARINT) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_INT:
+        if (writer_varint(writer, (uint64_t) value->data.as_int64) != 0 ||
+            writer_tag(writer, OTLP_ANY_INT, OTLP_WIRE_VARINT) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_UINT:
+        if (writer_varint(writer, value->data.as_uint64) != 0 ||
+            writer_tag(writer, OTLP_ANY_INT, OTLP_WIRE_VARINT) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_DOUBLE:
+        memcpy(&bits, &value->data.as_double, sizeof(bits));
+        if (writer_fixed64(writer, bits) != 0 ||
+            writer_tag(writer, OTLP_ANY_DOUBLE, OTLP_WIRE_FIXED64) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_ARRAY:
+        if (value->data.as_array == NULL ||
+            array_values_write(writer, value->data.as_array, OTLP_VALUES,
+                               depth + 1) != 0 ||
+            writer_close_message(writer, end, OTLP_ANY_ARRAY) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL ||
+            key_values_write(writer, value->data.as_kvlist, OTLP_VALUES,
+                             depth + 1) != 0 ||
+            writer_close_message(writer, end, OTLP_ANY_KVLIST) != 0) {
+            return -1;
+        }
+        break;
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
+
+static int field_number_valid(uint32_t field_number)
+{
+    return field_number > 0 && field_number <= OTLP_MAX_FIELD_NUMBER;
+}
+
+static int writer_init(struct otlp_writer *writer, char *buffer,
+                       size_t buffer_size, size_t size)
+{
+    if ((buffer == NULL && size > 0) || size > buffer_size) {
+        return -1;
+    }
+
+    writer->start = buffer;
+    writer->cursor = buffer + size;
+
+    return 0;
+}
+
+static int writer_finish(struct otlp_writer *writer, size_t size,
+                         size_t *encoded_size)
+{
+    /* the sizing pass and the writer must agree byte for byte */
+    if (writer->cursor != writer->start) {
+        return -1;
+    }
+
+    if (encoded_size != NULL) {
+        *encoded_size = size;
+    }
+
+    return 0;
+}
+
+int cfl_otlp_any_value_size(struct cfl_variant *value, size_t *size)
+{
+    if (size == NULL) {
+        return -1;
+    }
+
+    return any_value_size(value, NULL, 0, size);
+}
+
+int cfl_otlp_any_value_encode(struct cfl_variant *value,
+                              char *buffer, size_t buffer_size,
+                              size_t *encoded_size)
+{
+    size_t size;
+    struct otlp_writer writer;
+
+    if (any_value_size(value, NULL, 0, &size) != 0 ||
+        writer_init(&writer, buffer, buffer_size, size) != 0 ||
+        any_value_write(&writer, value, 0) != 0) {
+        return -1;
+    }
+
+    return writer_finish(&writer, size, encoded_size);
+}
+
+int cfl_otlp_array_values_size(struct cfl_array *array,
+                               uint32_t field_number, size_t *size)
+{
+    if (array == NULL || size == NULL || !field_number_valid(field_number)) {
+        return -1;
+    }
+
+    return array_values_size(array, field_number, NULL, 0, size);
+}
+
+int cfl_otlp_array_values_encode(struct cfl_array *array,
+                                 uint32_t field_number,
+                                 char *buffer, size_t buffer_size,
+                                 size_t *encoded_size)
+{
+    size_t size;
+    struct otlp_writer writer;
+
+    if (cfl_otlp_array_values_size(array, field_number, &size) != 0 ||
+        writer_init(&writer, buffer, buffer_size, size) != 0 ||
+        array_values_write(&writer, array, field_number, 0) != 0) {
+        return -1;
+    }
+
+    return writer_finish(&writer, size, encoded_size);
+}
+
+int cfl_otlp_key_values_size(struct cfl_kvlist *kvlist,
+                             uint32_t field_number, size_t *size)
+{
+    if (kvlist == NULL || size == NULL || !field_number_valid(field_number)) {
+        return -1;
+    }
+
+    return key_values_size(kvlist, field_number, NULL, 0, size);
+}
+
+int cfl_otlp_key_values_encode(struct cfl_kvlist *kvlist,
+                               uint32_t field_number,
+                               char *buffer, size_t buffer_size,
+                               size_t *encoded_size)
+{
+    size_t size;
+    struct otlp_writer writer;
+
+    if (cfl_otlp_key_values_size(kvlist, field_number, &size) != 0 ||
+        writer_init(&writer, buffer, buffer_size, size) != 0 ||
+        key_values_write(&writer, kvlist, field_number, 0) != 0) {
+        return -1;
+    }
+
+    return writer_finish(&writer, size, encoded_size);
+}
+
+int cfl_otlp_any_value_size_cached(struct cfl_variant *value,
+                                   struct cfl_size_cache *cache,
+                                   size_t *size)
+{
+    if (size == NULL) {
+        return -1;
+    }
+
+    return any_value_size(value, cache, 0, size);
+}
+
+int cfl_otlp_array_values_size_cached(struct cfl_array *array,
+                                      struct cfl_size_cache *cache,
+                                      size_t *size)
+{
+    if (array == NULL || size == NULL) {
+        return -1;
+    }
+
+    return array_values_size(array, OTLP_VALUES, cache, 0, size);
+}
+
+int cfl_otlp_key_values_size_cached(struct cfl_kvlist *kvlist,
+                                    struct cfl_size_cache *cache,
+                                    size_t *size)
+{
+    if (kvlist == NULL || size == NULL) {
+        return -1;
+    }
+
+    return key_values_size(kvlist, OTLP_VALUES, cache, 0, size);
+}
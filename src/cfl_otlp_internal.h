@@ -0,0 +1,20 @@
+#ifndef CFL_OTLP_INTERNAL_H
+#define CFL_OTLP_INTERNAL_H
+
+#include <stddef.h>
+
+#include <cfl/cfl_otlp.h>
+#include <cfl/cfl_size_cache.h>
+
+/* cfl_otlp_*_size() variants that consult and fill an optional size cache */
+int cfl_otlp_any_value_size_cached(struct cfl_variant *value,
+                                   struct cfl_size_cache *cache,
+                                   size_t *size);
+int cfl_otlp_array_values_size_cached(struct cfl_array *array,
+                                      struct cfl_size_cache *cache,
+                                      size_t *size);
+int cfl_otlp_key_values_size_cached(struct cfl_kvlist *kvlist,
+                                    struct cfl_size_cache *cache,
+                                    size_t *size);
+
+#endif
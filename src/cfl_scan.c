@@ -0,0 +1,222 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+
+#include "cfl_cpu_internal.h"
+#include "cfl_scan_internal.h"
+
+#if defined(CFL_CPU_X86_64)
+#include <emmintrin.h>
+#endif
+
+#if defined(CFL_CPU_AARCH64)
+#include <arm_neon.h>
+#endif
+
+static size_t population_count(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    mask = mask - ((mask >> 1) & 0x5555555555555555ULL);
+    mask = (mask & 0x3333333333333333ULL) +
+           ((mask >> 2) & 0x3333333333333333ULL);
+    mask = (mask + (mask >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+
+    return (size_t) ((mask * 0x0101010101010101ULL) >> 56);
+#else
+    return (size_t) __builtin_popcountll(mask);
+#endif
+}
+
+#if defined(CFL_CPU_X86_64)
+
+static uint64_t match16_sse2(const char *data, __m128i a, __m128i b, __m128i c)
+{
+    __m128i in;
+
+    in = _mm_loadu_si128((const __m128i *) data);
+
+    return (uint64_t) (unsigned int) _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, a),
+                                  _mm_cmpeq_epi8(in, b)),
+                     _mm_cmpeq_epi8(in, c)));
+}
+
+/* one bit per byte of the 64 bytes at 'data' */
+static uint64_t match64(const char *data, int a, int b, int c)
+{
+    __m128i va = _mm_set1_epi8((char) a);
+    __m128i vb = _mm_set1_epi8((char) b);
+    __m128i vc = _mm_set1_epi8((char) c);
+
+    return match16_sse2(data, va, vb, vc) |
+           match16_sse2(data + 16, va, vb, vc) << 16 |
+           match16_sse2(data + 32, va, vb, vc) << 32 |
+           match16_sse2(data + 48, va, vb, vc) << 48;
+}
+
+#elif defined(CFL_CPU_AARCH64)
+
+static uint8x16_t match16_neon(const char *data,
+                               uint8x16_t a, uint8x16_t b, uint8x16_t c)
+{
+    uint8x16_t in;
+
+    in = vld1q_u8((const uint8_t *) data);
+
+    return vorrq_u8(vorrq_u8(vceqq_u8(in, a), vceqq_u8(in, b)),
+                    vceqq_u8(in, c));
+}
+
+/* one bit per byte of the 64 bytes at 'data' */
+static uint64_t match64(const char *data, int a, int b, int c)
+{
+    uint8x16_t va = vdupq_n_u8((uint8_t) a);
+    uint8x16_t vb = vdupq_n_u8((uint8_t) b);
+    uint8x16_t vc = vdupq_n_u8((uint8_t) c);
+    static const uint8_t weights[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+    uint8x16_t bits;
+    uint8x16_t sum0;
+    uint8x16_t sum1;
+
+    /* keep one weighted bit per byte and fold pairwise to 8 bytes */
+    bits = vld1q_u8(weights);
+    sum0 = vpaddq_u8(vandq_u8(match16_neon(data, va, vb, vc), bits),
+                     vandq_u8(match16_neon(data + 16, va, vb, vc), bits));
+    sum1 = vpaddq_u8(vandq_u8(match16_neon(data + 32, va, vb, vc), bits),
+                     vandq_u8(match16_neon(data + 48, va, vb, vc), bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+#else
+
+static uint64_t match64(const char *data, int a, int b, int c)
+{
+    int index;
+    uint64_t mask = 0;
+
+    for (index = 0; index < 64; index++) {
+        if (data[index] == (char) a || data[index] == (char) b ||
+            data[index] == (char) c) {
+            mask |= (uint64_t) 1 << index;
+        }
+    }
+
+    return mask;
+}
+
+#endif
+
+/* mask of the 'length' (below 64) bytes at 'data' */
+static uint64_t match_tail(const char *data, size_t length,
+                           int a, int b, int c)
+{
+    char block[64];
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, data, length);
+
+    return match64(block, a, b, c) & (((uint64_t) 1 << length) - 1);
+}
+
+size_t cfl_scan_find(const char *data, size_t length, int a, int b, int c)
+{
+    size_t index;
+    uint64_t mask;
+
+    for (index = 0; index + 64 <= length; index += 64) {
+        mask = match64(data + index, a, b, c);
+        if (mask != 0) {
+            return index + cfl_scan_trailing_zeros(mask);
+        }
+    }
+
+    if (index < length) {
+        mask = match_tail(data + index, length - index, a, b, c);
+        if (mask != 0) {
+            return index + cfl_scan_trailing_zeros(mask);
+        }
+    }
+
+    return length;
+}
+
+size_t cfl_scan_count(const char *data, size_t length, int a, int b, int c)
+{
+    size_t index;
+    size_t count = 0;
+
+    for (index = 0; index + 64 <= length; index += 64) {
+        count += population_count(match64(data + index, a, b, c));
+    }
+
+    if (index < length) {
+        count += population_count(match_tail(data + index, length - index,
+                                             a, b, c));
+    }
+
+    return count;
+}
+
+void cfl_scan_init(struct cfl_scan *scan, const char *data, size_t length,
+                   int a, int b, int c)
+{
+    scan->data = data;
+    scan->length = length;
+    scan->a = a;
+    scan->b = b;
+    scan->c = c;
+
+    /* empty block, the first cfl_scan_next() refills */
+    scan->block = 0;
+    scan->mask = 0;
+}
+
+size_t cfl_scan_refill(struct cfl_scan *scan, size_t offset)
+{
+    uint64_t mask;
+
+    /* blocks start at the requested offset, loads are unaligned */
+    for (; offset + 64 <= scan->length; offset += 64) {
+        mask = match64(scan->data + offset, scan->a, scan->b, scan->c);
+        if (mask != 0) {
+            scan->block = offset;
+            scan->mask = mask;
+
+            return offset + cfl_scan_trailing_zeros(mask);
+        }
+    }
+
+    if (offset < scan->length) {
+        mask = match_tail(scan->data + offset, scan->length - offset,
+                          scan->a, scan->b, scan->c);
+        scan->block = offset;
+        scan->mask = mask;
+        if (mask != 0) {
+            return offset + cfl_scan_trailing_zeros(mask);
+        }
+    }
+
+    return scan->length;
+}
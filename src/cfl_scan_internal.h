@@ -0,0 +1,72 @@
+#ifndef CFL_SCAN_INTERNAL_H
+#define CFL_SCAN_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/*
+ * Byte classification kernels used by the tokenizers. A 64-byte block is
+ * compared against up to three byte values at once (SSE2 on x86-64, NEON on
+ * AArch64, a byte loop elsewhere) giving one mask bit per byte. Pass the
+ * same byte more than once to match fewer than three values.
+ */
+
+/* offset of the first byte equal to 'a', 'b' or 'c', or 'length' */
+size_t cfl_scan_find(const char *data, size_t length, int a, int b, int c);
+
+/* number of bytes equal to 'a', 'b' or 'c' */
+size_t cfl_scan_count(const char *data, size_t length, int a, int b, int c);
+
+/*
+ * Streaming scanner for tokenizers that look for the next match many times
+ * over the same buffer. The mask of the current block is kept so that short
+ * tokens cost a bit scan instead of a new search. Offsets passed to
+ * cfl_scan_next() must not decrease.
+ */
+struct cfl_scan {
+    const char *data;
+    size_t length;
+    size_t block;
+    uint64_t mask;
+    int a;
+    int b;
+    int c;
+};
+
+void cfl_scan_init(struct cfl_scan *scan, const char *data, size_t length,
+                   int a, int b, int c);
+size_t cfl_scan_refill(struct cfl_scan *scan, size_t offset);
+
+static inline int cfl_scan_trailing_zeros(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+
+    _BitScanForward64(&index, mask);
+
+    return (int) index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+/* offset of the next match at or after 'offset', or the buffer length */
+static inline size_t cfl_scan_next(struct cfl_scan *scan, size_t offset)
+{
+    uint64_t mask;
+
+    if (offset - scan->block < 64) {
+        mask = scan->mask & (~(uint64_t) 0 << (offset - scan->block));
+        if (mask != 0) {
+            return scan->block + cfl_scan_trailing_zeros(mask);
+        }
+    }
+
+    return cfl_scan_refill(scan, offset);
+}
+
+#endif
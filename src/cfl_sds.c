@@ -28,47 +28,146 @@
 #include <stdarg.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <float.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <cfl/cfl_sds.h>
 #include "cfl_arena_internal.h"
+#include "cfl_object_cache_internal.h"
 
-#define CFL_SDS_ARENA_FLAG (UINT64_C(1) << 63)
-#define CFL_SDS_ALLOC_MASK (~CFL_SDS_ARENA_FLAG)
-
+/* arena strings carry this header in front of the SDS header */
+#pragma pack(push, 1)
 struct cfl_sds_arena_header {
     struct cfl_arena *arena;
     uint8_t external;
     uint8_t allocation_class;
 };
+#pragma pack(pop)
+
+static int sds_type(size_t capacity)
+{
+    if (capacity <= UINT8_MAX) {
+        return CFL_SDS_TYPE_8;
+    }
+    if (capacity <= UINT16_MAX) {
+        return CFL_SDS_TYPE_16;
+    }
+    if (capacity <= UINT32_MAX) {
+        return CFL_SDS_TYPE_32;
+    }
+
+    return CFL_SDS_TYPE_64;
+}
+
+static size_t sds_type_header_size(int type)
+{
+    switch (type) {
+    case CFL_SDS_TYPE_8:
+        return sizeof(struct cfl_sds8);
+    case CFL_SDS_TYPE_16:
+        return sizeof(struct cfl_sds16);
+    case CFL_SDS_TYPE_32:
+        return sizeof(struct cfl_sds32);
+    default:
+        return sizeof(struct cfl_sds64);
+    }
+}
+
+#define SDS_HEAD(type, s) ((struct type *) ((s) - sizeof(struct type)))
+
+static size_t sds_get_len(cfl_sds_t s)
+{
+    switch (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) {
+    case CFL_SDS_TYPE_8:
+        return SDS_HEAD(cfl_sds8, s)->len;
+    case CFL_SDS_TYPE_16:
+        return SDS_HEAD(cfl_sds16, s)->len;
+    case CFL_SDS_TYPE_32:
+        return SDS_HEAD(cfl_sds32, s)->len;
+    default:
+        return (size_t) SDS_HEAD(cfl_sds64, s)->len;
+    }
+}
+
+static size_t sds_get_alloc(cfl_sds_t s)
+{
+    switch (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) {
+    case CFL_SDS_TYPE_8:
+        return SDS_HEAD(cfl_sds8, s)->alloc;
+    case CFL_SDS_TYPE_16:
+        return SDS_HEAD(cfl_sds16, s)->alloc;
+    case CFL_SDS_TYPE_32:
+        return SDS_HEAD(cfl_sds32, s)->alloc;
+    default:
+        return (size_t) SDS_HEAD(cfl_sds64, s)->alloc;
+    }
+}
+
+/* 'len' must not exceed the capacity */
+static void sds_put_len(cfl_sds_t s, size_t len)
+{
+    switch (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) {
+    case CFL_SDS_TYPE_8:
+        SDS_HEAD(cfl_sds8, s)->len = (uint8_t) len;
+        break;
+    case CFL_SDS_TYPE_16:
+        SDS_HEAD(cfl_sds16, s)->len = (uint16_t) len;
+        break;
+    case CFL_SDS_TYPE_32:
+        SDS_HEAD(cfl_sds32, s)->len = (uint32_t) len;
+        break;
+    default:
+        SDS_HEAD(cfl_sds64, s)->len = len;
+        break;
+    }
+}
+
+/* 'alloc' must fit the header width */
+static void sds_put_alloc(cfl_sds_t s, size_t alloc)
+{
+    switch (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) {
+    case CFL_SDS_TYPE_8:
+        SDS_HEAD(cfl_sds8, s)->alloc = (uint8_t) alloc;
+        break;
+    case CFL_SDS_TYPE_16:
+        SDS_HEAD(cfl_sds16, s)->alloc = (uint16_t) alloc;
+        break;
+    case CFL_SDS_TYPE_32:
+        SDS_HEAD(cfl_sds32, s)->alloc = (uint32_t) alloc;
+        break;
+    default:
+        SDS_HEAD(cfl_sds64, s)->alloc = alloc;
+        break;
+    }
+}
 
-static struct cfl_sds_arena_header *sds_arena_header(struct cfl_sds *head)
+static struct cfl_sds_arena_header *sds_arena_header(cfl_sds_t s)
 {
     return (struct cfl_sds_arena_header *)
-           ((char *) head - sizeof(struct cfl_sds_arena_header));
+           (s - cfl_sds_header_size(s) - sizeof(struct cfl_sds_arena_header));
 }
 
 size_t cfl_sds_avail(cfl_sds_t s)
 {
-    struct cfl_sds *h;
-
     if (s == NULL) {
         return 0;
     }
 
-    h = CFL_SDS_HEADER(s);
-    return (size_t) ((h->alloc & CFL_SDS_ALLOC_MASK) - h->len);
+    return sds_get_alloc(s) - sds_get_len(s);
 }
 
 static cfl_sds_t sds_alloc(struct cfl_arena *arena, size_t size)
 {
+    int type;
     void *buf;
     cfl_sds_t s;
-    struct cfl_sds *head;
     struct cfl_sds_arena_header *arena_head;
+    size_t header_size;
     size_t allocation_size;
     size_t external_threshold;
     size_t payload_capacity;
+    size_t class_size;
     uint8_t allocation_class;
 
     if (size > SIZE_MAX - CFL_SDS_HEADER_SIZE -
@@ -76,21 +175,29 @@ static cfl_sds_t sds_alloc(struct cfl_arena *arena, size_t size)
         return NULL;
     }
 
+    /* pooled arena slots get the header width of their class */
+    class_size = 0;
+    if (arena != NULL) {
+        class_size = cfl_arena_sds_class_size(size);
+    }
+    type = sds_type(class_size != 0 ? class_size : size);
+    header_size = sds_type_header_size(type);
+
     payload_capacity = size;
     allocation_class = 0;
-    allocation_size = CFL_SDS_HEADER_SIZE + size + 1;
+    allocation_size = header_size + size + 1;
     if (arena == NULL) {
-        buf = malloc(allocation_size);
+        buf = cfl_object_cache_alloc(allocation_size);
     }
-    else if (size <= 1024) {
+    else if (class_size != 0) {
         external_threshold = cfl_arena_large_object_threshold(arena);
         buf = cfl_arena_alloc_sds(arena, size,
-                                          CFL_SDS_HEADER_SIZE +
+                                          header_size +
                                           sizeof(struct cfl_sds_arena_header),
                                           &allocation_class,
                                           &payload_capacity);
         allocation_size = sizeof(struct cfl_sds_arena_header) +
-                          CFL_SDS_HEADER_SIZE + payload_capacity + 1;
+                          header_size + payload_capacity + 1;
     }
     else {
         external_threshold = cfl_arena_large_object_threshold(arena);
@@ -107,7 +214,11 @@ static cfl_sds_t sds_alloc(struct cfl_arena *arena, size_t size)
     }
 
     if (arena == NULL) {
-        head = buf;
+        s = (char *) buf + header_size;
+        CFL_SDS_FLAGS(s) = (unsigned char) type;
+        if (cfl_object_cache_class(allocation_size) != 0) {
+            CFL_SDS_FLAGS(s) |= CFL_SDS_CACHED;
+        }
     }
     else {
         arena_head = buf;
@@ -115,15 +226,11 @@ static cfl_sds_t sds_alloc(struct cfl_arena *arena, size_t size)
         arena_head->external = allocation_class == 0 &&
                                allocation_size >= external_threshold;
         arena_head->allocation_class = allocation_class;
-        head = (struct cfl_sds *) (arena_head + 1);
-    }
-    head->len = 0;
-    head->alloc = payload_capacity;
-    if (arena != NULL) {
-        head->alloc |= CFL_SDS_ARENA_FLAG;
+        s = (char *) (arena_head + 1) + header_size;
+        CFL_SDS_FLAGS(s) = (unsigned char) (type | CFL_SDS_ARENA);
     }
-
-    s = head->buf;
+    sds_put_len(s, 0);
+    sds_put_alloc(s, payload_capacity);
     *s = '\0';
 
     return s;
@@ -135,25 +242,21 @@ size_t cfl_sds_alloc(cfl_sds_t s)
         return 0;
     }
 
-    return (size_t) (CFL_SDS_HEADER(s)->alloc & CFL_SDS_ALLOC_MASK);
+    return sds_get_alloc(s);
 }
 
 cfl_sds_t cfl_sds_increase(cfl_sds_t s, size_t len)
 {
+    int type;
     size_t new_size;
-    struct cfl_sds *head;
-    struct cfl_sds *new_head;
+    size_t header_size;
     cfl_sds_t out;
-    cfl_sds_t arena_out;
     void *tmp;
 
     if (s == NULL) {
         return NULL;
     }
 
-    out = s;
-    head = CFL_SDS_HEADER(s);
-
     if (len == 0) {
         return s;
     }
@@ -166,26 +269,39 @@ cfl_sds_t cfl_sds_increase(cfl_sds_t s, size_t len)
     if (new_size > SIZE_MAX - CFL_SDS_HEADER_SIZE - 1) {
         return NULL;
     }
-    if ((head->alloc & CFL_SDS_ARENA_FLAG) != 0) {
-        arena_out = sds_alloc(sds_arena_header(head)->arena, new_size);
-        if (arena_out == NULL) {
+
+    type = sds_type(new_size);
+    header_size = sds_type_header_size(type);
+
+    /* the cached block may already hold the new capacity */
+    if ((CFL_SDS_FLAGS(s) & CFL_SDS_CACHED) != 0 &&
+        type == (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) &&
+        cfl_object_cache_class(header_size + new_size + 1) ==
+        cfl_object_cache_class(header_size + cfl_sds_alloc(s) + 1)) {
+        sds_put_alloc(s, new_size);
+        return s;
+    }
+
+    if ((CFL_SDS_FLAGS(s) & (CFL_SDS_ARENA | CFL_SDS_CACHED)) != 0 ||
+        type != (CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK)) {
+        /* moves to another arena slot, size class or to a wider header */
+        out = sds_alloc((CFL_SDS_FLAGS(s) & CFL_SDS_ARENA) != 0 ?
+                        sds_arena_header(s)->arena : NULL, new_size);
+        if (out == NULL) {
             return NULL;
         }
-        memcpy(arena_out, s, head->len + 1);
-        new_head = CFL_SDS_HEADER(arena_out);
-        new_head->len = head->len;
+        memcpy(out, s, sds_get_len(s) + 1);
+        sds_put_len(out, sds_get_len(s));
         cfl_sds_destroy(s);
-        return arena_out;
+        return out;
     }
 
-    new_size += CFL_SDS_HEADER_SIZE + 1;
-    tmp = realloc(head, new_size);
+    tmp = cfl_realloc(s - header_size, header_size + new_size + 1);
     if (!tmp) {
         return NULL;
     }
-    head = (struct cfl_sds *) tmp;
-    head->alloc += len;
-    out = head->buf;
+    out = (char *) tmp + header_size;
+    sds_put_alloc(out, new_size);
 
     return out;
 }
@@ -196,7 +312,7 @@ size_t cfl_sds_len(cfl_sds_t s)
         return 0;
     }
 
-    return (size_t) CFL_SDS_HEADER(s)->len;
+    return sds_get_len(s);
 }
 
 cfl_sds_t cfl_sds_create_len(const char *str, int len)
@@ -208,7 +324,6 @@ cfl_sds_t cfl_sds_create_len_in(struct cfl_arena *arena,
                                 const char *str, int len)
 {
     cfl_sds_t s;
-    struct cfl_sds *head;
 
     if (len < 0) {
         return NULL;
@@ -222,9 +337,7 @@ cfl_sds_t cfl_sds_create_len_in(struct cfl_arena *arena,
     if (str) {
         memcpy(s, str, len);
         s[len] = '\0';
-
-        head = CFL_SDS_HEADER(s);
-        head->len = len;
+        sds_put_len(s, len);
     }
     return s;
 }
@@ -248,19 +361,22 @@ cfl_sds_t cfl_sds_create(const char *str)
 
 void cfl_sds_destroy(cfl_sds_t s)
 {
-    struct cfl_sds *head;
     struct cfl_sds_arena_header *arena_head;
 
     if (!s) {
         return;
     }
 
-    head = CFL_SDS_HEADER(s);
-    if ((head->alloc & CFL_SDS_ARENA_FLAG) == 0) {
-        free(head);
+    if ((CFL_SDS_FLAGS(s) & CFL_SDS_CACHED) != 0) {
+        cfl_object_cache_free(s - cfl_sds_header_size(s),
+                              cfl_sds_header_size(s) + cfl_sds_alloc(s) + 1);
+    }
+    else if ((CFL_SDS_FLAGS(s) & CFL_SDS_ARENA) == 0) {
+        cfl_free_sized(s - cfl_sds_header_size(s),
+                       cfl_sds_header_size(s) + cfl_sds_alloc(s) + 1);
     }
     else {
-        arena_head = sds_arena_header(head);
+        arena_head = sds_arena_header(s);
         if (arena_head->external) {
             cfl_arena_free_external(arena_head->arena, arena_head);
         }
@@ -268,20 +384,20 @@ void cfl_sds_destroy(cfl_sds_t s)
             cfl_arena_free_sds(
                 arena_head->arena, arena_head,
                 arena_head->allocation_class,
-                sizeof(struct cfl_sds_arena_header) + CFL_SDS_HEADER_SIZE +
-                cfl_sds_alloc(s) + 1);
+                sizeof(struct cfl_sds_arena_header) +
+                cfl_sds_header_size(s) + cfl_sds_alloc(s) + 1);
         }
     }
 }
 
 cfl_sds_t cfl_sds_cat(cfl_sds_t s, const char *str, int len)
 {
+    size_t len_before;
     size_t avail;
     size_t append_len;
     size_t source_offset;
     uintptr_t buffer_addr;
     uintptr_t source_addr;
-    struct cfl_sds *head;
     cfl_sds_t tmp = NULL;
     const char *source;
     int source_in_buffer;
@@ -296,10 +412,10 @@ cfl_sds_t cfl_sds_cat(cfl_sds_t s, const char *str, int len)
     }
 
     append_len = (size_t) len;
-    head = CFL_SDS_HEADER(s);
+    len_before = sds_get_len(s);
     allocation_size = cfl_sds_alloc(s);
-    if (head->len > allocation_size ||
-        head->len > SIZE_MAX - append_len - 1) {
+    if (len_before > allocation_size ||
+        len_before > SIZE_MAX - append_len - 1) {
         return NULL;
     }
 
@@ -338,15 +454,10 @@ cfl_sds_t cfl_sds_cat(cfl_sds_t s, const char *str, int len)
         source = s + source_offset;
     }
 
-    head = CFL_SDS_HEADER(s);
-    if (head->len > UINT64_MAX - append_len) {
-        return NULL;
-    }
-
-    memmove((char *) (s + head->len), source, append_len);
+    memmove((char *) (s + len_before), source, append_len);
 
-    head->len += append_len;
-    s[head->len] = '\0';
+    sds_put_len(s, len_before + append_len);
+    s[len_before + append_len] = '\0';
 
     return s;
 }
@@ -358,18 +469,15 @@ cfl_sds_t cfl_sds_create_size(size_t size)
 
 void cfl_sds_set_len(cfl_sds_t s, size_t len)
 {
-    struct cfl_sds *head;
-
     if (s == NULL) {
         return;
     }
 
-    head = CFL_SDS_HEADER(s);
     if (len > cfl_sds_alloc(s)) {
         return;
     }
 
-    head->len = len;
+    sds_put_len(s, len);
     s[len] = '\0';
 }
 
@@ -388,32 +496,486 @@ void cfl_sds_cat_safe(cfl_sds_t *buf, const char *str, int len)
     *buf = tmp;
 }
 
-cfl_sds_t cfl_sds_printf(cfl_sds_t *sds, const char *fmt, ...)
+/* length modifiers of the native formatter */
+#define FORMAT_INT          0
+#define FORMAT_LONG         1
+#define FORMAT_LONG_LONG    2
+#define FORMAT_SIZE         3
+#define FORMAT_INTMAX       4
+
+#define FORMAT_NO_PRECISION -1
+#define FORMAT_STAR         -2
+
+/* larger precisions are left to vsnprintf() */
+#define FORMAT_MAX_PRECISION 64
+
+struct format_spec {
+    int length;
+    int conversion;
+    int precision;
+};
+
+/*
+ * Parse the conversion after a '%'. Only precision, the length modifiers
+ * used by the PRI*64 and size_t macros and the conversions d, i, u, x, X,
+ * c, s, f and % are handled: flags and field widths return NULL and the
+ * whole format goes through vsnprintf().
+ */
+static const char *format_parse(const char *p, struct format_spec *spec)
 {
-    va_list ap;
+    spec->length = FORMAT_INT;
+    spec->precision = FORMAT_NO_PRECISION;
+
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->precision = FORMAT_STAR;
+            p++;
+        }
+        else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                spec->precision = spec->precision * 10 + (*p - '0');
+                if (spec->precision > FORMAT_MAX_PRECISION) {
+                    return NULL;
+                }
+                p++;
+            }
+        }
+    }
+
+    switch (*p) {
+    case 'l':
+        p++;
+        spec->length = FORMAT_LONG;
+        if (*p == 'l') {
+            p++;
+            spec->length = FORMAT_LONG_LONG;
+        }
+        break;
+    case 'z':
+        p++;
+        spec->length = FORMAT_SIZE;
+        break;
+    case 'j':
+        p++;
+        spec->length = FORMAT_INTMAX;
+        break;
+    case 'I':
+        /* PRId64 and PRIu64 with older Microsoft C runtimes */
+        if (p[1] != '6' || p[2] != '4') {
+            return NULL;
+        }
+        p += 3;
+        spec->length = FORMAT_LONG_LONG;
+        break;
+    }
+
+    spec->conversion = *p;
+    switch (spec->conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+        if (spec->precision != FORMAT_NO_PRECISION) {
+            return NULL;
+        }
+        break;
+    case 'f':
+        /* 'l' has no effect on f */
+        if (spec->length != FORMAT_INT && spec->length != FORMAT_LONG) {
+            return NULL;
+        }
+        break;
+    case 's':
+    case 'c':
+    case '%':
+        if (spec->length != FORMAT_INT ||
+            (spec->conversion != 's' &&
+             spec->precision != FORMAT_NO_PRECISION)) {
+            return NULL;
+        }
+        break;
+    default:
+        return NULL;
+    }
+
+    return p + 1;
+}
+
+static int64_t format_signed(va_list *ap, int length)
+{
+    switch (length) {
+    case FORMAT_LONG:
+        return va_arg(*ap, long);
+    case FORMAT_LONG_LONG:
+        return va_arg(*ap, long long);
+    case FORMAT_SIZE:
+        return (int64_t) (ptrdiff_t) va_arg(*ap, size_t);
+    case FORMAT_INTMAX:
+        return va_arg(*ap, intmax_t);
+    default:
+        return va_arg(*ap, int);
+    }
+}
+
+static uint64_t format_unsigned(va_list *ap, int length)
+{
+    switch (length) {
+    case FORMAT_LONG:
+        return va_arg(*ap, unsigned long);
+    case FORMAT_LONG_LONG:
+        return va_arg(*ap, unsigned long long);
+    case FORMAT_SIZE:
+        return va_arg(*ap, size_t);
+    case FORMAT_INTMAX:
+        return va_arg(*ap, uintmax_t);
+    default:
+        return va_arg(*ap, unsigned int);
+    }
+}
+
+static size_t format_decimal_count(uint64_t value)
+{
+    size_t count = 1;
+
+    while (value >= 10000) {
+        value /= 10000;
+        count += 4;
+    }
+    while (value >= 10) {
+        value /= 10;
+        count++;
+    }
+
+    return count;
+}
+
+static size_t format_hex_count(uint64_t value)
+{
+    size_t count = 1;
+
+    while (value >= 16) {
+        value >>= 4;
+        count++;
+    }
+
+    return count;
+}
+
+/* two digits per division */
+static size_t format_write_decimal(char *out, uint64_t value)
+{
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    size_t count;
+    size_t index;
+
+    count = format_decimal_count(value);
+    index = count;
+    while (value >= 100) {
+        index -= 2;
+        memcpy(out + index, pairs + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        memcpy(out + index - 2, pairs + value * 2, 2);
+    }
+    else {
+        out[index - 1] = (char) ('0' + value);
+    }
+
+    return count;
+}
+
+static size_t format_write_hex(char *out, uint64_t value, const char *digits)
+{
+    size_t count;
+    size_t index;
+
+    count = format_hex_count(value);
+    index = count;
+    do {
+        out[--index] = digits[value & 15];
+        value >>= 4;
+    } while (value != 0);
+
+    return count;
+}
+
+/*
+ * The exact rounding below needs double arithmetic without excess
+ * precision, as in the number parser.
+ */
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0) || \
+    defined(_M_X64) || defined(_M_ARM64)
+#define FORMAT_NATIVE_DOUBLE 1
+#endif
+
+#ifdef FORMAT_NATIVE_DOUBLE
+/* largest precision with an exact power of ten below 2^53 */
+#define FORMAT_DOUBLE_DIGITS 15
+
+static const double format_power_of_ten[FORMAT_DOUBLE_DIGITS + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15
+};
+
+/* 'high' + 'low' is exactly a * b */
+static void format_two_product(double a, double b, double *high, double *low)
+{
+#if defined(__FP_FAST_FMA)
+    *high = a * b;
+    *low = __builtin_fma(a, b, -*high);
+#else
+    /* Dekker's product with Veltkamp splitting, exact without FMA */
+    double split;
+    double a_high;
+    double a_low;
+    double b_high;
+    double b_low;
+
+    split = 134217729.0 * a;
+    a_high = split - (split - a);
+    a_low = a - a_high;
+    split = 134217729.0 * b;
+    b_high = split - (split - b);
+    b_low = b - b_high;
+
+    *high = a * b;
+    *low = ((a_high * b_high - *high) + a_high * b_low + a_low * b_high) +
+           a_low * b_low;
+#endif
+}
+#endif
+
+/*
+ * %.<precision>f for values whose scaled magnitude stays below 2^52. The
+ * scaled value is classified exactly against the rounding midpoint so the
+ * result matches a correctly rounding C library, ties going to even.
+ * Returns the length, or 0 when the value must go to snprintf().
+ */
+static size_t format_double(char *out, double value, int precision)
+{
+#ifdef FORMAT_NATIVE_DOUBLE
+    int negative;
+    size_t length = 0;
+    uint64_t scaled;
+    uint64_t power;
+    double magnitude;
+    double high;
+    double low;
+    double difference;
+
+    if (precision > FORMAT_DOUBLE_DIGITS || value != value) {
+        return 0;
+    }
+
+    negative = value < 0 || (value == 0 && 1 / value < 0);
+    magnitude = negative ? -value : value;
+    if (!(magnitude < 4503599627370496.0 / format_power_of_ten[precision])) {
+        return 0;
+    }
+
+    format_two_product(magnitude, format_power_of_ten[precision],
+                       &high, &low);
+    scaled = (uint64_t) high;
+
+    /* 'high' may have rounded up to the next integer */
+    if ((double) scaled == high && low < 0 && scaled > 0) {
+        scaled--;
+    }
+
+    /* both operands are below 2^52, the difference is exact */
+    difference = high - ((double) scaled + 0.5);
+    if (difference > 0 || (difference == 0 && low > 0) ||
+        (difference == 0 && low == 0 && (scaled & 1))) {
+        scaled++;
+    }
+
+    if (negative) {
+        out[length++] = '-';
+    }
+
+    power = (uint64_t) format_power_of_ten[precision];
+    length += format_write_decimal(out + length, scaled / power);
+    if (precision > 0) {
+        out[length++] = '.';
+        scaled %= power;
+        memset(out + length, '0', precision);
+        format_write_decimal(out + length + precision -
+                             format_decimal_count(scaled), scaled);
+        length += precision;
+    }
+
+    return length;
+#else
+    (void) out;
+    (void) value;
+    (void) precision;
+
+    return 0;
+#endif
+}
+
+/*
+ * Size ('out' is NULL) or write the formatted text. Sizing returns -1 when
+ * the format needs vsnprintf(); the size of %f is an upper bound.
+ */
+static int format_run(char *out, const char *fmt, va_list *ap, size_t *size)
+{
+    int precision;
+    int64_t number;
+    uint64_t magnitude;
+    size_t length;
+    size_t written;
+    size_t total = 0;
+    double real;
+    const char *p = fmt;
+    const char *percent;
+    const char *string;
+    struct format_spec spec;
+
+    while (*p != '\0') {
+        percent = strchr(p, '%');
+        length = percent != NULL ? (size_t) (percent - p) : strlen(p);
+        if (out != NULL) {
+            memcpy(out + total, p, length);
+        }
+        total += length;
+        if (percent == NULL) {
+            break;
+        }
+
+        p = format_parse(percent + 1, &spec);
+        if (p == NULL) {
+            return -1;
+        }
+
+        switch (spec.conversion) {
+        case 'd':
+        case 'i':
+            number = format_signed(ap, spec.length);
+            magnitude = number < 0 ? 0 - (uint64_t) number : (uint64_t) number;
+            if (out != NULL) {
+                if (number < 0) {
+                    out[total] = '-';
+                }
+                format_write_decimal(out + total + (number < 0), magnitude);
+            }
+            total += (number < 0) + format_decimal_count(magnitude);
+            break;
+        case 'u':
+            magnitude = format_unsigned(ap, spec.length);
+            if (out != NULL) {
+                format_write_decimal(out + total, magnitude);
+            }
+            total += format_decimal_count(magnitude);
+            break;
+        case 'x':
+        case 'X':
+            magnitude = format_unsigned(ap, spec.length);
+            if (out != NULL) {
+                format_write_hex(out + total, magnitude,
+                                 spec.conversion == 'x' ?
+                                 "0123456789abcdef" : "0123456789ABCDEF");
+            }
+            total += format_hex_count(magnitude);
+            break;
+        case 's':
+            precision = spec.precision;
+            if (precision == FORMAT_STAR) {
+                precision = va_arg(*ap, int);
+            }
+            string = va_arg(*ap, const char *);
+            if (string == NULL) {
+                string = "(null)";
+            }
+            if (precision < 0) {
+                length = strlen(string);
+            }
+            else {
+                percent = memchr(string, '\0', precision);
+                length = percent != NULL ? (size_t) (percent - string) :
+                                           (size_t) precision;
+            }
+            if (out != NULL) {
+                memcpy(out + total, string, length);
+            }
+            total += length;
+            break;
+        case 'c':
+            if (out != NULL) {
+                out[total] = (char) va_arg(*ap, int);
+            }
+            else {
+                (void) va_arg(*ap, int);
+            }
+            total++;
+            break;
+        case 'f':
+            precision = spec.precision;
+            if (precision == FORMAT_STAR) {
+                precision = va_arg(*ap, int);
+                if (precision > FORMAT_MAX_PRECISION) {
+                    return -1;
+                }
+            }
+            if (precision < 0) {
+                precision = 6;
+            }
+            real = va_arg(*ap, double);
+
+            /* sign, integer digits, decimal point and fraction */
+            length = 2 + precision +
+                     (real > -1e15 && real < 1e15 ? 16 : DBL_MAX_10_EXP + 1);
+            if (out != NULL) {
+                written = format_double(out + total, real, precision);
+                if (written == 0) {
+                    /* the C library rounds every other value exactly */
+                    written = snprintf(out + total, length + 1, "%.*f",
+                                       precision, real);
+                }
+                length = written;
+            }
+            total += length;
+            break;
+        default:
+            if (out != NULL) {
+                out[total] = '%';
+            }
+            total++;
+            break;
+        }
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static cfl_sds_t sds_vprintf(cfl_sds_t *sds, const char *fmt, va_list ap)
+{
+    va_list copy;
     size_t avail;
     size_t growth;
     size_t base_len;
     int size;
     cfl_sds_t tmp = NULL;
     cfl_sds_t s;
-    struct cfl_sds *head;
-
-    if (sds == NULL || *sds == NULL || fmt == NULL) {
-        return NULL;
-    }
 
     s = *sds;
     base_len = cfl_sds_len(s);
-    if (base_len > cfl_sds_alloc(s)) {
-        return NULL;
-    }
 
     while (1) {
         avail = cfl_sds_avail(s);
-        va_start(ap, fmt);
-        size = vsnprintf((char *) (s + base_len), avail + 1, fmt, ap);
-        va_end(ap);
+        va_copy(copy, ap);
+        size = vsnprintf((char *) (s + base_len), avail + 1, fmt, copy);
+        va_end(copy);
 
         if (size < 0) {
             s[base_len] = '\0';
@@ -440,13 +1002,63 @@ cfl_sds_t cfl_sds_printf(cfl_sds_t *sds, const char *fmt, ...)
         *sds = s = tmp;
     }
 
-    head = CFL_SDS_HEADER(s);
-    if (head->len > UINT64_MAX - (size_t) size) {
+    sds_put_len(s, base_len + (size_t) size);
+    s[base_len + (size_t) size] = '\0';
+
+    return s;
+}
+
+/*
+ * Formats handled by format_run() are sized in one pass, the SDS grows at
+ * most once and the text is written in a second pass. Anything else goes
+ * through vsnprintf().
+ */
+cfl_sds_t cfl_sds_printf(cfl_sds_t *sds, const char *fmt, ...)
+{
+    va_list ap;
+    int ret;
+    size_t size;
+    size_t avail;
+    size_t base_len;
+    cfl_sds_t tmp;
+    cfl_sds_t s;
+
+    if (sds == NULL || *sds == NULL || fmt == NULL) {
+        return NULL;
+    }
+
+    s = *sds;
+    base_len = cfl_sds_len(s);
+    if (base_len > cfl_sds_alloc(s)) {
         return NULL;
     }
 
-    head->len += (size_t) size;
-    s[head->len] = '\0';
+    va_start(ap, fmt);
+    ret = format_run(NULL, fmt, &ap, &size);
+    va_end(ap);
+
+    if (ret != 0) {
+        va_start(ap, fmt);
+        s = sds_vprintf(sds, fmt, ap);
+        va_end(ap);
+        return s;
+    }
+
+    avail = cfl_sds_avail(s);
+    if (size > avail) {
+        tmp = cfl_sds_increase(s, size - avail);
+        if (!tmp) {
+            return NULL;
+        }
+        *sds = s = tmp;
+    }
+
+    va_start(ap, fmt);
+    format_run(s + base_len, fmt, &ap, &size);
+    va_end(ap);
+
+    sds_put_len(s, base_len + size);
+    s[base_len + size] = '\0';
 
     return s;
 }
@@ -0,0 +1,309 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_sds_builder.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BUILDER_BLOCK_SIZE     4096
+#define BUILDER_IOV_SIZE       16
+
+/* storage for copied segments */
+struct builder_block {
+    struct builder_block *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+struct cfl_sds_builder {
+    struct cfl_iovec *iov;
+    size_t iov_count;
+    size_t iov_size;
+
+    cfl_sds_t *owned;
+    size_t owned_count;
+    size_t owned_size;
+
+    /* the head block receives copies, older blocks follow it */
+    struct builder_block *blocks;
+
+    size_t length;
+};
+
+struct cfl_sds_builder *cfl_sds_builder_create()
+{
+    struct cfl_sds_builder *builder;
+
+    builder = cfl_calloc(1, sizeof(struct cfl_sds_builder));
+    if (builder == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    return builder;
+}
+
+static void builder_release(struct cfl_sds_builder *builder)
+{
+    size_t index;
+
+    for (index = 0 ; index < builder->owned_count ; index++) {
+        cfl_sds_destroy(builder->owned[index]);
+    }
+
+    builder->owned_count = 0;
+    builder->iov_count = 0;
+    builder->length = 0;
+}
+
+void cfl_sds_builder_destroy(struct cfl_sds_builder *builder)
+{
+    struct builder_block *block;
+
+    if (builder == NULL) {
+        return;
+    }
+
+    builder_release(builder);
+
+    while (builder->blocks != NULL) {
+        block = builder->blocks;
+        builder->blocks = block->next;
+        cfl_free(block);
+    }
+
+    cfl_free(builder->owned);
+    cfl_free(builder->iov);
+    cfl_free(builder);
+}
+
+void cfl_sds_builder_reset(struct cfl_sds_builder *builder)
+{
+    struct builder_block *block;
+
+    if (builder == NULL) {
+        return;
+    }
+
+    builder_release(builder);
+
+    /* keep the head block, it is the most recent and the largest one */
+    if (builder->blocks != NULL) {
+        while (builder->blocks->next != NULL) {
+            block = builder->blocks->next;
+            builder->blocks->next = block->next;
+            cfl_free(block);
+        }
+        builder->blocks->used = 0;
+    }
+}
+
+static int builder_push(struct cfl_sds_builder *builder,
+                        const void *data, size_t length)
+{
+    size_t size;
+    struct cfl_iovec *iov;
+
+    if (builder->iov_count > 0) {
+        iov = &builder->iov[builder->iov_count - 1];
+        if ((const char *) iov->iov_base + iov->iov_len == data) {
+            iov->iov_len += length;
+            builder->length += length;
+            return 0;
+        }
+    }
+
+    if (builder->iov_count == builder->iov_size) {
+        size = builder->iov_size == 0 ? BUILDER_IOV_SIZE :
+                                        builder->iov_size * 2;
+        iov = cfl_realloc(builder->iov, size * sizeof(struct cfl_iovec));
+        if (iov == NULL) {
+            cfl_errno();
+            return -1;
+        }
+        builder->iov = iov;
+        builder->iov_size = size;
+    }
+
+    iov = &builder->iov[builder->iov_count++];
+    iov->iov_base = (void *) data;
+    iov->iov_len = length;
+    builder->length += length;
+
+    return 0;
+}
+
+int cfl_sds_builder_append(struct cfl_sds_builder *builder,
+                           const void *data, size_t length)
+{
+    size_t size;
+    char *tail;
+    struct builder_block *block;
+
+    if (builder == NULL || (data == NULL && length > 0)) {
+        return -1;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    block = builder->blocks;
+    if (block == NULL || block->size - block->used < length) {
+        size = length > BUILDER_BLOCK_SIZE ? length : BUILDER_BLOCK_SIZE;
+        block = cfl_malloc(sizeof(struct builder_block) + size);
+        if (block == NULL) {
+            cfl_errno();
+            return -1;
+        }
+        block->size = size;
+        block->used = 0;
+        block->next = builder->blocks;
+        builder->blocks = block;
+    }
+
+    /* a copy that follows the previous one extends its segment */
+    tail = block->data + block->used;
+    memcpy(tail, data, length);
+
+    if (builder_push(builder, tail, length) != 0) {
+        return -1;
+    }
+    block->used += length;
+
+    return 0;
+}
+
+int cfl_sds_builder_append_ref(struct cfl_sds_builder *builder,
+                               const void *data, size_t length)
+{
+    if (builder == NULL || (data == NULL && length > 0)) {
+        return -1;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    if (length < CFL_SDS_BUILDER_INLINE_MAX) {
+        return cfl_sds_builder_append(builder, data, length);
+    }
+
+    return builder_push(builder, data, length);
+}
+
+int cfl_sds_builder_append_sds(struct cfl_sds_builder *builder, cfl_sds_t s)
+{
+    int ret;
+    size_t size;
+    size_t length;
+    cfl_sds_t *owned;
+
+    if (s == NULL) {
+        return -1;
+    }
+
+    if (builder == NULL) {
+        cfl_sds_destroy(s);
+        return -1;
+    }
+
+    length = cfl_sds_len(s);
+    if (length < CFL_SDS_BUILDER_INLINE_MAX) {
+        ret = cfl_sds_builder_append(builder, s, length);
+        cfl_sds_destroy(s);
+        return ret;
+    }
+
+    if (builder->owned_count == builder->owned_size) {
+        size = builder->owned_size == 0 ? BUILDER_IOV_SIZE :
+                                          builder->owned_size * 2;
+        owned = cfl_realloc(builder->owned, size * sizeof(cfl_sds_t));
+        if (owned == NULL) {
+            cfl_errno();
+            cfl_sds_destroy(s);
+            return -1;
+        }
+        builder->owned = owned;
+        builder->owned_size = size;
+    }
+
+    if (builder_push(builder, s, length) != 0) {
+        cfl_sds_destroy(s);
+        return -1;
+    }
+    builder->owned[builder->owned_count++] = s;
+
+    return 0;
+}
+
+size_t cfl_sds_builder_length(struct cfl_sds_builder *builder)
+{
+    if (builder == NULL) {
+        return 0;
+    }
+
+    return builder->length;
+}
+
+struct cfl_iovec *cfl_sds_builder_iov(struct cfl_sds_builder *builder,
+                                      size_t *count)
+{
+    if (builder == NULL) {
+        if (count != NULL) {
+            *count = 0;
+        }
+        return NULL;
+    }
+
+    if (count != NULL) {
+        *count = builder->iov_count;
+    }
+
+    return builder->iov;
+}
+
+cfl_sds_t cfl_sds_builder_flatten(struct cfl_sds_builder *builder)
+{
+    size_t index;
+    char *output;
+    cfl_sds_t s;
+
+    if (builder == NULL) {
+        return NULL;
+    }
+
+    s = cfl_sds_create_size(builder->length);
+    if (s == NULL) {
+        return NULL;
+    }
+
+    output = s;
+    for (index = 0 ; index < builder->iov_count ; index++) {
+        memcpy(output, builder->iov[index].iov_base,
+               builder->iov[index].iov_len);
+        output += builder->iov[index].iov_len;
+    }
+    cfl_sds_len_set(s, builder->length);
+
+    return s;
+}
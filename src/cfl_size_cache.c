@@ -0,0 +1,412 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_size_cache.h>
+
+#include "cfl_arena_internal.h"
+#include "cfl_size_cache_internal.h"
+
+/* number of CFL_VARIANT_FORMAT_* slots per entry */
+#define SIZE_CACHE_FORMATS         4
+#define SIZE_CACHE_INITIAL_SLOTS   64
+
+/* structural hashes, ordered and key-order-insensitive */
+#define SIZE_CACHE_HASHES          2
+#define SIZE_CACHE_HASH_VALID(n)   (1u << (SIZE_CACHE_FORMATS + (n)))
+
+/*
+ * Open addressing table keyed by container address. Linear probing with
+ * backward shift deletion keeps lookups free of tombstones.
+ */
+struct size_cache_entry {
+    const void *container;
+    unsigned int valid;
+    size_t sizes[SIZE_CACHE_FORMATS];
+    uint64_t hashes[SIZE_CACHE_HASHES];
+};
+
+struct cfl_size_cache {
+    struct cfl_arena *arena;
+    struct size_cache_entry *entries;
+    size_t slot_count;
+    size_t entry_count;
+};
+
+static size_t slot_hash(const void *container, size_t slot_count)
+{
+    uint64_t value;
+
+    value = (uint64_t) (uintptr_t) container;
+    value ^= value >> 33;
+    value *= UINT64_C(0xff51afd7ed558ccd);
+    value ^= value >> 33;
+
+    return (size_t) value & (slot_count - 1);
+}
+
+static struct size_cache_entry *table_alloc(struct cfl_size_cache *cache,
+                                            size_t slot_count)
+{
+    size_t size;
+    struct size_cache_entry *entries;
+
+    size = slot_count * sizeof(struct size_cache_entry);
+    if (cache->arena != NULL) {
+        /*
+         * External blocks are not aligned for the entry fields. Tables only
+         * double, so the ones left behind in the arena never add up to more
+         * than the live table.
+         */
+        entries = cfl_arena_calloc(cache->arena, 1, size);
+    }
+    else {
+        entries = cfl_calloc(1, size);
+        if (entries == NULL) {
+            cfl_errno();
+        }
+    }
+
+    return entries;
+}
+
+static void table_free(struct cfl_size_cache *cache,
+                       struct size_cache_entry *entries)
+{
+    if (entries == NULL) {
+        return;
+    }
+
+    /* arena tables are released with the arena */
+    if (cache->arena == NULL) {
+        cfl_free(entries);
+    }
+}
+
+static struct size_cache_entry *entry_find(struct cfl_size_cache *cache,
+                                           const void *container)
+{
+    size_t slot;
+    struct size_cache_entry *entry;
+
+    if (cache->entries == NULL) {
+        return NULL;
+    }
+
+    slot = slot_hash(container, cache->slot_count);
+    while (1) {
+        entry = &cache->entries[slot];
+        if (entry->container == container) {
+            return entry;
+        }
+        if (entry->container == NULL) {
+            return NULL;
+        }
+        slot = (slot + 1) & (cache->slot_count - 1);
+    }
+}
+
+static struct size_cache_entry *entry_insert(struct cfl_size_cache *cache,
+                                             const void *container)
+{
+    size_t slot;
+    struct size_cache_entry *entry;
+
+    slot = slot_hash(container, cache->slot_count);
+    while (1) {
+        entry = &cache->entries[slot];
+        if (entry->container == container) {
+            return entry;
+        }
+        if (entry->container == NULL) {
+            entry->container = container;
+            entry->valid = 0;
+            cache->entry_count++;
+            return entry;
+        }
+        slot = (slot + 1) & (cache->slot_count - 1);
+    }
+}
+
+static int table_grow(struct cfl_size_cache *cache)
+{
+    size_t index;
+    size_t slot_count;
+    size_t old_slot_count;
+    struct size_cache_entry *entry;
+    struct size_cache_entry *entries;
+    struct size_cache_entry *old_entries;
+
+    slot_count = SIZE_CACHE_INITIAL_SLOTS;
+    if (cache->slot_count > 0) {
+        if (cache->slot_count > SIZE_MAX / 2 /
+                                sizeof(struct size_cache_entry)) {
+            return -1;
+        }
+        slot_count = cache->slot_count * 2;
+    }
+
+    entries = table_alloc(cache, slot_count);
+    if (entries == NULL) {
+        return -1;
+    }
+
+    old_entries = cache->entries;
+    old_slot_count = cache->slot_count;
+
+    cache->entries = entries;
+    cache->slot_count = slot_count;
+    cache->entry_count = 0;
+
+    for (index = 0; index < old_slot_count; index++) {
+        if (old_entries[index].container == NULL) {
+            continue;
+        }
+        entry = entry_insert(cache, old_entries[index].container);
+        entry->valid = old_entries[index].valid;
+        memcpy(entry->sizes, old_entries[index].sizes, sizeof(entry->sizes));
+        memcpy(entry->hashes, old_entries[index].hashes,
+               sizeof(entry->hashes));
+    }
+
+    table_free(cache, old_entries);
+
+    return 0;
+}
+
+static void entry_remove(struct cfl_size_cache *cache,
+                         struct size_cache_entry *entry)
+{
+    size_t hole;
+    size_t slot;
+    size_t home;
+    size_t mask;
+
+    mask = cache->slot_count - 1;
+    hole = (size_t) (entry - cache->entries);
+    slot = hole;
+
+    while (1) {
+        slot = (slot + 1) & mask;
+        if (cache->entries[slot].container == NULL) {
+            break;
+        }
+
+        /* move the entry back when the hole lies on its probe path */
+        home = slot_hash(cache->entries[slot].container, cache->slot_count);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            cache->entries[hole] = cache->entries[slot];
+            hole = slot;
+        }
+    }
+
+    memset(&cache->entries[hole], 0, sizeof(struct size_cache_entry));
+    cache->entry_count--;
+}
+
+struct cfl_size_cache *cfl_size_cache_create(struct cfl_arena *arena)
+{
+    struct cfl_size_cache *cache;
+
+    if (arena != NULL) {
+        cache = cfl_arena_calloc(arena, 1, sizeof(struct cfl_size_cache));
+    }
+    else {
+        cache = cfl_calloc(1, sizeof(struct cfl_size_cache));
+        if (cache == NULL) {
+            cfl_errno();
+        }
+    }
+
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->arena = arena;
+
+    return cache;
+}
+
+void cfl_size_cache_destroy(struct cfl_size_cache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+
+    table_free(cache, cache->entries);
+    cache->entries = NULL;
+    cache->slot_count = 0;
+    cache->entry_count = 0;
+
+    if (cache->arena == NULL) {
+        cfl_free(cache);
+    }
+}
+
+void cfl_size_cache_clear(struct cfl_size_cache *cache)
+{
+    if (cache == NULL || cache->entries == NULL) {
+        return;
+    }
+
+    memset(cache->entries, 0,
+           cache->slot_count * sizeof(struct size_cache_entry));
+    cache->entry_count = 0;
+}
+
+size_t cfl_size_cache_count(struct cfl_size_cache *cache)
+{
+    if (cache == NULL) {
+        return 0;
+    }
+
+    return cache->entry_count;
+}
+
+int cfl_size_cache_lookup(struct cfl_size_cache *cache,
+                          const void *container, int format, size_t *size)
+{
+    struct size_cache_entry *entry;
+
+    if (cache == NULL || format < 1 || format > SIZE_CACHE_FORMATS) {
+        return -1;
+    }
+
+    entry = entry_find(cache, container);
+    if (entry == NULL || (entry->valid & (1u << (format - 1))) == 0) {
+        return -1;
+    }
+
+    *size = entry->sizes[format - 1];
+
+    return 0;
+}
+
+void cfl_size_cache_store(struct cfl_size_cache *cache,
+                          const void *container, int format, size_t size)
+{
+    struct size_cache_entry *entry;
+
+    if (cache == NULL || format < 1 || format > SIZE_CACHE_FORMATS) {
+        return;
+    }
+
+    /* keep the load factor at or below 3/4; a failed grow skips caching */
+    if (cache->slot_count == 0 ||
+        cache->entry_count + 1 > cache->slot_count / 4 * 3) {
+        if (table_grow(cache) != 0) {
+            return;
+        }
+    }
+
+    entry = entry_insert(cache, container);
+    entry->sizes[format - 1] = size;
+    entry->valid |= 1u << (format - 1);
+}
+
+int cfl_size_cache_lookup_hash(struct cfl_size_cache *cache,
+                               const void *container, int unordered,
+                               uint64_t *hash)
+{
+    int slot;
+    struct size_cache_entry *entry;
+
+    if (cache == NULL) {
+        return -1;
+    }
+
+    slot = unordered ? 1 : 0;
+    entry = entry_find(cache, container);
+    if (entry == NULL || (entry->valid & SIZE_CACHE_HASH_VALID(slot)) == 0) {
+        return -1;
+    }
+
+    *hash = entry->hashes[slot];
+
+    return 0;
+}
+
+void cfl_size_cache_store_hash(struct cfl_size_cache *cache,
+                               const void *container, int unordered,
+                               uint64_t hash)
+{
+    int slot;
+    struct size_cache_entry *entry;
+
+    if (cache == NULL) {
+        return;
+    }
+
+    if (cache->slot_count == 0 ||
+        cache->entry_count + 1 > cache->slot_count / 4 * 3) {
+        if (table_grow(cache) != 0) {
+            return;
+        }
+    }
+
+    slot = unordered ? 1 : 0;
+    entry = entry_insert(cache, container);
+    entry->hashes[slot] = hash;
+    entry->valid |= SIZE_CACHE_HASH_VALID(slot);
+}
+
+static void invalidate_chain(struct cfl_size_cache *cache,
+                             struct cfl_array *array,
+                             struct cfl_kvlist *kvlist)
+{
+    struct size_cache_entry *entry;
+
+    while (array != NULL || kvlist != NULL) {
+        if (array != NULL) {
+            entry = entry_find(cache, array);
+            if (entry != NULL) {
+                entry_remove(cache, entry);
+            }
+            kvlist = array->parent_kvlist;
+            array = array->parent_array;
+        }
+        else {
+            entry = entry_find(cache, kvlist);
+            if (entry != NULL) {
+                entry_remove(cache, entry);
+            }
+            array = kvlist->parent_array;
+            kvlist = kvlist->parent_kvlist;
+        }
+    }
+}
+
+void cfl_size_cache_invalidate_array(struct cfl_size_cache *cache,
+                                     struct cfl_array *array)
+{
+    if (cache == NULL || array == NULL) {
+        return;
+    }
+
+    invalidate_chain(cache, array, NULL);
+}
+
+void cfl_size_cache_invalidate_kvlist(struct cfl_size_cache *cache,
+                                      struct cfl_kvlist *kvlist)
+{
+    if (cache == NULL || kvlist == NULL) {
+        return;
+    }
+
+    invalidate_chain(cache, NULL, kvlist);
+}
@@ -0,0 +1,23 @@
+#ifndef CFL_SIZE_CACHE_INTERNAL_H
+#define CFL_SIZE_CACHE_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cfl/cfl_size_cache.h>
+
+/* 'format' is one of the CFL_VARIANT_FORMAT_* values */
+int cfl_size_cache_lookup(struct cfl_size_cache *cache,
+                          const void *container, int format, size_t *size);
+void cfl_size_cache_store(struct cfl_size_cache *cache,
+                          const void *container, int format, size_t size);
+
+/* structural hashes from cfl_variant_hash_cached() */
+int cfl_size_cache_lookup_hash(struct cfl_size_cache *cache,
+                               const void *container, int unordered,
+                               uint64_t *hash);
+void cfl_size_cache_store_hash(struct cfl_size_cache *cache,
+                               const void *container, int unordered,
+                               uint64_t hash);
+
+#endif
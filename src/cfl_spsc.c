@@ -0,0 +1,366 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_spsc.h>
+
+#include <limits.h>
+
+#include "cfl_cpu_internal.h"
+#include "cfl_thread_internal.h"
+
+#if defined(__linux__)
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define SPSC_HAVE_FUTEX 1
+#endif
+
+#define READY_READABLE 0
+#define READY_WRITABLE 1
+
+#ifdef SPSC_HAVE_FUTEX
+static void futex_wait(uint32_t *word, uint32_t value, int64_t timeout_ns)
+{
+    struct timespec  timeout;
+    struct timespec *timeout_pointer;
+
+    timeout_pointer = NULL;
+    if (timeout_ns >= 0) {
+        timeout.tv_sec = timeout_ns / 1000000000;
+        timeout.tv_nsec = timeout_ns % 1000000000;
+        timeout_pointer = &timeout;
+    }
+
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, timeout_pointer,
+            NULL, 0);
+}
+
+static void futex_wake(uint32_t *word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+#endif
+
+struct cfl_spsc_ring *cfl_spsc_ring_create(size_t capacity, int flags)
+{
+    size_t                size;
+    struct cfl_spsc_ring *ring;
+
+    if (capacity == 0 || capacity > SIZE_MAX / 2 / sizeof(void *)) {
+        return NULL;
+    }
+
+    size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    ring = cfl_calloc(1, sizeof(struct cfl_spsc_ring));
+    if (ring == NULL) {
+        cfl_errno();
+        return NULL;
+    }
+
+    ring->slots = cfl_calloc(size, sizeof(void *));
+    if (ring->slots == NULL) {
+        cfl_errno();
+        cfl_free(ring);
+        return NULL;
+    }
+
+    ring->flags = flags;
+    ring->spins = CFL_SPSC_RING_DEFAULT_SPINS;
+    ring->mask = size - 1;
+
+    return ring;
+}
+
+void cfl_spsc_ring_destroy(struct cfl_spsc_ring *ring)
+{
+    if (ring == NULL) {
+        return;
+    }
+
+    cfl_free(ring->slots);
+    cfl_free(ring);
+}
+
+size_t cfl_spsc_ring_capacity(struct cfl_spsc_ring *ring)
+{
+    return (size_t) ring->mask + 1;
+}
+
+void cfl_spsc_ring_set_spins(struct cfl_spsc_ring *ring, uint32_t spins)
+{
+    ring->spins = spins;
+}
+
+/* wake a peer sleeping on 'event' after the position store */
+static inline void notify(struct cfl_spsc_ring *ring,
+                          uint32_t *sleeping, uint32_t *event)
+{
+    if ((ring->flags & CFL_SPSC_RING_WAIT) == 0) {
+        return;
+    }
+
+    /* orders the position store before the 'sleeping' load */
+    cfl_atomic_thread_fence(CFL_ATOMIC_SEQ_CST);
+
+    if (cfl_atomic32_load_explicit(sleeping, CFL_ATOMIC_RELAXED) != 0) {
+        cfl_atomic32_fetch_add_explicit(event, 1, CFL_ATOMIC_RELEASE);
+#ifdef SPSC_HAVE_FUTEX
+        futex_wake(event);
+#endif
+    }
+}
+
+/* number of free slots as seen by the producer, refreshing the cache */
+static inline size_t producer_free(struct cfl_spsc_ring *ring, size_t wanted)
+{
+    size_t capacity;
+    size_t free_slots;
+
+    capacity = (size_t) ring->mask + 1;
+    free_slots = capacity - (size_t) (ring->head - ring->producer_cached_tail);
+
+    if (free_slots < wanted) {
+        ring->producer_cached_tail = cfl_atomic_load_explicit(&ring->tail,
+                                                        CFL_ATOMIC_ACQUIRE);
+        free_slots = capacity -
+                     (size_t) (ring->head - ring->producer_cached_tail);
+    }
+
+    return free_slots;
+}
+
+/* number of queued items as seen by the consumer, refreshing the cache */
+static inline size_t consumer_available(struct cfl_spsc_ring *ring,
+                                        size_t wanted)
+{
+    size_t available;
+
+    available = (size_t) (ring->consumer_cached_head - ring->tail);
+
+    if (available < wanted) {
+        ring->consumer_cached_head = cfl_atomic_load_explicit(&ring->head,
+                                                        CFL_ATOMIC_ACQUIRE);
+        available = (size_t) (ring->consumer_cached_head - ring->tail);
+    }
+
+    return available;
+}
+
+size_t cfl_spsc_ring_push_batch(struct cfl_spsc_ring *ring,
+                                void **items, size_t count)
+{
+    size_t   index;
+    size_t   free_slots;
+    uint64_t head;
+
+    free_slots = producer_free(ring, count);
+    if (count > free_slots) {
+        count = free_slots;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    head = ring->head;
+    for (index = 0; index < count; index++) {
+        ring->slots[(head + index) & ring->mask] = items[index];
+    }
+
+    /* publish every slot with a single release store */
+    cfl_atomic_store_explicit(&ring->head, head + count, CFL_ATOMIC_RELEASE);
+
+    notify(ring, &ring->reader_sleeping, &ring->readable_event);
+
+    return count;
+}
+
+int cfl_spsc_ring_push(struct cfl_spsc_ring *ring, void *item)
+{
+    if (item == NULL) {
+        return -1;
+    }
+
+    if (cfl_spsc_ring_push_batch(ring, &item, 1) != 1) {
+        return -1;
+    }
+
+    return 0;
+}
+
+size_t cfl_spsc_ring_pop_batch(struct cfl_spsc_ring *ring,
+                               void **items, size_t count)
+{
+    size_t   index;
+    size_t   available;
+    uint64_t tail;
+
+    available = consumer_available(ring, count);
+    if (count > available) {
+        count = available;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    tail = ring->tail;
+    for (index = 0; index < count; index++) {
+        items[index] = ring->slots[(tail + index) & ring->mask];
+    }
+
+    /* hand the slots back to the producer */
+    cfl_atomic_store_explicit(&ring->tail, tail + count, CFL_ATOMIC_RELEASE);
+
+    notify(ring, &ring->writer_sleeping, &ring->writable_event);
+
+    return count;
+}
+
+void *cfl_spsc_ring_pop(struct cfl_spsc_ring *ring)
+{
+    void *item;
+
+    if (cfl_spsc_ring_pop_batch(ring, &item, 1) != 1) {
+        return NULL;
+    }
+
+    return item;
+}
+
+size_t cfl_spsc_ring_size(struct cfl_spsc_ring *ring)
+{
+    uint64_t head;
+    uint64_t tail;
+
+    tail = cfl_atomic_load_explicit(&ring->tail, CFL_ATOMIC_ACQUIRE);
+    head = cfl_atomic_load_explicit(&ring->head, CFL_ATOMIC_ACQUIRE);
+
+    if (head < tail) {
+        return 0;
+    }
+
+    return (size_t) (head - tail);
+}
+
+static inline int is_ready(struct cfl_spsc_ring *ring, int condition)
+{
+    if (condition == READY_READABLE) {
+        return consumer_available(ring, 1) > 0;
+    }
+
+    return producer_free(ring, 1) > 0;
+}
+
+static int ring_wait(struct cfl_spsc_ring *ring, int condition,
+                     int64_t timeout_ns)
+{
+    uint32_t  spin;
+    uint64_t  deadline;
+    uint64_t  now;
+    int64_t   remaining;
+    uint32_t *sleeping;
+    uint32_t *event;
+    uint32_t  value;
+
+    for (spin = 0; spin < ring->spins; spin++) {
+        if (is_ready(ring, condition)) {
+            return 0;
+        }
+        cfl_cpu_relax();
+    }
+
+    if (timeout_ns == 0) {
+        return is_ready(ring, condition) ? 0 : -1;
+    }
+
+    if (condition == READY_READABLE) {
+        sleeping = &ring->reader_sleeping;
+        event = &ring->readable_event;
+    }
+    else {
+        sleeping = &ring->writer_sleeping;
+        event = &ring->writable_event;
+    }
+
+    deadline = 0;
+    if (timeout_ns > 0) {
+        deadline = cfl_time_now() + (uint64_t) timeout_ns;
+    }
+
+    while (1) {
+        remaining = -1;
+        if (deadline != 0) {
+            now = cfl_time_now();
+            if (now >= deadline) {
+                return is_ready(ring, condition) ? 0 : -1;
+            }
+            remaining = (int64_t) (deadline - now);
+        }
+
+#ifdef SPSC_HAVE_FUTEX
+        if (ring->flags & CFL_SPSC_RING_WAIT) {
+            /*
+             * Announce the sleep, then read the event before checking the
+             * ring once more: a publish that misses the announcement is
+             * visible to the check, any later one changes the event and
+             * makes futex_wait() return.
+             */
+            cfl_atomic32_store_explicit(sleeping, 1, CFL_ATOMIC_RELAXED);
+            cfl_atomic_thread_fence(CFL_ATOMIC_SEQ_CST);
+            value = cfl_atomic32_load_explicit(event, CFL_ATOMIC_ACQUIRE);
+
+            if (!is_ready(ring, condition)) {
+                futex_wait(event, value, remaining);
+            }
+
+            cfl_atomic32_store_explicit(sleeping, 0, CFL_ATOMIC_RELAXED);
+        }
+        else {
+            cfl_thread_yield();
+        }
+#else
+        (void) sleeping;
+        (void) event;
+        (void) value;
+        (void) remaining;
+        cfl_thread_yield();
+#endif
+
+        if (is_ready(ring, condition)) {
+            return 0;
+        }
+    }
+}
+
+int cfl_spsc_ring_wait_readable(struct cfl_spsc_ring *ring,
+                                int64_t timeout_ns)
+{
+    return ring_wait(ring, READY_READABLE, timeout_ns);
+}
+
+int cfl_spsc_ring_wait_writable(struct cfl_spsc_ring *ring,
+                                int64_t timeout_ns)
+{
+    return ring_wait(ring, READY_WRITABLE, timeout_ns);
+}
@@ -0,0 +1,78 @@
+#ifndef CFL_THREAD_INTERNAL_H
+#define CFL_THREAD_INTERNAL_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#define CFL_THREAD_LOCAL __declspec(thread)
+#else
+#define CFL_THREAD_LOCAL __thread
+#endif
+
+/* minimal mutex for the slow paths of the concurrency modules */
+#if defined(_WIN32)
+#include <windows.h>
+
+typedef CRITICAL_SECTION cfl_mutex_t;
+
+static inline int cfl_mutex_init(cfl_mutex_t *mutex)
+{
+    InitializeCriticalSection(mutex);
+    return 0;
+}
+
+#define cfl_mutex_lock(mutex)    EnterCriticalSection(mutex)
+#define cfl_mutex_unlock(mutex)  LeaveCriticalSection(mutex)
+#define cfl_mutex_destroy(mutex) DeleteCriticalSection(mutex)
+#define cfl_thread_yield()       SwitchToThread()
+
+typedef HANDLE cfl_thread_t;
+typedef DWORD  cfl_thread_result_t;
+#define CFL_THREAD_CALL WINAPI
+
+#define cfl_thread_create(thread, routine, argument)                       \
+    ((*(thread) = CreateThread(NULL, 0, routine, argument, 0, NULL))      \
+     == NULL ? -1 : 0)
+
+static inline void cfl_thread_join(cfl_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static inline void cfl_thread_sleep(uint64_t nanoseconds)
+{
+    Sleep((DWORD) ((nanoseconds + 999999) / 1000000));
+}
+#else
+#include <pthread.h>
+#include <sched.h>
+
+typedef pthread_mutex_t cfl_mutex_t;
+
+#define cfl_mutex_init(mutex)    pthread_mutex_init(mutex, NULL)
+#define cfl_mutex_lock(mutex)    pthread_mutex_lock(mutex)
+#define cfl_mutex_unlock(mutex)  pthread_mutex_unlock(mutex)
+#define cfl_mutex_destroy(mutex) pthread_mutex_destroy(mutex)
+#define cfl_thread_yield()       sched_yield()
+
+typedef pthread_t cfl_thread_t;
+typedef void *    cfl_thread_result_t;
+#define CFL_THREAD_CALL
+
+#define cfl_thread_create(thread, routine, argument)                       \
+    (pthread_create(thread, NULL, routine, argument) == 0 ? 0 : -1)
+#define cfl_thread_join(thread)  pthread_join(thread, NULL)
+
+static inline void cfl_thread_sleep(uint64_t nanoseconds)
+{
+    struct timespec interval;
+
+    interval.tv_sec = (time_t) (nanoseconds / 1000000000);
+    interval.tv_nsec = (long) (nanoseconds % 1000000000);
+    nanosleep(&interval, NULL);
+}
+#endif
+
+#endif
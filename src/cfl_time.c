@@ -28,6 +28,64 @@
 #include <inttypes.h>
 #include <time.h>
 
+#include "cfl_cpu_internal.h"
+#include "cfl_thread_internal.h"
+
+#if defined(CFL_CPU_X86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#define TIME_CACHE_STOPPED       0
+#define TIME_CACHE_RUNNING       1
+#define TIME_CACHE_STOPPING      2
+
+#define TIME_CACHE_INTERVAL      1000000
+
+#define TSC_UNCALIBRATED         0
+#define TSC_CALIBRATING          1
+#define TSC_READY                2
+#define TSC_UNAVAILABLE          3
+
+/* counter ticks are scaled by 'mult' / 2^TSC_SHIFT */
+#define TSC_SHIFT                32
+#define TSC_CALIBRATION_NS       5000000
+
+/* re-anchor against the monotonic clock this often */
+#define TSC_RESYNC_NS            100000000
+
+/* bracketed reads per sample, the one with the smallest gap wins */
+#define TSC_SAMPLES              5
+
+/*
+ * Readers take the anchor (base_ns, base_ticks, mult) under 'sequence',
+ * which is odd while the thread holding 'resyncing' replaces it. The
+ * sample_* fields hold the last unadjusted sample and are only touched by
+ * that thread.
+ */
+struct time_tsc {
+    uint32_t state;
+    uint32_t sequence;
+    uint32_t resyncing;
+    uint64_t mult;
+    uint64_t base_ticks;
+    uint64_t base_ns;
+    uint64_t resync_ticks;
+    uint64_t sample_ticks;
+    uint64_t sample_ns;
+};
+
+static struct time_tsc tsc_clock;
+
+static uint32_t        cache_state = TIME_CACHE_STOPPED;
+static uint64_t        cache_interval;
+static uint64_t        cache_wall;
+static uint64_t        cache_monotonic;
+static cfl_thread_t    cache_thread;
+
 uint64_t cfl_time_now()
 {
     struct timespec tm = {0};
@@ -60,3 +118,476 @@ uint64_t cfl_time_now()
 
     return (((uint64_t) tm.tv_sec * 1000000000L) + tm.tv_nsec);
 }
+
+#if !defined(_WIN32) && !defined(CLOCK_MONOTONIC)
+#define CLOCK_MONOTONIC CLOCK_REALTIME
+#endif
+
+static inline uint64_t timespec_ns(struct timespec *tm)
+{
+    return ((uint64_t) tm->tv_sec * 1000000000L) + tm->tv_nsec;
+}
+
+#if defined(_WIN32)
+/* 100 ns intervals between 1601-01-01 and 1970-01-01 */
+#define FILETIME_UNIX_EPOCH 116444736000000000ULL
+
+static uint64_t performance_counter_ns()
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER        counter;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+
+    return ((uint64_t) counter.QuadPart / frequency.QuadPart) * 1000000000 +
+           ((uint64_t) counter.QuadPart % frequency.QuadPart) * 1000000000 /
+           frequency.QuadPart;
+}
+#endif
+
+uint64_t cfl_time_now_coarse()
+{
+#if defined(_WIN32)
+    FILETIME       file_time;
+    ULARGE_INTEGER value;
+
+    GetSystemTimeAsFileTime(&file_time);
+    value.LowPart = file_time.dwLowDateTime;
+    value.HighPart = file_time.dwHighDateTime;
+
+    return (value.QuadPart - FILETIME_UNIX_EPOCH) * 100;
+#elif defined(CLOCK_REALTIME_COARSE)
+    struct timespec tm;
+
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &tm) == 0) {
+        return timespec_ns(&tm);
+    }
+
+    return cfl_time_now();
+#else
+    return cfl_time_now();
+#endif
+}
+
+uint64_t cfl_time_monotonic()
+{
+#if defined(_WIN32)
+    return performance_counter_ns();
+#else
+    struct timespec tm = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+
+    return timespec_ns(&tm);
+#endif
+}
+
+uint64_t cfl_time_monotonic_coarse()
+{
+#if defined(_WIN32)
+    return (uint64_t) GetTickCount64() * 1000000;
+#elif defined(CLOCK_MONOTONIC_COARSE) || defined(CLOCK_MONOTONIC_RAW_APPROX)
+    struct timespec tm;
+
+#if defined(CLOCK_MONOTONIC_COARSE)
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &tm) == 0) {
+#else
+    if (clock_gettime(CLOCK_MONOTONIC_RAW_APPROX, &tm) == 0) {
+#endif
+        return timespec_ns(&tm);
+    }
+
+    return cfl_time_monotonic();
+#else
+    return cfl_time_monotonic();
+#endif
+}
+
+static inline uint64_t tsc_ticks()
+{
+#if defined(CFL_CPU_X86_64)
+    return __rdtsc();
+#elif defined(CFL_CPU_AARCH64) && (defined(__GNUC__) || defined(__clang__))
+    uint64_t ticks;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r" (ticks));
+
+    return ticks;
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t tsc_scale(uint64_t ticks, uint64_t mult)
+{
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t) (((unsigned __int128) ticks * mult) >> TSC_SHIFT);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low;
+
+    low = _umul128(ticks, mult, &high);
+
+    return (high << (64 - TSC_SHIFT)) | (low >> TSC_SHIFT);
+#else
+    return (uint64_t) ((double) ticks * mult / 4294967296.0);
+#endif
+}
+
+/*
+ * Read the counter between two monotonic reads and pair it with their
+ * midpoint; a preempted or slow read only widens the gap, so keep the
+ * tightest of a few tries. Returns the gap.
+ */
+static uint64_t tsc_sample(uint64_t *ns, uint64_t *ticks)
+{
+    int      index;
+    uint64_t before;
+    uint64_t after;
+    uint64_t counter;
+    uint64_t gap;
+
+    *ns = 0;
+    *ticks = 0;
+    gap = UINT64_MAX;
+    for (index = 0; index < TSC_SAMPLES; index++) {
+        before = cfl_time_monotonic();
+        counter = tsc_ticks();
+        after = cfl_time_monotonic();
+
+        if (after - before < gap) {
+            gap = after - before;
+            *ns = before + gap / 2;
+            *ticks = counter;
+        }
+    }
+
+    return gap;
+}
+
+static void tsc_anchor_set(uint64_t ns, uint64_t ticks, uint64_t mult)
+{
+    uint32_t sequence;
+
+    sequence = cfl_atomic32_load_explicit(&tsc_clock.sequence,
+                                          CFL_ATOMIC_RELAXED);
+    cfl_atomic32_store_explicit(&tsc_clock.sequence, sequence + 1,
+                                CFL_ATOMIC_RELAXED);
+    cfl_atomic_thread_fence(CFL_ATOMIC_RELEASE);
+
+    cfl_atomic_store_explicit(&tsc_clock.base_ns, ns, CFL_ATOMIC_RELAXED);
+    cfl_atomic_store_explicit(&tsc_clock.base_ticks, ticks,
+                              CFL_ATOMIC_RELAXED);
+    cfl_atomic_store_explicit(&tsc_clock.mult, mult, CFL_ATOMIC_RELAXED);
+
+    cfl_atomic32_store_explicit(&tsc_clock.sequence, sequence + 2,
+                                CFL_ATOMIC_RELEASE);
+}
+
+static void tsc_anchor_get(uint64_t *ns, uint64_t *ticks, uint64_t *mult)
+{
+    uint32_t sequence;
+
+    do {
+        sequence = cfl_atomic32_load_explicit(&tsc_clock.sequence,
+                                              CFL_ATOMIC_ACQUIRE);
+
+        *ns = cfl_atomic_load_explicit(&tsc_clock.base_ns, CFL_ATOMIC_RELAXED);
+        *ticks = cfl_atomic_load_explicit(&tsc_clock.base_ticks,
+                                          CFL_ATOMIC_RELAXED);
+        *mult = cfl_atomic_load_explicit(&tsc_clock.mult, CFL_ATOMIC_RELAXED);
+
+        cfl_atomic_thread_fence(CFL_ATOMIC_ACQUIRE);
+    } while ((sequence & 1) != 0 ||
+             sequence != cfl_atomic32_load_explicit(&tsc_clock.sequence,
+                                                    CFL_ATOMIC_RELAXED));
+}
+
+/* runs once, in the thread that wins the state transition */
+static void tsc_calibrate()
+{
+    uint64_t start_ns;
+    uint64_t start_ticks;
+    uint64_t end_ns;
+    uint64_t end_ticks;
+    uint64_t mult;
+
+#if defined(CFL_CPU_X86_64)
+    if ((cfl_cpu_features() & CFL_CPU_X86_INVARIANT_TSC) == 0) {
+        cfl_atomic32_store_explicit(&tsc_clock.state, TSC_UNAVAILABLE,
+                                    CFL_ATOMIC_RELEASE);
+        return;
+    }
+    mult = 0;
+#elif defined(CFL_CPU_AARCH64) && (defined(__GNUC__) || defined(__clang__))
+    uint64_t frequency;
+
+    /* the generic timer reports its own fixed frequency */
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r" (frequency));
+    mult = 0;
+    if (frequency != 0) {
+        mult = (UINT64_C(1000000000) << TSC_SHIFT) / frequency;
+    }
+#else
+    cfl_atomic32_store_explicit(&tsc_clock.state, TSC_UNAVAILABLE,
+                                CFL_ATOMIC_RELEASE);
+    return;
+#endif
+
+    tsc_sample(&start_ns, &start_ticks);
+
+    if (mult == 0) {
+        end_ns = start_ns;
+        end_ticks = start_ticks;
+        while (end_ns - start_ns < TSC_CALIBRATION_NS) {
+            tsc_sample(&end_ns, &end_ticks);
+        }
+
+        if (end_ticks <= start_ticks) {
+            cfl_atomic32_store_explicit(&tsc_clock.state, TSC_UNAVAILABLE,
+                                        CFL_ATOMIC_RELEASE);
+            return;
+        }
+
+        mult = ((end_ns - start_ns) << TSC_SHIFT) / (end_ticks - start_ticks);
+    }
+    else {
+        end_ns = start_ns;
+        end_ticks = start_ticks;
+    }
+
+    if (mult == 0) {
+        cfl_atomic32_store_explicit(&tsc_clock.state, TSC_UNAVAILABLE,
+                                    CFL_ATOMIC_RELEASE);
+        return;
+    }
+
+    tsc_clock.resync_ticks = ((uint64_t) TSC_RESYNC_NS << TSC_SHIFT) / mult;
+    tsc_clock.sample_ns = end_ns;
+    tsc_clock.sample_ticks = end_ticks;
+    tsc_anchor_set(end_ns, end_ticks, mult);
+
+    cfl_atomic32_store_explicit(&tsc_clock.state, TSC_READY,
+                                CFL_ATOMIC_RELEASE);
+}
+
+/*
+ * Re-anchor on a fresh sample and measure the rate over the interval since
+ * the previous one, which tracks adjustments of the monotonic clock and
+ * keeps the error from the first 5 ms calibration from accumulating.
+ * Readings never step back: when the old anchor runs ahead of the sample
+ * the new one starts from the extrapolated time with a rate slowed to meet
+ * the monotonic clock again by the next re-anchor.
+ *
+ * Returns 1 when this thread replaced the anchor, 0 otherwise.
+ */
+static int tsc_resync()
+{
+    int      replaced;
+    uint32_t expected;
+    uint64_t ns;
+    uint64_t ticks;
+    uint64_t base_ns;
+    uint64_t base_ticks;
+    uint64_t mult;
+    uint64_t current;
+    uint64_t ahead;
+    double   rate;
+
+    expected = 0;
+    if (!cfl_atomic32_compare_exchange_explicit(&tsc_clock.resyncing,
+                                                &expected, 1,
+                                                CFL_ATOMIC_ACQ_REL)) {
+        return 0;
+    }
+
+    tsc_anchor_get(&base_ns, &base_ticks, &mult);
+    tsc_sample(&ns, &ticks);
+
+    if (ticks > tsc_clock.sample_ticks && ns > tsc_clock.sample_ns) {
+        rate = (double) (ns - tsc_clock.sample_ns) /
+               (double) (ticks - tsc_clock.sample_ticks);
+    }
+    else {
+        rate = (double) mult / 4294967296.0;
+    }
+    tsc_clock.sample_ns = ns;
+    tsc_clock.sample_ticks = ticks;
+
+    current = base_ns;
+    if (ticks > base_ticks) {
+        current += tsc_scale(ticks - base_ticks, mult);
+    }
+
+    if (current > ns && current - ns < TSC_RESYNC_NS / 2) {
+        ahead = current - ns;
+        rate *= (double) (TSC_RESYNC_NS - ahead) / TSC_RESYNC_NS;
+        ns = current;
+    }
+
+    replaced = 0;
+    mult = (uint64_t) (rate * 4294967296.0);
+    if (mult > 0) {
+        tsc_anchor_set(ns, ticks, mult);
+        replaced = 1;
+    }
+
+    cfl_atomic32_store_explicit(&tsc_clock.resyncing, 0, CFL_ATOMIC_RELEASE);
+
+    return replaced;
+}
+
+static uint32_t tsc_state()
+{
+    uint32_t state;
+    uint32_t expected;
+
+    state = cfl_atomic32_load_explicit(&tsc_clock.state, CFL_ATOMIC_ACQUIRE);
+    if (state == TSC_UNCALIBRATED) {
+        expected = TSC_UNCALIBRATED;
+        if (cfl_atomic32_compare_exchange_explicit(&tsc_clock.state, &expected,
+                                                   TSC_CALIBRATING,
+                                                   CFL_ATOMIC_ACQ_REL)) {
+            tsc_calibrate();
+        }
+        state = cfl_atomic32_load_explicit(&tsc_clock.state,
+                                           CFL_ATOMIC_ACQUIRE);
+    }
+
+    return state;
+}
+
+int cfl_time_tsc_available()
+{
+    uint32_t state;
+
+    /* wait out a calibration running in another thread */
+    while ((state = tsc_state()) == TSC_CALIBRATING) {
+        cfl_thread_yield();
+    }
+
+    return state == TSC_READY;
+}
+
+uint64_t cfl_time_tsc()
+{
+    uint64_t ticks;
+    uint64_t base_ns;
+    uint64_t base_ticks;
+    uint64_t mult;
+
+    /* other threads use the monotonic clock while one calibrates */
+    if (tsc_state() != TSC_READY) {
+        return cfl_time_monotonic();
+    }
+
+    do {
+        tsc_anchor_get(&base_ns, &base_ticks, &mult);
+        ticks = tsc_ticks();
+        if (ticks < base_ticks) {
+            return base_ns;
+        }
+    } while (ticks - base_ticks >= tsc_clock.resync_ticks && tsc_resync());
+
+    return base_ns + tsc_scale(ticks - base_ticks, mult);
+}
+
+static void cache_update()
+{
+    cfl_atomic_store_explicit(&cache_wall, cfl_time_now(),
+                              CFL_ATOMIC_RELAXED);
+    cfl_atomic_store_explicit(&cache_monotonic, cfl_time_monotonic(),
+                              CFL_ATOMIC_RELAXED);
+}
+
+static cfl_thread_result_t CFL_THREAD_CALL cache_worker(void *data)
+{
+    (void) data;
+
+    while (cfl_atomic32_load_explicit(&cache_state, CFL_ATOMIC_ACQUIRE) ==
+           TIME_CACHE_RUNNING) {
+        cfl_thread_sleep(cache_interval);
+        cache_update();
+    }
+
+    return 0;
+}
+
+int cfl_time_cache_start(uint64_t interval_ns)
+{
+    uint32_t expected;
+
+    expected = TIME_CACHE_STOPPED;
+    if (!cfl_atomic32_compare_exchange_explicit(&cache_state, &expected,
+                                                TIME_CACHE_RUNNING,
+                                                CFL_ATOMIC_ACQ_REL)) {
+        /* already running, or being stopped by another thread */
+        return expected == TIME_CACHE_RUNNING ? 0 : -1;
+    }
+
+    if (interval_ns == 0) {
+        interval_ns = TIME_CACHE_INTERVAL;
+    }
+    cache_interval = interval_ns;
+
+    /* readers see fresh values as soon as the cache is running */
+    cache_update();
+
+    if (cfl_thread_create(&cache_thread, cache_worker, NULL) != 0) {
+        cfl_atomic_store_explicit(&cache_wall, 0, CFL_ATOMIC_RELAXED);
+        cfl_atomic_store_explicit(&cache_monotonic, 0, CFL_ATOMIC_RELAXED);
+        cfl_atomic32_store_explicit(&cache_state, TIME_CACHE_STOPPED,
+                                    CFL_ATOMIC_RELEASE);
+        return -1;
+    }
+
+    return 0;
+}
+
+void cfl_time_cache_stop()
+{
+    uint32_t expected;
+
+    expected = TIME_CACHE_RUNNING;
+    if (!cfl_atomic32_compare_exchange_explicit(&cache_state, &expected,
+                                                TIME_CACHE_STOPPING,
+                                                CFL_ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    cfl_thread_join(cache_thread);
+
+    cfl_atomic_store_explicit(&cache_wall, 0, CFL_ATOMIC_RELAXED);
+    cfl_atomic_store_explicit(&cache_monotonic, 0, CFL_ATOMIC_RELAXED);
+
+    cfl_atomic32_store_explicit(&cache_state, TIME_CACHE_STOPPED,
+                                CFL_ATOMIC_RELEASE);
+}
+
+/* the cached values are zero while the cache is stopped */
+uint64_t cfl_time_cached_now()
+{
+    uint64_t value;
+
+    value = cfl_atomic_load_explicit(&cache_wall, CFL_ATOMIC_RELAXED);
+    if (value == 0) {
+        return cfl_time_now_coarse();
+    }
+
+    return value;
+}
+
+uint64_t cfl_time_cached_monotonic()
+{
+    uint64_t value;
+
+    value = cfl_atomic_load_explicit(&cache_monotonic, CFL_ATOMIC_RELAXED);
+    if (value == 0) {
+        return cfl_time_monotonic_coarse();
+    }
+
+    return value;
+}
@@ -22,34 +22,7 @@
 #include <limits.h>
 #include <stdint.h>
 
-/* Lookup char into string, return position
- * Based on monkey/monkey's mk_string_char_search.
- */
-static int cfl_string_char_search(const char *string, int c, int len)
-{
-    char *p;
-    size_t string_len;
-
-    if (string == NULL) {
-        return -1;
-    }
-
-    if (len < 0) {
-        string_len = strlen(string);
-        if (string_len > INT_MAX) {
-            return -1;
-        }
-
-        len = (int) string_len;
-    }
-
-    p = memchr(string, c, len);
-    if (p) {
-        return (p - string);
-    }
-
-    return -1;
-}
+#include "cfl_scan_internal.h"
 
 /* Return a buffer with a new string from string.
  * Based on monkey/monkey's mk_string_copy_substr.
@@ -74,7 +47,7 @@ static char *cfl_string_copy_substr(const char *string, int pos_init, int pos_en
         size = 4;
     }
 
-    buffer = calloc(1, size);
+    buffer = cfl_calloc(1, size);
 
     if (!buffer) {
         return NULL;
@@ -87,186 +60,209 @@ static char *cfl_string_copy_substr(const char *string, int pos_init, int pos_en
 }
 
 /*
- * quoted_string_len returns the length of a quoted string, not including the quotes.
+ * Tokenizer state shared by the split functions. Separators are found with
+ * memchr(), quoted tokens with a scanner that classifies quotes and
+ * backslashes a 64-byte block at a time. 'parse_quotes' is set to CFL_TRUE
+ * when quotes shall be considered when tokenizing.
  */
-static int quoted_string_len(const char *str)
+struct tokenizer {
+    const char *line;
+    size_t length;
+    int separator;
+    int parse_quotes;
+    struct cfl_scan quotes;
+};
+
+static void tokenizer_init(struct tokenizer *tokenizer,
+                           const char *line, size_t length,
+                           int separator, int parse_quotes)
 {
-    int len = 0;
-    char quote;
+    tokenizer->line = line;
+    tokenizer->length = length;
+    tokenizer->separator = separator;
+    tokenizer->parse_quotes = parse_quotes;
 
-    if (str == NULL) {
-        return -1;
+    if (parse_quotes) {
+        cfl_scan_init(&tokenizer->quotes, line, length, '"', '\'', '\\');
     }
-
-    quote = *str++; /* Consume the quote character. */
-
-    while (quote != 0) {
-        char c = *str++;
-        switch (c) {
-            case '\0':
-                /* Error: string ends before end-quote was seen. */
-                return -1;
-            case '\\':
-                /* Skip escaped quote or \\. */
-                if (*str == quote || *str == '\\') {
-                    str++;
-                }
-                break;
-            case '\'':
-            case '"':
-                /* End-quote seen: stop iterating. */
-                if (c == quote) {
-                    quote = 0;
-                }
-                break;
-            default:
-                break;
-        }
-        if (len == INT_MAX) {
-            return -1;
-        }
-        len++;
-    }
-
-    /* Go back one character to ignore end-quote */
-    len--;
-
-    return len;
 }
 
 /*
- * next_token returns the next token in the string 'str' delimited by 'separator'.
- * 'out' is set to the beginning of the token.
- * 'out_len' is set to the length of the token.
- * 'parse_quotes' is set to CFL_TRUE when quotes shall be considered when tokenizing the 'str'.
- * The function returns offset to next token in the string.
+ * next_view locates the next token starting at '*offset'. For a quoted
+ * token the view covers the text between the quotes and 'escapes' is set
+ * when it holds escapes that must be removed. '*offset' is set to the
+ * separator (or end-quote) that ends the token.
+ * The function returns 0 on success or -1 on an unbalanced quote.
  */
-static int next_token(const char *str, int separator, char **out, int *out_len, int parse_quotes) {
-    const char *token_in = str;
-    char *token_out;
-    size_t token_len;
-    int next_separator = 0;
-    int quote = 0; /* Parser state: 0 not inside quoted string, or '"' or '\'' when inside quoted string. */
-    int len = 0;
-    int i;
-
-    if (str == NULL || out == NULL || out_len == NULL) {
-        return -1;
-    }
+static int next_view(struct tokenizer *tokenizer, size_t *offset,
+                     struct cfl_split_view *view, int *escapes)
+{
+    size_t start;
+    size_t end;
+    size_t length;
+    char quote;
+    const char *line;
+    const char *found;
+
+    line = tokenizer->line;
+    length = tokenizer->length;
+    start = *offset;
+    *escapes = CFL_FALSE;
 
     /* Skip leading separators. */
-    while (*token_in == separator) {
-        token_in++;
+    while (start < length && line[start] == tokenizer->separator) {
+        start++;
     }
 
-    /* Should quotes be parsed? Or is token quoted? If not, copy until separator or the end of string. */
-    if (parse_quotes == CFL_FALSE || (*token_in != '"' && *token_in != '\'')) {
-        token_len = strlen(token_in);
-        if (token_len > INT_MAX) {
-            return -1;
-        }
-
-        len = (int) token_len;
-        next_separator = cfl_string_char_search(token_in, separator, len);
-        if (next_separator > 0) {
-            len = next_separator;
+    /* Should quotes be parsed? Or is token quoted? If not, stop at separator or the end of string. */
+    if (tokenizer->parse_quotes == CFL_FALSE || start == length ||
+        (line[start] != '"' && line[start] != '\'')) {
+        found = memchr(line + start, tokenizer->separator, length - start);
+        if (found != NULL) {
+            end = (size_t) (found - line);
         }
-        *out_len = len;
-        *out = cfl_string_copy_substr(token_in, 0, len);
-        if (*out == NULL) {
-            return -1;
+        else {
+            end = length;
         }
 
-        return (int)(token_in - str) + len;
+        view->value = line + start;
+        view->len = end - start;
+        *offset = end;
+
+        return 0;
     }
 
-    /* Token is quoted. */
+    /* Token is quoted. Consume the quote character. */
+    quote = line[start++];
 
-    len = quoted_string_len(token_in);
-    if (len < 0) {
-        return -1;
-    }
+    end = start;
+    while ((end = cfl_scan_next(&tokenizer->quotes, end)) < length) {
+        if (line[end] == quote) {
+            break;
+        }
 
-    /* Consume the quote character. */
-    quote = *token_in++;
+        /* Escaped quote or \\. */
+        if (line[end] == '\\' && end + 1 < length &&
+            (line[end + 1] == quote || line[end + 1] == '\\')) {
+            *escapes = CFL_TRUE;
+            end++;
+        }
+        end++;
+    }
 
-    token_out = calloc(1, len + 1);
-    if (!token_out) {
+    if (end == length) {
+        /* Error: string ends before end-quote was seen. */
         return -1;
     }
 
-    /* Copy the token */
-    for (i = 0; i < len; i++) {
-        /* Handle escapes when inside quoted token:
-         *   \" -> "
-         *   \' -> '
-         *   \\ -> \
-         */
-        if (*token_in == '\\' && (token_in[1] == quote || token_in[1] == '\\')) {
-            token_in++;
+    view->value = line + start;
+    view->len = end - start;
+    *offset = end;
+
+    return 0;
+}
+
+/*
+ * Copy a quoted token to 'out' handling escapes:
+ *   \" -> "
+ *   \' -> '
+ *   \\ -> \
+ * Returns the unescaped length.
+ */
+static size_t unescape_view(char *out, const struct cfl_split_view *view,
+                            char quote)
+{
+    size_t i = 0;
+    size_t run;
+    size_t len = 0;
+
+    while (i < view->len) {
+        run = cfl_scan_find(view->value + i, view->len - i, '\\', '\\', '\\');
+        memcpy(out + len, view->value + i, run);
+        len += run;
+        i += run;
+        if (i == view->len) {
+            break;
         }
-        token_out[i] = *token_in++;
-    }
-    token_out[i] = '\0';
 
-    *out = token_out;
-    *out_len = len;
+        if (i + 1 < view->len &&
+            (view->value[i + 1] == quote || view->value[i + 1] == '\\')) {
+            i++;
+        }
+        out[len++] = view->value[i++];
+    }
 
-    return (int)(token_in - str);
+    return len;
 }
 
-
 static struct cfl_list *split(const char *line, int separator, int max_split, int quoted)
 {
-    int i = 0;
     int count = 0;
-    int val_len;
-    int len;
-    int end;
-    size_t line_len;
+    int escapes;
+    size_t i = 0;
+    size_t len;
+    size_t end;
     char *val;
     struct cfl_list *list;
     struct cfl_split_entry *new;
+    struct cfl_split_view view;
+    struct tokenizer tokenizer;
 
     if (!line) {
         return NULL;
     }
 
-    list = calloc(1, sizeof(struct cfl_list));
+    list = cfl_calloc(1, sizeof(struct cfl_list));
     if (!list) {
         cfl_errno();
         return NULL;
     }
     cfl_list_init(list);
 
-    line_len = strlen(line);
-    if (line_len > INT_MAX) {
-        free(list);
+    len = strlen(line);
+    if (len > INT_MAX) {
+        cfl_free(list);
         return NULL;
     }
 
-    len = (int) line_len;
+    tokenizer_init(&tokenizer, line, len, separator, quoted);
+
     while (i < len) {
-        end = next_token(line + i, separator, &val, &val_len, quoted);
-        if (end == -1) {
+        end = i;
+        if (next_view(&tokenizer, &end, &view, &escapes) == -1) {
+            cfl_report_runtime_error();
+            cfl_utils_split_free(list);
+            return NULL;
+        }
+
+        if (escapes) {
+            val = cfl_calloc(1, view.len + 1);
+            if (val != NULL) {
+                view.len = unescape_view(val, &view, line[view.value - line - 1]);
+            }
+        }
+        else {
+            val = cfl_string_copy_substr(view.value, 0, (int) view.len);
+        }
+        if (val == NULL) {
             cfl_report_runtime_error();
             cfl_utils_split_free(list);
             return NULL;
         }
 
         /* Update last position */
-        i += end;
+        i = end;
 
         /* Create new entry */
-        new = calloc(1, sizeof(struct cfl_split_entry));
+        new = cfl_calloc(1, sizeof(struct cfl_split_entry));
         if (!new) {
             cfl_errno();
-            free(val);
+            cfl_free(val);
             cfl_utils_split_free(list);
             return NULL;
         }
         new->value = val;
-        new->len = val_len;
+        new->len = (int) view.len;
         new->last_pos = i;
         cfl_list_add(&new->_head, list);
         count++;
@@ -280,20 +276,20 @@ static struct cfl_list *split(const char *line, int separator, int max_split, in
          * and last entry.
          */
         if (count >= max_split && max_split > 0 && i < len) {
-            new = calloc(1, sizeof(struct cfl_split_entry));
+            new = cfl_calloc(1, sizeof(struct cfl_split_entry));
             if (!new) {
                 cfl_errno();
                 cfl_utils_split_free(list);
                 return NULL;
             }
-            new->value = cfl_string_copy_substr(line, i, len);
+            new->value = cfl_string_copy_substr(line, (int) i, (int) len);
             if (new->value == NULL) {
                 cfl_errno();
-                free(new);
+                cfl_free(new);
                 cfl_utils_split_free(list);
                 return NULL;
             }
-            new->len   = len - i;
+            new->len   = (int) (len - i);
             cfl_list_add(&new->_head, list);
             break;
         }
@@ -320,8 +316,8 @@ void cfl_utils_split_free_entry(struct cfl_split_entry *entry)
     }
 
     cfl_list_del(&entry->_head);
-    free(entry->value);
-    free(entry);
+    cfl_free(entry->value);
+    cfl_free(entry);
 }
 
 void cfl_utils_split_free(struct cfl_list *list)
@@ -339,5 +335,147 @@ void cfl_utils_split_free(struct cfl_list *list)
         cfl_utils_split_free_entry(entry);
     }
 
-    free(list);
+    cfl_free(list);
+}
+
+/*
+ * split_view shares the tokenizer with split(). Escaped tokens are written
+ * to 'scratch', which the arena variant allocates on first use.
+ */
+static int split_view(struct cfl_arena *arena,
+                      const char *line, size_t length, int separator,
+                      int max_split, int quoted,
+                      struct cfl_split_view *views, size_t view_count,
+                      char *scratch, size_t scratch_size)
+{
+    int escapes;
+    size_t i = 0;
+    size_t end;
+    size_t used = 0;
+    size_t count = 0;
+    struct cfl_split_view view;
+    struct tokenizer tokenizer;
+
+    if (line == NULL || (views == NULL && view_count > 0)) {
+        return -1;
+    }
+
+    if (view_count > INT_MAX) {
+        view_count = INT_MAX;
+    }
+
+    tokenizer_init(&tokenizer, line, length, separator, quoted);
+
+    while (i < length) {
+        end = i;
+        if (next_view(&tokenizer, &end, &view, &escapes) == -1) {
+            return -1;
+        }
+
+        if (count == view_count) {
+            return -1;
+        }
+
+        if (escapes) {
+            if (scratch == NULL && arena != NULL) {
+                scratch = cfl_arena_malloc(arena, length);
+                scratch_size = length;
+            }
+            if (scratch == NULL || scratch_size - used < view.len) {
+                return -1;
+            }
+
+            view.len = unescape_view(scratch + used, &view,
+                                     line[view.value - line - 1]);
+            view.value = scratch + used;
+            used += view.len;
+        }
+
+        i = end;
+        view.last_pos = i;
+        views[count++] = view;
+
+        /* Skip the separator or end-quote */
+        i++;
+
+        /* Remaining bytes go into a last view */
+        if (count >= (size_t) max_split && max_split > 0 && i < length) {
+            if (count == view_count) {
+                return -1;
+            }
+
+            views[count].value = line + i;
+            views[count].len = length - i;
+            views[count].last_pos = length;
+            count++;
+            break;
+        }
+    }
+
+    return (int) count;
+}
+
+int cfl_utils_split_view(const char *line, size_t length, int separator,
+                         int max_split,
+                         struct cfl_split_view *views, size_t view_count)
+{
+    return split_view(NULL, line, length, separator, max_split, CFL_FALSE,
+                      views, view_count, NULL, 0);
+}
+
+int cfl_utils_split_quoted_view(const char *line, size_t length,
+                                int separator, int max_split,
+                                struct cfl_split_view *views,
+                                size_t view_count,
+                                char *scratch, size_t scratch_size)
+{
+    return split_view(NULL, line, length, separator, max_split, CFL_TRUE,
+                      views, view_count, scratch, scratch_size);
+}
+
+int cfl_utils_split_view_in(struct cfl_arena *arena,
+                            const char *line, size_t length, int separator,
+                            int max_split, int quoted,
+                            struct cfl_split_view **views)
+{
+    int ret;
+    size_t count;
+
+    if (arena == NULL || line == NULL || views == NULL) {
+        return -1;
+    }
+
+    *views = NULL;
+
+    /*
+     * Every token but the last one ends at a separator, or at the end-quote
+     * of a quoted token.
+     */
+    if (quoted) {
+        count = cfl_scan_count(line, length, separator, '"', '\'') + 1;
+    }
+    else {
+        count = cfl_scan_count(line, length, separator, separator, separator) + 1;
+    }
+
+    if (max_split > 0 && count > (size_t) max_split + 1) {
+        count = (size_t) max_split + 1;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    *views = cfl_arena_malloc(arena, count * sizeof(struct cfl_split_view));
+    if (*views == NULL) {
+        return -1;
+    }
+
+    ret = split_view(arena, line, length, separator, max_split, quoted,
+                     *views, count, NULL, 0);
+    if (ret <= 0) {
+        *views = NULL;
+    }
+
+    return ret;
 }
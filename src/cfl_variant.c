@@ -22,6 +22,10 @@
 #include <cfl/cfl_arena.h>
 
 #include "cfl_arena_internal.h"
+#include "cfl_otlp_internal.h"
+#include "cfl_size_cache_internal.h"
+#include "cfl_number_internal.h"
+#include "cfl_object_cache_internal.h"
 
 static void variant_instance_release(struct cfl_variant *instance)
 {
@@ -30,7 +34,7 @@ static void variant_instance_release(struct cfl_variant *instance)
     }
 
     if (instance->arena == NULL) {
-        free(instance);
+        cfl_object_cache_free(instance, sizeof(struct cfl_variant));
     }
     else {
         cfl_arena_free_variant(instance->arena, instance,
@@ -41,6 +45,8 @@ static void variant_instance_release(struct cfl_variant *instance)
 #include <cfl/cfl_kvlist.h>
 #include <cfl/cfl_container.h>
 #include <cfl/cfl_compat.h>
+#include <cfl/cfl_image.h>
+#include <cfl/cfl_codec.h>
 
 #include <limits.h>
 #include <math.h>
@@ -48,6 +54,8 @@ static void variant_instance_release(struct cfl_variant *instance)
 #include <float.h>
 #endif
 
+#define VARIANT_SIZE_MAX_DEPTH 512
+
 static int double_is_finite(double value)
 {
 #if defined(_MSC_VER)
@@ -132,11 +140,72 @@ static int print_json_string(FILE *fp, const char *str, size_t len)
     return (int) written;
 }
 
+/*
+ * Encodes in chunks so large payloads need no heap buffer. Returns the
+ * number of characters written, clamped to INT_MAX.
+ */
+static int print_bytes(FILE *fp, const char *data, size_t size,
+                       int bytes_format)
+{
+    char buffer[1024];
+    size_t chunk;
+    size_t length;
+    size_t total;
+    int quoted;
+
+    if (bytes_format == CFL_VARIANT_PRINT_BYTES_BASE64) {
+        chunk = sizeof(buffer) / 4 * 3;
+    }
+    else if (bytes_format == CFL_VARIANT_PRINT_BYTES_HEX ||
+             bytes_format == CFL_VARIANT_PRINT_BYTES_RAW_HEX) {
+        chunk = sizeof(buffer) / 2;
+    }
+    else {
+        return -1;
+    }
+
+    quoted = bytes_format != CFL_VARIANT_PRINT_BYTES_RAW_HEX;
+    if (quoted && fputc('"', fp) == EOF) {
+        return -1;
+    }
+    total = quoted ? 2 : 0;
+
+    while (size > 0) {
+        if (chunk > size) {
+            chunk = size;
+        }
+
+        if (bytes_format == CFL_VARIANT_PRINT_BYTES_BASE64) {
+            length = cfl_base64_encode(data, chunk, buffer);
+        }
+        else {
+            length = cfl_hex_encode(data, chunk, buffer);
+        }
+
+        if (fwrite(buffer, 1, length, fp) != length) {
+            return -1;
+        }
+        total += length;
+
+        data += chunk;
+        size -= chunk;
+    }
+
+    if (quoted && fputc('"', fp) == EOF) {
+        return -1;
+    }
+
+    return total > INT_MAX ? INT_MAX : (int) total;
+}
+
 int cfl_variant_print(FILE *fp, struct cfl_variant *val)
+{
+    return cfl_variant_print_ex(fp, val, CFL_VARIANT_PRINT_BYTES_RAW_HEX);
+}
+
+int cfl_variant_print_ex(FILE *fp, struct cfl_variant *val, int bytes_format)
 {
     int ret = -1;
-    size_t size;
-    size_t i;
 
     if (fp == NULL || val == NULL) {
         return -1;
@@ -179,25 +248,18 @@ int cfl_variant_print(FILE *fp, struct cfl_variant *val)
             return -1;
         }
 
-        size = val->size;
-        ret = 0;
-        for (i = 0; i < size; i++) {
-            ret = fprintf(fp, "%02x", (unsigned char)val->data.as_bytes[i]);
-            if (ret < 0) {
-                return -1;
-            }
-        }
+        ret = print_bytes(fp, val->data.as_bytes, val->size, bytes_format);
         break;
 
     case CFL_VARIANT_REFERENCE:
         ret = fputs("null", fp);
         break;
     case CFL_VARIANT_ARRAY:
-        ret = cfl_array_print(fp, val->data.as_array);
+        ret = cfl_array_print_ex(fp, val->data.as_array, bytes_format);
         break;
 
     case CFL_VARIANT_KVLIST:
-        ret = cfl_kvlist_print(fp, val->data.as_kvlist);
+        ret = cfl_kvlist_print_ex(fp, val->data.as_kvlist, bytes_format);
         break;
 
     default:
@@ -206,6 +268,230 @@ int cfl_variant_print(FILE *fp, struct cfl_variant *val)
     return ret;
 }
 
+static int size_add(size_t *total, size_t value)
+{
+    if (*total > SIZE_MAX - value) {
+        return -1;
+    }
+
+    *total += value;
+
+    return 0;
+}
+
+static size_t decimal_digits(uint64_t value)
+{
+    size_t digits;
+
+    digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+
+    return digits;
+}
+
+static int json_string_size(const char *str, size_t len, size_t *size)
+{
+    size_t i;
+    size_t total;
+    unsigned char c;
+
+    if ((str == NULL && len > 0) || len > (SIZE_MAX - 2) / 6) {
+        return -1;
+    }
+
+    /* same escaping rules as print_json_string() */
+    total = 2;
+    for (i = 0; i < len; i++) {
+        c = (unsigned char) str[i];
+        if (c == '"' || c == '\\' || c == '\b' || c == '\f' ||
+            c == '\n' || c == '\r' || c == '\t') {
+            total += 2;
+        }
+        else if (c < 0x20) {
+            total += 6;
+        }
+        else {
+            total++;
+        }
+    }
+
+    *size = total;
+
+    return 0;
+}
+
+static int json_value_size(struct cfl_variant *value,
+                           struct cfl_size_cache *cache, size_t depth,
+                           size_t *size);
+
+static int json_array_size(struct cfl_array *array,
+                           struct cfl_size_cache *cache, size_t depth,
+                           size_t *size)
+{
+    size_t i;
+    size_t total;
+    size_t entry_size;
+
+    if (cfl_size_cache_lookup(cache, array, CFL_VARIANT_FORMAT_JSON,
+                              size) == 0) {
+        return 0;
+    }
+
+    /* brackets and the separators between entries */
+    total = 2;
+    if (array->entry_count > 0) {
+        total += array->entry_count - 1;
+    }
+
+    for (i = 0; i < array->entry_count; i++) {
+        if (json_value_size(array->entries[i], cache, depth + 1,
+                            &entry_size) != 0 ||
+            size_add(&total, entry_size) != 0) {
+            return -1;
+        }
+    }
+
+    cfl_size_cache_store(cache, array, CFL_VARIANT_FORMAT_JSON, total);
+    *size = total;
+
+    return 0;
+}
+
+static int json_kvlist_size(struct cfl_kvlist *kvlist,
+                            struct cfl_size_cache *cache, size_t depth,
+                            size_t *size)
+{
+    int printed;
+    size_t total;
+    size_t key_size;
+    size_t value_size;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+
+    if (cfl_size_cache_lookup(cache, kvlist, CFL_VARIANT_FORMAT_JSON,
+                              size) == 0) {
+        return 0;
+    }
+
+    total = 2;
+    printed = CFL_FALSE;
+    cfl_list_foreach(head, &kvlist->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (pair->key == NULL || pair->val == NULL) {
+            continue;
+        }
+
+        /* the colon, preceded by a comma after the first pair */
+        if (json_string_size(pair->key, cfl_sds_len(pair->key),
+                             &key_size) != 0 ||
+            json_value_size(pair->val, cache, depth + 1, &value_size) != 0 ||
+            size_add(&total, (printed ? 2 : 1)) != 0 ||
+            size_add(&total, key_size) != 0 ||
+            size_add(&total, value_size) != 0) {
+            return -1;
+        }
+        printed = CFL_TRUE;
+    }
+
+    cfl_size_cache_store(cache, kvlist, CFL_VARIANT_FORMAT_JSON, total);
+    *size = total;
+
+    return 0;
+}
+
+static int json_value_size(struct cfl_variant *value,
+                           struct cfl_size_cache *cache, size_t depth,
+                           size_t *size)
+{
+    int length;
+
+    if (value == NULL || depth > VARIANT_SIZE_MAX_DEPTH) {
+        return -1;
+    }
+
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+        return json_string_size(value->data.as_string, value->size, size);
+    case CFL_VARIANT_BOOL:
+        *size = value->data.as_bool ? 4 : 5;
+        return 0;
+    case CFL_VARIANT_INT:
+        if (value->data.as_int64 < 0) {
+            *size = 1 + decimal_digits(0 - (uint64_t) value->data.as_int64);
+        }
+        else {
+            *size = decimal_digits((uint64_t) value->data.as_int64);
+        }
+        return 0;
+    case CFL_VARIANT_UINT:
+        *size = decimal_digits(value->data.as_uint64);
+        return 0;
+    case CFL_VARIANT_DOUBLE:
+        if (!double_is_finite(value->data.as_double)) {
+            *size = 4;
+            return 0;
+        }
+        length = snprintf(NULL, 0, "%lf", value->data.as_double);
+        if (length < 0) {
+            return -1;
+        }
+        *size = (size_t) length;
+        return 0;
+    case CFL_VARIANT_NULL:
+    case CFL_VARIANT_REFERENCE:
+        *size = 4;
+        return 0;
+    case CFL_VARIANT_BYTES:
+        if ((value->data.as_bytes == NULL && value->size > 0) ||
+            value->size > SIZE_MAX / 2) {
+            return -1;
+        }
+        *size = value->size * 2;
+        return 0;
+    case CFL_VARIANT_ARRAY:
+        if (value->data.as_array == NULL) {
+            return -1;
+        }
+        return json_array_size(value->data.as_array, cache, depth, size);
+    case CFL_VARIANT_KVLIST:
+        if (value->data.as_kvlist == NULL) {
+            return -1;
+        }
+        return json_kvlist_size(value->data.as_kvlist, cache, depth, size);
+    }
+
+    return -1;
+}
+
+int cfl_variant_encoded_size_cached(struct cfl_variant *value, int format,
+                                    struct cfl_size_cache *cache,
+                                    size_t *size)
+{
+    if (value == NULL || size == NULL) {
+        return -1;
+    }
+
+    switch (format) {
+    case CFL_VARIANT_FORMAT_JSON:
+        return json_value_size(value, cache, 0, size);
+    case CFL_VARIANT_FORMAT_OTLP:
+        return cfl_otlp_any_value_size_cached(value, cache, size);
+    case CFL_VARIANT_FORMAT_IMAGE:
+        return cfl_image_size(value, size);
+    }
+
+    return -1;
+}
+
+int cfl_variant_encoded_size(struct cfl_variant *value, int format,
+                             size_t *size)
+{
+    return cfl_variant_encoded_size_cached(value, format, NULL, size);
+}
+
 struct cfl_variant *cfl_variant_create_from_string_s(char *value, size_t value_size, int referenced)
 {
     struct cfl_variant *instance;
@@ -225,14 +511,14 @@ struct cfl_variant *cfl_variant_create_from_string_s(char *value, size_t value_s
     }
     else {
         if (value_size > INT_MAX) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
 
         instance->data.as_string = cfl_sds_create_len_in(NULL, value,
                                                          (int) value_size);
         if (instance->data.as_string == NULL) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
 
@@ -271,13 +557,13 @@ struct cfl_variant *cfl_variant_create_from_bytes(char *value, size_t length, in
     }
     else {
         if (length > INT_MAX) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
 
         instance->data.as_bytes = cfl_sds_create_len(value, (int) length);
         if (instance->data.as_bytes == NULL) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
     }
@@ -359,7 +645,7 @@ struct cfl_variant *cfl_variant_create_from_array(struct cfl_array *value)
     if (instance != NULL) {
         if (value != NULL &&
             cfl_container_claim_array(value, instance) != 0) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
 
@@ -378,7 +664,7 @@ struct cfl_variant *cfl_variant_create_from_kvlist(struct cfl_kvlist *value)
     if (instance != NULL) {
         if (value != NULL &&
             cfl_container_claim_kvlist(value, instance) != 0) {
-            free(instance);
+            variant_instance_release(instance);
             return NULL;
         }
 
@@ -406,13 +692,12 @@ struct cfl_variant *cfl_variant_create()
 {
     struct cfl_variant *instance;
 
-    instance = calloc(1, sizeof(struct cfl_variant));
+    instance = cfl_object_cache_alloc(sizeof(struct cfl_variant));
     if (instance == NULL) {
         cfl_errno();
         return NULL;
     }
-    instance->size = 0;
-    instance->arena = NULL;
+    memset(instance, 0, sizeof(struct cfl_variant));
 
     return instance;
 }
@@ -612,6 +897,26 @@ struct cfl_variant *cfl_variant_create_from_kvlist_in(struct cfl_arena *arena,
     return instance;
 }
 
+struct cfl_variant *cfl_variant_create_from_numeric_text_in(struct cfl_arena *arena,
+                                                            const char *text,
+                                                            size_t length)
+{
+    struct cfl_number number;
+
+    if (cfl_number_parse(text, length, &number) != 0) {
+        return NULL;
+    }
+
+    if (number.type == CFL_VARIANT_INT) {
+        return cfl_variant_create_from_int64_in(arena, number.data.as_int64);
+    }
+    else if (number.type == CFL_VARIANT_UINT) {
+        return cfl_variant_create_from_uint64_in(arena, number.data.as_uint64);
+    }
+
+    return cfl_variant_create_from_double_in(arena, number.data.as_double);
+}
+
 void cfl_variant_destroy(struct cfl_variant *instance)
 {
     if (!instance) {
@@ -0,0 +1,629 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_variant.h>
+#include <cfl/cfl_array.h>
+#include <cfl/cfl_kvlist.h>
+#include <cfl/cfl_hash.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfl_size_cache_internal.h"
+
+/*
+ * Frames are heap allocated, so the limit only has to stay above the depth
+ * the container API lets graphs reach; it stops walks of cycles built by
+ * hand.
+ */
+#define VARIANT_HASH_MAX_DEPTH     1024
+#define VARIANT_HASH_FRAMES        16
+
+/* per-type seeds keep e.g. the string "1" and the bytes "1" apart */
+#define HASH_SEED(type)  (UINT64_C(0x9e3779b97f4a7c15) * (uint64_t) ((type) + 1))
+
+/*
+ * Containers being hashed. The walk descends into one child at a time and
+ * folds its hash into the parent frame once the child is complete.
+ */
+struct hash_frame {
+    int type;
+    void *container;
+    size_t index;
+    struct cfl_list *cursor;
+    struct cfl_list *head;
+    uint64_t hash;
+    uint64_t sum;
+    uint64_t mix;
+    uint64_t key_hash;
+};
+
+/* one kvlist pair, sorted by key for key-order-insensitive comparison */
+struct equal_entry {
+    const char *key;
+    size_t key_length;
+    uint64_t value_hash;
+    struct cfl_variant *value;
+};
+
+/* pairs of containers being compared */
+struct equal_frame {
+    int type;
+    struct cfl_array *array_a;
+    struct cfl_array *array_b;
+    struct cfl_list *cursor_a;
+    struct cfl_list *cursor_b;
+    struct cfl_list *head_a;
+    struct cfl_list *head_b;
+    struct equal_entry *entries_a;
+    struct equal_entry *entries_b;
+    size_t index;
+    size_t count;
+};
+
+static void store_le64(unsigned char *buffer, uint64_t value)
+{
+    int index;
+
+    for (index = 0; index < 8; index++) {
+        buffer[index] = (unsigned char) (value >> (index * 8));
+    }
+}
+
+/* order-dependent fold of 'value' into 'hash' */
+static uint64_t hash_combine(uint64_t hash, uint64_t value)
+{
+    unsigned char buffer[8];
+
+    store_le64(buffer, value);
+
+    return cfl_hash_64bits_with_seed(buffer, sizeof(buffer), hash);
+}
+
+static uint64_t hash_double(double value)
+{
+    uint64_t bits;
+    unsigned char buffer[8];
+
+    /* equal values hash equally: -0.0 == 0.0 and NaN matches NaN */
+    if (value == 0) {
+        value = 0;
+    }
+
+    if (isnan(value)) {
+        bits = UINT64_C(0x7ff8000000000000);
+    }
+    else {
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    store_le64(buffer, bits);
+
+    return cfl_hash_64bits_with_seed(buffer, sizeof(buffer),
+                                     HASH_SEED(CFL_VARIANT_DOUBLE));
+}
+
+static uint64_t hash_scalar(struct cfl_variant *value)
+{
+    unsigned char buffer[8];
+
+    switch (value->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        return cfl_hash_64bits_with_seed(value->data.as_string, value->size,
+                                         HASH_SEED(value->type));
+    case CFL_VARIANT_BOOL:
+        buffer[0] = value->data.as_bool ? 1 : 0;
+        return cfl_hash_64bits_with_seed(buffer, 1, HASH_SEED(value->type));
+    case CFL_VARIANT_INT:
+        store_le64(buffer, (uint64_t) value->data.as_int64);
+        break;
+    case CFL_VARIANT_UINT:
+        store_le64(buffer, value->data.as_uint64);
+        break;
+    case CFL_VARIANT_DOUBLE:
+        return hash_double(value->data.as_double);
+    case CFL_VARIANT_REFERENCE:
+        store_le64(buffer, (uint64_t) (uintptr_t) value->data.as_reference);
+        break;
+    default:
+        return cfl_hash_64bits_with_seed(NULL, 0, HASH_SEED(value->type));
+    }
+
+    return cfl_hash_64bits_with_seed(buffer, sizeof(buffer),
+                                     HASH_SEED(value->type));
+}
+
+static int frames_reserve(void **frames, size_t *capacity, size_t count,
+                          size_t frame_size)
+{
+    size_t size;
+    void *tmp;
+
+    if (count < *capacity) {
+        return 0;
+    }
+
+    if (count >= VARIANT_HASH_MAX_DEPTH) {
+        return -1;
+    }
+
+    size = *capacity == 0 ? VARIANT_HASH_FRAMES : *capacity * 2;
+    tmp = cfl_realloc(*frames, size * frame_size);
+    if (tmp == NULL) {
+        cfl_errno();
+        return -1;
+    }
+    *frames = tmp;
+    *capacity = size;
+
+    return 0;
+}
+
+/* next pair with a key and a value, or NULL at the end of the list */
+static struct cfl_kvpair *kvlist_next(struct cfl_list **cursor,
+                                      struct cfl_list *head)
+{
+    struct cfl_kvpair *pair;
+
+    while (*cursor != head) {
+        pair = cfl_list_entry(*cursor, struct cfl_kvpair, _head);
+        *cursor = (*cursor)->next;
+        if (pair->key != NULL && pair->val != NULL) {
+            return pair;
+        }
+    }
+
+    return NULL;
+}
+
+static int variant_hash(struct cfl_variant *value, int flags,
+                        struct cfl_size_cache *cache, uint64_t *hash)
+{
+    int opened;
+    int unordered;
+    size_t count;
+    size_t capacity;
+    uint64_t result;
+    void *container;
+    struct cfl_array *array;
+    struct hash_frame *frame;
+    struct hash_frame *frames;
+    struct cfl_kvpair *pair;
+
+    if (value == NULL || hash == NULL) {
+        return -1;
+    }
+
+    unordered = (flags & CFL_VARIANT_KVLIST_UNORDERED) != 0;
+    frames = NULL;
+    capacity = 0;
+    count = 0;
+
+    while (1) {
+        /* hash 'value', or open a frame when it is an uncached container */
+        opened = CFL_FALSE;
+        result = 0;
+
+        if (value->type == CFL_VARIANT_ARRAY) {
+            container = value->data.as_array;
+        }
+        else if (value->type == CFL_VARIANT_KVLIST) {
+            container = value->data.as_kvlist;
+        }
+        else {
+            container = NULL;
+            result = hash_scalar(value);
+        }
+
+        if (container != NULL &&
+            cfl_size_cache_lookup_hash(cache, container, unordered,
+                                       &result) != 0) {
+            if (frames_reserve((void **) &frames, &capacity, count,
+                               sizeof(struct hash_frame)) != 0) {
+                cfl_free(frames);
+                return -1;
+            }
+
+            frame = &frames[count++];
+            memset(frame, 0, sizeof(struct hash_frame));
+            frame->type = value->type;
+            frame->container = container;
+
+            if (value->type == CFL_VARIANT_ARRAY) {
+                frame->hash = hash_combine(HASH_SEED(value->type),
+                                           value->data.as_array->entry_count);
+            }
+            else {
+                frame->head = &value->data.as_kvlist->list;
+                frame->cursor = frame->head->next;
+                frame->hash = HASH_SEED(value->type);
+            }
+            opened = CFL_TRUE;
+        }
+        else if (container == NULL && (value->type == CFL_VARIANT_ARRAY ||
+                                       value->type == CFL_VARIANT_KVLIST)) {
+            cfl_free(frames);
+            return -1;
+        }
+
+        /*
+         * Fold the completed hash into its parent and move to the next
+         * child, closing every frame that runs out of children.
+         */
+        while (1) {
+            if (count == 0) {
+                cfl_free(frames);
+                *hash = result;
+                return 0;
+            }
+
+            frame = &frames[count - 1];
+            if (!opened) {
+                if (frame->type == CFL_VARIANT_ARRAY) {
+                    frame->hash = hash_combine(frame->hash, result);
+                }
+                else {
+                    result = hash_combine(frame->key_hash, result);
+                    if (unordered) {
+                        /* commutative, so the key order does not matter */
+                        frame->sum += result;
+                        frame->mix ^= hash_combine(0, result);
+                    }
+                    else {
+                        frame->hash = hash_combine(frame->hash, result);
+                    }
+                }
+            }
+            opened = CFL_FALSE;
+
+            if (frame->type == CFL_VARIANT_ARRAY) {
+                array = frame->container;
+                if (frame->index < array->entry_count) {
+                    value = array->entries[frame->index++];
+                    break;
+                }
+                result = frame->hash;
+            }
+            else {
+                pair = kvlist_next(&frame->cursor, frame->head);
+                if (pair != NULL) {
+                    frame->key_hash = cfl_hash_64bits_with_seed(pair->key,
+                                          cfl_sds_len(pair->key),
+                                          HASH_SEED(CFL_VARIANT_STRING));
+                    value = pair->val;
+                    break;
+                }
+
+                result = frame->hash;
+                if (unordered) {
+                    result = hash_combine(hash_combine(result, frame->sum),
+                                          frame->mix);
+                }
+            }
+
+            cfl_size_cache_store_hash(cache, frame->container, unordered,
+                                      result);
+            count--;
+        }
+
+        if (value == NULL) {
+            cfl_free(frames);
+            return -1;
+        }
+    }
+}
+
+int cfl_variant_hash(struct cfl_variant *value, int flags, uint64_t *hash)
+{
+    return variant_hash(value, flags, NULL, hash);
+}
+
+int cfl_variant_hash_cached(struct cfl_variant *value, int flags,
+                            struct cfl_size_cache *cache, uint64_t *hash)
+{
+    return variant_hash(value, flags, cache, hash);
+}
+
+static int scalar_equal(struct cfl_variant *a, struct cfl_variant *b)
+{
+    switch (a->type) {
+    case CFL_VARIANT_STRING:
+    case CFL_VARIANT_BYTES:
+        if (a->size != b->size) {
+            return CFL_FALSE;
+        }
+        return a->size == 0 ||
+               memcmp(a->data.as_string, b->data.as_string, a->size) == 0;
+    case CFL_VARIANT_BOOL:
+        return (a->data.as_bool != 0) == (b->data.as_bool != 0);
+    case CFL_VARIANT_INT:
+        return a->data.as_int64 == b->data.as_int64;
+    case CFL_VARIANT_UINT:
+        return a->data.as_uint64 == b->data.as_uint64;
+    case CFL_VARIANT_DOUBLE:
+        return a->data.as_double == b->data.as_double ||
+               (isnan(a->data.as_double) && isnan(b->data.as_double));
+    case CFL_VARIANT_REFERENCE:
+        return a->data.as_reference == b->data.as_reference;
+    default:
+        return CFL_TRUE;
+    }
+}
+
+static int entry_compare(const void *first, const void *second)
+{
+    int ret;
+    size_t length;
+    const struct equal_entry *a = first;
+    const struct equal_entry *b = second;
+
+    length = a->key_length < b->key_length ? a->key_length : b->key_length;
+    ret = memcmp(a->key, b->key, length);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (a->key_length != b->key_length) {
+        return a->key_length < b->key_length ? -1 : 1;
+    }
+
+    if (a->value_hash != b->value_hash) {
+        return a->value_hash < b->value_hash ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Sorted pairs of a kvlist. Pairs sharing a key are ordered by value hash
+ * so equal multisets line up; the hashes are only computed when a key
+ * repeats.
+ */
+static int kvlist_entries(struct cfl_kvlist *kvlist,
+                          struct equal_entry **out, size_t *out_count)
+{
+    int duplicates;
+    size_t count;
+    size_t index;
+    struct cfl_list *cursor;
+    struct cfl_kvpair *pair;
+    struct equal_entry *entries;
+
+    *out = NULL;
+    *out_count = 0;
+    count = (size_t) cfl_list_size(&kvlist->list);
+    if (count == 0) {
+        return 0;
+    }
+
+    entries = cfl_calloc(count, sizeof(struct equal_entry));
+    if (entries == NULL) {
+        cfl_errno();
+        return -1;
+    }
+
+    index = 0;
+    cursor = kvlist->list.next;
+    while ((pair = kvlist_next(&cursor, &kvlist->list)) != NULL) {
+        entries[index].key = pair->key;
+        entries[index].key_length = cfl_sds_len(pair->key);
+        entries[index].value = pair->val;
+        index++;
+    }
+    count = index;
+
+    qsort(entries, count, sizeof(struct equal_entry), entry_compare);
+
+    duplicates = CFL_FALSE;
+    for (index = 1; index < count; index++) {
+        if (entries[index].key_length == entries[index - 1].key_length &&
+            memcmp(entries[index].key, entries[index - 1].key,
+                   entries[index].key_length) == 0) {
+            duplicates = CFL_TRUE;
+            break;
+        }
+    }
+
+    if (duplicates) {
+        for (index = 0; index < count; index++) {
+            if (variant_hash(entries[index].value,
+                             CFL_VARIANT_KVLIST_UNORDERED, NULL,
+                             &entries[index].value_hash) != 0) {
+                cfl_free(entries);
+                return -1;
+            }
+        }
+        qsort(entries, count, sizeof(struct equal_entry), entry_compare);
+    }
+
+    *out = entries;
+    *out_count = count;
+
+    return 0;
+}
+
+static int entry_keys_equal(struct equal_entry *a, struct equal_entry *b)
+{
+    return a->key_length == b->key_length &&
+           memcmp(a->key, b->key, a->key_length) == 0;
+}
+
+static void equal_frames_destroy(struct equal_frame *frames, size_t count)
+{
+    size_t index;
+
+    for (index = 0; index < count; index++) {
+        cfl_free(frames[index].entries_a);
+        cfl_free(frames[index].entries_b);
+    }
+    cfl_free(frames);
+}
+
+static int keys_equal(struct cfl_kvpair *a, struct cfl_kvpair *b)
+{
+    return cfl_sds_len(a->key) == cfl_sds_len(b->key) &&
+           memcmp(a->key, b->key, cfl_sds_len(a->key)) == 0;
+}
+
+int cfl_variant_equal(struct cfl_variant *a, struct cfl_variant *b,
+                      int flags)
+{
+    int unordered;
+    size_t count;
+    size_t capacity;
+    size_t entries;
+    struct equal_frame *frame;
+    struct equal_frame *frames;
+    struct cfl_kvpair *pair_a;
+    struct cfl_kvpair *pair_b;
+
+    if (a == NULL || b == NULL) {
+        return -1;
+    }
+
+    unordered = (flags & CFL_VARIANT_KVLIST_UNORDERED) != 0;
+    frames = NULL;
+    capacity = 0;
+    count = 0;
+
+    while (1) {
+        if (a != b) {
+            if (a == NULL || b == NULL || a->type != b->type) {
+                equal_frames_destroy(frames, count);
+                return CFL_FALSE;
+            }
+
+            if (a->type == CFL_VARIANT_ARRAY) {
+                if (a->data.as_array == NULL || b->data.as_array == NULL) {
+                    equal_frames_destroy(frames, count);
+                    return -1;
+                }
+                if (a->data.as_array->entry_count !=
+                    b->data.as_array->entry_count) {
+                    equal_frames_destroy(frames, count);
+                    return CFL_FALSE;
+                }
+            }
+            else if (a->type == CFL_VARIANT_KVLIST) {
+                if (a->data.as_kvlist == NULL || b->data.as_kvlist == NULL) {
+                    equal_frames_destroy(frames, count);
+                    return -1;
+                }
+                if (cfl_kvlist_count(a->data.as_kvlist) !=
+                    cfl_kvlist_count(b->data.as_kvlist)) {
+                    equal_frames_destroy(frames, count);
+                    return CFL_FALSE;
+                }
+            }
+            else if (!scalar_equal(a, b)) {
+                equal_frames_destroy(frames, count);
+                return CFL_FALSE;
+            }
+
+            if (a->type == CFL_VARIANT_ARRAY ||
+                a->type == CFL_VARIANT_KVLIST) {
+                if (frames_reserve((void **) &frames, &capacity, count,
+                                   sizeof(struct equal_frame)) != 0) {
+                    equal_frames_destroy(frames, count);
+                    return -1;
+                }
+
+                frame = &frames[count++];
+                memset(frame, 0, sizeof(struct equal_frame));
+                frame->type = a->type;
+
+                if (a->type == CFL_VARIANT_ARRAY) {
+                    frame->array_a = a->data.as_array;
+                    frame->array_b = b->data.as_array;
+                    frame->count = frame->array_a->entry_count;
+                }
+                else if (unordered) {
+                    if (kvlist_entries(a->data.as_kvlist, &frame->entries_a,
+                                       &frame->count) != 0 ||
+                        kvlist_entries(b->data.as_kvlist, &frame->entries_b,
+                                       &entries) != 0) {
+                        equal_frames_destroy(frames, count);
+                        return -1;
+                    }
+                    if (entries != frame->count) {
+                        equal_frames_destroy(frames, count);
+                        return CFL_FALSE;
+                    }
+                }
+                else {
+                    frame->head_a = &a->data.as_kvlist->list;
+                    frame->head_b = &b->data.as_kvlist->list;
+                    frame->cursor_a = frame->head_a->next;
+                    frame->cursor_b = frame->head_b->next;
+                }
+            }
+        }
+
+        /* pick the next pair of children, closing exhausted frames */
+        while (1) {
+            if (count == 0) {
+                cfl_free(frames);
+                return CFL_TRUE;
+            }
+
+            frame = &frames[count - 1];
+            if (frame->type == CFL_VARIANT_ARRAY) {
+                if (frame->index < frame->count) {
+                    a = frame->array_a->entries[frame->index];
+                    b = frame->array_b->entries[frame->index];
+                    frame->index++;
+                    break;
+                }
+            }
+            else if (unordered) {
+                if (frame->index < frame->count) {
+                    if (!entry_keys_equal(&frame->entries_a[frame->index],
+                                          &frame->entries_b[frame->index])) {
+                        equal_frames_destroy(frames, count);
+                        return CFL_FALSE;
+                    }
+                    a = frame->entries_a[frame->index].value;
+                    b = frame->entries_b[frame->index].value;
+                    frame->index++;
+                    break;
+                }
+            }
+            else {
+                pair_a = kvlist_next(&frame->cursor_a, frame->head_a);
+                pair_b = kvlist_next(&frame->cursor_b, frame->head_b);
+                if (pair_a != NULL || pair_b != NULL) {
+                    if (pair_a == NULL || pair_b == NULL ||
+                        !keys_equal(pair_a, pair_b)) {
+                        equal_frames_destroy(frames, count);
+                        return CFL_FALSE;
+                    }
+                    a = pair_a->val;
+                    b = pair_b->val;
+                    break;
+                }
+            }
+
+            cfl_free(frame->entries_a);
+            cfl_free(frame->entries_b);
+            count--;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#include <cfl/cfl.h>
+#include <cfl/cfl_allocator.h>
+#include <cfl/cfl_object_cache.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cfl_tests_internal.h"
+
+#define PREFIX_SIZE 16
+
+struct sized_state {
+    int allocations;
+    int frees;
+    int sized_frees;
+    int size_mismatches;
+};
+
+/* libc-backed allocator that checks the sizes passed to free_sized_fn */
+static void *sized_malloc(void *context, size_t size)
+{
+    char *block;
+
+    block = malloc(PREFIX_SIZE + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size_t));
+    ((struct sized_state *) context)->allocations++;
+
+    return block + PREFIX_SIZE;
+}
+
+static void *sized_realloc(void *context, void *pointer, size_t size)
+{
+    char *block;
+
+    if (pointer == NULL) {
+        return sized_malloc(context, size);
+    }
+
+    block = realloc((char *) pointer - PREFIX_SIZE, PREFIX_SIZE + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size_t));
+
+    return block + PREFIX_SIZE;
+}
+
+static void sized_free(void *context, void *pointer)
+{
+    if (pointer == NULL) {
+        return;
+    }
+
+    ((struct sized_state *) context)->frees++;
+    free((char *) pointer - PREFIX_SIZE);
+}
+
+static void sized_free_sized(void *context, void *pointer, size_t size)
+{
+    size_t allocated;
+    struct sized_state *state;
+
+    state = context;
+    memcpy(&allocated, (char *) pointer - PREFIX_SIZE, sizeof(size_t));
+    if (allocated != size) {
+        state->size_mismatches++;
+    }
+    state->sized_frees++;
+    state->frees++;
+    free((char *) pointer - PREFIX_SIZE);
+}
+
+static void build_and_destroy()
+{
+    int index;
+    char key[32];
+    cfl_sds_t s;
+    struct cfl_list *split;
+    struct cfl_array *array;
+    struct cfl_kvlist *list;
+    struct cfl_arena *arena;
+    struct cfl_variant *variant;
+
+    list = cfl_kvlist_create();
+    TEST_CHECK(list != NULL);
+    for (index = 0; index < 200; index++) {
+        snprintf(key, sizeof(key), "key-%d", index);
+        cfl_kvlist_insert_string(list, key, "a string value");
+        cfl_kvlist_insert_int64(list, key, index);
+    }
+
+    array = cfl_array_create(1);
+    cfl_array_resizable(array, CFL_TRUE);
+    for (index = 0; index < 100; index++) {
+        cfl_array_append_double(array, index);
+    }
+    cfl_kvlist_insert_array(list, "array", array);
+    cfl_kvlist_destroy(list);
+
+    /* strings in cached, realloc'd and large blocks */
+    s = cfl_sds_create("x");
+    for (index = 0; index < 2000; index++) {
+        s = cfl_sds_cat(s, "abcdefgh", 8);
+    }
+    cfl_sds_destroy(s);
+
+    s = cfl_sds_create_size(100000);
+    cfl_sds_destroy(s);
+
+    variant = cfl_variant_create_from_bytes("bytes", 5, CFL_FALSE);
+    cfl_variant_destroy(variant);
+
+    split = cfl_utils_split("a,b,c", ',', -1);
+    TEST_CHECK(split != NULL);
+    cfl_utils_split_free(split);
+
+    arena = cfl_arena_create(4096);
+    list = cfl_kvlist_create_in(arena);
+    cfl_kvlist_insert_string(list, "key", "value");
+    cfl_arena_destroy(arena);
+}
+
+static void test_counting()
+{
+    struct cfl_allocator counting;
+    struct cfl_allocator_counters counters;
+
+    cfl_allocator_counting_init(&counting, &counters);
+    TEST_CHECK(cfl_set_allocator(&counting) == 0);
+
+    build_and_destroy();
+    TEST_CHECK(counters.allocations > 0);
+    TEST_CHECK(counters.reallocations > 0);
+    TEST_CHECK(counters.bytes_peak >= 100000);
+
+    /* cached blocks are still in use until the cache is flushed */
+    cfl_object_cache_flush();
+    TEST_CHECK(counters.bytes_in_use == 0);
+    TEST_CHECK(counters.frees == counters.allocations);
+
+    TEST_CHECK(cfl_set_allocator(NULL) == 0);
+}
+
+static void test_sized_free()
+{
+    struct sized_state state;
+    struct cfl_allocator allocator;
+
+    memset(&state, 0, sizeof(state));
+    memset(&allocator, 0, sizeof(allocator));
+    allocator.malloc_fn = sized_malloc;
+    allocator.realloc_fn = sized_realloc;
+    allocator.free_fn = sized_free;
+    allocator.free_sized_fn = sized_free_sized;
+    allocator.context = &state;
+
+    TEST_CHECK(cfl_set_allocator(&allocator) == 0);
+
+    build_and_destroy();
+    cfl_object_cache_flush();
+
+    TEST_CHECK(state.allocations > 0);
+    TEST_CHECK(state.frees == state.allocations);
+    TEST_CHECK(state.sized_frees > 0);
+    TEST_CHECK(state.size_mismatches == 0);
+
+    TEST_CHECK(cfl_set_allocator(NULL) == 0);
+}
+
+static void test_calloc()
+{
+    int index;
+    unsigned char *block;
+    struct sized_state state;
+    struct cfl_allocator allocator;
+    struct cfl_allocator current;
+
+    memset(&state, 0, sizeof(state));
+    memset(&allocator, 0, sizeof(allocator));
+    allocator.malloc_fn = sized_malloc;
+    allocator.realloc_fn = sized_realloc;
+    allocator.free_fn = sized_free;
+    allocator.context = &state;
+
+    TEST_CHECK(cfl_set_allocator(&allocator) == 0);
+
+    /* calloc falls back to malloc_fn and clears the block */
+    block = cfl_calloc(64, 4);
+    TEST_CHECK(block != NULL);
+    for (index = 0; index < 256; index++) {
+        TEST_CHECK(block[index] == 0);
+    }
+    cfl_free(block);
+    TEST_CHECK(state.allocations == 1 && state.frees == 1);
+    TEST_CHECK(cfl_calloc(SIZE_MAX / 2, 4) == NULL);
+
+    /* without free_sized_fn sized frees go to free_fn */
+    cfl_free_sized(cfl_malloc(10), 10);
+    TEST_CHECK(state.frees == 2);
+
+    cfl_get_allocator(&current);
+    TEST_CHECK(current.malloc_fn == sized_malloc);
+    TEST_CHECK(current.calloc_fn != NULL);
+    TEST_CHECK(current.context == &state);
+
+    TEST_CHECK(cfl_set_allocator(NULL) == 0);
+}
+
+static void test_invalid()
+{
+    struct cfl_allocator allocator;
+    struct cfl_allocator current;
+
+    memset(&allocator, 0, sizeof(allocator));
+    allocator.malloc_fn = sized_malloc;
+    allocator.free_fn = sized_free;
+    TEST_CHECK(cfl_set_allocator(&allocator) == -1);
+
+    allocator.realloc_fn = sized_realloc;
+    allocator.free_fn = NULL;
+    TEST_CHECK(cfl_set_allocator(&allocator) == -1);
+
+    /* the libc allocator stays in place */
+    cfl_get_allocator(&current);
+    TEST_CHECK(current.malloc_fn != sized_malloc);
+    TEST_CHECK(current.calloc_fn != NULL);
+    TEST_CHECK(current.free_sized_fn == NULL);
+
+    cfl_free(NULL);
+    cfl_free_sized(NULL, 0);
+}
+
+TEST_LIST = {
+    {"counting",   test_counting},
+    {"sized_free", test_sized_free},
+    {"calloc",     test_calloc},
+    {"invalid",    test_invalid},
+    { 0 }
+};
@@ -32,6 +32,7 @@
 #define EXPECTED_VALUE (THREAD_COUNT * CYCLE_COUNT)
 
 static uint64_t global_counter;
+static uint32_t global_fetch_counter;
 
 static void test_atomic_initialize()
 {
@@ -77,6 +78,76 @@ static void test_atomic_full_width_values()
     TEST_CHECK(cfl_atomic_load(&value) == 0);
 }
 
+static void test_atomic_explicit_operations()
+{
+    uint64_t value;
+    uint64_t expected;
+    uint32_t narrow;
+    uint32_t narrow_expected;
+    void    *pointer;
+    void    *pointer_expected;
+    int      order;
+
+    TEST_CHECK(cfl_atomic_initialize() == 0);
+    TEST_CHECK(cfl_atomic_implementation() != NULL);
+
+    for (order = CFL_ATOMIC_RELAXED; order <= CFL_ATOMIC_SEQ_CST; order++) {
+        value = 0;
+        cfl_atomic_store_explicit(&value, 40, order);
+        TEST_CHECK(cfl_atomic_load_explicit(&value, order) == 40);
+        TEST_CHECK(cfl_atomic_fetch_add_explicit(&value, 3, order) == 40);
+        TEST_CHECK(cfl_atomic_fetch_sub_explicit(&value, 1, order) == 43);
+        TEST_CHECK(cfl_atomic_exchange_explicit(&value, UINT64_MAX,
+                                                order) == 42);
+
+        expected = 1;
+        TEST_CHECK(cfl_atomic_compare_exchange_explicit(&value, &expected,
+                                                        7, order) == 0);
+        TEST_CHECK(expected == UINT64_MAX);
+        TEST_CHECK(cfl_atomic_compare_exchange_explicit(&value, &expected,
+                                                        7, order) == 1);
+        TEST_CHECK(cfl_atomic_load(&value) == 7);
+
+        narrow = 0;
+        cfl_atomic32_store_explicit(&narrow, UINT32_MAX, order);
+        TEST_CHECK(cfl_atomic32_load_explicit(&narrow, order) == UINT32_MAX);
+        TEST_CHECK(cfl_atomic32_fetch_add_explicit(&narrow, 1,
+                                                   order) == UINT32_MAX);
+        TEST_CHECK(cfl_atomic32_fetch_sub_explicit(&narrow, 1, order) == 0);
+        TEST_CHECK(cfl_atomic32_exchange_explicit(&narrow, 5,
+                                                  order) == UINT32_MAX);
+
+        narrow_expected = 4;
+        TEST_CHECK(cfl_atomic32_compare_exchange_explicit(&narrow,
+                                                          &narrow_expected,
+                                                          6, order) == 0);
+        TEST_CHECK(narrow_expected == 5);
+        TEST_CHECK(cfl_atomic32_compare_exchange_explicit(&narrow,
+                                                          &narrow_expected,
+                                                          6, order) == 1);
+        TEST_CHECK(cfl_atomic32_load_explicit(&narrow, order) == 6);
+
+        pointer = NULL;
+        cfl_atomic_ptr_store_explicit(&pointer, &value, order);
+        TEST_CHECK(cfl_atomic_ptr_load_explicit(&pointer, order) == &value);
+        TEST_CHECK(cfl_atomic_ptr_exchange_explicit(&pointer, &narrow,
+                                                    order) == &value);
+
+        pointer_expected = NULL;
+        TEST_CHECK(cfl_atomic_ptr_compare_exchange_explicit(&pointer,
+                                                            &pointer_expected,
+                                                            &value,
+                                                            order) == 0);
+        TEST_CHECK(pointer_expected == &narrow);
+        TEST_CHECK(cfl_atomic_ptr_compare_exchange_explicit(&pointer,
+                                                            &pointer_expected,
+                                                            NULL, order) == 1);
+        TEST_CHECK(cfl_atomic_ptr_load_explicit(&pointer, order) == NULL);
+
+        cfl_atomic_thread_fence(order);
+    }
+}
+
 static void add_through_compare_exchange(uint64_t val)
 {
     uint64_t old;
@@ -104,6 +175,8 @@ static void *worker_thread_add_through_compare_exchange(void *ptr)
 
     for (local_counter = 0; local_counter < CYCLE_COUNT; local_counter++) {
         add_through_compare_exchange(1);
+        cfl_atomic32_fetch_add_explicit(&global_fetch_counter, 1,
+                                        CFL_ATOMIC_RELAXED);
     }
 
 #if defined (_WIN32) || defined (_WIN64)
@@ -125,6 +198,7 @@ static void test_atomic_operations()
     TEST_CHECK(cfl_init() == 0);
 
     cfl_atomic_store(&global_counter, 0);
+    cfl_atomic32_store_explicit(&global_fetch_counter, 0, CFL_ATOMIC_SEQ_CST);
 
     for (thread_index = 0; thread_index < THREAD_COUNT; thread_index++) {
         threads[thread_index] = CreateThread(NULL, 0,
@@ -139,6 +213,9 @@ static void test_atomic_operations()
     }
 
     TEST_CHECK(cfl_atomic_load(&global_counter) == EXPECTED_VALUE);
+    TEST_CHECK(cfl_atomic32_load_explicit(&global_fetch_counter,
+                                          CFL_ATOMIC_SEQ_CST) ==
+               EXPECTED_VALUE);
 }
 
 #else
@@ -152,6 +229,7 @@ static void test_atomic_operations()
     TEST_CHECK(cfl_init() == 0);
 
     cfl_atomic_store(&global_counter, 0);
+    cfl_atomic32_store_explicit(&global_fetch_counter, 0, CFL_ATOMIC_SEQ_CST);
 
     for (thread_index = 0; thread_index < THREAD_COUNT; thread_index++) {
         result = pthread_create(&threads[thread_index], NULL,
@@ -165,6 +243,9 @@ static void test_atomic_operations()
     }
 
     TEST_CHECK(cfl_atomic_load(&global_counter) == EXPECTED_VALUE);
+    TEST_CHECK(cfl_atomic32_load_explicit(&global_fetch_counter,
+                                          CFL_ATOMIC_SEQ_CST) ==
+               EXPECTED_VALUE);
 }
 #endif
 
@@ -172,6 +253,7 @@ TEST_LIST = {
     { "atomic_initialize", test_atomic_initialize },
     { "atomic_basic_operations", test_atomic_basic_operations },
     { "atomic_full_width_values", test_atomic_full_width_values },
+    { "atomic_explicit_operations", test_atomic_explicit_operations },
     { "atomic_operations", test_atomic_operations },
     { 0 }
 };
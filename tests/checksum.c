@@ -19,7 +19,59 @@
 
 #include <cfl/cfl_checksum.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "cfl_tests_internal.h"
+#include "../src/cfl_checksum_internal.h"
+
+static const char *crc32c_kernels[] = {
+    "slicing-by-8", "sse4.2", "sse4.2-pclmul", "armv8-crc"
+};
+
+/* kernel under test, for failure messages */
+static const char *kernel;
+
+/* run a check once per kernel the host supports */
+static void crc32c_each_kernel(void (*check)(void))
+{
+    size_t index;
+
+    for (index = 0; index < sizeof(crc32c_kernels) / sizeof(char *);
+         index++) {
+        kernel = crc32c_kernels[index];
+        if (cfl_checksum_crc32c_select(kernel) != 0) {
+            continue;
+        }
+        TEST_CHECK(strcmp(cfl_checksum_crc32c_implementation(), kernel) == 0);
+        TEST_MSG("kernel: %s", kernel);
+
+        check();
+    }
+
+    TEST_CHECK(cfl_checksum_crc32c_select(NULL) == 0);
+    TEST_CHECK(cfl_checksum_crc32c_select("none") == -1);
+    TEST_CHECK(cfl_checksum_crc32c_implementation() != NULL);
+    TEST_MSG("implementation: %s", cfl_checksum_crc32c_implementation());
+}
+
+/* bit-at-a-time reference */
+static uint32_t crc32c_reference(const unsigned char *buffer, size_t length)
+{
+    int bit;
+    size_t index;
+    uint32_t crc;
+
+    crc = 0xFFFFFFFF;
+    for (index = 0; index < length; index++) {
+        crc ^= buffer[index];
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+    }
+
+    return crc ^ 0xFFFFFFFF;
+}
 
 static void crc32c_null_input()
 {
@@ -32,7 +84,125 @@ static void crc32c_null_input()
     TEST_CHECK(crc == 0);
 }
 
+static void check_known_values()
+{
+    unsigned char zeros[32];
+    unsigned char ones[32];
+
+    memset(zeros, 0, sizeof(zeros));
+    memset(ones, 0xff, sizeof(ones));
+
+    /* check value and RFC 3720 B.4 vectors */
+    TEST_CHECK(cfl_checksum_crc32c((unsigned char *) "123456789", 9) ==
+               0xE3069283);
+    TEST_CHECK(cfl_checksum_crc32c(zeros, sizeof(zeros)) == 0x8A9136AA);
+    TEST_CHECK(cfl_checksum_crc32c(ones, sizeof(ones)) == 0x62A8AB43);
+    TEST_MSG("kernel: %s", kernel);
+}
+
+static void check_lengths_and_alignment()
+{
+    size_t index;
+    size_t length;
+    size_t offset;
+    size_t sizes[] = {767, 768, 769, 3 * 8192 - 1, 3 * 8192, 3 * 8192 + 769,
+                      100000};
+    unsigned char *buffer;
+
+    buffer = malloc(100000 + 8);
+    TEST_CHECK(buffer != NULL);
+    for (index = 0; index < 100000 + 8; index++) {
+        buffer[index] = (unsigned char) (index * 2654435761u >> 13);
+    }
+
+    for (offset = 0; offset < 8; offset++) {
+        for (length = 0; length <= 64; length++) {
+            TEST_CHECK(cfl_checksum_crc32c(buffer + offset, length) ==
+                       crc32c_reference(buffer + offset, length));
+            TEST_MSG("%s: offset %zu length %zu", kernel, offset, length);
+        }
+
+        /* sizes around the interleaved block boundaries */
+        for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index++) {
+            TEST_CHECK(cfl_checksum_crc32c(buffer + offset, sizes[index]) ==
+                       crc32c_reference(buffer + offset, sizes[index]));
+            TEST_MSG("%s: offset %zu length %zu", kernel, offset,
+                     sizes[index]);
+        }
+    }
+
+    free(buffer);
+}
+
+static void check_incremental_and_combine()
+{
+    size_t index;
+    size_t split;
+    size_t length;
+    uint32_t crc;
+    uint32_t expected;
+    uint32_t first;
+    uint32_t second;
+    unsigned char *buffer;
+    size_t splits[] = {0, 1, 7, 8, 100, 4096, 30000, 70000};
+
+    length = 70000;
+    buffer = malloc(length);
+    TEST_CHECK(buffer != NULL);
+    for (index = 0; index < length; index++) {
+        buffer[index] = (unsigned char) (index * 31 + (index >> 9));
+    }
+    expected = cfl_checksum_crc32c(buffer, length);
+
+    /* uneven pieces through init/update/final */
+    crc = cfl_checksum_crc32c_init();
+    for (index = 0; index < length; index += split) {
+        split = (index % 1000) + 1;
+        if (index + split > length) {
+            split = length - index;
+        }
+        crc = cfl_checksum_crc32c_update(crc, buffer + index, split);
+    }
+    TEST_CHECK(cfl_checksum_crc32c_final(crc) == expected);
+
+    crc = cfl_checksum_crc32c_update(cfl_checksum_crc32c_init(), NULL, 10);
+    TEST_CHECK(cfl_checksum_crc32c_final(crc) == 0);
+
+    for (index = 0; index < sizeof(splits) / sizeof(splits[0]); index++) {
+        split = splits[index];
+        first = cfl_checksum_crc32c(buffer, split);
+        second = cfl_checksum_crc32c(buffer + split, length - split);
+
+        TEST_CHECK(cfl_checksum_crc32c_combine(first, second,
+                                               length - split) == expected);
+        TEST_MSG("%s: split %zu", kernel, split);
+    }
+
+    /* combining with an empty tail is the identity */
+    TEST_CHECK(cfl_checksum_crc32c_combine(expected, 0, 0) == expected);
+
+    free(buffer);
+}
+
+static void crc32c_known_values()
+{
+    crc32c_each_kernel(check_known_values);
+}
+
+static void crc32c_lengths_and_alignment()
+{
+    crc32c_each_kernel(check_lengths_and_alignment);
+}
+
+static void crc32c_incremental_and_combine()
+{
+    crc32c_each_kernel(check_incremental_and_combine);
+}
+
 TEST_LIST = {
     {"crc32c_null_input", crc32c_null_input},
+    {"crc32c_known_values", crc32c_known_values},
+    {"crc32c_lengths_and_alignment", crc32c_lengths_and_alignment},
+    {"crc32c_incremental_and_combine", crc32c_incremental_and_combine},
     { 0 }
 };
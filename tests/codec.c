@@ -0,0 +1,301 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_codec.h>
+
+#include "cfl_tests_internal.h"
+
+#define MAX_LENGTH 300
+
+static void fill_pattern(unsigned char *data, size_t length)
+{
+    size_t index;
+
+    for (index = 0; index < length; index++) {
+        data[index] = (unsigned char) (index * 131 + 17);
+    }
+}
+
+static void reference_hex(const unsigned char *data, size_t length,
+                          char *output)
+{
+    size_t index;
+
+    for (index = 0; index < length; index++) {
+        snprintf(output + index * 2, 3, "%02x", data[index]);
+    }
+}
+
+static void test_hex_vectors()
+{
+    char text[32];
+    unsigned char data[16];
+    size_t size;
+
+    TEST_CHECK(cfl_hex_encode("\x00\x7f\xff\x10", 4, text) == 8);
+    TEST_CHECK(memcmp(text, "007fff10", 8) == 0);
+
+    TEST_CHECK(cfl_hex_decode("0aFf", 4, data, &size) == 0);
+    TEST_CHECK(size == 2 && data[0] == 0x0a && data[1] == 0xff);
+
+    TEST_CHECK(cfl_hex_decode("abc", 3, data, &size) == -1);
+    TEST_CHECK(cfl_hex_decode("0g", 2, data, &size) == -1);
+    TEST_CHECK(cfl_hex_decode("", 0, data, &size) == 0 && size == 0);
+}
+
+static void test_hex_round_trip()
+{
+    size_t length;
+    size_t size;
+    char text[MAX_LENGTH * 2 + 1];
+    char expected[MAX_LENGTH * 2 + 1];
+    unsigned char data[MAX_LENGTH];
+    unsigned char decoded[MAX_LENGTH];
+
+    fill_pattern(data, sizeof(data));
+
+    for (length = 0; length <= MAX_LENGTH; length++) {
+        TEST_CHECK(cfl_hex_encode(data, length, text) ==
+                   cfl_hex_encoded_size(length));
+        reference_hex(data, length, expected);
+        TEST_CHECK(memcmp(text, expected, length * 2) == 0);
+        TEST_MSG("length %zu", length);
+
+        TEST_CHECK(cfl_hex_decode(text, length * 2, decoded, &size) == 0);
+        TEST_CHECK(size == length);
+        TEST_CHECK(memcmp(decoded, data, length) == 0);
+    }
+
+    /* an invalid character anywhere, inside or after a vector block */
+    cfl_hex_encode(data, 100, text);
+    for (length = 0; length < 200; length += 7) {
+        expected[0] = text[length];
+        text[length] = 'x';
+        TEST_CHECK(cfl_hex_decode(text, 200, decoded, &size) == -1);
+        TEST_MSG("offset %zu", length);
+        text[length] = expected[0];
+    }
+
+    /* uppercase digits go through the same paths */
+    for (length = 0; length < 200; length++) {
+        if (text[length] >= 'a') {
+            text[length] -= 'a' - 'A';
+        }
+    }
+    TEST_CHECK(cfl_hex_decode(text, 200, decoded, &size) == 0);
+    TEST_CHECK(memcmp(decoded, data, 100) == 0);
+}
+
+static void test_base64_vectors()
+{
+    size_t index;
+    size_t size;
+    char text[16];
+    unsigned char data[16];
+    static const char *plain[] = {"", "f", "fo", "foo", "foob", "fooba",
+                                  "foobar"};
+    static const char *encoded[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==",
+                                    "Zm9vYmE=", "Zm9vYmFy"};
+
+    /* RFC 4648 section 10 */
+    for (index = 0; index < sizeof(plain) / sizeof(plain[0]); index++) {
+        size = cfl_base64_encode(plain[index], strlen(plain[index]), text);
+        TEST_CHECK(size == strlen(encoded[index]));
+        TEST_CHECK(memcmp(text, encoded[index], size) == 0);
+
+        TEST_CHECK(cfl_base64_decoded_size(encoded[index], size) ==
+                   strlen(plain[index]));
+        TEST_CHECK(cfl_base64_decode(encoded[index], size, data, &size) == 0);
+        TEST_CHECK(size == strlen(plain[index]));
+        TEST_CHECK(memcmp(data, plain[index], size) == 0);
+    }
+
+    /* padding is optional */
+    TEST_CHECK(cfl_base64_decoded_size("Zm9vYg", 6) == 4);
+    TEST_CHECK(cfl_base64_decode("Zm9vYg", 6, data, &size) == 0);
+    TEST_CHECK(size == 4 && memcmp(data, "foob", 4) == 0);
+
+    TEST_CHECK(cfl_base64_decode("+/+/", 4, data, &size) == 0);
+    TEST_CHECK(size == 3 && data[0] == 0xfb && data[1] == 0xff);
+
+    TEST_CHECK(cfl_base64_decode("Zm9vY", 5, data, &size) == -1);
+    TEST_CHECK(cfl_base64_decode("Zm 9v", 5, data, &size) == -1);
+    TEST_CHECK(cfl_base64_decode("Zm9v=g==", 8, data, &size) == -1);
+}
+
+static void test_base64_round_trip()
+{
+    size_t length;
+    size_t size;
+    size_t offset;
+    char saved;
+    char text[MAX_LENGTH * 2];
+    unsigned char data[MAX_LENGTH];
+    unsigned char decoded[MAX_LENGTH];
+
+    fill_pattern(data, sizeof(data));
+
+    for (length = 0; length <= MAX_LENGTH; length++) {
+        size = cfl_base64_encode(data, length, text);
+        TEST_CHECK(size == cfl_base64_encoded_size(length));
+        TEST_CHECK(cfl_base64_decoded_size(text, size) == length);
+
+        memset(decoded, 0, sizeof(decoded));
+        TEST_CHECK(cfl_base64_decode(text, size, decoded, &size) == 0);
+        TEST_CHECK(size == length);
+        TEST_CHECK(memcmp(decoded, data, length) == 0);
+        TEST_MSG("length %zu", length);
+    }
+
+    /* invalid and non-ASCII characters inside and after vector blocks */
+    size = cfl_base64_encode(data, 150, text);
+    for (offset = 0; offset < size; offset += 5) {
+        saved = text[offset];
+        text[offset] = (offset & 1) ? '*' : (char) 0xc3;
+        TEST_CHECK(cfl_base64_decode(text, size, decoded, NULL) == -1);
+        TEST_MSG("offset %zu", offset);
+        text[offset] = saved;
+    }
+}
+
+static char *print_to_buffer(struct cfl_variant *value, int bytes_format,
+                             size_t *size)
+{
+    FILE *fp;
+    long length;
+    char *buffer;
+
+    *size = 0;
+    fp = tmpfile();
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    if (cfl_variant_print_ex(fp, value, bytes_format) < 0) {
+        fclose(fp);
+        return NULL;
+    }
+    length = ftell(fp);
+    rewind(fp);
+
+    buffer = malloc(length + 1);
+    if (buffer != NULL) {
+        *size = fread(buffer, 1, length, fp);
+        buffer[*size] = '\0';
+    }
+    fclose(fp);
+
+    return buffer;
+}
+
+static void test_print_formats()
+{
+    size_t size;
+    char *output;
+    char trace_id[] = "\x5b\x8e\xfc\xf4\x0b\x2b\x4d\x6e"
+                      "\x9c\x1d\x2a\x5f\x3e\x4d\x5c\x6b";
+    struct cfl_kvlist *kvlist;
+    struct cfl_array *array;
+    struct cfl_variant *value;
+
+    kvlist = cfl_kvlist_create();
+    array = cfl_array_create(2);
+    cfl_array_append_bytes(array, "foob", 4, CFL_FALSE);
+    cfl_array_append_string(array, "text");
+    cfl_kvlist_insert_bytes(kvlist, "trace_id", trace_id, 16, CFL_FALSE);
+    cfl_kvlist_insert_array(kvlist, "body", array);
+    value = cfl_variant_create_from_kvlist(kvlist);
+
+    output = print_to_buffer(value, CFL_VARIANT_PRINT_BYTES_RAW_HEX, &size);
+    TEST_CHECK(output != NULL);
+    TEST_CHECK(strcmp(output, "{\"trace_id\":5b8efcf40b2b4d6e9c1d2a5f3e4d5c6b,"
+                              "\"body\":[666f6f62,\"text\"]}") == 0);
+    TEST_MSG("output: %s", output);
+    free(output);
+
+    output = print_to_buffer(value, CFL_VARIANT_PRINT_BYTES_HEX, &size);
+    TEST_CHECK(output != NULL);
+    TEST_CHECK(strcmp(output,
+                      "{\"trace_id\":\"5b8efcf40b2b4d6e9c1d2a5f3e4d5c6b\","
+                      "\"body\":[\"666f6f62\",\"text\"]}") == 0);
+    TEST_MSG("output: %s", output);
+    free(output);
+
+    output = print_to_buffer(value, CFL_VARIANT_PRINT_BYTES_BASE64, &size);
+    TEST_CHECK(output != NULL);
+    TEST_CHECK(strcmp(output, "{\"trace_id\":\"W4789AsrTW6cHSpfPk1caw==\","
+                              "\"body\":[\"Zm9vYg==\",\"text\"]}") == 0);
+    TEST_MSG("output: %s", output);
+    free(output);
+
+    TEST_CHECK(print_to_buffer(value, 99, &size) == NULL);
+
+    cfl_variant_destroy(value);
+}
+
+static void test_print_large()
+{
+    size_t size;
+    size_t length;
+    size_t decoded_size;
+    char *output;
+    unsigned char *data;
+    unsigned char *decoded;
+    struct cfl_variant *value;
+
+    /* spans several of the printer's stack chunks */
+    length = 5000;
+    data = malloc(length);
+    decoded = malloc(length);
+    TEST_CHECK(data != NULL && decoded != NULL);
+    fill_pattern(data, length);
+
+    value = cfl_variant_create_from_bytes((char *) data, length, CFL_FALSE);
+
+    output = print_to_buffer(value, CFL_VARIANT_PRINT_BYTES_BASE64, &size);
+    TEST_CHECK(output != NULL);
+    TEST_CHECK(size == cfl_base64_encoded_size(length) + 2);
+    TEST_CHECK(cfl_base64_decode(output + 1, size - 2,
+                                 decoded, &decoded_size) == 0);
+    TEST_CHECK(decoded_size == length);
+    TEST_CHECK(memcmp(decoded, data, length) == 0);
+    free(output);
+
+    output = print_to_buffer(value, CFL_VARIANT_PRINT_BYTES_RAW_HEX, &size);
+    TEST_CHECK(output != NULL);
+    TEST_CHECK(size == length * 2);
+    TEST_CHECK(cfl_hex_decode(output, size, decoded, &decoded_size) == 0);
+    TEST_CHECK(memcmp(decoded, data, length) == 0);
+    free(output);
+
+    cfl_variant_destroy(value);
+    free(data);
+    free(decoded);
+}
+
+TEST_LIST = {
+    {"hex_vectors",       test_hex_vectors},
+    {"hex_round_trip",    test_hex_round_trip},
+    {"base64_vectors",    test_base64_vectors},
+    {"base64_round_trip", test_base64_round_trip},
+    {"print_formats",     test_print_formats},
+    {"print_large",       test_print_large},
+    { 0 }
+};
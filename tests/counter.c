@@ -0,0 +1,130 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_counter.h>
+
+#if defined (_WIN32) || defined (_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+#define THREAD_COUNT 16
+#define CYCLE_COUNT  100000
+
+static void test_basic()
+{
+    struct cfl_counter *counter;
+
+    counter = cfl_counter_create(3);
+    TEST_CHECK(counter != NULL);
+    TEST_CHECK(counter->mask == 3);
+    TEST_CHECK(((uintptr_t) counter->slots % CFL_CACHE_LINE_SIZE) == 0);
+    TEST_CHECK(cfl_counter_get(counter) == 0);
+
+    cfl_counter_inc(counter);
+    cfl_counter_add(counter, 41);
+    TEST_CHECK(cfl_counter_get(counter) == 42);
+
+    /* values wrap, adding the two's complement subtracts */
+    cfl_counter_add(counter, (uint64_t) -2);
+    TEST_CHECK(cfl_counter_get(counter) == 40);
+
+    TEST_CHECK(cfl_counter_reset(counter) == 40);
+    TEST_CHECK(cfl_counter_get(counter) == 0);
+
+    cfl_counter_destroy(counter);
+
+    /* default: one slot per CPU */
+    counter = cfl_counter_create(0);
+    TEST_CHECK(counter != NULL);
+    cfl_counter_inc(counter);
+    TEST_CHECK(cfl_counter_get(counter) == 1);
+    cfl_counter_destroy(counter);
+}
+
+#if defined (_WIN32) || defined (_WIN64)
+static DWORD WINAPI worker(LPVOID data)
+#else
+static void *worker(void *data)
+#endif
+{
+    int index;
+
+    for (index = 0; index < CYCLE_COUNT; index++) {
+        cfl_counter_inc(data);
+    }
+
+#if defined (_WIN32) || defined (_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void test_threads()
+{
+    int                 index;
+    uint64_t            drained;
+    struct cfl_counter *counter;
+#if defined (_WIN32) || defined (_WIN64)
+    HANDLE              threads[THREAD_COUNT];
+#else
+    pthread_t           threads[THREAD_COUNT];
+#endif
+
+    counter = cfl_counter_create(0);
+    TEST_CHECK(counter != NULL);
+
+    for (index = 0; index < THREAD_COUNT; index++) {
+#if defined (_WIN32) || defined (_WIN64)
+        threads[index] = CreateThread(NULL, 0, worker, counter, 0, NULL);
+        TEST_CHECK(threads[index] != NULL);
+#else
+        TEST_CHECK(pthread_create(&threads[index], NULL,
+                                  worker, counter) == 0);
+#endif
+    }
+
+    /* draining while writers run loses nothing */
+    drained = cfl_counter_reset(counter);
+
+    for (index = 0; index < THREAD_COUNT; index++) {
+#if defined (_WIN32) || defined (_WIN64)
+        WaitForSingleObject(threads[index], INFINITE);
+        CloseHandle(threads[index]);
+#else
+        pthread_join(threads[index], NULL);
+#endif
+    }
+
+    TEST_CHECK(drained + cfl_counter_get(counter) ==
+               (uint64_t) THREAD_COUNT * CYCLE_COUNT);
+
+    cfl_counter_destroy(counter);
+}
+
+TEST_LIST = {
+    {"basic",   test_basic},
+    {"threads", test_threads},
+    { 0 }
+};
@@ -0,0 +1,257 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_otlp.h>
+#include <cfl/cfl_size_cache.h>
+
+#include "cfl_tests_internal.h"
+
+static size_t printed_size(struct cfl_variant *value)
+{
+    FILE *fp;
+    long length;
+
+    fp = tmpfile();
+    if (fp == NULL) {
+        return 0;
+    }
+
+    cfl_variant_print(fp, value);
+    length = ftell(fp);
+    fclose(fp);
+
+    return (size_t) length;
+}
+
+static size_t otlp_size(struct cfl_variant *value)
+{
+    size_t size;
+
+    if (cfl_otlp_any_value_size(value, &size) != 0) {
+        return 0;
+    }
+
+    return size;
+}
+
+static void check_sizes(struct cfl_variant *value)
+{
+    int ret;
+    size_t size;
+
+    ret = cfl_variant_encoded_size(value, CFL_VARIANT_FORMAT_JSON, &size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(size == printed_size(value));
+    TEST_MSG("json size=%zu printed=%zu", size, printed_size(value));
+
+    ret = cfl_variant_encoded_size(value, CFL_VARIANT_FORMAT_OTLP, &size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(size == otlp_size(value));
+}
+
+static struct cfl_kvlist *create_record(int index)
+{
+    char bytes[] = {0x0f, (char) 0xf0};
+    struct cfl_array *array;
+    struct cfl_kvlist *kvlist;
+
+    kvlist = cfl_kvlist_create();
+    array = cfl_array_create(3);
+    if (kvlist == NULL || array == NULL) {
+        return NULL;
+    }
+
+    cfl_array_append_string(array, "line\nbreak \"quoted\" \x02");
+    cfl_array_append_double(array, 1.0 / 3.0);
+    cfl_array_append_uint64(array, UINT64_MAX);
+
+    cfl_kvlist_insert_int64(kvlist, "index", index);
+    cfl_kvlist_insert_int64(kvlist, "min", INT64_MIN);
+    cfl_kvlist_insert_bool(kvlist, "flag", index % 2);
+    cfl_kvlist_insert_bytes(kvlist, "raw", bytes, sizeof(bytes), CFL_FALSE);
+    cfl_kvlist_insert_double(kvlist, "big", 1e300);
+    cfl_kvlist_insert_array(kvlist, "items", array);
+    cfl_kvlist_insert_reference(kvlist, "ref", NULL);
+
+    return kvlist;
+}
+
+static void test_scalars()
+{
+    struct cfl_variant *value;
+
+    value = cfl_variant_create_from_string("tab\there");
+    check_sizes(value);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_int64(-1234567);
+    check_sizes(value);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_double(-0.5);
+    check_sizes(value);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_null();
+    check_sizes(value);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_bool(CFL_FALSE);
+    check_sizes(value);
+    cfl_variant_destroy(value);
+}
+
+static void test_graph()
+{
+    struct cfl_array *empty;
+    struct cfl_kvlist *kvlist;
+    struct cfl_variant *value;
+
+    kvlist = create_record(1);
+    TEST_CHECK(kvlist != NULL);
+
+    empty = cfl_array_create(0);
+    cfl_kvlist_insert_array(kvlist, "empty", empty);
+    cfl_kvlist_insert_kvlist(kvlist, "nested", create_record(2));
+
+    value = cfl_variant_create_from_kvlist(kvlist);
+    check_sizes(value);
+
+    TEST_CHECK(cfl_variant_encoded_size(value, 0, NULL) == -1);
+    TEST_CHECK(cfl_variant_encoded_size(NULL, CFL_VARIANT_FORMAT_JSON,
+                                        NULL) == -1);
+
+    cfl_variant_destroy(value);
+}
+
+static void check_cached(struct cfl_variant *value,
+                         struct cfl_size_cache *cache)
+{
+    int ret;
+    size_t size;
+
+    ret = cfl_variant_encoded_size_cached(value, CFL_VARIANT_FORMAT_JSON,
+                                          cache, &size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(size == printed_size(value));
+
+    ret = cfl_variant_encoded_size_cached(value, CFL_VARIANT_FORMAT_OTLP,
+                                          cache, &size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(size == otlp_size(value));
+}
+
+static void test_cache()
+{
+    int index;
+    size_t count;
+    struct cfl_array *batch;
+    struct cfl_kvlist *record;
+    struct cfl_kvlist *changed;
+    struct cfl_variant *value;
+    struct cfl_size_cache *cache;
+
+    cache = cfl_size_cache_create(NULL);
+    TEST_CHECK(cache != NULL);
+
+    changed = NULL;
+    batch = cfl_array_create(128);
+    for (index = 0; index < 128; index++) {
+        record = create_record(index);
+        if (index == 77) {
+            changed = record;
+        }
+        cfl_array_append_kvlist(batch, record);
+    }
+    value = cfl_variant_create_from_array(batch);
+
+    check_cached(value, cache);
+
+    /* batch, 128 records and their item arrays */
+    count = cfl_size_cache_count(cache);
+    TEST_CHECK(count == 1 + 128 * 2);
+
+    /* cached results are reused */
+    check_cached(value, cache);
+    TEST_CHECK(cfl_size_cache_count(cache) == count);
+
+    /* a change drops the record and the batch, siblings stay cached */
+    cfl_kvlist_insert_string(changed, "extra", "value");
+    cfl_size_cache_invalidate_kvlist(cache, changed);
+    TEST_CHECK(cfl_size_cache_count(cache) == count - 2);
+    check_cached(value, cache);
+    TEST_CHECK(cfl_size_cache_count(cache) == count);
+
+    cfl_size_cache_clear(cache);
+    TEST_CHECK(cfl_size_cache_count(cache) == 0);
+
+    cfl_variant_destroy(value);
+    cfl_size_cache_destroy(cache);
+}
+
+static void test_cache_in_arena()
+{
+    int index;
+    struct cfl_arena *arena;
+    struct cfl_array *batch;
+    struct cfl_size_cache *cache;
+    struct cfl_variant *value;
+
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+
+    /* leave the arena at an odd offset, entries must still be aligned */
+    TEST_CHECK(cfl_arena_malloc(arena, 1) != NULL);
+
+    cache = cfl_size_cache_create(arena);
+    TEST_CHECK(cache != NULL);
+
+    value = cfl_variant_create_from_kvlist(create_record(3));
+    check_cached(value, cache);
+    TEST_CHECK(cfl_size_cache_count(cache) == 2);
+
+    cfl_variant_destroy(value);
+    cfl_size_cache_clear(cache);
+
+    /* enough containers to grow the table several times */
+    TEST_CHECK(cfl_arena_malloc(arena, 3) != NULL);
+    batch = cfl_array_create(200);
+    TEST_CHECK(batch != NULL);
+    for (index = 0; index < 200; index++) {
+        TEST_CHECK(cfl_array_append_kvlist(batch,
+                                           create_record(index)) == 0);
+    }
+    value = cfl_variant_create_from_array(batch);
+    check_cached(value, cache);
+    TEST_CHECK(cfl_size_cache_count(cache) == 1 + 200 * 2);
+
+    cfl_variant_destroy(value);
+
+    /* the table is released with the arena */
+    cfl_arena_destroy(arena);
+}
+
+TEST_LIST = {
+    {"scalars",        test_scalars},
+    {"graph",          test_graph},
+    {"cache",          test_cache},
+    {"cache_in_arena", test_cache_in_arena},
+    { 0 }
+};
@@ -0,0 +1,375 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_encoder.h>
+#include <cfl/cfl_otlp.h>
+
+#include "cfl_tests_internal.h"
+
+static struct cfl_variant *create_sample()
+{
+    char bytes[] = {0x00, 0x7f, (char) 0xff};
+    struct cfl_array *array;
+    struct cfl_array *empty;
+    struct cfl_kvlist *kvlist;
+    struct cfl_kvlist *inner;
+
+    kvlist = cfl_kvlist_create();
+    inner = cfl_kvlist_create();
+    array = cfl_array_create(5);
+    empty = cfl_array_create(0);
+    if (kvlist == NULL || inner == NULL || array == NULL || empty == NULL) {
+        return NULL;
+    }
+
+    TEST_CHECK(cfl_array_append_string(array, "plain") == 0);
+    TEST_CHECK(cfl_array_append_string(array,
+                   "quote \" slash \\ tab \t ctl \x01") == 0);
+    TEST_CHECK(cfl_array_append_int64(array, -42) == 0);
+    TEST_CHECK(cfl_array_append_double(array, 2.5) == 0);
+    TEST_CHECK(cfl_array_append_array(array, empty) == 0);
+
+    TEST_CHECK(cfl_kvlist_insert_bool(inner, "yes", CFL_TRUE) == 0);
+    TEST_CHECK(cfl_kvlist_insert_uint64(inner, "big", UINT64_MAX) == 0);
+    TEST_CHECK(cfl_kvlist_insert_bytes(inner, "raw", bytes, sizeof(bytes),
+                                       CFL_FALSE) == 0);
+
+    TEST_CHECK(cfl_kvlist_insert_string(kvlist, "message",
+                                        "hello world") == 0);
+    TEST_CHECK(cfl_kvlist_insert_array(kvlist, "list", array) == 0);
+    TEST_CHECK(cfl_kvlist_insert_kvlist(kvlist, "inner", inner) == 0);
+    TEST_CHECK(cfl_kvlist_insert_reference(kvlist, "ref", NULL) == 0);
+    TEST_CHECK(cfl_kvlist_insert_kvlist(kvlist, "empty",
+                                        cfl_kvlist_create()) == 0);
+
+    return cfl_variant_create_from_kvlist(kvlist);
+}
+
+static char *print_to_buffer(struct cfl_variant *value, size_t *size)
+{
+    FILE *fp;
+    long length;
+    char *buffer;
+
+    *size = 0;
+    fp = tmpfile();
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    cfl_variant_print(fp, value);
+    length = ftell(fp);
+    rewind(fp);
+
+    buffer = malloc(length + 1);
+    if (buffer != NULL) {
+        *size = fread(buffer, 1, length, fp);
+        buffer[*size] = '\0';
+    }
+    fclose(fp);
+
+    return buffer;
+}
+
+/* values[1] = AnyValue{array_value = ArrayValue{}} in an OTLP ArrayValue */
+static const char otlp_empty_array[] = {0x0a, 0x02, 0x2a, 0x00};
+
+static int contains(const char *data, size_t size,
+                    const char *needle, size_t needle_size)
+{
+    size_t offset;
+
+    for (offset = 0; offset + needle_size <= size; offset++) {
+        if (memcmp(data + offset, needle, needle_size) == 0) {
+            return CFL_TRUE;
+        }
+    }
+
+    return CFL_FALSE;
+}
+
+static char *encode_chunked(struct cfl_encoder *encoder,
+                            struct cfl_variant *value,
+                            size_t chunk_size, size_t *size)
+{
+    int ret;
+    size_t used;
+    size_t written;
+    char *output;
+
+    output = malloc(65536);
+    if (output == NULL) {
+        return NULL;
+    }
+
+    ret = cfl_encoder_begin(encoder, value);
+    TEST_CHECK(ret == 0);
+
+    used = 0;
+    do {
+        ret = cfl_encoder_write(encoder, output + used, chunk_size, &written);
+        TEST_CHECK(ret != CFL_ENCODER_ERROR);
+        TEST_CHECK(written <= chunk_size);
+        used += written;
+    } while (ret == CFL_ENCODER_NEED_SPACE && used + chunk_size <= 65536);
+
+    TEST_CHECK(ret == CFL_ENCODER_DONE);
+    *size = used;
+
+    return output;
+}
+
+static char *encode_iov(struct cfl_encoder *encoder,
+                        struct cfl_variant *value,
+                        size_t iov_count, size_t scratch_size, size_t *size)
+{
+    int ret;
+    size_t index;
+    size_t used;
+    size_t iov_used;
+    char *output;
+    char scratch[64];
+    struct cfl_iovec iov[8];
+
+    output = malloc(65536);
+    if (output == NULL) {
+        return NULL;
+    }
+
+    ret = cfl_encoder_begin(encoder, value);
+    TEST_CHECK(ret == 0);
+
+    used = 0;
+    do {
+        ret = cfl_encoder_write_iov(encoder, iov, iov_count, &iov_used,
+                                    scratch, scratch_size);
+        TEST_CHECK(ret != CFL_ENCODER_ERROR);
+        TEST_CHECK(iov_used <= iov_count);
+
+        for (index = 0; index < iov_used; index++) {
+            memcpy(output + used, iov[index].iov_base, iov[index].iov_len);
+            used += iov[index].iov_len;
+        }
+    } while (ret == CFL_ENCODER_NEED_SPACE);
+
+    TEST_CHECK(ret == CFL_ENCODER_DONE);
+    *size = used;
+
+    return output;
+}
+
+static void test_json_chunked()
+{
+    size_t index;
+    size_t size;
+    size_t expected_size;
+    char *expected;
+    char *output;
+    struct cfl_variant *value;
+    struct cfl_encoder *encoder;
+    size_t chunk_sizes[] = {1, 3, 7, 64, 4096};
+
+    value = create_sample();
+    TEST_CHECK(value != NULL);
+
+    expected = print_to_buffer(value, &expected_size);
+    TEST_CHECK(expected != NULL);
+
+    /* the nested empty array closes the list */
+    TEST_CHECK(strstr(expected, ",2.500000,[]],") != NULL);
+
+    encoder = cfl_encoder_create(CFL_VARIANT_FORMAT_JSON);
+    TEST_CHECK(encoder != NULL);
+
+    for (index = 0; index < sizeof(chunk_sizes) / sizeof(size_t); index++) {
+        output = encode_chunked(encoder, value, chunk_sizes[index], &size);
+        TEST_CHECK(output != NULL);
+        TEST_CHECK(size == expected_size);
+        TEST_CHECK(memcmp(output, expected, expected_size) == 0);
+        TEST_MSG("chunk size %zu", chunk_sizes[index]);
+        free(output);
+    }
+
+    cfl_encoder_destroy(encoder);
+    free(expected);
+    cfl_variant_destroy(value);
+}
+
+static void test_json_iov()
+{
+    size_t size;
+    size_t expected_size;
+    char *expected;
+    char *output;
+    struct cfl_variant *value;
+    struct cfl_encoder *encoder;
+
+    value = create_sample();
+    TEST_CHECK(value != NULL);
+
+    expected = print_to_buffer(value, &expected_size);
+    TEST_CHECK(expected != NULL);
+
+    /* the nested empty array closes the list */
+    TEST_CHECK(strstr(expected, ",2.500000,[]],") != NULL);
+
+    encoder = cfl_encoder_create(CFL_VARIANT_FORMAT_JSON);
+    TEST_CHECK(encoder != NULL);
+
+    output = encode_iov(encoder, value, 8, 64, &size);
+    TEST_CHECK(size == expected_size);
+    TEST_CHECK(memcmp(output, expected, expected_size) == 0);
+    free(output);
+
+    /* one segment and a tiny scratch buffer per call */
+    output = encode_iov(encoder, value, 1, 2, &size);
+    TEST_CHECK(size == expected_size);
+    TEST_CHECK(memcmp(output, expected, expected_size) == 0);
+    free(output);
+
+    cfl_encoder_destroy(encoder);
+    free(expected);
+    cfl_variant_destroy(value);
+}
+
+static void test_iov_references_strings()
+{
+    int ret;
+    size_t index;
+    size_t iov_used;
+    int found;
+    char scratch[64];
+    struct cfl_iovec iov[8];
+    struct cfl_variant *value;
+    struct cfl_encoder *encoder;
+
+    value = cfl_variant_create_from_string("zero copy payload");
+    TEST_CHECK(value != NULL);
+
+    encoder = cfl_encoder_create(CFL_VARIANT_FORMAT_JSON);
+    TEST_CHECK(cfl_encoder_begin(encoder, value) == 0);
+
+    ret = cfl_encoder_write_iov(encoder, iov, 8, &iov_used,
+                                scratch, sizeof(scratch));
+    TEST_CHECK(ret == CFL_ENCODER_DONE);
+
+    found = CFL_FALSE;
+    for (index = 0; index < iov_used; index++) {
+        if (iov[index].iov_base == (void *) value->data.as_string) {
+            found = CFL_TRUE;
+        }
+    }
+    TEST_CHECK(found == CFL_TRUE);
+
+    cfl_encoder_destroy(encoder);
+    cfl_variant_destroy(value);
+}
+
+static void test_otlp()
+{
+    int ret;
+    size_t size;
+    size_t expected_size;
+    size_t encoded_size;
+    char *expected;
+    char *output;
+    struct cfl_variant *value;
+    struct cfl_encoder *encoder;
+
+    value = create_sample();
+    TEST_CHECK(value != NULL);
+
+    ret = cfl_otlp_any_value_size(value, &expected_size);
+    TEST_CHECK(ret == 0);
+
+    expected = malloc(expected_size);
+    TEST_CHECK(expected != NULL);
+    ret = cfl_otlp_any_value_encode(value, expected, expected_size,
+                                    &encoded_size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(contains(expected, expected_size, otlp_empty_array,
+                        sizeof(otlp_empty_array)) == CFL_TRUE);
+
+    encoder = cfl_encoder_create(CFL_VARIANT_FORMAT_OTLP);
+    TEST_CHECK(encoder != NULL);
+
+    output = encode_chunked(encoder, value, 5, &size);
+    TEST_CHECK(size == expected_size);
+    TEST_CHECK(memcmp(output, expected, expected_size) == 0);
+    free(output);
+
+    output = encode_iov(encoder, value, 2, 16, &size);
+    TEST_CHECK(size == expected_size);
+    TEST_CHECK(memcmp(output, expected, expected_size) == 0);
+    free(output);
+
+    cfl_encoder_destroy(encoder);
+    free(expected);
+    cfl_variant_destroy(value);
+}
+
+static void test_invalid()
+{
+    int ret;
+    size_t written;
+    char buffer[16];
+    struct cfl_array *array;
+    struct cfl_variant *value;
+    struct cfl_encoder *encoder;
+
+    TEST_CHECK(cfl_encoder_create(0) == NULL);
+
+    encoder = cfl_encoder_create(CFL_VARIANT_FORMAT_JSON);
+    TEST_CHECK(encoder != NULL);
+    TEST_CHECK(cfl_encoder_begin(encoder, NULL) == -1);
+
+    /* NULL array entries cannot be encoded */
+    array = cfl_array_create(1);
+    cfl_array_append_int64(array, 1);
+    cfl_variant_destroy(array->entries[0]);
+    array->entries[0] = NULL;
+    value = cfl_variant_create_from_array(array);
+
+    TEST_CHECK(cfl_encoder_begin(encoder, value) == 0);
+    ret = cfl_encoder_write(encoder, buffer, sizeof(buffer), &written);
+    TEST_CHECK(ret == CFL_ENCODER_ERROR);
+
+    /* errors are sticky until the encoder is restarted */
+    ret = cfl_encoder_write(encoder, buffer, sizeof(buffer), &written);
+    TEST_CHECK(ret == CFL_ENCODER_ERROR);
+
+    array->entries[0] = cfl_variant_create_from_int64(7);
+    TEST_CHECK(cfl_encoder_begin(encoder, value) == 0);
+    ret = cfl_encoder_write(encoder, buffer, sizeof(buffer), &written);
+    TEST_CHECK(ret == CFL_ENCODER_DONE);
+    TEST_CHECK(written == 3 && memcmp(buffer, "[7]", 3) == 0);
+
+    cfl_encoder_destroy(encoder);
+    cfl_variant_destroy(value);
+}
+
+TEST_LIST = {
+    {"json_chunked",           test_json_chunked},
+    {"json_iov",               test_json_iov},
+    {"iov_references_strings", test_iov_references_strings},
+    {"otlp",                   test_otlp},
+    {"invalid",                test_invalid},
+    { 0 }
+};
@@ -0,0 +1,239 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_epoch.h>
+
+#if defined (_WIN32) || defined (_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+#define READER_COUNT  4
+#define VERSION_COUNT 2000
+
+static int destroyed;
+
+static void count_destroy(void *data)
+{
+    (void) data;
+    destroyed++;
+}
+
+static void test_deferral()
+{
+    int                      index;
+    struct cfl_epoch        *domain;
+    struct cfl_epoch_reader *reader;
+
+    domain = cfl_epoch_create();
+    TEST_CHECK(domain != NULL);
+    TEST_CHECK(cfl_epoch_barrier_implementation(domain) != NULL);
+
+    reader = cfl_epoch_reader_create(domain);
+    TEST_CHECK(reader != NULL);
+
+    destroyed = 0;
+
+    /* nested sections keep the reader in its first epoch */
+    cfl_epoch_enter(reader);
+    cfl_epoch_enter(reader);
+    cfl_epoch_exit(reader);
+
+    TEST_CHECK(cfl_epoch_defer(domain, count_destroy, NULL) == 0);
+    for (index = 0; index < 4; index++) {
+        cfl_epoch_reclaim(domain);
+    }
+    TEST_CHECK(destroyed == 0);
+
+    cfl_epoch_exit(reader);
+
+    cfl_epoch_reclaim(domain);
+    TEST_CHECK(destroyed == 1);
+
+    /* idle readers do not hold anything back */
+    TEST_CHECK(cfl_epoch_defer(domain, count_destroy, NULL) == 0);
+    cfl_epoch_synchronize(domain);
+    TEST_CHECK(destroyed == 2);
+
+    /* pending callbacks run on destroy */
+    TEST_CHECK(cfl_epoch_defer(domain, count_destroy, NULL) == 0);
+    cfl_epoch_reader_destroy(reader);
+    cfl_epoch_destroy(domain);
+    TEST_CHECK(destroyed == 3);
+}
+
+static void test_objects()
+{
+    struct cfl_arena   *arena;
+    struct cfl_kvlist  *kvlist;
+    struct cfl_variant *value;
+    struct cfl_epoch   *domain;
+    void               *slot;
+
+    domain = cfl_epoch_create();
+    TEST_CHECK(domain != NULL);
+
+    kvlist = cfl_kvlist_create();
+    cfl_kvlist_insert_string(kvlist, "route", "default");
+    value = cfl_variant_create_from_kvlist(kvlist);
+
+    slot = NULL;
+    TEST_CHECK(cfl_epoch_publish(&slot, value) == NULL);
+    TEST_CHECK(cfl_epoch_dereference(&slot) == value);
+
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+    kvlist = cfl_kvlist_create_in(arena);
+    cfl_kvlist_insert_string(kvlist, "route", "next");
+
+    TEST_CHECK(cfl_epoch_publish(&slot,
+                    cfl_variant_create_from_kvlist_in(arena, kvlist)) == value);
+    TEST_CHECK(cfl_epoch_defer_variant_destroy(domain, value) == 0);
+
+    cfl_epoch_synchronize(domain);
+
+    cfl_epoch_publish(&slot, NULL);
+    TEST_CHECK(cfl_epoch_defer_arena_destroy(domain, arena) == 0);
+
+    cfl_epoch_destroy(domain);
+}
+
+static struct cfl_epoch *shared_domain;
+static void             *shared_slot;
+static uint32_t          shared_done;
+
+#if defined (_WIN32) || defined (_WIN64)
+static DWORD WINAPI reader_thread(LPVOID data)
+#else
+static void *reader_thread(void *data)
+#endif
+{
+    int                     *failures;
+    int64_t                  last;
+    struct cfl_variant      *value;
+    struct cfl_variant      *version;
+    struct cfl_epoch_reader *reader;
+
+    failures = data;
+    last = 0;
+
+    reader = cfl_epoch_reader_create(shared_domain);
+    if (reader == NULL) {
+        (*failures)++;
+        goto exit;
+    }
+
+    while (!cfl_atomic32_load_explicit(&shared_done, CFL_ATOMIC_ACQUIRE)) {
+        cfl_epoch_enter(reader);
+
+        value = cfl_epoch_dereference(&shared_slot);
+        version = cfl_kvlist_fetch(value->data.as_kvlist, "version");
+
+        /* versions only move forward and are never freed under us */
+        if (version == NULL || version->data.as_int64 < last) {
+            (*failures)++;
+        }
+        else {
+            last = version->data.as_int64;
+        }
+
+        cfl_epoch_exit(reader);
+    }
+
+    cfl_epoch_reader_destroy(reader);
+
+exit:
+#if defined (_WIN32) || defined (_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static struct cfl_variant *create_version(int64_t number)
+{
+    struct cfl_kvlist *kvlist;
+
+    kvlist = cfl_kvlist_create();
+    cfl_kvlist_insert_int64(kvlist, "version", number);
+    cfl_kvlist_insert_string(kvlist, "route", "output");
+
+    return cfl_variant_create_from_kvlist(kvlist);
+}
+
+static void test_readers()
+{
+    int                 index;
+    int                 failures[READER_COUNT];
+    struct cfl_variant *old;
+#if defined (_WIN32) || defined (_WIN64)
+    HANDLE              threads[READER_COUNT];
+#else
+    pthread_t           threads[READER_COUNT];
+#endif
+
+    shared_domain = cfl_epoch_create();
+    TEST_CHECK(shared_domain != NULL);
+    shared_slot = create_version(0);
+    shared_done = 0;
+
+    for (index = 0; index < READER_COUNT; index++) {
+        failures[index] = 0;
+#if defined (_WIN32) || defined (_WIN64)
+        threads[index] = CreateThread(NULL, 0, reader_thread,
+                                      &failures[index], 0, NULL);
+        TEST_CHECK(threads[index] != NULL);
+#else
+        TEST_CHECK(pthread_create(&threads[index], NULL, reader_thread,
+                                  &failures[index]) == 0);
+#endif
+    }
+
+    for (index = 1; index <= VERSION_COUNT; index++) {
+        old = cfl_epoch_publish(&shared_slot, create_version(index));
+        TEST_CHECK(cfl_epoch_defer_variant_destroy(shared_domain, old) == 0);
+    }
+
+    cfl_atomic32_store_explicit(&shared_done, 1, CFL_ATOMIC_RELEASE);
+
+    for (index = 0; index < READER_COUNT; index++) {
+#if defined (_WIN32) || defined (_WIN64)
+        WaitForSingleObject(threads[index], INFINITE);
+        CloseHandle(threads[index]);
+#else
+        pthread_join(threads[index], NULL);
+#endif
+        TEST_CHECK(failures[index] == 0);
+    }
+
+    cfl_epoch_synchronize(shared_domain);
+    cfl_epoch_destroy(shared_domain);
+    cfl_variant_destroy(shared_slot);
+}
+
+TEST_LIST = {
+    {"deferral", test_deferral},
+    {"objects",  test_objects},
+    {"readers",  test_readers},
+    { 0 }
+};
@@ -19,6 +19,8 @@
 
 #include <cfl/cfl_hash.h>
 
+#include <stdlib.h>
+
 #include "cfl_tests_internal.h"
 
 static void checks()
@@ -51,7 +53,74 @@ static void checks()
     TEST_CHECK(cfl_hash == xxh_hash);
 }
 
+static void long_inputs()
+{
+    size_t index;
+    size_t length;
+    size_t sizes[] = {0, 1, 17, 129, 240, 241, 1024, 4097, 100000};
+    unsigned char *buffer;
+    XXH128_hash_t xxh_wide;
+    cfl_hash_128bits_t cfl_wide;
+    cfl_hash_state_t state;
+
+    buffer = malloc(100000);
+    TEST_CHECK(buffer != NULL);
+    for (index = 0; index < 100000; index++) {
+        buffer[index] = (unsigned char) (index * 7 + (index >> 8));
+    }
+
+    TEST_CHECK(cfl_hash_64bits("", 0) == 0x2D06800538D394C2ULL);
+    TEST_CHECK(cfl_hash_implementation() != NULL);
+    TEST_MSG("implementation: %s", cfl_hash_implementation());
+
+    /* the dispatched kernels must match the portable results */
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index++) {
+        length = sizes[index];
+
+        TEST_CHECK(cfl_hash_64bits(buffer, length) ==
+                   XXH3_64bits(buffer, length));
+        TEST_CHECK(cfl_hash_64bits_with_seed(buffer, length, 42) ==
+                   XXH3_64bits_withSeed(buffer, length, 42));
+
+        cfl_wide = cfl_hash_128bits(buffer, length);
+        xxh_wide = XXH3_128bits(buffer, length);
+        TEST_CHECK(XXH128_isEqual(cfl_wide, xxh_wide));
+
+        cfl_wide = cfl_hash_128bits_with_seed(buffer, length, 42);
+        xxh_wide = XXH3_128bits_withSeed(buffer, length, 42);
+        TEST_CHECK(XXH128_isEqual(cfl_wide, xxh_wide));
+        TEST_MSG("length %zu", length);
+    }
+
+    /* streaming in uneven pieces matches one-shot hashing */
+    TEST_CHECK(cfl_hash_128bits_reset_with_seed(&state, 7) == XXH_OK);
+    for (index = 0; index < 100000; index += length) {
+        length = 1 + index % 3001;
+        if (index + length > 100000) {
+            length = 100000 - index;
+        }
+        TEST_CHECK(cfl_hash_128bits_update(&state, buffer + index,
+                                           length) == XXH_OK);
+    }
+    cfl_wide = cfl_hash_128bits_digest(&state);
+    TEST_CHECK(XXH128_isEqual(cfl_wide,
+                              cfl_hash_128bits_with_seed(buffer, 100000, 7)));
+
+    TEST_CHECK(cfl_hash_128bits_reset(&state) == XXH_OK);
+    TEST_CHECK(cfl_hash_128bits_update(&state, buffer, 5000) == XXH_OK);
+    cfl_wide = cfl_hash_128bits_digest(&state);
+    TEST_CHECK(XXH128_isEqual(cfl_wide, cfl_hash_128bits(buffer, 5000)));
+
+    TEST_CHECK(cfl_hash_64bits_reset_with_seed(&state, 9) == XXH_OK);
+    TEST_CHECK(cfl_hash_64bits_update(&state, buffer, 5000) == XXH_OK);
+    TEST_CHECK(cfl_hash_64bits_digest(&state) ==
+               cfl_hash_64bits_with_seed(buffer, 5000, 9));
+
+    free(buffer);
+}
+
 TEST_LIST = {
     {"checks",  checks},
+    {"long_inputs", long_inputs},
     { 0 }
 };
@@ -0,0 +1,244 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_image.h>
+
+#include "cfl_tests_internal.h"
+
+static char *encode_image(struct cfl_variant *value, size_t *size)
+{
+    int ret;
+    size_t encoded_size;
+    char *buffer;
+
+    ret = cfl_image_size(value, size);
+    TEST_CHECK(ret == 0);
+
+    buffer = malloc(*size);
+    TEST_CHECK(buffer != NULL);
+
+    ret = cfl_image_encode(value, buffer, *size, &encoded_size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(encoded_size == *size);
+
+    return buffer;
+}
+
+static void test_scalars()
+{
+    int ret;
+    int flag;
+    size_t size;
+    int64_t number;
+    char *buffer;
+    struct cfl_image image;
+    struct cfl_variant *value;
+    const struct cfl_image_slot *root;
+
+    value = cfl_variant_create_from_int64(-7);
+    buffer = encode_image(value, &size);
+    TEST_CHECK(size == 32);
+
+    ret = cfl_image_open(&image, buffer, size);
+    TEST_CHECK(ret == 0);
+
+    root = cfl_image_root(&image);
+    TEST_CHECK(cfl_image_type(&image, root) == CFL_VARIANT_INT);
+    TEST_CHECK(cfl_image_get_int64(&image, root, &number) == 0);
+    TEST_CHECK(number == -7);
+
+    /* type mismatches are rejected */
+    TEST_CHECK(cfl_image_get_bool(&image, root, &flag) == -1);
+    TEST_CHECK(cfl_image_array_count(&image, root) == 0);
+
+    free(buffer);
+    cfl_variant_destroy(value);
+}
+
+static void test_graph()
+{
+    int ret;
+    int flag;
+    size_t index;
+    size_t size;
+    size_t length;
+    char key[16];
+    double ratio;
+    uint64_t big;
+    int64_t number;
+    const char *data;
+    char *buffer;
+    struct cfl_array *array;
+    struct cfl_kvlist *kvlist;
+    struct cfl_kvlist *inner;
+    struct cfl_variant *value;
+    struct cfl_image image;
+    const struct cfl_image_slot *root;
+    const struct cfl_image_slot *slot;
+    const struct cfl_image_slot *entry;
+
+    kvlist = cfl_kvlist_create();
+    inner = cfl_kvlist_create();
+    array = cfl_array_create(4);
+
+    cfl_array_append_string(array, "first");
+    cfl_array_append_bytes(array, "\0\1", 2, CFL_FALSE);
+    cfl_array_append_null(array);
+    cfl_array_append_uint64(array, UINT64_MAX);
+
+    cfl_kvlist_insert_bool(inner, "ok", CFL_TRUE);
+    cfl_kvlist_insert_double(inner, "ratio", 0.25);
+
+    /* enough keys to exercise the directory sort */
+    for (index = 0; index < 40; index++) {
+        snprintf(key, sizeof(key), "key-%02zu", 39 - index);
+        cfl_kvlist_insert_int64(kvlist, key, (int64_t) (39 - index));
+    }
+    cfl_kvlist_insert_string(kvlist, "Host", "upper");
+    cfl_kvlist_insert_string(kvlist, "host", "lower");
+    cfl_kvlist_insert_array(kvlist, "list", array);
+    cfl_kvlist_insert_kvlist(kvlist, "inner", inner);
+
+    value = cfl_variant_create_from_kvlist(kvlist);
+    buffer = encode_image(value, &size);
+    TEST_CHECK(size % 8 == 0);
+
+    ret = cfl_variant_encoded_size(value, CFL_VARIANT_FORMAT_IMAGE, &length);
+    TEST_CHECK(ret == 0 && length == size);
+
+    ret = cfl_image_open(&image, buffer, size);
+    TEST_CHECK(ret == 0);
+
+    root = cfl_image_root(&image);
+    TEST_CHECK(cfl_image_type(&image, root) == CFL_VARIANT_KVLIST);
+    TEST_CHECK(cfl_image_kvlist_count(&image, root) == 44);
+
+    for (index = 0; index < 40; index++) {
+        snprintf(key, sizeof(key), "key-%02zu", index);
+        slot = cfl_image_kvlist_fetch_s(&image, root, key, strlen(key));
+        TEST_CHECK(cfl_image_get_int64(&image, slot, &number) == 0);
+        TEST_CHECK(number == (int64_t) index);
+    }
+
+    /* insertion order is kept for iteration */
+    ret = cfl_image_kvlist_entry(&image, root, 0, &data, &length, &slot);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(length == 6 && memcmp(data, "key-39", 6) == 0);
+    TEST_CHECK(data[length] == '\0');
+
+    /* case-insensitive lookups return the first match like kvlist fetch */
+    slot = cfl_image_kvlist_fetch_s(&image, root, "HOST", 4);
+    TEST_CHECK(cfl_image_get_string(&image, slot, &data, &length) == 0);
+    TEST_CHECK(length == 5 && memcmp(data, "upper", 5) == 0);
+
+    slot = cfl_image_kvlist_fetch_case_s(&image, root, "host", 4);
+    TEST_CHECK(cfl_image_get_string(&image, slot, &data, &length) == 0);
+    TEST_CHECK(length == 5 && memcmp(data, "lower", 5) == 0);
+
+    TEST_CHECK(cfl_image_kvlist_fetch_case_s(&image, root,
+                                             "HOST", 4) == NULL);
+    TEST_CHECK(cfl_image_kvlist_fetch_s(&image, root, "missing", 7) == NULL);
+
+    slot = cfl_image_kvlist_fetch_s(&image, root, "list", 4);
+    TEST_CHECK(cfl_image_array_count(&image, slot) == 4);
+
+    entry = cfl_image_array_fetch_by_index(&image, slot, 0);
+    TEST_CHECK(cfl_image_get_string(&image, entry, &data, &length) == 0);
+    TEST_CHECK(length == 5 && memcmp(data, "first", 5) == 0);
+
+    entry = cfl_image_array_fetch_by_index(&image, slot, 1);
+    TEST_CHECK(cfl_image_type(&image, entry) == CFL_VARIANT_BYTES);
+    TEST_CHECK(cfl_image_get_string(&image, entry, &data, &length) == 0);
+    TEST_CHECK(length == 2 && data[0] == 0 && data[1] == 1);
+
+    entry = cfl_image_array_fetch_by_index(&image, slot, 2);
+    TEST_CHECK(cfl_image_type(&image, entry) == CFL_VARIANT_NULL);
+
+    entry = cfl_image_array_fetch_by_index(&image, slot, 3);
+    TEST_CHECK(cfl_image_get_uint64(&image, entry, &big) == 0);
+    TEST_CHECK(big == UINT64_MAX);
+
+    TEST_CHECK(cfl_image_array_fetch_by_index(&image, slot, 4) == NULL);
+
+    slot = cfl_image_kvlist_fetch_s(&image, root, "inner", 5);
+    entry = cfl_image_kvlist_fetch_s(&image, slot, "ok", 2);
+    TEST_CHECK(cfl_image_get_bool(&image, entry, &flag) == 0 && flag);
+    entry = cfl_image_kvlist_fetch_s(&image, slot, "ratio", 5);
+    TEST_CHECK(cfl_image_get_double(&image, entry, &ratio) == 0);
+    TEST_CHECK(ratio == 0.25);
+
+    free(buffer);
+    cfl_variant_destroy(value);
+}
+
+static void test_malformed()
+{
+    int ret;
+    size_t size;
+    size_t length;
+    const char *data;
+    char *buffer;
+    struct cfl_image image;
+    struct cfl_array *array;
+    struct cfl_variant *value;
+    const struct cfl_image_slot *root;
+    const struct cfl_image_slot *slot;
+
+    array = cfl_array_create(2);
+    cfl_array_append_string(array, "a");
+    cfl_array_append_string(array, "b");
+    value = cfl_variant_create_from_array(array);
+    buffer = encode_image(value, &size);
+
+    /* short buffers and bad headers */
+    TEST_CHECK(cfl_image_open(&image, buffer, size - 1) == -1);
+    buffer[0] = 'X';
+    TEST_CHECK(cfl_image_open(&image, buffer, size) == -1);
+    buffer[0] = 'C';
+
+    ret = cfl_image_open(&image, buffer, size);
+    TEST_CHECK(ret == 0);
+    root = cfl_image_root(&image);
+    TEST_CHECK(cfl_image_array_count(&image, root) == 2);
+
+    /* an entry count larger than the image is rejected */
+    buffer[32] = (char) 0xff;
+    TEST_CHECK(cfl_image_array_count(&image, root) == 0);
+    TEST_CHECK(cfl_image_array_fetch_by_index(&image, root, 0) == NULL);
+    buffer[32] = 2;
+
+    /* a string offset outside of the image is rejected */
+    slot = cfl_image_array_fetch_by_index(&image, root, 0);
+    TEST_CHECK(cfl_image_get_string(&image, slot, &data, &length) == 0);
+    buffer[32 + 8 + 8 + 6] = 0x7f;
+    TEST_CHECK(cfl_image_get_string(&image, slot, &data, &length) == -1);
+
+    TEST_CHECK(cfl_image_encode(value, buffer, size - 1, NULL) == -1);
+
+    free(buffer);
+    cfl_variant_destroy(value);
+}
+
+TEST_LIST = {
+    {"scalars",   test_scalars},
+    {"graph",     test_graph},
+    {"malformed", test_malformed},
+    { 0 }
+};
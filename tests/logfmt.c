@@ -0,0 +1,247 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_logfmt.h>
+
+#include "cfl_tests_internal.h"
+
+static struct cfl_variant *value_at(struct cfl_kvlist *list, int index,
+                                    const char *key)
+{
+    int position = 0;
+    struct cfl_list *head;
+    struct cfl_kvpair *pair;
+
+    cfl_list_foreach(head, &list->list) {
+        pair = cfl_list_entry(head, struct cfl_kvpair, _head);
+        if (position++ == index) {
+            TEST_CHECK(strcmp(pair->key, key) == 0);
+            TEST_MSG("key %d: got=%s expect=%s", index, pair->key, key);
+            return pair->val;
+        }
+    }
+
+    TEST_CHECK(0);
+    TEST_MSG("no pair %d", index);
+
+    return NULL;
+}
+
+static void check_string(struct cfl_kvlist *list, int index,
+                         const char *key, const char *value)
+{
+    struct cfl_variant *variant;
+
+    variant = value_at(list, index, key);
+    if (!TEST_CHECK(variant != NULL && variant->type == CFL_VARIANT_STRING)) {
+        return;
+    }
+    TEST_CHECK(variant->size == strlen(value) &&
+               memcmp(variant->data.as_string, value, variant->size) == 0);
+    TEST_MSG("key=%s got=%.*s expect=%s", key, (int) variant->size,
+             variant->data.as_string, value);
+}
+
+static void test_strings()
+{
+    const char *line;
+    struct cfl_variant *variant;
+    struct cfl_kvlist *list;
+
+    line = "time=2026-03-14T09:26:53Z level=info msg=\"order \\\"42\\\" placed\" "
+           "path=/a?b=c  empty= flag\tquoted=\"plain value\" tab=\"a\\tb\\\\\" "
+           "other=\"\\x\"";
+
+    list = cfl_logfmt_parse(NULL, line, strlen(line), 0);
+    TEST_CHECK(list != NULL);
+    if (list == NULL) {
+        return;
+    }
+
+    TEST_CHECK(cfl_kvlist_count(list) == 9);
+    check_string(list, 0, "time", "2026-03-14T09:26:53Z");
+    check_string(list, 1, "level", "info");
+    check_string(list, 2, "msg", "order \"42\" placed");
+    check_string(list, 3, "path", "/a?b=c");
+    check_string(list, 4, "empty", "");
+    variant = value_at(list, 5, "flag");
+    TEST_CHECK(variant != NULL && variant->type == CFL_VARIANT_NULL);
+    check_string(list, 6, "quoted", "plain value");
+    check_string(list, 7, "tab", "a\tb\\");
+    check_string(list, 8, "other", "\\x");
+
+    /* values without escapes point into the line */
+    variant = value_at(list, 1, "level");
+    TEST_CHECK(variant->referenced == CFL_TRUE);
+    TEST_CHECK(variant->data.as_string == line + 32);
+    variant = value_at(list, 6, "quoted");
+    TEST_CHECK(variant->referenced == CFL_TRUE);
+    variant = value_at(list, 2, "msg");
+    TEST_CHECK(variant->referenced == CFL_FALSE);
+
+    cfl_kvlist_destroy(list);
+
+    list = cfl_logfmt_parse(NULL, line, strlen(line), CFL_LOGFMT_COPY);
+    TEST_CHECK(list != NULL);
+    variant = value_at(list, 1, "level");
+    TEST_CHECK(variant->referenced == CFL_FALSE);
+    TEST_CHECK(strcmp(variant->data.as_string, "info") == 0);
+    cfl_kvlist_destroy(list);
+
+    /* empty lines give empty lists */
+    list = cfl_logfmt_parse(NULL, " \t ", 3, 0);
+    TEST_CHECK(list != NULL && cfl_kvlist_count(list) == 0);
+    cfl_kvlist_destroy(list);
+}
+
+static void test_types()
+{
+    const char *line;
+    struct cfl_variant *variant;
+    struct cfl_kvlist *list;
+
+    line = "a=42 b=-7 c=18446744073709551615 d=-9223372036854775808 "
+           "e=3.25 f=-1e3 g=true h=false i=\"12\" j=1.2.3 k=- l=99999999999999999999 "
+           "m=1e n=0x10 o=.5";
+
+    list = cfl_logfmt_parse(NULL, line, strlen(line), CFL_LOGFMT_INFER_TYPES);
+    TEST_CHECK(list != NULL);
+    if (list == NULL) {
+        return;
+    }
+
+    variant = value_at(list, 0, "a");
+    TEST_CHECK(variant->type == CFL_VARIANT_INT && variant->data.as_int64 == 42);
+    variant = value_at(list, 1, "b");
+    TEST_CHECK(variant->type == CFL_VARIANT_INT && variant->data.as_int64 == -7);
+    variant = value_at(list, 2, "c");
+    TEST_CHECK(variant->type == CFL_VARIANT_UINT &&
+               variant->data.as_uint64 == UINT64_MAX);
+    variant = value_at(list, 3, "d");
+    TEST_CHECK(variant->type == CFL_VARIANT_INT &&
+               variant->data.as_int64 == INT64_MIN);
+    variant = value_at(list, 4, "e");
+    TEST_CHECK(variant->type == CFL_VARIANT_DOUBLE &&
+               variant->data.as_double == 3.25);
+    variant = value_at(list, 5, "f");
+    TEST_CHECK(variant->type == CFL_VARIANT_DOUBLE &&
+               variant->data.as_double == -1000.0);
+    variant = value_at(list, 6, "g");
+    TEST_CHECK(variant->type == CFL_VARIANT_BOOL && variant->data.as_bool);
+    variant = value_at(list, 7, "h");
+    TEST_CHECK(variant->type == CFL_VARIANT_BOOL && !variant->data.as_bool);
+    check_string(list, 8, "i", "12");
+    check_string(list, 9, "j", "1.2.3");
+    check_string(list, 10, "k", "-");
+    variant = value_at(list, 11, "l");
+    TEST_CHECK(variant->type == CFL_VARIANT_DOUBLE &&
+               variant->data.as_double == 1e20);
+    check_string(list, 12, "m", "1e");
+    check_string(list, 13, "n", "0x10");
+    variant = value_at(list, 14, "o");
+    TEST_CHECK(variant->type == CFL_VARIANT_DOUBLE &&
+               variant->data.as_double == 0.5);
+
+    cfl_kvlist_destroy(list);
+}
+
+static void test_arena()
+{
+    int index;
+    char line[512];
+    struct cfl_arena *arena;
+    struct cfl_kvlist *list;
+    struct cfl_variant *variant;
+
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+
+    /* escapes on both sides of the 64-byte scan blocks */
+    for (index = 0; index < 100; index++) {
+        snprintf(line, sizeof(line),
+                 "k%d=\"%.*s\\\"x\" n=%d pad=\"%.*s\" end=1.5",
+                 index, index, "abcdefghijabcdefghijabcdefghijabcdefghij"
+                 "abcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghij",
+                 index, 100 - index,
+                 "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz"
+                 "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz");
+
+        list = cfl_logfmt_parse(arena, line, strlen(line),
+                                CFL_LOGFMT_INFER_TYPES);
+        if (!TEST_CHECK(list != NULL)) {
+            TEST_MSG("line=%s", line);
+            continue;
+        }
+        TEST_CHECK(list->arena == arena);
+        TEST_CHECK(cfl_kvlist_count(list) == 4);
+
+        variant = cfl_kvlist_fetch(list, "n");
+        TEST_CHECK(variant != NULL && variant->type == CFL_VARIANT_INT &&
+                   variant->data.as_int64 == index);
+        variant = cfl_kvlist_fetch(list, "pad");
+        TEST_CHECK(variant != NULL && variant->size == (size_t) (100 - index));
+        variant = cfl_kvlist_fetch(list, "end");
+        TEST_CHECK(variant != NULL && variant->type == CFL_VARIANT_DOUBLE);
+        variant = value_at(list, 0, cfl_list_entry_first(&list->list,
+                                                         struct cfl_kvpair,
+                                                         _head)->key);
+        TEST_CHECK(variant->size == (size_t) index + 2 &&
+                   variant->data.as_string[index] == '"' &&
+                   variant->data.as_string[index + 1] == 'x');
+
+        cfl_kvlist_destroy(list);
+        cfl_arena_reset(arena);
+    }
+
+    cfl_arena_destroy(arena);
+}
+
+static void test_errors()
+{
+    struct cfl_kvlist *list;
+
+    TEST_CHECK(cfl_logfmt_parse(NULL, "a=\"open", 7, 0) == NULL);
+    TEST_CHECK(cfl_logfmt_parse(NULL, "a=\"open\\\"", 9, 0) == NULL);
+    TEST_CHECK(cfl_logfmt_parse(NULL, "a=\"x\"y", 6, 0) == NULL);
+    TEST_CHECK(cfl_logfmt_parse(NULL, "=x", 2, 0) == NULL);
+    TEST_CHECK(cfl_logfmt_parse(NULL, "a=1 \"b\"=2", 9, 0) == NULL);
+    TEST_CHECK(cfl_logfmt_parse(NULL, NULL, 1, 0) == NULL);
+
+    /* pairs before the error are kept */
+    list = cfl_kvlist_create();
+    TEST_CHECK(cfl_logfmt_decode(list, "a=1 b=\"", 7, 0) == -1);
+    TEST_CHECK(cfl_kvlist_count(list) == 1);
+    TEST_CHECK(cfl_logfmt_decode(NULL, "a=1", 3, 0) == -1);
+    cfl_kvlist_destroy(list);
+
+    /* the line does not need to be NUL terminated */
+    list = cfl_logfmt_parse(NULL, "a=12345", 4, CFL_LOGFMT_INFER_TYPES);
+    TEST_CHECK(list != NULL);
+    TEST_CHECK(cfl_kvlist_fetch(list, "a")->data.as_int64 == 12);
+    cfl_kvlist_destroy(list);
+}
+
+TEST_LIST = {
+    {"strings", test_strings},
+    {"types",   test_types},
+    {"arena",   test_arena},
+    {"errors",  test_errors},
+    { 0 }
+};
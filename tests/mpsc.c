@@ -0,0 +1,179 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_mpsc.h>
+
+#if defined (_WIN32) || defined (_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+#define PRODUCER_COUNT 8
+#define ITEM_COUNT     20000
+
+struct item {
+    int                  producer;
+    int                  sequence;
+    struct cfl_mpsc_node _head;
+};
+
+static struct cfl_mpsc_queue shared_queue;
+static struct item          *shared_items;
+
+static void test_order()
+{
+    int                   index;
+    size_t                count;
+    struct item           items[5];
+    struct item          *entry;
+    struct cfl_mpsc_node *node;
+    struct cfl_mpsc_node *batch[8];
+    struct cfl_mpsc_queue queue;
+
+    cfl_mpsc_queue_init(&queue);
+    TEST_CHECK(cfl_mpsc_queue_is_empty(&queue));
+    TEST_CHECK(cfl_mpsc_queue_pop(&queue) == NULL);
+
+    for (index = 0; index < 5; index++) {
+        items[index].sequence = index;
+        cfl_mpsc_queue_push(&queue, &items[index]._head);
+    }
+    TEST_CHECK(!cfl_mpsc_queue_is_empty(&queue));
+
+    node = cfl_mpsc_queue_pop(&queue);
+    entry = cfl_mpsc_entry(node, struct item, _head);
+    TEST_CHECK(entry == &items[0]);
+
+    count = cfl_mpsc_queue_pop_batch(&queue, batch, 2);
+    TEST_CHECK(count == 2);
+    TEST_CHECK(batch[0] == &items[1]._head && batch[1] == &items[2]._head);
+
+    /* popped nodes can be queued again */
+    cfl_mpsc_queue_push(&queue, &items[0]._head);
+
+    count = cfl_mpsc_queue_pop_batch(&queue, batch, 8);
+    TEST_CHECK(count == 3);
+    TEST_CHECK(batch[0] == &items[3]._head);
+    TEST_CHECK(batch[1] == &items[4]._head);
+    TEST_CHECK(batch[2] == &items[0]._head);
+
+    TEST_CHECK(cfl_mpsc_queue_is_empty(&queue));
+    TEST_CHECK(cfl_mpsc_queue_pop_batch(&queue, batch, 8) == 0);
+}
+
+#if defined (_WIN32) || defined (_WIN64)
+static DWORD WINAPI producer(LPVOID data)
+#else
+static void *producer(void *data)
+#endif
+{
+    int          index;
+    struct item *items;
+
+    items = data;
+    for (index = 0; index < ITEM_COUNT; index++) {
+        cfl_mpsc_queue_push(&shared_queue, &items[index]._head);
+    }
+
+#if defined (_WIN32) || defined (_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void test_producers()
+{
+    int                   index;
+    int                   received;
+    size_t                count;
+    int                   next_sequence[PRODUCER_COUNT];
+    struct item          *entry;
+    struct cfl_mpsc_node *batch[64];
+#if defined (_WIN32) || defined (_WIN64)
+    HANDLE                threads[PRODUCER_COUNT];
+#else
+    pthread_t             threads[PRODUCER_COUNT];
+#endif
+
+    shared_items = calloc(PRODUCER_COUNT * ITEM_COUNT, sizeof(struct item));
+    TEST_CHECK(shared_items != NULL);
+    if (shared_items == NULL) {
+        return;
+    }
+
+    cfl_mpsc_queue_init(&shared_queue);
+
+    for (index = 0; index < PRODUCER_COUNT * ITEM_COUNT; index++) {
+        shared_items[index].producer = index / ITEM_COUNT;
+        shared_items[index].sequence = index % ITEM_COUNT;
+    }
+
+    for (index = 0; index < PRODUCER_COUNT; index++) {
+        next_sequence[index] = 0;
+#if defined (_WIN32) || defined (_WIN64)
+        threads[index] = CreateThread(NULL, 0, producer,
+                                      &shared_items[index * ITEM_COUNT],
+                                      0, NULL);
+        TEST_CHECK(threads[index] != NULL);
+#else
+        TEST_CHECK(pthread_create(&threads[index], NULL, producer,
+                                  &shared_items[index * ITEM_COUNT]) == 0);
+#endif
+    }
+
+    /* every item arrives once and each producer's items stay in order */
+    received = 0;
+    while (received < PRODUCER_COUNT * ITEM_COUNT) {
+        count = cfl_mpsc_queue_pop_batch(&shared_queue, batch, 64);
+
+        for (index = 0; index < (int) count; index++) {
+            entry = cfl_mpsc_entry(batch[index], struct item, _head);
+            if (entry->sequence != next_sequence[entry->producer]) {
+                TEST_CHECK(entry->sequence == next_sequence[entry->producer]);
+            }
+            next_sequence[entry->producer]++;
+        }
+        received += (int) count;
+    }
+
+    for (index = 0; index < PRODUCER_COUNT; index++) {
+#if defined (_WIN32) || defined (_WIN64)
+        WaitForSingleObject(threads[index], INFINITE);
+        CloseHandle(threads[index]);
+#else
+        pthread_join(threads[index], NULL);
+#endif
+        TEST_CHECK(next_sequence[index] == ITEM_COUNT);
+    }
+
+    TEST_CHECK(cfl_mpsc_queue_is_empty(&shared_queue));
+
+    free(shared_items);
+}
+
+TEST_LIST = {
+    {"order",     test_order},
+    {"producers", test_producers},
+    { 0 }
+};
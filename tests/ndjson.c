@@ -0,0 +1,427 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_ndjson.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+struct replay {
+    int lines[4];
+    int records[4];
+    int64_t sum[4];
+    int stop_after;
+};
+
+static struct cfl_variant *value_of(struct cfl_kvlist *list, const char *key)
+{
+    struct cfl_variant *value;
+
+    value = cfl_kvlist_fetch(list, (char *) key);
+    TEST_CHECK(value != NULL);
+    TEST_MSG("missing key %s", key);
+
+    return value;
+}
+
+static void check_string(struct cfl_variant *value, const char *expected,
+                         size_t length)
+{
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_STRING);
+    if (value == NULL || value->type != CFL_VARIANT_STRING) {
+        return;
+    }
+
+    TEST_CHECK(cfl_variant_size_get(value) == length);
+    TEST_CHECK(memcmp(value->data.as_string, expected, length) == 0);
+    TEST_MSG("got=%.*s expect=%.*s", (int) cfl_variant_size_get(value),
+             value->data.as_string, (int) length, expected);
+}
+
+static void test_ndjson_decode()
+{
+    const char *line = " {\"service\": \"api\", \"status\":200, \"ok\":true,"
+                       " \"error\":null, \"latency\":-1.5e-3,"
+                       " \"bytes\":18446744073709551615,"
+                       " \"tags\":[\"a\", 1, [], {}],"
+                       " \"http\":{\"method\":\"GET\", \"path\":\"/\"}} ";
+    struct cfl_kvlist *list;
+    struct cfl_kvlist *http;
+    struct cfl_array *tags;
+    struct cfl_variant *value;
+    struct cfl_arena *arena;
+
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+
+    list = cfl_ndjson_decode(arena, line, strlen(line), 0);
+    TEST_CHECK(list != NULL);
+    if (list == NULL) {
+        cfl_arena_destroy(arena);
+        return;
+    }
+    TEST_CHECK(cfl_kvlist_count(list) == 8);
+
+    value = value_of(list, "service");
+    check_string(value, "api", 3);
+    TEST_CHECK(value->referenced == CFL_TRUE);
+    TEST_CHECK(value->data.as_string == line + 14);
+
+    value = value_of(list, "status");
+    TEST_CHECK(value->type == CFL_VARIANT_INT);
+    TEST_CHECK(value->data.as_int64 == 200);
+
+    value = value_of(list, "ok");
+    TEST_CHECK(value->type == CFL_VARIANT_BOOL);
+    TEST_CHECK(value->data.as_bool == CFL_TRUE);
+
+    value = value_of(list, "error");
+    TEST_CHECK(value->type == CFL_VARIANT_NULL);
+
+    value = value_of(list, "latency");
+    TEST_CHECK(value->type == CFL_VARIANT_DOUBLE);
+    TEST_CHECK(value->data.as_double == -1.5e-3);
+
+    value = value_of(list, "bytes");
+    TEST_CHECK(value->type == CFL_VARIANT_UINT);
+    TEST_CHECK(value->data.as_uint64 == UINT64_MAX);
+
+    value = value_of(list, "tags");
+    TEST_CHECK(value->type == CFL_VARIANT_ARRAY);
+    tags = value->data.as_array;
+    TEST_CHECK(cfl_array_size(tags) == 4);
+    check_string(cfl_array_fetch_by_index(tags, 0), "a", 1);
+    TEST_CHECK(cfl_array_fetch_by_index(tags, 1)->data.as_int64 == 1);
+    TEST_CHECK(cfl_array_fetch_by_index(tags, 2)->type == CFL_VARIANT_ARRAY);
+    TEST_CHECK(cfl_array_size(cfl_array_fetch_by_index(tags, 2)->data.as_array) == 0);
+    TEST_CHECK(cfl_array_fetch_by_index(tags, 3)->type == CFL_VARIANT_KVLIST);
+
+    value = value_of(list, "http");
+    TEST_CHECK(value->type == CFL_VARIANT_KVLIST);
+    http = value->data.as_kvlist;
+    check_string(value_of(http, "method"), "GET", 3);
+    check_string(value_of(http, "path"), "/", 1);
+
+    cfl_arena_destroy(arena);
+
+    /* heap allocated and copied */
+    list = cfl_ndjson_decode(NULL, line, strlen(line), CFL_NDJSON_COPY);
+    TEST_CHECK(list != NULL);
+    value = value_of(list, "service");
+    check_string(value, "api", 3);
+    TEST_CHECK(value->referenced == CFL_FALSE);
+    cfl_kvlist_destroy(list);
+}
+
+static void test_ndjson_decode_escapes()
+{
+    const char *line = "{\"k\\u0065y\":\"a\\\"b\\\\c\\/d\\n\\t\","
+                       "\"unicode\":\"\\u00e9\\u20ac\\ud83d\\ude00\","
+                       "\"lone\":\"\\ud800x\"}";
+    struct cfl_kvlist *list;
+    struct cfl_variant *value;
+
+    list = cfl_ndjson_decode(NULL, line, strlen(line), 0);
+    TEST_CHECK(list != NULL);
+    if (list == NULL) {
+        return;
+    }
+
+    value = value_of(list, "key");
+    check_string(value, "a\"b\\c/d\n\t", 9);
+    TEST_CHECK(value->referenced == CFL_FALSE);
+
+    check_string(value_of(list, "unicode"),
+                 "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", 9);
+    check_string(value_of(list, "lone"), "\xef\xbf\xbdx", 4);
+
+    cfl_kvlist_destroy(list);
+}
+
+static void test_ndjson_decode_invalid()
+{
+    int index;
+    int depth;
+    char nested[600];
+    struct cfl_kvlist *list;
+    const char *lines[] = {
+        "",
+        "   ",
+        "[1, 2]",
+        "\"text\"",
+        "{",
+        "{\"a\"}",
+        "{\"a\":}",
+        "{\"a\":1,}",
+        "{\"a\":1 \"b\":2}",
+        "{\"a\":[1,]}",
+        "{\"a\":\"unterminated}",
+        "{\"a\":\"bad \\x escape\"}",
+        "{\"a\":\"\\u12\"}",
+        "{\"a\":01}",
+        "{\"a\":+1}",
+        "{\"a\":1.}",
+        "{\"a\":.5}",
+        "{\"a\":1e}",
+        "{\"a\":tru}",
+        "{\"a\":nul}",
+        "{a:1}",
+        "{\"a\":1} x",
+        "{\"a\":1}{}",
+        NULL
+    };
+
+    for (index = 0; lines[index] != NULL; index++) {
+        list = cfl_ndjson_decode(NULL, lines[index], strlen(lines[index]), 0);
+        TEST_CHECK(list == NULL);
+        TEST_MSG("accepted: %s", lines[index]);
+        if (list != NULL) {
+            cfl_kvlist_destroy(list);
+        }
+    }
+
+    /* nesting beyond the depth limit */
+    depth = 0;
+    nested[depth++] = '{';
+    while (depth < 500) {
+        memcpy(nested + depth, "\"a\":[", 5);
+        depth += 5;
+    }
+    list = cfl_ndjson_decode(NULL, nested, depth, 0);
+    TEST_CHECK(list == NULL);
+}
+
+static void test_ndjson_reader_next()
+{
+    int count = 0;
+    size_t length;
+    const char *line;
+    const char *data = "{\"a\":1}\r\n\n\r\n{\"a\":2}\n  \n{\"a\":3}";
+    const char *expected[] = {"{\"a\":1}", "{\"a\":2}", "  ", "{\"a\":3}"};
+    struct cfl_ndjson_reader *reader;
+
+    reader = cfl_ndjson_reader_create(data, strlen(data));
+    TEST_CHECK(reader != NULL);
+
+    while (cfl_ndjson_reader_next(reader, &line, &length) == 0) {
+        TEST_CHECK(count < 4);
+        if (count >= 4) {
+            break;
+        }
+        TEST_CHECK(length == strlen(expected[count]));
+        TEST_CHECK(memcmp(line, expected[count], length) == 0);
+        TEST_CHECK(line >= data && line < data + strlen(data));
+        count++;
+    }
+    TEST_CHECK(count == 4);
+    TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == -1);
+    cfl_ndjson_reader_destroy(reader);
+
+    reader = cfl_ndjson_reader_create(NULL, 0);
+    TEST_CHECK(reader != NULL);
+    TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == -1);
+    cfl_ndjson_reader_destroy(reader);
+}
+
+static int replay_callback(struct cfl_kvlist *record,
+                           const char *line, size_t length,
+                           int worker, void *data)
+{
+    struct replay *replay = data;
+    struct cfl_variant *value;
+
+    (void) line;
+    (void) length;
+
+    replay->lines[worker]++;
+    if (record != NULL) {
+        replay->records[worker]++;
+        value = cfl_kvlist_fetch(record, "n");
+        if (value != NULL && value->type == CFL_VARIANT_INT) {
+            replay->sum[worker] += value->data.as_int64;
+        }
+    }
+
+    if (replay->stop_after > 0 && replay->lines[worker] == replay->stop_after) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static char *replay_data(int lines, size_t *size)
+{
+    int index;
+    size_t offset = 0;
+    char *data;
+
+    data = malloc(lines * 64);
+    TEST_CHECK(data != NULL);
+
+    for (index = 1; index <= lines; index++) {
+        if (index % 100 == 0) {
+            offset += sprintf(data + offset, "not json\n");
+        }
+        else {
+            offset += sprintf(data + offset,
+                              "{\"n\":%d,\"msg\":\"line \\\"%d\\\"\"}\n",
+                              index, index);
+        }
+    }
+    *size = offset;
+
+    return data;
+}
+
+static void test_ndjson_reader_for_each()
+{
+    int index;
+    int workers;
+    int lines = 10000;
+    int records;
+    int total;
+    int64_t sum;
+    int64_t expected = 0;
+    size_t size;
+    size_t length;
+    const char *line;
+    char *data;
+    struct replay replay;
+    struct cfl_ndjson_reader *reader;
+
+    data = replay_data(lines, &size);
+    for (index = 1; index <= lines; index++) {
+        if (index % 100 != 0) {
+            expected += index;
+        }
+    }
+
+    for (workers = 1; workers <= 4; workers++) {
+        reader = cfl_ndjson_reader_create(data, size);
+        TEST_CHECK(reader != NULL);
+
+        memset(&replay, 0, sizeof(replay));
+        TEST_CHECK(cfl_ndjson_reader_for_each(reader, workers,
+                                              CFL_NDJSON_DECODE,
+                                              replay_callback, &replay) == 0);
+
+        sum = 0;
+        records = 0;
+        total = 0;
+        for (index = 0; index < workers; index++) {
+            sum += replay.sum[index];
+            records += replay.records[index];
+            total += replay.lines[index];
+        }
+        TEST_CHECK(total == lines);
+        TEST_CHECK(records == lines - lines / 100);
+        TEST_CHECK(sum == expected);
+        TEST_MSG("workers=%d sum=%lld", workers, (long long) sum);
+
+        TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == -1);
+        cfl_ndjson_reader_destroy(reader);
+    }
+
+    /* without decoding, after lines were consumed with next() */
+    reader = cfl_ndjson_reader_create(data, size);
+    TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == 0);
+    TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == 0);
+    memset(&replay, 0, sizeof(replay));
+    TEST_CHECK(cfl_ndjson_reader_for_each(reader, 3, 0,
+                                          replay_callback, &replay) == 0);
+    TEST_CHECK(replay.lines[0] + replay.lines[1] + replay.lines[2] ==
+               lines - 2);
+    TEST_CHECK(replay.records[0] + replay.records[1] + replay.records[2] == 0);
+    cfl_ndjson_reader_destroy(reader);
+
+    /* a callback stops the run */
+    reader = cfl_ndjson_reader_create(data, size);
+    memset(&replay, 0, sizeof(replay));
+    replay.stop_after = 10;
+    TEST_CHECK(cfl_ndjson_reader_for_each(reader, 1, CFL_NDJSON_DECODE,
+                                          replay_callback, &replay) == -1);
+    TEST_CHECK(replay.lines[0] == 10);
+    cfl_ndjson_reader_destroy(reader);
+
+    free(data);
+}
+
+#ifndef _WIN32
+static void test_ndjson_reader_open()
+{
+    int fd;
+    int count = 0;
+    char path[] = "/tmp/cfl-ndjson-XXXXXX";
+    const char *data = "{\"a\":1}\n{\"a\":2}\n";
+    size_t length;
+    const char *line;
+    struct cfl_kvlist *list;
+    struct cfl_ndjson_reader *reader;
+
+    TEST_CHECK(cfl_ndjson_reader_open("/nonexistent/cfl.ndjson") == NULL);
+
+    fd = mkstemp(path);
+    TEST_CHECK(fd != -1);
+    if (fd == -1) {
+        return;
+    }
+
+    /* empty file */
+    reader = cfl_ndjson_reader_open(path);
+    TEST_CHECK(reader != NULL);
+    TEST_CHECK(cfl_ndjson_reader_next(reader, &line, &length) == -1);
+    cfl_ndjson_reader_destroy(reader);
+
+    TEST_CHECK(write(fd, data, strlen(data)) == (ssize_t) strlen(data));
+    close(fd);
+
+    reader = cfl_ndjson_reader_open(path);
+    TEST_CHECK(reader != NULL);
+    while (reader != NULL &&
+           cfl_ndjson_reader_next(reader, &line, &length) == 0) {
+        list = cfl_ndjson_decode(NULL, line, length, 0);
+        TEST_CHECK(list != NULL);
+        TEST_CHECK(value_of(list, "a")->data.as_int64 == ++count);
+        cfl_kvlist_destroy(list);
+    }
+    TEST_CHECK(count == 2);
+    cfl_ndjson_reader_destroy(reader);
+
+    unlink(path);
+}
+#endif
+
+TEST_LIST = {
+    {"decode", test_ndjson_decode},
+    {"decode_escapes", test_ndjson_decode_escapes},
+    {"decode_invalid", test_ndjson_decode_invalid},
+    {"reader_next", test_ndjson_reader_next},
+    {"reader_for_each", test_ndjson_reader_for_each},
+#ifndef _WIN32
+    {"reader_open", test_ndjson_reader_open},
+#endif
+    { 0 }
+};
@@ -0,0 +1,227 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#include <cfl/cfl.h>
+#include <cfl/cfl_object_cache.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined (_WIN32) || defined (_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+#define THREAD_COUNT 4
+#define ENTRY_COUNT  2000
+
+/* upper bound of the per-thread cache: 16 classes of 16 KiB */
+#define CACHE_LIMIT  (16 * 16384)
+
+static struct cfl_kvlist *create_graph(int entries)
+{
+    int index;
+    char key[32];
+    struct cfl_array *array;
+    struct cfl_kvlist *list;
+
+    list = cfl_kvlist_create();
+    if (list == NULL) {
+        return NULL;
+    }
+
+    for (index = 0; index < entries; index++) {
+        snprintf(key, sizeof(key), "key-%d", index);
+        if (index % 3 == 0) {
+            cfl_kvlist_insert_string(list, key, "a short string value");
+        }
+        else if (index % 3 == 1) {
+            cfl_kvlist_insert_int64(list, key, index);
+        }
+        else {
+            array = cfl_array_create(2);
+            cfl_array_append_string(array, "element");
+            cfl_array_append_double(array, 1.5);
+            cfl_kvlist_insert_array(list, key, array);
+        }
+    }
+
+    return list;
+}
+
+static void test_reuse()
+{
+    struct cfl_variant *first;
+    struct cfl_variant *second;
+    struct cfl_kvlist *list;
+
+    cfl_object_cache_flush();
+    TEST_CHECK(cfl_object_cache_size() == 0);
+
+    list = create_graph(30);
+    TEST_CHECK(list != NULL);
+    cfl_kvlist_destroy(list);
+
+    first = cfl_variant_create_from_string("value");
+    TEST_CHECK(first != NULL);
+    cfl_variant_destroy(first);
+
+#ifdef CFL_HAVE_OBJECT_CACHE
+    TEST_CHECK(cfl_object_cache_size() > 0);
+
+    /* the most recently freed block of the class comes back first */
+    second = cfl_variant_create_from_string("other");
+    TEST_CHECK(second == first);
+    TEST_CHECK(strcmp(second->data.as_string, "other") == 0);
+    cfl_variant_destroy(second);
+#else
+    TEST_CHECK(cfl_object_cache_size() == 0);
+    second = NULL;
+    (void) second;
+#endif
+
+    cfl_object_cache_flush();
+    TEST_CHECK(cfl_object_cache_size() == 0);
+}
+
+static void test_bound()
+{
+    struct cfl_kvlist *list;
+
+    list = create_graph(ENTRY_COUNT * 5);
+    TEST_CHECK(list != NULL);
+    cfl_kvlist_destroy(list);
+
+    TEST_CHECK(cfl_object_cache_size() <= CACHE_LIMIT);
+
+    cfl_object_cache_flush();
+    TEST_CHECK(cfl_object_cache_size() == 0);
+}
+
+static void test_sds_growth()
+{
+    int index;
+    char expected[600];
+    cfl_sds_t s;
+
+    /* grows within a class, across classes and out of the cached sizes */
+    s = cfl_sds_create("x");
+    TEST_CHECK(s != NULL);
+    expected[0] = 'x';
+    for (index = 1; index < 500; index++) {
+        s = cfl_sds_cat(s, "0123456789" + (index % 10), 1);
+        TEST_CHECK(s != NULL);
+        if (s == NULL) {
+            return;
+        }
+        expected[index] = "0123456789"[index % 10];
+    }
+    TEST_CHECK(cfl_sds_len(s) == 500);
+    TEST_CHECK(memcmp(s, expected, 500) == 0);
+    TEST_CHECK(s[500] == '\0');
+    cfl_sds_destroy(s);
+
+    /* exact capacities are kept for cached strings */
+    s = cfl_sds_create("test");
+    TEST_CHECK(cfl_sds_alloc(s) == 4);
+    s = cfl_sds_cat(s, "ing", 3);
+    TEST_CHECK(cfl_sds_alloc(s) == 7);
+    TEST_CHECK(strcmp(s, "testing") == 0);
+    cfl_sds_destroy(s);
+
+    cfl_object_cache_flush();
+}
+
+#if defined (_WIN32) || defined (_WIN64)
+static DWORD WINAPI worker(LPVOID data)
+#else
+static void *worker(void *data)
+#endif
+{
+    int round;
+    struct cfl_kvlist *list;
+    struct cfl_kvlist **handoff;
+
+    handoff = data;
+
+    for (round = 0; round < 10; round++) {
+        list = create_graph(ENTRY_COUNT);
+        cfl_kvlist_destroy(list);
+    }
+
+    /* left for the main thread to free, the worker exits with a full cache */
+    *handoff = create_graph(ENTRY_COUNT);
+
+#if defined (_WIN32) || defined (_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void test_threads()
+{
+    int                 index;
+    struct cfl_kvlist  *lists[THREAD_COUNT];
+#if defined (_WIN32) || defined (_WIN64)
+    HANDLE              threads[THREAD_COUNT];
+#else
+    pthread_t           threads[THREAD_COUNT];
+#endif
+
+    for (index = 0; index < THREAD_COUNT; index++) {
+        lists[index] = NULL;
+#if defined (_WIN32) || defined (_WIN64)
+        threads[index] = CreateThread(NULL, 0, worker, &lists[index], 0, NULL);
+        TEST_CHECK(threads[index] != NULL);
+#else
+        TEST_CHECK(pthread_create(&threads[index], NULL,
+                                  worker, &lists[index]) == 0);
+#endif
+    }
+
+    for (index = 0; index < THREAD_COUNT; index++) {
+#if defined (_WIN32) || defined (_WIN64)
+        WaitForSingleObject(threads[index], INFINITE);
+        CloseHandle(threads[index]);
+#else
+        pthread_join(threads[index], NULL);
+#endif
+    }
+
+    /* objects allocated by the workers go to this thread's cache */
+    for (index = 0; index < THREAD_COUNT; index++) {
+        TEST_CHECK(lists[index] != NULL);
+        TEST_CHECK(cfl_kvlist_count(lists[index]) == ENTRY_COUNT);
+        cfl_kvlist_destroy(lists[index]);
+    }
+    TEST_CHECK(cfl_object_cache_size() <= CACHE_LIMIT);
+
+    cfl_object_cache_flush();
+}
+
+TEST_LIST = {
+    {"reuse",      test_reuse},
+    {"bound",      test_bound},
+    {"sds_growth", test_sds_growth},
+    {"threads",    test_threads},
+    { 0 }
+};
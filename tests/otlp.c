@@ -0,0 +1,251 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_otlp.h>
+
+#include "cfl_tests_internal.h"
+
+static int check_any_value(struct cfl_variant *value,
+                           const unsigned char *expected,
+                           size_t expected_size)
+{
+    int ret;
+    size_t size;
+    size_t encoded_size;
+    char buffer[256];
+
+    ret = cfl_otlp_any_value_size(value, &size);
+    if (!TEST_CHECK(ret == 0 && size == expected_size)) {
+        TEST_MSG("size mismatch. got=%zu expect=%zu", size, expected_size);
+        return -1;
+    }
+
+    memset(buffer, 0xAA, sizeof(buffer));
+    ret = cfl_otlp_any_value_encode(value, buffer, sizeof(buffer),
+                                    &encoded_size);
+    if (!TEST_CHECK(ret == 0 && encoded_size == expected_size)) {
+        return -1;
+    }
+
+    if (!TEST_CHECK(memcmp(buffer, expected, expected_size) == 0)) {
+        TEST_MSG("encoded bytes mismatch");
+        return -1;
+    }
+
+    /* nothing is written past the encoded size */
+    TEST_CHECK((unsigned char) buffer[expected_size] == 0xAA);
+
+    return 0;
+}
+
+static void test_scalars()
+{
+    struct cfl_variant *value;
+    char bytes[] = {0x01, 0x02};
+    const unsigned char string_expected[] = {0x0a, 0x02, 'h', 'i'};
+    const unsigned char empty_expected[] = {0x0a, 0x00};
+    const unsigned char bool_expected[] = {0x10, 0x01};
+    const unsigned char false_expected[] = {0x10, 0x00};
+    const unsigned char int_expected[] = {0x18, 0x96, 0x01};
+    const unsigned char negative_expected[] = {
+        0x18, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01
+    };
+    const unsigned char uint_expected[] = {
+        0x18, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01
+    };
+    const unsigned char double_expected[] = {
+        0x21, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f
+    };
+    const unsigned char bytes_expected[] = {0x3a, 0x02, 0x01, 0x02};
+
+    value = cfl_variant_create_from_string("hi");
+    check_any_value(value, string_expected, sizeof(string_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_string("");
+    check_any_value(value, empty_expected, sizeof(empty_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_bool(CFL_TRUE);
+    check_any_value(value, bool_expected, sizeof(bool_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_bool(CFL_FALSE);
+    check_any_value(value, false_expected, sizeof(false_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_int64(150);
+    check_any_value(value, int_expected, sizeof(int_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_int64(-1);
+    check_any_value(value, negative_expected, sizeof(negative_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_uint64(UINT64_MAX);
+    check_any_value(value, uint_expected, sizeof(uint_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_double(1.0);
+    check_any_value(value, double_expected, sizeof(double_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_bytes(bytes, sizeof(bytes), CFL_FALSE);
+    check_any_value(value, bytes_expected, sizeof(bytes_expected));
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_null();
+    check_any_value(value, (const unsigned char *) "", 0);
+    cfl_variant_destroy(value);
+}
+
+static void test_containers()
+{
+    struct cfl_array *array;
+    struct cfl_kvlist *kvlist;
+    struct cfl_variant *value;
+    const unsigned char array_expected[] = {
+        0x2a, 0x09,
+              0x0a, 0x03, 0x0a, 0x01, 'a',
+              0x0a, 0x02, 0x18, 0x01
+    };
+    const unsigned char kvlist_expected[] = {
+        0x32, 0x09,
+              0x0a, 0x07,
+                    0x0a, 0x01, 'k',
+                    0x12, 0x02, 0x10, 0x01
+    };
+
+    array = cfl_array_create(2);
+    TEST_CHECK(array != NULL);
+    TEST_CHECK(cfl_array_append_string(array, "a") == 0);
+    TEST_CHECK(cfl_array_append_int64(array, 1) == 0);
+    value = cfl_variant_create_from_array(array);
+    check_any_value(value, array_expected, sizeof(array_expected));
+    cfl_variant_destroy(value);
+
+    kvlist = cfl_kvlist_create();
+    TEST_CHECK(kvlist != NULL);
+    TEST_CHECK(cfl_kvlist_insert_bool(kvlist, "k", CFL_TRUE) == 0);
+    value = cfl_variant_create_from_kvlist(kvlist);
+    check_any_value(value, kvlist_expected, sizeof(kvlist_expected));
+    cfl_variant_destroy(value);
+}
+
+static void test_attributes()
+{
+    int ret;
+    size_t size;
+    size_t encoded_size;
+    char buffer[64];
+    struct cfl_kvlist *kvlist;
+    const unsigned char expected[] = {
+        0x32, 0x08, 0x0a, 0x01, 'a', 0x12, 0x03, 0x0a, 0x01, 'b',
+        0x32, 0x07, 0x0a, 0x01, 'c', 0x12, 0x02, 0x18, 0x05
+    };
+
+    kvlist = cfl_kvlist_create();
+    TEST_CHECK(kvlist != NULL);
+    TEST_CHECK(cfl_kvlist_insert_string(kvlist, "a", "b") == 0);
+    TEST_CHECK(cfl_kvlist_insert_int64(kvlist, "c", 5) == 0);
+
+    /* LogRecord.attributes is field 6 */
+    ret = cfl_otlp_key_values_size(kvlist, 6, &size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(size == sizeof(expected));
+
+    ret = cfl_otlp_key_values_encode(kvlist, 6, buffer, sizeof(buffer),
+                                     &encoded_size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(encoded_size == sizeof(expected));
+    TEST_CHECK(memcmp(buffer, expected, sizeof(expected)) == 0);
+
+    /* a short buffer is rejected before anything is written */
+    ret = cfl_otlp_key_values_encode(kvlist, 6, buffer, sizeof(expected) - 1,
+                                     &encoded_size);
+    TEST_CHECK(ret == -1);
+
+    ret = cfl_otlp_key_values_size(kvlist, 0, &size);
+    TEST_CHECK(ret == -1);
+
+    cfl_kvlist_destroy(kvlist);
+}
+
+static void test_nested_sizes()
+{
+    int ret;
+    size_t index;
+    size_t size;
+    size_t encoded_size;
+    char *buffer;
+    char payload[300];
+    struct cfl_array *array;
+    struct cfl_kvlist *kvlist;
+    struct cfl_kvlist *inner;
+    struct cfl_variant *value;
+
+    memset(payload, 'x', sizeof(payload));
+
+    kvlist = cfl_kvlist_create();
+    inner = cfl_kvlist_create();
+    array = cfl_array_create(64);
+    TEST_CHECK(kvlist != NULL && inner != NULL && array != NULL);
+
+    for (index = 0; index < 64; index++) {
+        TEST_CHECK(cfl_array_append_string_s(array, payload,
+                                             index * 4, CFL_FALSE) == 0);
+    }
+
+    TEST_CHECK(cfl_kvlist_insert_array(inner, "values", array) == 0);
+    TEST_CHECK(cfl_kvlist_insert_double(inner, "ratio", 0.5) == 0);
+    TEST_CHECK(cfl_kvlist_insert_kvlist(kvlist, "inner", inner) == 0);
+    TEST_CHECK(cfl_kvlist_insert_reference(kvlist, "none", NULL) == 0);
+
+    value = cfl_variant_create_from_kvlist(kvlist);
+    TEST_CHECK(value != NULL);
+
+    ret = cfl_otlp_any_value_size(value, &size);
+    TEST_CHECK(ret == 0);
+
+    buffer = malloc(size);
+    TEST_CHECK(buffer != NULL);
+
+    ret = cfl_otlp_any_value_encode(value, buffer, size, &encoded_size);
+    TEST_CHECK(ret == 0);
+    TEST_CHECK(encoded_size == size);
+
+    /* kvlist_value tag followed by a two byte length prefix */
+    TEST_CHECK((unsigned char) buffer[0] == 0x32);
+    TEST_CHECK(((unsigned char) buffer[1] & 0x80) != 0);
+
+    ret = cfl_otlp_any_value_encode(value, buffer, size - 1, &encoded_size);
+    TEST_CHECK(ret == -1);
+
+    free(buffer);
+    cfl_variant_destroy(value);
+}
+
+TEST_LIST = {
+    {"scalars",      test_scalars},
+    {"containers",   test_containers},
+    {"attributes",   test_attributes},
+    {"nested_sizes", test_nested_sizes},
+    { 0 }
+};
@@ -18,7 +18,10 @@
  */
 
 #include <cfl/cfl.h>
+#include <limits.h>
+#include <math.h>
 #include <stddef.h>
+#include <stdio.h>
 #include "cfl_tests_internal.h"
 
 static void test_sds_header_compatibility()
@@ -26,9 +29,6 @@ static void test_sds_header_compatibility()
     cfl_sds_t s;
     struct cfl_sds *head;
 
-    TEST_CHECK(CFL_SDS_HEADER_SIZE == sizeof(uint64_t) * 2);
-    TEST_CHECK(offsetof(struct cfl_sds, buf) == CFL_SDS_HEADER_SIZE);
-
     s = cfl_sds_create_size(64);
     TEST_CHECK(s != NULL);
     if (s == NULL) {
@@ -39,7 +39,103 @@ static void test_sds_header_compatibility()
     TEST_CHECK(head->len == 0);
     TEST_CHECK(head->alloc == 64);
     TEST_CHECK(head->buf == s);
+
+    s = cfl_sds_cat(s, "compat", 6);
+    TEST_CHECK(s != NULL);
+    if (s == NULL) {
+        return;
+    }
+    TEST_CHECK(CFL_SDS_HEADER(s)->len == 6);
+    TEST_CHECK(CFL_SDS_HEADER(s)->alloc == cfl_sds_alloc(s));
+
+    cfl_sds_len_set(s, 3);
+    head = CFL_SDS_HEADER(s);
+    TEST_CHECK(head->len == 3);
+    TEST_CHECK(strcmp(head->buf, "com") == 0);
+    cfl_sds_destroy(s);
+}
+
+static void test_sds_header_widths()
+{
+    size_t index;
+    cfl_sds_t s;
+    struct cfl_arena *arena;
+    struct {
+        size_t size;
+        int type;
+        size_t header_size;
+    } cases[] = {
+        {0, CFL_SDS_TYPE_8, 3},
+        {255, CFL_SDS_TYPE_8, 3},
+        {256, CFL_SDS_TYPE_16, 5},
+        {65535, CFL_SDS_TYPE_16, 5},
+        {65536, CFL_SDS_TYPE_32, 9},
+    };
+
+    TEST_CHECK(sizeof(struct cfl_sds8) == 3);
+    TEST_CHECK(sizeof(struct cfl_sds16) == 5);
+    TEST_CHECK(sizeof(struct cfl_sds32) == 9);
+    TEST_CHECK(sizeof(struct cfl_sds64) == 17);
+    TEST_CHECK(CFL_SDS_HEADER_SIZE == sizeof(struct cfl_sds64));
+
+    for (index = 0; index < sizeof(cases) / sizeof(cases[0]); index++) {
+        s = cfl_sds_create_size(cases[index].size);
+        TEST_CHECK(s != NULL);
+        if (s == NULL) {
+            continue;
+        }
+
+        TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) == cases[index].type);
+        TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_ARENA) == 0);
+        TEST_CHECK(cfl_sds_header_size(s) == cases[index].header_size);
+        TEST_CHECK((char *) cfl_sds_header_start(s) ==
+                   s - cases[index].header_size);
+        TEST_CHECK(cfl_sds_len(s) == 0);
+        TEST_CHECK(cfl_sds_alloc(s) == cases[index].size);
+        TEST_MSG("size=%zu", cases[index].size);
+        cfl_sds_destroy(s);
+    }
+
+    /* growing past a width moves the string to a wider header */
+    s = cfl_sds_create("0123456789");
+    TEST_CHECK(s != NULL);
+    for (index = 0; index < 7000; index++) {
+        s = cfl_sds_cat(s, "0123456789", 10);
+        TEST_CHECK(s != NULL);
+        if (s == NULL) {
+            return;
+        }
+    }
+    TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) == CFL_SDS_TYPE_32);
+    TEST_CHECK(cfl_sds_len(s) == 70010);
+    TEST_CHECK(strncmp(s + 70000, "0123456789", 10) == 0);
+    TEST_CHECK(s[70010] == '\0');
+    cfl_sds_destroy(s);
+
+    /* arena strings take the width of their pooled class */
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+
+    s = cfl_sds_create_len_in(arena, "short", 5);
+    TEST_CHECK(s != NULL);
+    TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_ARENA) != 0);
+    TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) == CFL_SDS_TYPE_8);
+    TEST_CHECK(cfl_sds_len(s) == 5);
+    TEST_CHECK(cfl_sds_alloc(s) == 32);
+
+    s = cfl_sds_cat(s, "0123456789012345678901234567890123456789", 40);
+    TEST_CHECK(s != NULL);
+    TEST_CHECK(cfl_sds_len(s) == 45);
+    TEST_CHECK(strncmp(s, "short0123", 9) == 0);
+    cfl_sds_destroy(s);
+
+    s = cfl_sds_create_len_in(arena, NULL, 200);
+    TEST_CHECK(s != NULL);
+    TEST_CHECK((CFL_SDS_FLAGS(s) & CFL_SDS_TYPE_MASK) == CFL_SDS_TYPE_16);
+    TEST_CHECK(cfl_sds_alloc(s) == 256);
     cfl_sds_destroy(s);
+
+    cfl_arena_destroy(arena);
 }
 
 static void test_sds_usage()
@@ -85,6 +181,107 @@ static void test_sds_printf()
     cfl_sds_destroy(s);
 }
 
+#define CHECK_PRINTF(fmt, ...)                                          \
+    do {                                                                \
+        char expected[512];                                             \
+        cfl_sds_t out;                                                  \
+        out = cfl_sds_create_size(1);                                   \
+        TEST_CHECK(out != NULL);                                        \
+        snprintf(expected, sizeof(expected), fmt, __VA_ARGS__);         \
+        TEST_CHECK(cfl_sds_printf(&out, fmt, __VA_ARGS__) == out);      \
+        TEST_CHECK(cfl_sds_len(out) == strlen(expected));               \
+        TEST_CHECK(strcmp(out, expected) == 0);                         \
+        TEST_MSG("format=%s got=%s expected=%s", fmt, out, expected);  \
+        cfl_sds_destroy(out);                                           \
+    } while (0)
+
+static void test_sds_printf_formats()
+{
+    int index;
+    int precision;
+    int exponent;
+    double value;
+    char expected[512];
+    cfl_sds_t s;
+    char *null_string = NULL;
+
+    CHECK_PRINTF("%d %d %d %i", 0, -1, INT_MAX, INT_MIN);
+    CHECK_PRINTF("%u %u", 0u, UINT_MAX);
+    CHECK_PRINTF("%ld %lu", LONG_MIN, ULONG_MAX);
+    CHECK_PRINTF("%lld %llu", LLONG_MIN, ULLONG_MAX);
+    CHECK_PRINTF("%" PRId64 " %" PRIu64, INT64_MIN, UINT64_MAX);
+    CHECK_PRINTF("%zu %zu", (size_t) 0, SIZE_MAX);
+    CHECK_PRINTF("%x %X %x %lx", 0u, 0xdeadbeefu, UINT_MAX, ULONG_MAX);
+    CHECK_PRINTF("[%s] [%s] [%c%c]", "text", "", 'o', 'k');
+    CHECK_PRINTF("%.*s|%.*s|%.*s", 3, "abcdef", 10, "abc", -1, "neg");
+    CHECK_PRINTF("%.2s %.0s", "abcdef", "abc");
+    CHECK_PRINTF("%f %f %f %f", 0.0, -1.5, 3.14159265358979, 1e300);
+    CHECK_PRINTF("%f %f %.3f %.0f %.*f", 0.1, -123456789.987654321, 2.0005,
+                 2.5, 2, 1.005);
+    CHECK_PRINTF("%lf %f %f", 1e15, 999999999999999.9, -0.0);
+    CHECK_PRINTF("%.1f %.1f %.1f %.2f %.0f %.0f %.0f", 0.25, 0.35, -0.05,
+                 1.005, 0.5, 1.5, -2.5);
+    CHECK_PRINTF("%f %.15f %f %f", 4503599627.370495, 0.1, NAN, -INFINITY);
+    CHECK_PRINTF("100%% %s", "done");
+    CHECK_PRINTF("%s", "no conversions at the end");
+
+    /* left to vsnprintf() */
+    CHECK_PRINTF("%5d|%-5s|%05.1f|%+d", 42, "ab", 3.14159, 7);
+    CHECK_PRINTF("%e %g %p", 12345.678, 0.0001, (void *) NULL);
+    CHECK_PRINTF("%.3d %hd %hhu", 5, (short) -3, (unsigned char) 200);
+
+    /* decimal halfway cases and random magnitudes against the C library */
+    srand(7);
+    for (index = 0; index < 20000; index++) {
+        precision = index % 9;
+        if (index % 2 == 0) {
+            value = (double) (rand() % 2000000 - 1000000) / 2000.0;
+        }
+        else {
+            value = (double) rand() / RAND_MAX - 0.5;
+            for (exponent = rand() % 24 - 10; exponent > 0; exponent--) {
+                value *= 10;
+            }
+            for (; exponent < 0; exponent++) {
+                value /= 10;
+            }
+        }
+
+        s = cfl_sds_create_size(0);
+        snprintf(expected, sizeof(expected), "%.*f", precision, value);
+        TEST_CHECK(cfl_sds_printf(&s, "%.*f", precision, value) == s);
+        if (strcmp(s, expected) != 0) {
+            TEST_CHECK(strcmp(s, expected) == 0);
+            TEST_MSG("precision=%d got=%s expected=%s", precision, s,
+                     expected);
+        }
+        cfl_sds_destroy(s);
+    }
+
+    s = cfl_sds_create("key");
+    TEST_CHECK(s != NULL);
+    TEST_CHECK(cfl_sds_printf(&s, "=%s", null_string) == s);
+    TEST_CHECK(strcmp(s, "key=(null)") == 0);
+    cfl_sds_destroy(s);
+
+    /* grows once from a short header to a wider one */
+    s = cfl_sds_create("prefix:");
+    TEST_CHECK(s != NULL);
+    TEST_CHECK(cfl_sds_printf(&s, "%.*s%" PRIu64, 300,
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789"
+                              "0123456789012345678901234567890123456789",
+                              UINT64_MAX) == s);
+    TEST_CHECK(cfl_sds_len(s) == 7 + 300 + 20);
+    TEST_CHECK(strcmp(s + 307, "18446744073709551615") == 0);
+    cfl_sds_destroy(s);
+}
+
 static void test_sds_invalid_inputs()
 {
     cfl_sds_t s;
@@ -206,8 +403,10 @@ static void test_sds_in_buffer_slice_boundaries()
 
 TEST_LIST = {
     { "sds_header_compatibility", test_sds_header_compatibility},
+    { "sds_header_widths", test_sds_header_widths},
     { "sds_usage" , test_sds_usage},
     { "sds_printf", test_sds_printf},
+    { "sds_printf_formats", test_sds_printf_formats},
     { "sds_invalid_inputs", test_sds_invalid_inputs},
     { "sds_self_append", test_sds_self_append},
     { "sds_rejects_oversized_in_buffer_slice", test_sds_rejects_oversized_in_buffer_slice},
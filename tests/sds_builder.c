@@ -0,0 +1,216 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_sds_builder.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cfl_tests_internal.h"
+
+static char *long_text(char *buffer, size_t length, char fill)
+{
+    memset(buffer, fill, length);
+    return buffer;
+}
+
+static void test_sds_builder_flatten()
+{
+    char a[200];
+    char b[300];
+    char expected[600];
+    size_t length;
+    cfl_sds_t s;
+    struct cfl_sds_builder *builder;
+
+    builder = cfl_sds_builder_create();
+    TEST_CHECK(builder != NULL);
+
+    s = cfl_sds_builder_flatten(builder);
+    TEST_CHECK(s != NULL && cfl_sds_len(s) == 0 && s[0] == '\0');
+    cfl_sds_destroy(s);
+
+    long_text(a, sizeof(a), 'a');
+    long_text(b, sizeof(b), 'b');
+
+    TEST_CHECK(cfl_sds_builder_append(builder, "head:", 5) == 0);
+    TEST_CHECK(cfl_sds_builder_append_ref(builder, a, sizeof(a)) == 0);
+    TEST_CHECK(cfl_sds_builder_append(builder, ",", 1) == 0);
+    TEST_CHECK(cfl_sds_builder_append_sds(builder,
+                   cfl_sds_create_len(b, sizeof(b))) == 0);
+    TEST_CHECK(cfl_sds_builder_append_sds(builder,
+                   cfl_sds_create(":tail")) == 0);
+    TEST_CHECK(cfl_sds_builder_append_ref(builder, "!", 1) == 0);
+    TEST_CHECK(cfl_sds_builder_append(builder, NULL, 0) == 0);
+
+    length = 0;
+    memcpy(expected + length, "head:", 5);
+    length += 5;
+    memcpy(expected + length, a, sizeof(a));
+    length += sizeof(a);
+    expected[length++] = ',';
+    memcpy(expected + length, b, sizeof(b));
+    length += sizeof(b);
+    memcpy(expected + length, ":tail!", 6);
+    length += 6;
+
+    TEST_CHECK(cfl_sds_builder_length(builder) == length);
+
+    s = cfl_sds_builder_flatten(builder);
+    TEST_CHECK(s != NULL);
+    TEST_CHECK(cfl_sds_len(s) == length);
+    TEST_CHECK(memcmp(s, expected, length) == 0);
+    TEST_CHECK(s[length] == '\0');
+    cfl_sds_destroy(s);
+
+    /* flattening leaves the segments in place */
+    s = cfl_sds_builder_flatten(builder);
+    TEST_CHECK(s != NULL && cfl_sds_len(s) == length);
+    cfl_sds_destroy(s);
+
+    cfl_sds_builder_reset(builder);
+    TEST_CHECK(cfl_sds_builder_length(builder) == 0);
+
+    TEST_CHECK(cfl_sds_builder_append(builder, "again", 5) == 0);
+    s = cfl_sds_builder_flatten(builder);
+    TEST_CHECK(s != NULL && strcmp(s, "again") == 0);
+    cfl_sds_destroy(s);
+
+    cfl_sds_builder_destroy(builder);
+}
+
+static void test_sds_builder_iov()
+{
+    char a[100];
+    char b[100];
+    size_t count;
+    struct cfl_iovec *iov;
+    struct cfl_sds_builder *builder;
+
+    builder = cfl_sds_builder_create();
+    TEST_CHECK(builder != NULL);
+
+    iov = cfl_sds_builder_iov(builder, &count);
+    TEST_CHECK(count == 0);
+
+    long_text(a, sizeof(a), 'a');
+    long_text(b, sizeof(b), 'b');
+
+    /* consecutive copies share one segment, short refs are copied too */
+    cfl_sds_builder_append(builder, "[", 1);
+    cfl_sds_builder_append(builder, "1,", 2);
+    cfl_sds_builder_append_ref(builder, "2", 1);
+    cfl_sds_builder_append_sds(builder, cfl_sds_create(",3"));
+
+    /* large refs are kept in place */
+    cfl_sds_builder_append_ref(builder, a, sizeof(a));
+    cfl_sds_builder_append(builder, "]", 1);
+    cfl_sds_builder_append_ref(builder, b, sizeof(b));
+
+    iov = cfl_sds_builder_iov(builder, &count);
+    TEST_CHECK(count == 4);
+    TEST_CHECK(iov[0].iov_len == 6);
+    TEST_CHECK(memcmp(iov[0].iov_base, "[1,2,3", 6) == 0);
+    TEST_CHECK(iov[1].iov_base == (void *) a);
+    TEST_CHECK(iov[1].iov_len == sizeof(a));
+    TEST_CHECK(iov[2].iov_len == 1);
+    TEST_CHECK(memcmp(iov[2].iov_base, "]", 1) == 0);
+    TEST_CHECK(iov[3].iov_base == (void *) b);
+    TEST_CHECK(cfl_sds_builder_length(builder) == 6 + 100 + 1 + 100);
+
+    cfl_sds_builder_destroy(builder);
+}
+
+static void test_sds_builder_large()
+{
+    int index;
+    int segments;
+    char value[40];
+    size_t length;
+    cfl_sds_t s;
+    cfl_sds_t expected;
+    struct cfl_sds_builder *builder;
+
+    builder = cfl_sds_builder_create();
+    expected = cfl_sds_create_size(64);
+
+    /* copies spanning many blocks and an owned string per record */
+    segments = 0;
+    for (index = 0; index < 5000; index++) {
+        length = (size_t) snprintf(value, sizeof(value), "%d,", index);
+        TEST_CHECK(cfl_sds_builder_append(builder, value, length) == 0);
+        expected = cfl_sds_cat(expected, value, (int) length);
+
+        if (index % 100 == 0) {
+            s = cfl_sds_create_size(CFL_SDS_BUILDER_INLINE_MAX + 10);
+            memset(s, 'v', CFL_SDS_BUILDER_INLINE_MAX + 10);
+            cfl_sds_len_set(s, CFL_SDS_BUILDER_INLINE_MAX + 10);
+            expected = cfl_sds_cat(expected, s, (int) cfl_sds_len(s));
+            TEST_CHECK(cfl_sds_builder_append_sds(builder, s) == 0);
+            segments++;
+        }
+    }
+
+    /* one large copy gets a block of its own */
+    s = cfl_sds_create_size(10000);
+    memset(s, 'L', 10000);
+    cfl_sds_len_set(s, 10000);
+    TEST_CHECK(cfl_sds_builder_append(builder, s, 10000) == 0);
+    expected = cfl_sds_cat(expected, s, 10000);
+    cfl_sds_destroy(s);
+
+    TEST_CHECK(cfl_sds_builder_length(builder) == cfl_sds_len(expected));
+    cfl_sds_builder_iov(builder, &length);
+    TEST_CHECK(length >= (size_t) segments * 2);
+
+    s = cfl_sds_builder_flatten(builder);
+    TEST_CHECK(cfl_sds_len(s) == cfl_sds_len(expected));
+    TEST_CHECK(memcmp(s, expected, cfl_sds_len(s)) == 0);
+    cfl_sds_destroy(s);
+
+    cfl_sds_destroy(expected);
+    cfl_sds_builder_destroy(builder);
+}
+
+static void test_sds_builder_invalid()
+{
+    struct cfl_sds_builder *builder;
+
+    TEST_CHECK(cfl_sds_builder_append(NULL, "x", 1) == -1);
+    TEST_CHECK(cfl_sds_builder_append_sds(NULL, cfl_sds_create("x")) == -1);
+    TEST_CHECK(cfl_sds_builder_length(NULL) == 0);
+    TEST_CHECK(cfl_sds_builder_flatten(NULL) == NULL);
+    cfl_sds_builder_destroy(NULL);
+
+    builder = cfl_sds_builder_create();
+    TEST_CHECK(cfl_sds_builder_append(builder, NULL, 1) == -1);
+    TEST_CHECK(cfl_sds_builder_append_ref(builder, NULL, 1) == -1);
+    TEST_CHECK(cfl_sds_builder_append_sds(builder, NULL) == -1);
+    TEST_CHECK(cfl_sds_builder_length(builder) == 0);
+    cfl_sds_builder_destroy(builder);
+}
+
+TEST_LIST = {
+    {"flatten", test_sds_builder_flatten},
+    {"iov", test_sds_builder_iov},
+    {"large", test_sds_builder_large},
+    {"invalid", test_sds_builder_invalid},
+    { 0 }
+};
@@ -0,0 +1,205 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_spsc.h>
+
+#if defined (_WIN32) || defined (_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "cfl_tests_internal.h"
+
+#define TRANSFER_COUNT 200000
+
+static void test_basic()
+{
+    int                   index;
+    size_t                count;
+    uintptr_t             values[8];
+    void                 *items[8];
+    struct cfl_spsc_ring *ring;
+
+    TEST_CHECK(cfl_spsc_ring_create(0, 0) == NULL);
+
+    ring = cfl_spsc_ring_create(5, 0);
+    TEST_CHECK(ring != NULL);
+    TEST_CHECK(cfl_spsc_ring_capacity(ring) == 8);
+    TEST_CHECK(cfl_spsc_ring_pop(ring) == NULL);
+    TEST_CHECK(cfl_spsc_ring_push(ring, NULL) == -1);
+    TEST_CHECK(cfl_spsc_ring_wait_readable(ring, 0) == -1);
+    TEST_CHECK(cfl_spsc_ring_wait_writable(ring, 0) == 0);
+
+    for (index = 0; index < 8; index++) {
+        values[index] = index + 1;
+        TEST_CHECK(cfl_spsc_ring_push(ring, (void *) values[index]) == 0);
+    }
+    TEST_CHECK(cfl_spsc_ring_push(ring, (void *) values[0]) == -1);
+    TEST_CHECK(cfl_spsc_ring_size(ring) == 8);
+    TEST_CHECK(cfl_spsc_ring_wait_writable(ring, 0) == -1);
+
+    TEST_CHECK(cfl_spsc_ring_pop(ring) == (void *) 1);
+    TEST_CHECK(cfl_spsc_ring_pop(ring) == (void *) 2);
+    TEST_CHECK(cfl_spsc_ring_pop(ring) == (void *) 3);
+
+    /* batches wrap around the end of the slot array */
+    for (index = 0; index < 8; index++) {
+        items[index] = (void *) (uintptr_t) (index + 100);
+    }
+    count = cfl_spsc_ring_push_batch(ring, items, 8);
+    TEST_CHECK(count == 3);
+
+    count = cfl_spsc_ring_pop_batch(ring, items, 8);
+    TEST_CHECK(count == 8);
+    TEST_CHECK(items[0] == (void *) 4);
+    TEST_CHECK(items[4] == (void *) 8);
+    TEST_CHECK(items[5] == (void *) 100);
+    TEST_CHECK(items[7] == (void *) 102);
+
+    TEST_CHECK(cfl_spsc_ring_pop_batch(ring, items, 8) == 0);
+    TEST_CHECK(cfl_spsc_ring_size(ring) == 0);
+
+    cfl_spsc_ring_destroy(ring);
+}
+
+static void test_timeout()
+{
+    uint64_t              start;
+    struct cfl_spsc_ring *ring;
+
+    ring = cfl_spsc_ring_create(4, CFL_SPSC_RING_WAIT);
+    TEST_CHECK(ring != NULL);
+
+    start = cfl_time_now();
+    TEST_CHECK(cfl_spsc_ring_wait_readable(ring, 2000000) == -1);
+    TEST_CHECK(cfl_time_now() - start >= 1000000);
+
+    TEST_CHECK(cfl_spsc_ring_push(ring, ring) == 0);
+    TEST_CHECK(cfl_spsc_ring_wait_readable(ring, -1) == 0);
+
+    cfl_spsc_ring_destroy(ring);
+}
+
+#if defined (_WIN32) || defined (_WIN64)
+static DWORD WINAPI producer(LPVOID data)
+#else
+static void *producer(void *data)
+#endif
+{
+    size_t                next;
+    size_t                count;
+    size_t                index;
+    void                 *items[16];
+    struct cfl_spsc_ring *ring;
+
+    ring = data;
+    next = 1;
+
+    while (next <= TRANSFER_COUNT) {
+        cfl_spsc_ring_wait_writable(ring, -1);
+
+        count = 1 + next % 16;
+        if (count > TRANSFER_COUNT - next + 1) {
+            count = TRANSFER_COUNT - next + 1;
+        }
+        for (index = 0; index < count; index++) {
+            items[index] = (void *) (uintptr_t) (next + index);
+        }
+        next += cfl_spsc_ring_push_batch(ring, items, count);
+    }
+
+#if defined (_WIN32) || defined (_WIN64)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void transfer(int flags, uint32_t spins)
+{
+    int                   ordered;
+    size_t                index;
+    size_t                count;
+    size_t                expected;
+    void                 *items[32];
+    struct cfl_spsc_ring *ring;
+#if defined (_WIN32) || defined (_WIN64)
+    HANDLE                thread;
+#else
+    pthread_t             thread;
+#endif
+
+    ring = cfl_spsc_ring_create(64, flags);
+    TEST_CHECK(ring != NULL);
+    cfl_spsc_ring_set_spins(ring, spins);
+
+#if defined (_WIN32) || defined (_WIN64)
+    thread = CreateThread(NULL, 0, producer, ring, 0, NULL);
+    TEST_CHECK(thread != NULL);
+#else
+    TEST_CHECK(pthread_create(&thread, NULL, producer, ring) == 0);
+#endif
+
+    ordered = CFL_TRUE;
+    expected = 1;
+    while (expected <= TRANSFER_COUNT) {
+        cfl_spsc_ring_wait_readable(ring, -1);
+
+        count = cfl_spsc_ring_pop_batch(ring, items, 32);
+        for (index = 0; index < count; index++) {
+            if (items[index] != (void *) (uintptr_t) expected) {
+                ordered = CFL_FALSE;
+            }
+            expected++;
+        }
+    }
+    TEST_CHECK(ordered);
+
+#if defined (_WIN32) || defined (_WIN64)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+
+    TEST_CHECK(cfl_spsc_ring_size(ring) == 0);
+    cfl_spsc_ring_destroy(ring);
+}
+
+static void test_transfer_spin()
+{
+    transfer(0, CFL_SPSC_RING_DEFAULT_SPINS);
+}
+
+static void test_transfer_wait()
+{
+    /* no spinning forces every wait through the sleep handshake */
+    transfer(CFL_SPSC_RING_WAIT, 0);
+    transfer(CFL_SPSC_RING_WAIT, CFL_SPSC_RING_DEFAULT_SPINS);
+}
+
+TEST_LIST = {
+    {"basic",         test_basic},
+    {"timeout",       test_timeout},
+    {"transfer_spin", test_transfer_spin},
+    {"transfer_wait", test_transfer_wait},
+    { 0 }
+};
@@ -0,0 +1,163 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_time.h>
+
+#include "cfl_tests_internal.h"
+
+#define MS 1000000ULL
+
+static void wait_ns(uint64_t interval)
+{
+    uint64_t start;
+
+    start = cfl_time_monotonic();
+    while (cfl_time_monotonic() - start < interval) {
+    }
+}
+
+static void test_clocks()
+{
+    int      index;
+    uint64_t previous;
+    uint64_t current;
+    uint64_t wall;
+
+    previous = cfl_time_monotonic();
+    for (index = 0; index < 1000; index++) {
+        current = cfl_time_monotonic();
+        TEST_CHECK(current >= previous);
+        previous = current;
+    }
+
+    /* coarse clocks trail the precise ones by at most a few ticks */
+    wall = cfl_time_now();
+    TEST_CHECK(cfl_time_now_coarse() <= wall + 50 * MS);
+    TEST_CHECK(cfl_time_now_coarse() + 50 * MS >= wall);
+
+    current = cfl_time_monotonic();
+    TEST_CHECK(cfl_time_monotonic_coarse() <= current + 50 * MS);
+    TEST_CHECK(cfl_time_monotonic_coarse() + 50 * MS >= current);
+}
+
+static void test_tsc()
+{
+    uint64_t tsc_start;
+    uint64_t tsc_end;
+    uint64_t start;
+    uint64_t end;
+    int64_t  drift;
+
+    TEST_MSG("tsc available: %d", cfl_time_tsc_available());
+
+    /* the first call calibrates */
+    cfl_time_tsc();
+
+    start = cfl_time_monotonic();
+    tsc_start = cfl_time_tsc();
+    wait_ns(20 * MS);
+    tsc_end = cfl_time_tsc();
+    end = cfl_time_monotonic();
+
+    TEST_CHECK(tsc_end > tsc_start);
+
+    /* both clocks measure the same interval within 2% */
+    drift = (int64_t) (tsc_end - tsc_start) - (int64_t) (end - start);
+    if (drift < 0) {
+        drift = -drift;
+    }
+    TEST_CHECK((uint64_t) drift < (end - start) / 50);
+    TEST_MSG("monotonic=%llu tsc=%llu", (unsigned long long) (end - start),
+             (unsigned long long) (tsc_end - tsc_start));
+
+    /* TSC readings stay on the monotonic timeline */
+    TEST_CHECK(cfl_time_tsc() + 50 * MS >= cfl_time_monotonic());
+    TEST_CHECK(cfl_time_tsc() <= cfl_time_monotonic() + 50 * MS);
+}
+
+static void test_tsc_resync()
+{
+    int      index;
+    uint64_t before;
+    uint64_t after;
+    uint64_t reading;
+    uint64_t previous;
+
+    cfl_time_tsc();
+
+    /* span a few re-anchors, each reading bracketed by monotonic reads */
+    previous = 0;
+    for (index = 0; index < 35; index++) {
+        before = cfl_time_monotonic();
+        reading = cfl_time_tsc();
+        after = cfl_time_monotonic();
+
+        TEST_CHECK(reading + MS >= before);
+        TEST_CHECK(reading <= after + MS);
+        TEST_MSG("monotonic=[%llu, %llu] tsc=%llu",
+                 (unsigned long long) before, (unsigned long long) after,
+                 (unsigned long long) reading);
+
+        TEST_CHECK(reading >= previous);
+        previous = reading;
+
+        wait_ns(10 * MS);
+    }
+}
+
+static void test_cache()
+{
+    uint64_t first;
+    uint64_t wall;
+
+    /* not running: the coarse clocks answer */
+    wall = cfl_time_now();
+    TEST_CHECK(cfl_time_cached_now() + 50 * MS >= wall);
+
+    TEST_CHECK(cfl_time_cache_start(MS) == 0);
+    TEST_CHECK(cfl_time_cache_start(MS) == 0);
+
+    first = cfl_time_cached_monotonic();
+    TEST_CHECK(first != 0);
+
+    wait_ns(20 * MS);
+    TEST_CHECK(cfl_time_cached_monotonic() > first);
+
+    wall = cfl_time_now();
+    TEST_CHECK(cfl_time_cached_now() <= wall);
+    TEST_CHECK(cfl_time_cached_now() + 50 * MS >= wall);
+
+    cfl_time_cache_stop();
+    cfl_time_cache_stop();
+
+    TEST_CHECK(cfl_time_cached_monotonic() + 50 * MS >= cfl_time_monotonic());
+
+    /* the cache can be restarted */
+    TEST_CHECK(cfl_time_cache_start(0) == 0);
+    cfl_time_cache_stop();
+}
+
+TEST_LIST = {
+    {"clocks",     test_clocks},
+    {"tsc",        test_tsc},
+    {"tsc_resync", test_tsc_resync},
+    {"cache",      test_cache},
+    { 0 }
+};
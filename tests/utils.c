@@ -167,11 +167,340 @@ void test_cfl_utils_null_inputs()
     cfl_utils_split_free(NULL);
 }
 
+static void compare_split_view(const char *input, int separator, int max_split, int quoted)
+{
+    int i;
+    int count;
+    size_t length;
+    char scratch[256];
+    struct cfl_list *head;
+    struct cfl_list *split;
+    struct cfl_split_entry *entry;
+    struct cfl_split_view views[32];
+
+    length = strlen(input);
+    if (quoted) {
+        split = cfl_utils_split_quoted(input, separator, max_split);
+        count = cfl_utils_split_quoted_view(input, length, separator, max_split,
+                                            views, 32, scratch, sizeof(scratch));
+    }
+    else {
+        split = cfl_utils_split(input, separator, max_split);
+        count = cfl_utils_split_view(input, length, separator, max_split,
+                                     views, 32);
+    }
+
+    TEST_CHECK(split != NULL);
+    TEST_CHECK(count == cfl_list_size(split));
+    TEST_MSG("input=%s got=%d expect=%d", input, count, cfl_list_size(split));
+
+    i = 0;
+    cfl_list_foreach(head, split) {
+        entry = cfl_list_entry(head, struct cfl_split_entry, _head);
+        if (i >= count) {
+            break;
+        }
+        TEST_CHECK(views[i].len == (size_t) entry->len);
+        TEST_CHECK(memcmp(views[i].value, entry->value, views[i].len) == 0);
+        TEST_MSG("input=%s token=%d got=%.*s expect=%s",
+                 input, i, (int) views[i].len, views[i].value, entry->value);
+        i++;
+    }
+
+    cfl_utils_split_free(split);
+}
+
+void test_cfl_utils_split_view()
+{
+    int count;
+    const char *line;
+    char scratch[64];
+    struct cfl_arena *arena;
+    struct cfl_split_view views[4];
+    struct cfl_split_view *arena_views;
+
+    compare_split_view("aa,bb", ',', 2, CFL_FALSE);
+    compare_split_view("a b c d e", ' ', 2, CFL_FALSE);
+    compare_split_view("Regex test  *a*", ' ', 3, CFL_FALSE);
+    compare_split_view("https://fluentbit.io/announcements/", '/', -1, CFL_FALSE);
+    compare_split_view("aa,,", ',', -1, CFL_FALSE);
+    compare_split_view("", ',', -1, CFL_FALSE);
+    compare_split_view("  aa   \" spaces bb \"  cc  '  spaces dd '  ff", ' ', 256, CFL_TRUE);
+    compare_split_view("aa \"\\\"escaped balanced quotes\\\"\" bb", ' ', 256, CFL_TRUE);
+    compare_split_view("aa 'escaped \\\\ escape\' bb", ' ', 256, CFL_TRUE);
+    compare_split_view("\"aa\"bb 'cc'", ' ', 256, CFL_TRUE);
+    compare_split_view("\\\"aa bb", ' ', 256, CFL_TRUE);
+
+    /* tokens point into the line unless they were unescaped */
+    line = "key 'quoted value' \"esc\\\"aped\"";
+    count = cfl_utils_split_quoted_view(line, strlen(line), ' ', -1,
+                                        views, 4, scratch, sizeof(scratch));
+    TEST_CHECK(count == 3);
+    TEST_CHECK(views[0].value == line);
+    TEST_CHECK(views[1].value == line + 5);
+    TEST_CHECK(views[1].len == 12);
+    TEST_CHECK(views[2].value == scratch);
+    TEST_CHECK(views[2].len == 8 && memcmp(scratch, "esc\"aped", 8) == 0);
+
+    /* scratch is only required when escapes are present */
+    count = cfl_utils_split_quoted_view(line, 18, ' ', -1, views, 4, NULL, 0);
+    TEST_CHECK(count == 2);
+    count = cfl_utils_split_quoted_view(line, strlen(line), ' ', -1,
+                                        views, 4, NULL, 0);
+    TEST_CHECK(count == -1);
+
+    /* the line does not need to be NUL terminated */
+    count = cfl_utils_split_view("aa,bb,cc", 5, ',', -1, views, 4);
+    TEST_CHECK(count == 2);
+    TEST_CHECK(views[1].len == 2 && views[1].last_pos == 5);
+
+    /* too many tokens and unbalanced quotes */
+    TEST_CHECK(cfl_utils_split_view("a,b,c,d,e", 9, ',', -1, views, 4) == -1);
+    TEST_CHECK(cfl_utils_split_view("a,b,c,d,e", 9, ',', 3, views, 4) == 4);
+    TEST_CHECK(views[3].len == 3 && memcmp(views[3].value, "d,e", 3) == 0);
+    TEST_CHECK(cfl_utils_split_quoted_view("aa 'bb", 6, ' ', -1,
+                                           views, 4, scratch, sizeof(scratch)) == -1);
+
+    arena = cfl_arena_create(1024);
+    TEST_CHECK(arena != NULL);
+
+    line = "\"a\"\"b\"'c' d,e f";
+    count = cfl_utils_split_view_in(arena, line, strlen(line), ' ', -1,
+                                    CFL_TRUE, &arena_views);
+    TEST_CHECK(count == 5);
+    TEST_CHECK(arena_views[2].len == 1 && arena_views[2].value[0] == 'c');
+    TEST_CHECK(arena_views[3].len == 3 && arena_views[3].value == line + 10);
+
+    line = "x 'y\\'z' w";
+    count = cfl_utils_split_view_in(arena, line, strlen(line), ' ', -1,
+                                    CFL_TRUE, &arena_views);
+    TEST_CHECK(count == 3);
+    TEST_CHECK(arena_views[1].len == 3 && memcmp(arena_views[1].value, "y'z", 3) == 0);
+
+    count = cfl_utils_split_view_in(arena, "", 0, ' ', -1, CFL_FALSE, &arena_views);
+    TEST_CHECK(count == 0 && arena_views == NULL);
+
+    cfl_arena_destroy(arena);
+
+    TEST_CHECK(cfl_utils_split_view(NULL, 0, ',', -1, views, 4) == -1);
+}
+
+/* tokens and escapes placed across the vector block boundaries */
+void test_cfl_utils_split_view_long_lines()
+{
+    int i;
+    int count;
+    size_t n;
+    size_t length;
+    char line[512];
+    char scratch[512];
+    char expect[256];
+    struct cfl_split_view views[8];
+    struct cfl_arena *arena;
+    struct cfl_split_view *arena_views;
+
+    arena = cfl_arena_create(4096);
+    TEST_CHECK(arena != NULL);
+
+    for (n = 0; n <= 130; n++) {
+        /* word "yyy\"zzz" word */
+        length = 0;
+        memset(line + length, 'w', n);
+        length += n;
+        line[length++] = ' ';
+        line[length++] = '"';
+        memset(line + length, 'y', n);
+        length += n;
+        line[length++] = '\\';
+        line[length++] = '"';
+        memset(line + length, 'z', 130 - n);
+        length += 130 - n;
+        line[length++] = '"';
+        line[length++] = ' ';
+        memset(line + length, 'v', 150 - n);
+        length += 150 - n;
+
+        memset(expect, 'y', n);
+        expect[n] = '"';
+        memset(expect + n + 1, 'z', 130 - n);
+
+        count = cfl_utils_split_quoted_view(line, length, ' ', -1, views, 8,
+                                            scratch, sizeof(scratch));
+        if (!TEST_CHECK(count == (n > 0 ? 3 : 2))) {
+            TEST_MSG("n=%zu count=%d", n, count);
+            continue;
+        }
+
+        i = (n > 0) ? 1 : 0;
+        TEST_CHECK(views[i].len == 131);
+        TEST_CHECK(memcmp(views[i].value, expect, 131) == 0);
+        TEST_CHECK(views[i + 1].len == 150 - n);
+        TEST_MSG("n=%zu", n);
+
+        count = cfl_utils_split_view_in(arena, line, length, ' ', -1,
+                                        CFL_TRUE, &arena_views);
+        TEST_CHECK(count == (n > 0 ? 3 : 2));
+        TEST_CHECK(memcmp(arena_views[i].value, expect, 131) == 0);
+
+        /* unquoted split sees the quotes as part of the tokens */
+        count = cfl_utils_split_view(line, length, '"', -1, views, 8);
+        TEST_CHECK(count == (n < 130 ? 4 : 3));
+        TEST_CHECK(views[0].len == n + 1 && views[1].len == n + 1);
+
+        cfl_arena_reset(arena);
+    }
+
+    cfl_arena_destroy(arena);
+}
+
+static void check_double(const char *text)
+{
+    int ret;
+    double value;
+    double expect;
+    uint64_t value_bits;
+    uint64_t expect_bits;
+
+    expect = strtod(text, NULL);
+    ret = cfl_utils_parse_double(text, strlen(text), &value);
+    memcpy(&value_bits, &value, sizeof(value));
+    memcpy(&expect_bits, &expect, sizeof(expect));
+
+    TEST_CHECK(ret == 0 && value_bits == expect_bits);
+    TEST_MSG("text=%s got=%.17g expect=%.17g", text, value, expect);
+}
+
+void test_cfl_utils_parse_integers()
+{
+    int64_t int_value;
+    uint64_t uint_value;
+
+    TEST_CHECK(cfl_utils_parse_int64("0", 1, &int_value) == 0 && int_value == 0);
+    TEST_CHECK(cfl_utils_parse_int64("-42", 3, &int_value) == 0 && int_value == -42);
+    TEST_CHECK(cfl_utils_parse_int64("+42", 3, &int_value) == 0 && int_value == 42);
+    TEST_CHECK(cfl_utils_parse_int64("1234567890123", 13, &int_value) == 0 &&
+               int_value == 1234567890123LL);
+    TEST_CHECK(cfl_utils_parse_int64("9223372036854775807", 19, &int_value) == 0 &&
+               int_value == INT64_MAX);
+    TEST_CHECK(cfl_utils_parse_int64("-9223372036854775808", 20, &int_value) == 0 &&
+               int_value == INT64_MIN);
+    TEST_CHECK(cfl_utils_parse_int64("0000000000000000000000042", 25, &int_value) == 0 &&
+               int_value == 42);
+    TEST_CHECK(cfl_utils_parse_int64("9223372036854775808", 19, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64("-9223372036854775809", 20, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64("12a", 3, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64("1234567a", 8, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64(" 1", 2, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64("-", 1, &int_value) == -1);
+    TEST_CHECK(cfl_utils_parse_int64("", 0, &int_value) == -1);
+
+    /* length delimited */
+    TEST_CHECK(cfl_utils_parse_int64("123456789", 4, &int_value) == 0 &&
+               int_value == 1234);
+
+    TEST_CHECK(cfl_utils_parse_uint64("18446744073709551615", 20, &uint_value) == 0 &&
+               uint_value == UINT64_MAX);
+    TEST_CHECK(cfl_utils_parse_uint64("18446744073709551616", 20, &uint_value) == -1);
+    TEST_CHECK(cfl_utils_parse_uint64("99999999999999999999", 20, &uint_value) == -1);
+    TEST_CHECK(cfl_utils_parse_uint64("184467440737095516150", 21, &uint_value) == -1);
+    TEST_CHECK(cfl_utils_parse_uint64("12345678", 8, &uint_value) == 0 &&
+               uint_value == 12345678);
+    TEST_CHECK(cfl_utils_parse_uint64("-1", 2, &uint_value) == -1);
+    TEST_CHECK(cfl_utils_parse_uint64(NULL, 1, &uint_value) == -1);
+}
+
+void test_cfl_utils_parse_double()
+{
+    int i;
+    int digits;
+    int exponent;
+    double value;
+    uint64_t bits;
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    char text[128];
+    size_t length;
+
+    static const char *cases[] = {
+        "0", "-0", "0.0", "1", "-1.5", "3.141592653589793", "1e308", "1.7976931348623157e308",
+        "1.7976931348623159e308", "1e309", "2.2250738585072014e-308",
+        "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062328e-324",
+        "2.4703282292062327e-324", "1e-400", "9007199254740993", "9007199254740992.5",
+        "123456789012345678901234567890", "0.000000000000000000000000000001234",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "7.3177701707893310e+15", "5e-324", ".5", "5.", "1E5", "1e+5", "1e-5",
+        "12345678901234567890e-10", "0.1", "0.2", "0.3", "100000000000000000000000",
+        "8.589973e9", "1.2345678e-320", "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791"
+    };
+
+    for (i = 0; i < (int) (sizeof(cases) / sizeof(cases[0])); i++) {
+        check_double(cases[i]);
+    }
+
+    /* shortest round-trip and long forms of random doubles */
+    for (i = 0; i < 20000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bits = state & 0x7fffffffffffffffULL;
+        if ((bits >> 52) == 0x7ff) {
+            continue;
+        }
+        memcpy(&value, &bits, sizeof(value));
+
+        snprintf(text, sizeof(text), "%.17g", value);
+        check_double(text);
+        snprintf(text, sizeof(text), "%.*g", 1 + (int) (state % 25), value);
+        check_double(text);
+    }
+
+    /* random digit strings and exponents, including more than 19 digits */
+    for (i = 0; i < 20000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        digits = 1 + (int) (state % 30);
+        exponent = (int) ((state >> 8) % 700) - 350;
+        length = 0;
+        text[length++] = (state >> 20) & 1 ? '-' : '+';
+        while (digits-- > 0) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            text[length++] = '0' + (char) (state % 10);
+            if (digits == 3) {
+                text[length++] = '.';
+            }
+        }
+        length += snprintf(text + length, sizeof(text) - length, "e%d", exponent);
+        check_double(text);
+    }
+
+    TEST_CHECK(cfl_utils_parse_double("inf", 3, &value) == 0 && isinf(value) && value > 0);
+    TEST_CHECK(cfl_utils_parse_double("-Infinity", 9, &value) == 0 && isinf(value) && value < 0);
+    TEST_CHECK(cfl_utils_parse_double("NaN", 3, &value) == 0 && isnan(value));
+
+    TEST_CHECK(cfl_utils_parse_double("1.5x", 4, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double("1e", 2, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double("e5", 2, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double(".", 1, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double("0x10", 4, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double("infinit", 7, &value) == -1);
+    TEST_CHECK(cfl_utils_parse_double("", 0, &value) == -1);
+
+    /* length delimited */
+    TEST_CHECK(cfl_utils_parse_double("2.5e10", 3, &value) == 0 && value == 2.5);
+}
 
 TEST_LIST = {
     { "test_flb_utils_split", test_cfl_utils_split },
     { "test_flb_utils_split_quoted", test_cfl_utils_split_quoted},
     { "test_flb_utils_split_quoted_errors", test_cfl_utils_split_quoted_errors},
     { "test_cfl_utils_null_inputs", test_cfl_utils_null_inputs},
+    { "test_cfl_utils_split_view", test_cfl_utils_split_view},
+    { "test_cfl_utils_split_view_long_lines", test_cfl_utils_split_view_long_lines},
+    { "test_cfl_utils_parse_integers", test_cfl_utils_parse_integers},
+    { "test_cfl_utils_parse_double", test_cfl_utils_parse_double},
     { 0 }
 };
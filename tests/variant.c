@@ -645,6 +645,54 @@ static void test_variant_print_referenced_bytes()
     fclose(fp);
 }
 
+static void test_variant_numeric_text()
+{
+    struct cfl_arena *arena;
+    struct cfl_variant *value;
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "-17", 3);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_INT &&
+               value->data.as_int64 == -17);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "9223372036854775808", 19);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_UINT &&
+               value->data.as_uint64 == 9223372036854775808ULL);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "18446744073709551616", 20);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_DOUBLE &&
+               value->data.as_double == 18446744073709551616.0);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "-9223372036854775809", 20);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_DOUBLE);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "0.25", 4);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_DOUBLE &&
+               value->data.as_double == 0.25);
+    cfl_variant_destroy(value);
+
+    value = cfl_variant_create_from_numeric_text_in(NULL, "1e3", 3);
+    TEST_CHECK(value != NULL && value->type == CFL_VARIANT_DOUBLE &&
+               value->data.as_double == 1000.0);
+    cfl_variant_destroy(value);
+
+    TEST_CHECK(cfl_variant_create_from_numeric_text_in(NULL, "12abc", 5) == NULL);
+    TEST_CHECK(cfl_variant_create_from_numeric_text_in(NULL, "nan", 3) == NULL);
+    TEST_CHECK(cfl_variant_create_from_numeric_text_in(NULL, NULL, 0) == NULL);
+
+    arena = cfl_arena_create(1024);
+    TEST_CHECK(arena != NULL);
+    value = cfl_variant_create_from_numeric_text_in(arena, "4200000000", 10);
+    TEST_CHECK(value != NULL && value->arena == arena &&
+               value->type == CFL_VARIANT_INT &&
+               value->data.as_int64 == 4200000000LL);
+    cfl_variant_destroy(value);
+    cfl_arena_destroy(arena);
+}
+
 static void test_variant_invalid_inputs()
 {
     struct cfl_variant *val;
@@ -753,6 +801,7 @@ TEST_LIST = {
     {"variant_print_escaped_string", test_variant_print_escaped_string},
     {"variant_print_bytes", test_variant_print_bytes},
     {"variant_print_referenced_bytes", test_variant_print_referenced_bytes},
+    {"variant_numeric_text", test_variant_numeric_text},
     {"variant_invalid_inputs", test_variant_invalid_inputs},
     {"variant_print_array", test_variant_print_array},
     {"variant_print_kvlist", test_variant_print_kvlist},
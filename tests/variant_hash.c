@@ -0,0 +1,285 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*  CFL
+ *  ===
+ *  Copyright (C) 2026 The CFL Authors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cfl/cfl.h>
+#include <cfl/cfl_size_cache.h>
+
+#include <math.h>
+
+#include "cfl_tests_internal.h"
+
+static uint64_t hash_of(struct cfl_variant *value, int flags)
+{
+    uint64_t hash;
+
+    hash = 0;
+    TEST_CHECK(cfl_variant_hash(value, flags, &hash) == 0);
+
+    return hash;
+}
+
+/* a record with nested containers; 'reverse' inserts the keys backwards */
+static struct cfl_variant *create_record(int reverse, int64_t status)
+{
+    struct cfl_kvlist *record;
+    struct cfl_kvlist *attributes;
+    struct cfl_array *tags;
+
+    record = cfl_kvlist_create();
+    attributes = cfl_kvlist_create();
+    tags = cfl_array_create(3);
+
+    cfl_array_append_string(tags, "a");
+    cfl_array_append_bytes(tags, "\0\1", 2, CFL_FALSE);
+    cfl_array_append_double(tags, 0.5);
+
+    if (reverse) {
+        cfl_kvlist_insert_int64(attributes, "status", status);
+        cfl_kvlist_insert_string(attributes, "service", "api");
+        cfl_kvlist_insert_array(record, "tags", tags);
+        cfl_kvlist_insert_kvlist(record, "attributes", attributes);
+        cfl_kvlist_insert_string(record, "message", "hello");
+    }
+    else {
+        cfl_kvlist_insert_string(record, "message", "hello");
+        cfl_kvlist_insert_kvlist(record, "attributes", attributes);
+        cfl_kvlist_insert_array(record, "tags", tags);
+        cfl_kvlist_insert_string(attributes, "service", "api");
+        cfl_kvlist_insert_int64(attributes, "status", status);
+    }
+
+    return cfl_variant_create_from_kvlist(record);
+}
+
+static void test_scalars()
+{
+    struct cfl_variant *a;
+    struct cfl_variant *b;
+
+    a = cfl_variant_create_from_int64(1);
+    b = cfl_variant_create_from_uint64(1);
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_FALSE);
+    TEST_CHECK(hash_of(a, 0) != hash_of(b, 0));
+    cfl_variant_destroy(b);
+
+    b = cfl_variant_create_from_int64(1);
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_TRUE);
+    TEST_CHECK(hash_of(a, 0) == hash_of(b, 0));
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+
+    a = cfl_variant_create_from_string("1");
+    b = cfl_variant_create_from_bytes("1", 1, CFL_FALSE);
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_FALSE);
+    TEST_CHECK(hash_of(a, 0) != hash_of(b, 0));
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+
+    a = cfl_variant_create_from_double(0.0);
+    b = cfl_variant_create_from_double(-0.0);
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_TRUE);
+    TEST_CHECK(hash_of(a, 0) == hash_of(b, 0));
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+
+    a = cfl_variant_create_from_double(NAN);
+    b = cfl_variant_create_from_double(-NAN);
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_TRUE);
+    TEST_CHECK(hash_of(a, 0) == hash_of(b, 0));
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+
+    TEST_CHECK(cfl_variant_equal(NULL, NULL, 0) == -1);
+    TEST_CHECK(cfl_variant_hash(NULL, 0, NULL) == -1);
+}
+
+static void test_graphs()
+{
+    struct cfl_variant *a;
+    struct cfl_variant *b;
+    struct cfl_variant *c;
+    struct cfl_variant *reversed;
+    struct cfl_variant *entry;
+    struct cfl_array *tags;
+
+    a = create_record(CFL_FALSE, 200);
+    b = create_record(CFL_FALSE, 200);
+    c = create_record(CFL_FALSE, 500);
+    reversed = create_record(CFL_TRUE, 200);
+
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_TRUE);
+    TEST_CHECK(hash_of(a, 0) == hash_of(b, 0));
+
+    /* a difference deep in the graph */
+    TEST_CHECK(cfl_variant_equal(a, c, 0) == CFL_FALSE);
+    TEST_CHECK(hash_of(a, 0) != hash_of(c, 0));
+    TEST_CHECK(cfl_variant_equal(a, c, CFL_VARIANT_KVLIST_UNORDERED) ==
+               CFL_FALSE);
+
+    /* key order matters only without the unordered flag */
+    TEST_CHECK(cfl_variant_equal(a, reversed, 0) == CFL_FALSE);
+    TEST_CHECK(hash_of(a, 0) != hash_of(reversed, 0));
+    TEST_CHECK(cfl_variant_equal(a, reversed,
+                                 CFL_VARIANT_KVLIST_UNORDERED) == CFL_TRUE);
+    TEST_CHECK(hash_of(a, CFL_VARIANT_KVLIST_UNORDERED) ==
+               hash_of(reversed, CFL_VARIANT_KVLIST_UNORDERED));
+
+    /* array order always matters */
+    tags = cfl_kvlist_fetch(a->data.as_kvlist, "tags")->data.as_array;
+    entry = tags->entries[0];
+    tags->entries[0] = tags->entries[2];
+    tags->entries[2] = entry;
+    TEST_CHECK(cfl_variant_equal(a, b, CFL_VARIANT_KVLIST_UNORDERED) ==
+               CFL_FALSE);
+    TEST_CHECK(hash_of(a, 0) != hash_of(b, 0));
+
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+    cfl_variant_destroy(c);
+    cfl_variant_destroy(reversed);
+}
+
+static void test_duplicate_keys()
+{
+    struct cfl_kvlist *first;
+    struct cfl_kvlist *second;
+    struct cfl_kvlist *third;
+    struct cfl_variant *a;
+    struct cfl_variant *b;
+    struct cfl_variant *c;
+
+    first = cfl_kvlist_create();
+    second = cfl_kvlist_create();
+    third = cfl_kvlist_create();
+
+    cfl_kvlist_insert_int64(first, "k", 1);
+    cfl_kvlist_insert_int64(first, "k", 2);
+    cfl_kvlist_insert_int64(second, "k", 2);
+    cfl_kvlist_insert_int64(second, "k", 1);
+    cfl_kvlist_insert_int64(third, "k", 1);
+    cfl_kvlist_insert_int64(third, "k", 1);
+
+    a = cfl_variant_create_from_kvlist(first);
+    b = cfl_variant_create_from_kvlist(second);
+    c = cfl_variant_create_from_kvlist(third);
+
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_FALSE);
+    TEST_CHECK(cfl_variant_equal(a, b, CFL_VARIANT_KVLIST_UNORDERED) ==
+               CFL_TRUE);
+    TEST_CHECK(cfl_variant_equal(a, c, CFL_VARIANT_KVLIST_UNORDERED) ==
+               CFL_FALSE);
+    TEST_CHECK(hash_of(a, CFL_VARIANT_KVLIST_UNORDERED) ==
+               hash_of(b, CFL_VARIANT_KVLIST_UNORDERED));
+    TEST_CHECK(hash_of(a, CFL_VARIANT_KVLIST_UNORDERED) !=
+               hash_of(c, CFL_VARIANT_KVLIST_UNORDERED));
+
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+    cfl_variant_destroy(c);
+}
+
+static void test_cached()
+{
+    uint64_t hash;
+    struct cfl_variant *value;
+    struct cfl_variant *attributes;
+    struct cfl_size_cache *cache;
+
+    value = create_record(CFL_FALSE, 200);
+    cache = cfl_size_cache_create(NULL);
+    TEST_CHECK(cache != NULL);
+
+    TEST_CHECK(cfl_variant_hash_cached(value, 0, cache, &hash) == 0);
+    TEST_CHECK(hash == hash_of(value, 0));
+    TEST_CHECK(cfl_size_cache_count(cache) == 3);
+
+    TEST_CHECK(cfl_variant_hash_cached(value, 0, cache, &hash) == 0);
+    TEST_CHECK(hash == hash_of(value, 0));
+
+    /* the unordered hash has its own slot */
+    TEST_CHECK(cfl_variant_hash_cached(value, CFL_VARIANT_KVLIST_UNORDERED,
+                                       cache, &hash) == 0);
+    TEST_CHECK(hash == hash_of(value, CFL_VARIANT_KVLIST_UNORDERED));
+
+    /* mutate, invalidate, and hash again */
+    attributes = cfl_kvlist_fetch(value->data.as_kvlist, "attributes");
+    cfl_kvlist_insert_bool(attributes->data.as_kvlist, "retry", CFL_TRUE);
+    cfl_size_cache_invalidate_kvlist(cache, attributes->data.as_kvlist);
+
+    TEST_CHECK(cfl_variant_hash_cached(value, 0, cache, &hash) == 0);
+    TEST_CHECK(hash == hash_of(value, 0));
+
+    cfl_size_cache_destroy(cache);
+    cfl_variant_destroy(value);
+}
+
+/* nests up to 'depth' arrays, as deep as the container API allows */
+static struct cfl_variant *create_nested(int depth, int *created)
+{
+    int index;
+    struct cfl_array *array;
+    struct cfl_array *child;
+    struct cfl_variant *value;
+
+    array = cfl_array_create(1);
+    value = cfl_variant_create_from_array(array);
+    for (index = 0; index < depth; index++) {
+        child = cfl_array_create(1);
+        if (cfl_array_append_array(array, child) != 0) {
+            cfl_array_destroy(child);
+            break;
+        }
+        array = child;
+    }
+    cfl_array_append_int64(array, 1);
+    *created = index;
+
+    return value;
+}
+
+static void test_depth()
+{
+    int created;
+    uint64_t hash;
+    struct cfl_variant *a;
+    struct cfl_variant *b;
+
+    /* the walks do not recurse, and accept the deepest graph accepted by
+     * the container API */
+    a = create_nested(100000, &created);
+    TEST_CHECK(created >= 400);
+    TEST_MSG("created %d", created);
+    b = create_nested(created, &created);
+
+    TEST_CHECK(cfl_variant_hash(a, 0, &hash) == 0);
+    TEST_CHECK(hash == hash_of(b, 0));
+    TEST_CHECK(cfl_variant_equal(a, b, 0) == CFL_TRUE);
+
+    cfl_variant_destroy(a);
+    cfl_variant_destroy(b);
+}
+
+TEST_LIST = {
+    {"scalars",        test_scalars},
+    {"graphs",         test_graphs},
+    {"duplicate_keys", test_duplicate_keys},
+    {"cached",         test_cached},
+    {"depth",          test_depth},
+    { 0 }
+};